@@ -0,0 +1,121 @@
+#include <benchmark/benchmark.h>
+#include "backtest_runner.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t DAYS = 4;
+constexpr std::size_t RECORDS_PER_DAY = 1 << 17;
+constexpr std::uint64_t PARAMETERS = 8;
+
+// Raw journals of a few days, written once to a temporary directory
+const std::vector<std::string>& journals() {
+    static const std::vector<std::string> paths = [] {
+        const std::string directory = "/tmp/lob_benchmark_backtest_runner_" + std::to_string(::getpid());
+        std::filesystem::create_directories(directory);
+        std::vector<std::string> written;
+        for (std::size_t day = 0; day < DAYS; ++day) {
+            std::mt19937_64 rng(day);
+            std::vector<lob::JournalRecord> records;
+            std::vector<lob::OrderId> live;
+            std::int64_t time = 34'200'000'000'000;
+            lob::Price mid = 10'000;
+            for (std::uint64_t sequence = 1; records.size() < RECORDS_PER_DAY; ++sequence) {
+                time += static_cast<std::int64_t>(rng() % 20'000);
+                if (rng() % 64 == 0) {
+                    mid += static_cast<lob::Price>(rng() % 3) - 1;
+                }
+                lob::OrderCommand command{.id = sequence};
+                const std::uint64_t pick = rng() % 10;
+                const bool buy = rng() % 2;
+                command.side = buy ? lob::Side::Buy : lob::Side::Sell;
+                if (pick < 4 && !live.empty()) {
+                    const std::size_t victim = rng() % live.size();
+                    command.id = live[victim];
+                    command.type = lob::CommandType::Cancel;
+                    live[victim] = live.back();
+                    live.pop_back();
+                } else if (pick < 5) {
+                    command.price = mid + (buy ? 2 : -2);
+                    command.quantity = 1 + rng() % 50;
+                    command.order_type = lob::OrderType::IOC;
+                } else {
+                    command.price = mid + (buy ? -1 : 1) * static_cast<lob::Price>(1 + rng() % 10);
+                    command.quantity = 1 + rng() % 50;
+                    live.push_back(command.id);
+                }
+                records.push_back({.sequence = sequence, .timestamp = time, .participant = 1, .command = command});
+            }
+            written.push_back(directory + "/day" + std::to_string(day));
+            std::ofstream(written.back(), std::ios::binary)
+                .write(reinterpret_cast<const char*>(records.data()),
+                       static_cast<std::streamsize>(records.size() * sizeof(lob::JournalRecord)));
+        }
+        static const bool cleanup = std::atexit([] {
+            std::filesystem::remove_all("/tmp/lob_benchmark_backtest_runner_" + std::to_string(::getpid()));
+        }) == 0;
+        (void)cleanup;
+        return written;
+    }();
+    return paths;
+}
+
+// Quotes parameter lots at the touch, following it
+class Quoter : public lob::BacktestStrategy {
+public:
+    explicit Quoter(lob::Quantity size) : size_(size) {}
+
+    void on_market_data(const lob::MarketEvent& event, lob::Backtester& backtester) override {
+        follow(0, lob::Side::Buy, event.bid, backtester);
+        follow(1, lob::Side::Sell, event.ask, backtester);
+    }
+
+private:
+    void follow(std::size_t slot, lob::Side side, const lob::BookLevel& touch, lob::Backtester& backtester) {
+        if (touch.quantity == 0 || touch.price == prices_[slot]) {
+            return;
+        }
+        if (ids_[slot]) {
+            (void)backtester.cancel(ids_[slot]);
+        }
+        ids_[slot] = backtester.submit(side, lob::OrderType::Limit, touch.price, size_);
+        prices_[slot] = touch.price;
+    }
+
+    lob::Quantity size_;
+    lob::OrderId ids_[2]{};
+    lob::Price prices_[2]{};
+};
+
+} // namespace
+
+// A sweep of DAYS x PARAMETERS runs; arg is the thread count. Scaling needs that many cores.
+static void BM_BacktestSweep(benchmark::State& state) {
+    std::vector<lob::BacktestTask> tasks;
+    for (const std::string& journal : journals()) {
+        for (std::uint64_t parameter = 1; parameter <= PARAMETERS; ++parameter) {
+            tasks.push_back({.journal = journal, .parameter = parameter,
+                             .options = {.feed_latency = std::chrono::microseconds(5),
+                                         .order_latency = std::chrono::microseconds(5)}});
+        }
+    }
+    const lob::BacktestRunner::StrategyFactory factory = [](const lob::BacktestTask& task, std::size_t) {
+        return std::make_unique<Quoter>(task.parameter);
+    };
+    lob::BacktestRunner runner({.threads = static_cast<std::size_t>(state.range(0))});
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(runner.run(tasks, factory));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(tasks.size() * RECORDS_PER_DAY));
+    state.counters["tasks"] = benchmark::Counter(static_cast<double>(state.iterations() * tasks.size()),
+                                                 benchmark::Counter::kIsRate);
+    state.counters["cores"] = static_cast<double>(std::thread::hardware_concurrency());
+}
+BENCHMARK(BM_BacktestSweep)->RangeMultiplier(2)->Range(1, 16)->Unit(benchmark::kMillisecond)->UseRealTime();
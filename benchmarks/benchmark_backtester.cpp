@@ -0,0 +1,165 @@
+#include <benchmark/benchmark.h>
+#include "backtester.hpp"
+#include "matching_engine.hpp"
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t RECORDS = 1 << 20;
+
+// ITCH-shaped day: adds around a drifting mid, most cancelled soon after, and
+// executions replayed as IOCs at a resting price
+std::vector<lob::JournalRecord> history() {
+    std::mt19937_64 rng(11);
+    std::vector<lob::JournalRecord> records;
+    std::vector<std::pair<lob::OrderId, lob::Price>> recent;
+    std::int64_t time = 34'200'000'000'000;  // 09:30 in nanoseconds since midnight
+    lob::Price mid = 1'523'400;
+    for (std::uint64_t sequence = 1; records.size() < RECORDS; ++sequence) {
+        time += rng() % 8 ? static_cast<std::int64_t>(rng() % 2'000) : static_cast<std::int64_t>(rng() % 500'000);
+        if (rng() % 64 == 0) {
+            mid += (static_cast<lob::Price>(rng() % 3) - 1) * 100;
+        }
+        lob::OrderCommand command{.id = sequence};
+        const std::uint64_t pick = rng() % 100;
+        if (pick < 45 && !recent.empty()) {
+            const std::size_t victim = recent.size() - 1 - rng() % std::min<std::size_t>(recent.size(), 16);
+            command.id = recent[victim].first;
+            command.type = lob::CommandType::Cancel;
+            recent.erase(recent.begin() + static_cast<std::ptrdiff_t>(victim));
+        } else if (pick < 50) {
+            const bool buy = rng() % 2;
+            command.side = buy ? lob::Side::Buy : lob::Side::Sell;
+            command.price = mid + (buy ? 100 : -100);
+            command.quantity = 100 * (1 + rng() % 3);
+            command.order_type = lob::OrderType::IOC;
+        } else {
+            const bool buy = rng() % 2;
+            command.side = buy ? lob::Side::Buy : lob::Side::Sell;
+            command.price = mid + (buy ? -1 : 1) * static_cast<lob::Price>(rng() % 10) * 100;
+            command.quantity = 100 * (1 + rng() % 5);
+            recent.emplace_back(command.id, command.price);
+            if (recent.size() > 4096) {
+                recent.erase(recent.begin());
+            }
+        }
+        records.push_back({.sequence = sequence, .timestamp = time, .participant = 1, .command = command});
+    }
+    return records;
+}
+
+const std::vector<lob::JournalRecord>& day() {
+    static const std::vector<lob::JournalRecord> records = history();
+    return records;
+}
+
+// Joins both sides of the touch with one lot and follows it when it moves
+class Quoter : public lob::BacktestStrategy {
+public:
+    void on_market_data(const lob::MarketEvent& event, lob::Backtester& backtester) override {
+        follow(lob::Side::Buy, event.bid, backtester);
+        follow(lob::Side::Sell, event.ask, backtester);
+    }
+
+private:
+    struct Quote {
+        lob::OrderId id{0};
+        lob::Price price{0};
+    };
+
+    void follow(lob::Side side, const lob::BookLevel& touch, lob::Backtester& backtester) {
+        Quote& quote = quotes_[static_cast<std::size_t>(side)];
+        if (touch.quantity == 0 || touch.price == quote.price) {
+            return;
+        }
+        if (quote.id) {
+            (void)backtester.cancel(quote.id);
+        }
+        quote = {backtester.submit(side, lob::OrderType::Limit, touch.price, 100), touch.price};
+    }
+
+    Quote quotes_[2];
+};
+
+} // namespace
+
+// Baseline: the history executed straight into an engine
+static void BM_ReplayOnly(benchmark::State& state) {
+    const auto& records = day();
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto engine = std::make_unique<lob::MatchingEngine>();
+        state.ResumeTiming();
+        for (const lob::JournalRecord& record : records) {
+            (void)lob::execute_command(*engine, record.command, record.participant);
+            engine->clear_trades();
+        }
+        state.PauseTiming();
+        engine.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(records.size()));
+}
+BENCHMARK(BM_ReplayOnly)->Unit(benchmark::kMillisecond);
+
+// Same history through the backtester with a quoting strategy; arg is every latency in
+// microseconds. items are history records; events adds the deliveries and strategy orders.
+static void BM_Backtest(benchmark::State& state) {
+    const auto& records = day();
+    const lob::Timestamp latency = std::chrono::microseconds(state.range(0));
+    std::uint64_t events = 0;
+    std::uint64_t fills = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto engine = std::make_unique<lob::MatchingEngine>();
+        Quoter strategy;
+        auto backtester = lob::Backtester::create(*engine, strategy, {
+            .feed_latency = latency, .order_latency = latency, .response_latency = latency});
+        state.ResumeTiming();
+        backtester->run(records);
+        backtester->advance(lob::Timestamp{records.back().timestamp} + 4 * latency);
+        state.PauseTiming();
+        events += 2 * backtester->records() + 2 * backtester->commands_sent() + backtester->fills();
+        fills += backtester->fills();
+        if (backtester->dropped() != 0) {
+            state.SkipWithError("queue overflow");
+        }
+        backtester.reset();
+        engine.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(records.size()));
+    state.counters["events"] = benchmark::Counter(static_cast<double>(events), benchmark::Counter::kIsRate);
+    state.counters["fills"] = benchmark::Counter(static_cast<double>(fills), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_Backtest)->Arg(0)->Arg(50)->Unit(benchmark::kMillisecond);
+
+// The loop's own cost: a history of cancels for unknown ids, which the book answers
+// with one lookup, delivered to a strategy that does nothing; items are events
+static void BM_BacktestLoop(benchmark::State& state) {
+    std::vector<lob::JournalRecord> records(RECORDS);
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        records[i] = {.sequence = i + 1, .timestamp = static_cast<std::int64_t>(i) * 100, .participant = 1,
+                      .command = {.id = (1ULL << 40) + i, .type = lob::CommandType::Cancel}};
+    }
+    const lob::Timestamp latency = std::chrono::microseconds(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto engine = std::make_unique<lob::MatchingEngine>();
+        lob::BacktestStrategy strategy;
+        auto backtester = lob::Backtester::create(*engine, strategy, {.feed_latency = latency});
+        state.ResumeTiming();
+        backtester->run(records);
+        backtester->advance(lob::Timestamp{records.back().timestamp} + latency);
+        state.PauseTiming();
+        backtester.reset();
+        engine.reset();
+        state.ResumeTiming();
+    }
+    // Each record is applied, then delivered
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(2 * records.size()));
+}
+BENCHMARK(BM_BacktestLoop)->Arg(0)->Arg(50)->Unit(benchmark::kMillisecond);
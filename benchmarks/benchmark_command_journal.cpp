@@ -0,0 +1,160 @@
+#include <benchmark/benchmark.h>
+#include "command_journal.hpp"
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t RECORDS = 1 << 20;
+
+// Gateway flow: a few dozen sessions sending limit orders around the touch, about
+// half of them cancelled or modified later
+std::vector<lob::JournalRecord> gateway_records() {
+    std::mt19937_64 rng(7);
+    std::vector<lob::JournalRecord> records;
+    std::vector<std::uint64_t> client_seq(33);
+    std::vector<lob::OrderId> live;
+    std::int64_t time = 1'700'000'000'000'000'000;
+    lob::Price mid = 10'000;
+    for (std::uint64_t sequence = 1; records.size() < RECORDS; ++sequence) {
+        time += static_cast<std::int64_t>(rng() % 20'000);
+        mid += static_cast<lob::Price>(rng() % 3) - 1;
+        const auto participant = static_cast<lob::ParticipantId>(1 + rng() % 32);
+        lob::OrderCommand command{.client_seq = ++client_seq[participant]};
+        const std::uint64_t pick = rng() % 10;
+        if (pick < 3 && !live.empty()) {
+            const std::size_t victim = rng() % live.size();
+            command.id = live[victim];
+            command.type = lob::CommandType::Cancel;
+            live[victim] = live.back();
+            live.pop_back();
+        } else if (pick < 4 && !live.empty()) {
+            command.id = live[rng() % live.size()];
+            command.type = lob::CommandType::Modify;
+            command.price = mid + static_cast<lob::Price>(rng() % 10) - 5;
+            command.quantity = 100 * (1 + rng() % 10);
+        } else {
+            command.id = sequence;
+            command.side = rng() % 2 ? lob::Side::Buy : lob::Side::Sell;
+            command.price = mid + static_cast<lob::Price>(rng() % 10) - 5;
+            command.quantity = 100 * (1 + rng() % 10);
+            live.push_back(command.id);
+        }
+        records.push_back({.sequence = sequence, .timestamp = time, .participant = participant, .command = command});
+    }
+    return records;
+}
+
+// ITCH-shaped flow: one feed's add/cancel/execute stream replayed as commands, with
+// exchange-assigned ids rising by small steps, bursty microsecond timestamps, odd lots,
+// and most adds cancelled soon after (execute -> an IOC at the resting price)
+std::vector<lob::JournalRecord> itch_records() {
+    std::mt19937_64 rng(11);
+    std::vector<lob::JournalRecord> records;
+    std::vector<std::pair<lob::OrderId, lob::Price>> recent;
+    std::int64_t time = 34'200'000'000'000;  // 09:30 in nanoseconds since midnight
+    lob::Price mid = 1'523'400;
+    lob::OrderId next_id = 4'000'000;
+    for (std::uint64_t sequence = 1; records.size() < RECORDS; ++sequence) {
+        time += rng() % 8 ? static_cast<std::int64_t>(rng() % 2'000) : static_cast<std::int64_t>(rng() % 5'000'000);
+        if (rng() % 64 == 0) {
+            mid += static_cast<lob::Price>(rng() % 201) - 100;
+        }
+        lob::OrderCommand command;
+        const std::uint64_t pick = rng() % 100;
+        if (pick < 45 && !recent.empty()) {
+            const std::size_t victim = recent.size() - 1 - rng() % std::min<std::size_t>(recent.size(), 16);
+            command.id = recent[victim].first;
+            command.type = lob::CommandType::Cancel;
+            recent.erase(recent.begin() + static_cast<std::ptrdiff_t>(victim));
+        } else if (pick < 50 && !recent.empty()) {
+            command.id = next_id++;
+            command.price = recent.back().second;
+            command.quantity = 1 + rng() % 300;
+            command.order_type = lob::OrderType::IOC;
+        } else {
+            next_id += 1 + rng() % 4;
+            command.id = next_id;
+            command.side = rng() % 2 ? lob::Side::Buy : lob::Side::Sell;
+            command.price = mid + (static_cast<lob::Price>(rng() % 50) - 25) * 100;
+            command.quantity = rng() % 4 ? 100 * (1 + rng() % 5) : 1 + rng() % 99;
+            recent.emplace_back(command.id, command.price);
+            if (recent.size() > 4096) {
+                recent.erase(recent.begin());
+            }
+        }
+        records.push_back({.sequence = sequence, .timestamp = time, .participant = 1, .command = command});
+    }
+    return records;
+}
+
+const std::vector<lob::JournalRecord>& workload(std::int64_t which) {
+    static const std::vector<lob::JournalRecord> gateway = gateway_records();
+    static const std::vector<lob::JournalRecord> itch = itch_records();
+    return which == 0 ? gateway : itch;
+}
+
+std::vector<std::byte> encode(const std::vector<lob::JournalRecord>& records) {
+    lob::JournalEncoder encoder;
+    std::vector<std::byte> stream(records.size() * lob::JournalEncoder::MAX_RECORD);
+    std::size_t length = 0;
+    for (const lob::JournalRecord& record : records) {
+        length += encoder.encode(record, stream.data() + length);
+    }
+    stream.resize(length);
+    return stream;
+}
+
+} // namespace
+
+// Arg 0: gateway flow, 1: ITCH-shaped flow; bytes are raw JournalRecord bytes
+static void BM_JournalEncode(benchmark::State& state) {
+    const auto& records = workload(state.range(0));
+    std::vector<std::byte> stream(records.size() * lob::JournalEncoder::MAX_RECORD);
+    std::size_t length = 0;
+    for (auto _ : state) {
+        lob::JournalEncoder encoder;
+        length = 0;
+        for (const lob::JournalRecord& record : records) {
+            length += encoder.encode(record, stream.data() + length);
+        }
+        benchmark::DoNotOptimize(stream.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(records.size()));
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(records.size() * sizeof(lob::JournalRecord)));
+    state.counters["bytes_per_record"] = static_cast<double>(length) / static_cast<double>(records.size());
+    state.counters["ratio"] = static_cast<double>(records.size() * sizeof(lob::JournalRecord)) /
+                              static_cast<double>(length);
+}
+BENCHMARK(BM_JournalEncode)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+static void BM_JournalDecode(benchmark::State& state) {
+    const auto& records = workload(state.range(0));
+    const auto stream = encode(records);
+    std::vector<lob::JournalRecord> decoded;
+    decoded.reserve(records.size());
+    for (auto _ : state) {
+        lob::JournalDecoder decoder;
+        decoded.clear();
+        benchmark::DoNotOptimize(decoder.decode_all(stream, decoded));
+    }
+    if (decoded.size() != records.size()) {
+        state.SkipWithError("stream did not decode");
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(records.size()));
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(records.size() * sizeof(lob::JournalRecord)));
+}
+BENCHMARK(BM_JournalDecode)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+// Baseline: copying the raw records, which is all the fixed-width journal costs in CPU
+static void BM_JournalRawCopy(benchmark::State& state) {
+    const auto& records = workload(state.range(0));
+    std::vector<lob::JournalRecord> copy(records.size());
+    for (auto _ : state) {
+        std::memcpy(copy.data(), records.data(), records.size() * sizeof(lob::JournalRecord));
+        benchmark::DoNotOptimize(copy.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(records.size()));
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(records.size() * sizeof(lob::JournalRecord)));
+}
+BENCHMARK(BM_JournalRawCopy)->Arg(0)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,67 @@
+#include <benchmark/benchmark.h>
+#include "exchange_simulator.hpp"
+#include "matching_engine.hpp"
+#include <memory>
+#include <vector>
+
+namespace {
+
+// Twenty market makers, then a fifth takers and the rest noise traders; the latter's timers
+// stretch with the population so the timed flow is about two commands per simulated
+// microsecond at any size, with the makers' reactions on top
+std::vector<std::unique_ptr<lob::SimulatedAgent>> population(std::size_t agents) {
+    const auto scale = static_cast<std::int64_t>(agents);
+    std::vector<std::unique_ptr<lob::SimulatedAgent>> result;
+    for (std::size_t i = 0; i < agents; ++i) {
+        if (i < 20) {
+            result.push_back(std::make_unique<lob::MarketMakerAgent>(100, 1 + static_cast<lob::Price>(i % 4),
+                                                                    std::chrono::microseconds(500)));
+        } else if (i % 5 == 0) {
+            result.push_back(std::make_unique<lob::TakerAgent>(50, lob::Timestamp{scale * 2'000}));
+        } else {
+            result.push_back(std::make_unique<lob::NoiseTraderAgent>(200, 20, lob::Timestamp{scale * 500}));
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+// args: agents, simulated service time in ns. items are commands matched; sim_p50/p99
+// are simulated exchange latency (queueing plus service), wall_p50 the engine's real time
+static void BM_ExchangeSimulator(benchmark::State& state) {
+    const auto agents = static_cast<std::size_t>(state.range(0));
+    const lob::Timestamp service_time{state.range(1)};
+    std::uint64_t commands = 0;
+    std::uint64_t events = 0;
+    double sim_p50 = 0;
+    double sim_p99 = 0;
+    double wall_p50 = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto engine = std::make_unique<lob::MatchingEngine>();
+        auto simulator = lob::ExchangeSimulator::create(*engine, population(agents), {.service_time = service_time});
+        state.ResumeTiming();
+        simulator->run_until(std::chrono::milliseconds(20));
+        state.PauseTiming();
+        commands += simulator->commands();
+        events += simulator->events();
+        sim_p50 = static_cast<double>(simulator->exchange_latency().percentile(0.5).count());
+        sim_p99 = static_cast<double>(simulator->exchange_latency().percentile(0.99).count());
+        wall_p50 = static_cast<double>(simulator->processing().percentile(0.5).count());
+        simulator.reset();
+        engine.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(commands));
+    state.counters["events"] = benchmark::Counter(static_cast<double>(events), benchmark::Counter::kIsRate);
+    state.counters["sim_p50_ns"] = sim_p50;
+    state.counters["sim_p99_ns"] = sim_p99;
+    state.counters["wall_p50_ns"] = wall_p50;
+}
+BENCHMARK(BM_ExchangeSimulator)
+    ->Args({1'000, 100})
+    ->Args({1'000, 400})
+    ->Args({10'000, 100})
+    ->Args({10'000, 400})
+    ->Unit(benchmark::kMillisecond);
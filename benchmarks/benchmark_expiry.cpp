@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+#include "matching_engine.hpp"
+#include <chrono>
+
+namespace {
+
+lob::Timestamp steady_now() {
+    return std::chrono::duration_cast<lob::Timestamp>(
+        std::chrono::steady_clock::now().time_since_epoch());
+}
+
+} // namespace
+
+static void BM_GTTSubmitCancel(benchmark::State& state) {
+    lob::MatchingEngine engine;
+    const lob::Timestamp expiry = steady_now() + std::chrono::hours(1);
+    
+    // Background of resting GTT orders spread over the hour
+    const std::size_t num_resting = state.range(0);
+    for (lob::OrderId id = 1; id <= num_resting; ++id) {
+        engine.submit_order(id, lob::Side::Buy, lob::OrderType::Limit, 90 + (id % 10), 10,
+                            lob::TimeInForce::GTT,
+                            expiry - std::chrono::milliseconds(id % 3600000));
+    }
+    
+    lob::OrderId id = num_resting + 1;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            engine.submit_order(id, lob::Side::Buy, lob::OrderType::Limit, 95, 10,
+                                lob::TimeInForce::GTT, expiry)
+        );
+        benchmark::DoNotOptimize(engine.cancel_order(id));
+        ++id;
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_GTTSubmitCancel)->Arg(1000)->Arg(100000)->Unit(benchmark::kNanosecond);
+
+// End-of-day: every resting order is a Day order expiring at the same close
+static void BM_EndOfDayMassExpiry(benchmark::State& state) {
+    const std::size_t num_orders = state.range(0);
+    const std::size_t batch = state.range(1);
+    
+    for (auto _ : state) {
+        state.PauseTiming();
+        lob::MatchingEngine engine;
+        const lob::Timestamp close = steady_now() + std::chrono::hours(8);
+        engine.set_session_close(close);
+        for (lob::OrderId id = 1; id <= num_orders; ++id) {
+            engine.submit_order(id, (id % 2 == 0) ? lob::Side::Buy : lob::Side::Sell,
+                                lob::OrderType::Limit,
+                                (id % 2 == 0) ? 90 - static_cast<lob::Price>(id % 50)
+                                              : 110 + static_cast<lob::Price>(id % 50),
+                                10, lob::TimeInForce::Day);
+        }
+        state.ResumeTiming();
+        
+        while (engine.expire_orders(close, batch) != 0) {
+        }
+        benchmark::DoNotOptimize(engine.get_order_book().order_count());
+    }
+    state.SetItemsProcessed(state.iterations() * num_orders);
+}
+BENCHMARK(BM_EndOfDayMassExpiry)
+    ->Args({100000, 64})->Args({100000, 4096})->Args({1000000, 4096})
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,92 @@
+#include <benchmark/benchmark.h>
+#include "fix_protocol.hpp"
+#include "fix_session.hpp"
+#include "matching_engine.hpp"
+#include <string>
+
+using lob::fix::Tag;
+
+namespace {
+
+std::string make_message(lob::fix::MessageBuilder& builder) {
+    std::string out(builder.size(), '\0');
+    out.resize(builder.finish(out.data()));
+    return out;
+}
+
+// A typical NewOrderSingle (about 150 bytes on the wire)
+std::string new_order_single(std::uint64_t seq, lob::OrderId id) {
+    lob::fix::MessageBuilder builder;
+    builder.begin("D", "CLIENT01", "LOB", seq, "20240102-09:30:00.123");
+    builder.add(Tag::ClOrdID, id).add(Tag::Symbol, "XYZ").add(Tag::Side, '1')
+        .add(Tag::OrderQty, std::uint64_t{100}).add(Tag::OrdType, '2').add(Tag::Price, "101.25")
+        .add(Tag::TimeInForce, '3');
+    return make_message(builder);
+}
+
+} // namespace
+
+// Framing, checksum and field extraction of one NewOrderSingle
+static void BM_FixParseNewOrderSingle(benchmark::State& state) {
+    const std::string message = new_order_single(7, 123456);
+    lob::fix::Message parsed;
+    
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lob::fix::decode_message(message, parsed));
+        benchmark::DoNotOptimize(parsed);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(message.size()));
+}
+BENCHMARK(BM_FixParseNewOrderSingle);
+
+// Composing a fill ExecutionReport into a preallocated buffer
+static void BM_FixEncodeExecutionReport(benchmark::State& state) {
+    lob::fix::MessageBuilder builder;
+    char out[512];
+    std::uint64_t seq = 0;
+    
+    for (auto _ : state) {
+        builder.begin("8", "LOB", "CLIENT01", ++seq, "20240102-09:30:00.123");
+        builder.add(Tag::ClOrdID, seq).add(Tag::OrderID, seq).add(Tag::ExecID, seq)
+            .add(Tag::ExecType, 'F').add(Tag::OrdStatus, '1').add(Tag::Symbol, "XYZ")
+            .add(Tag::Side, '1').add(Tag::LeavesQty, std::uint64_t{60}).add(Tag::CumQty, std::uint64_t{40})
+            .add(Tag::AvgPx, '0').add(Tag::LastQty, std::uint64_t{40}).add_price(Tag::LastPx, 10125, 2);
+        benchmark::DoNotOptimize(builder.finish(out));
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_FixEncodeExecutionReport);
+
+// Whole session path per IOC order against an empty book: decode, execute, acknowledge
+static void BM_FixSessionNewOrder(benchmark::State& state) {
+    lob::MatchingEngine engine;
+    lob::FixSessions sessions(engine, 1, lob::FixSessionConfig{.comp_id = "LOB", .symbol = "XYZ", .price_decimals = 2});
+    const std::size_t slot = *sessions.open();
+
+    lob::fix::MessageBuilder builder;
+    builder.begin("A", "CLIENT01", "LOB", 1, "20240102-09:30:00.123");
+    builder.add(Tag::EncryptMethod, '0').add(Tag::HeartBtInt, std::uint64_t{30});
+    const std::string logon = make_message(builder);
+    sessions.process(slot, std::as_bytes(std::span(logon.data(), logon.size())));
+
+    // Pre-built batch so message construction stays out of the timed loop
+    constexpr std::size_t batch = 1024;
+    std::uint64_t seq = 1;
+    lob::OrderId id = 0;
+    std::string input;
+    
+    for (auto _ : state) {
+        state.PauseTiming();
+        input.clear();
+        for (std::size_t i = 0; i < batch; ++i) {
+            input += new_order_single(++seq, ++id);
+        }
+        sessions.consume_output(slot, sessions.pending_output(slot).size());
+        state.ResumeTiming();
+        
+        const auto result = sessions.process(slot, std::as_bytes(std::span(input.data(), input.size())));
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(batch));
+}
+BENCHMARK(BM_FixSessionNewOrder)->Unit(benchmark::kMicrosecond);
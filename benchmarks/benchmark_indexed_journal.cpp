@@ -0,0 +1,138 @@
+#include <benchmark/benchmark.h>
+#include "indexed_journal.hpp"
+#include "matching_engine.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <string>
+#include <tuple>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr std::uint64_t DAY_RECORDS = 4'000'000;
+
+// A session's flow around a slowly moving mid: adds, cancels of live orders (keeping
+// the book to a few tens of thousands of orders) and some takers
+class DayFlow {
+public:
+    lob::JournalRecord next(std::uint64_t sequence) {
+        if (rng_() % 256 == 0) {
+            mid_ += static_cast<lob::Price>(rng_() % 3) - 1;
+        }
+        const std::uint64_t pick = rng_() % 10;
+        auto participant = static_cast<lob::ParticipantId>(1 + rng_() % 16);
+        lob::OrderCommand command{.client_seq = sequence, .id = sequence};
+        if (!live_.empty() && (pick < 4 || live_.size() > 20'000)) {
+            const std::size_t victim = rng_() % live_.size();
+            command.type = lob::CommandType::Cancel;
+            std::tie(command.id, participant) = live_[victim];
+            live_[victim] = live_.back();
+            live_.pop_back();
+        } else {
+            const bool buy = rng_() % 2;
+            command.side = buy ? lob::Side::Buy : lob::Side::Sell;
+            command.price = mid_ + (buy ? -1 : 1) * static_cast<lob::Price>(rng_() % 20);
+            command.quantity = 1 + rng_() % 100;
+            if (pick == 9) {
+                command.order_type = lob::OrderType::IOC;
+                command.price = mid_ + (buy ? 5 : -5);
+            } else {
+                live_.emplace_back(command.id, participant);
+            }
+        }
+        return lob::JournalRecord{
+            .sequence = sequence,
+            .timestamp = static_cast<std::int64_t>(sequence) * 5'850'000,  // 6.5 hours
+            .participant = participant,
+            .command = command
+        };
+    }
+
+private:
+    std::mt19937_64 rng_{5};
+    lob::Price mid_{10'000};
+    std::vector<std::pair<lob::OrderId, lob::ParticipantId>> live_;  // With their owners
+};
+
+// Journal of a day per segment length, written once and shared
+const std::string& day_journal(std::size_t snapshot_interval) {
+    static std::map<std::size_t, std::string> directories;
+    auto [it, inserted] = directories.try_emplace(snapshot_interval);
+    if (inserted) {
+        it->second = "/tmp/lob_benchmark_indexed_journal_" + std::to_string(::getpid()) + "_" +
+                     std::to_string(snapshot_interval);
+        lob::MatchingEngine engine;
+        auto writer = lob::IndexedJournalWriter::create(engine, it->second,
+                                                        {.snapshot_interval = snapshot_interval});
+        DayFlow flow;
+        for (std::uint64_t sequence = 1; writer && sequence <= DAY_RECORDS; ++sequence) {
+            const lob::JournalRecord record = flow.next(sequence);
+            writer->append(record);
+            (void)lob::execute_command(engine, record.command, record.participant);
+        }
+        static const bool cleanup = std::atexit([] {
+            for (const auto& [interval, directory] : directories) {
+                std::filesystem::remove_all(directory);
+            }
+        }) == 0;
+        (void)cleanup;
+    }
+    return it->second;
+}
+
+} // namespace
+
+// Rebuild the book at random points of the day; arg is the segment length in records
+static void BM_IndexedJournalSeek(benchmark::State& state) {
+    auto reader = lob::IndexedJournalReader::open(day_journal(static_cast<std::size_t>(state.range(0))));
+    if (!reader) {
+        state.SkipWithError("journal unavailable");
+        return;
+    }
+    std::mt19937_64 rng(9);
+    std::uint64_t replayed = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto engine = std::make_unique<lob::MatchingEngine>();
+        const lob::Timestamp time{static_cast<std::int64_t>(rng() % DAY_RECORDS) * 5'850'000};
+        state.ResumeTiming();
+        const auto position = reader->seek(time, *engine);
+        if (!position) {
+            state.SkipWithError("seek failed");
+            break;
+        }
+        replayed += position->replayed;
+        state.PauseTiming();
+        engine.reset();
+        state.ResumeTiming();
+    }
+    state.counters["replayed"] = benchmark::Counter(static_cast<double>(replayed), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_IndexedJournalSeek)->Arg(1 << 18)->Arg(1 << 20)->Unit(benchmark::kMillisecond)->Iterations(20);
+
+// Journal cost per command on the matching thread, snapshots included
+static void BM_IndexedJournalAppend(benchmark::State& state) {
+    const std::string directory = "/tmp/lob_benchmark_indexed_journal_append_" + std::to_string(::getpid());
+    lob::MatchingEngine engine;
+    auto writer = lob::IndexedJournalWriter::create(engine, directory,
+                                                    {.snapshot_interval = static_cast<std::size_t>(state.range(0))});
+    if (!writer) {
+        state.SkipWithError("journal unavailable");
+        return;
+    }
+    DayFlow flow;
+    std::uint64_t sequence = 0;
+    for (auto _ : state) {
+        const lob::JournalRecord record = flow.next(++sequence);
+        writer->append(record);
+        (void)lob::execute_command(engine, record.command, record.participant);
+    }
+    state.SetItemsProcessed(state.iterations());
+    writer.reset();
+    std::filesystem::remove_all(directory);
+}
+BENCHMARK(BM_IndexedJournalAppend)->Arg(1 << 18)->Arg(1 << 20);
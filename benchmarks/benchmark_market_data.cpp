@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+#include "market_data.hpp"
+#include "matching_engine.hpp"
+#include <random>
+
+// Mixed add/cancel flow published as MTU-sized incremental packets (arg: 1 = publisher
+// attached); the gateway-style flush() runs every 64 messages
+static void BM_MarketDataPublishOverhead(benchmark::State& state) {
+    lob::MatchingEngine engine;
+    std::unique_ptr<lob::MarketDataPublisher> publisher;
+    if (state.range(0)) {
+        publisher = lob::MarketDataPublisher::create(engine, lob::MarketDataOptions{
+            .incremental_group = "239.255.78.1",
+            .incremental_port = 39201,
+            .snapshot_group = "239.255.78.2",
+            .snapshot_port = 39202
+        });
+        if (!publisher) {
+            state.SkipWithError("multicast socket unavailable");
+            return;
+        }
+    }
+
+    for (lob::OrderId id = 1; id <= 500; ++id) {
+        (void)engine.submit_order(id, (id % 2 == 0) ? lob::Side::Buy : lob::Side::Sell,
+                                  lob::OrderType::Limit, (id % 2 == 0) ? 95 - (id % 10) : 105 + (id % 10), 10);
+    }
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<lob::Price> price_dist(90, 110);
+    lob::OrderId id = 1000;
+    for (auto _ : state) {
+        const lob::Side side = (id % 2 == 0) ? lob::Side::Buy : lob::Side::Sell;
+        benchmark::DoNotOptimize(
+            engine.submit_order(id, side, lob::OrderType::Limit, price_dist(gen), 5));
+        if (id % 3 == 0) {
+            benchmark::DoNotOptimize(engine.cancel_order(id));
+        }
+        if (publisher && id % 64 == 0) {
+            publisher->flush();
+        }
+        ++id;
+    }
+    if (publisher) {
+        publisher->flush();
+        state.counters["packets"] = static_cast<double>(publisher->packets_sent());
+        state.counters["msgs/packet"] =
+            static_cast<double>(state.iterations()) / static_cast<double>(publisher->packets_sent() + 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MarketDataPublishOverhead)->Arg(0)->Arg(1)->Unit(benchmark::kNanosecond);
+
+// Full-depth snapshot of a 1000-level book, fragmented into MTU-sized packets
+static void BM_MarketDataSnapshot(benchmark::State& state) {
+    lob::MatchingEngine engine;
+    auto publisher = lob::MarketDataPublisher::create(engine, lob::MarketDataOptions{
+        .incremental_group = "239.255.78.1",
+        .incremental_port = 39201,
+        .snapshot_group = "239.255.78.2",
+        .snapshot_port = 39202
+    });
+    if (!publisher) {
+        state.SkipWithError("multicast socket unavailable");
+        return;
+    }
+    for (lob::OrderId id = 1; id <= 1000; ++id) {
+        const bool buy = id % 2 == 0;
+        (void)engine.submit_order(id, buy ? lob::Side::Buy : lob::Side::Sell, lob::OrderType::Limit,
+                                  buy ? 10'000 - static_cast<lob::Price>(id) : 20'000 + static_cast<lob::Price>(id), 10);
+    }
+    publisher->flush();
+
+    for (auto _ : state) {
+        publisher->publish_snapshot();
+    }
+    state.SetItemsProcessed(state.iterations() * 1000);
+}
+BENCHMARK(BM_MarketDataSnapshot)->Unit(benchmark::kMicrosecond);
@@ -91,3 +91,126 @@ static void BM_PriceTimePriority(benchmark::State& state) {
 }
 BENCHMARK(BM_PriceTimePriority)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
 
+
+// Sweep a level where every other resting order belongs to the aggressor's participant
+static void BM_SelfTradePreventionSweep(benchmark::State& state) {
+    const auto mode = static_cast<lob::SelfTradePrevention>(state.range(0));
+    const std::size_t orders_per_level = state.range(1);
+    
+    lob::OrderId id = 1;
+    for (auto _ : state) {
+        state.PauseTiming();
+        lob::MatchingEngine engine;
+        engine.set_self_trade_prevention(mode);
+        for (std::size_t i = 0; i < orders_per_level; ++i) {
+            engine.submit_order(id++, lob::Side::Sell, lob::OrderType::Limit, 100, 1,
+                                lob::TimeInForce::GTC, {}, (i % 2 == 0) ? 7 : 9);
+        }
+        state.ResumeTiming();
+        
+        benchmark::DoNotOptimize(
+            engine.submit_order(id++, lob::Side::Buy, lob::OrderType::Limit, 100,
+                                orders_per_level, lob::TimeInForce::GTC, {}, 7)
+        );
+    }
+    state.SetItemsProcessed(state.iterations() * orders_per_level);
+}
+BENCHMARK(BM_SelfTradePreventionSweep)
+    ->ArgsProduct({{static_cast<long>(lob::SelfTradePrevention::None),
+                    static_cast<long>(lob::SelfTradePrevention::CancelOldest),
+                    static_cast<long>(lob::SelfTradePrevention::Decrement)},
+                   {100, 1000}})
+    ->Unit(benchmark::kMicrosecond);
+
+namespace {
+
+// Crossed call-period book: bids 90..110, asks 95..115, one order per id
+void fill_auction(lob::MatchingEngine& engine, std::size_t num_orders) {
+    engine.start_auction();
+    for (lob::OrderId id = 1; id <= num_orders; ++id) {
+        const bool buy = id % 2 == 0;
+        const lob::Price price = buy ? 90 + static_cast<lob::Price>(id % 21)
+                                     : 95 + static_cast<lob::Price>(id % 21);
+        (void)engine.submit_order(id, buy ? lob::Side::Buy : lob::Side::Sell,
+                                  lob::OrderType::Limit, price, 1 + id % 10);
+    }
+}
+
+} // namespace
+
+static void BM_AuctionIndicativePrice(benchmark::State& state) {
+    lob::MatchingEngine engine;
+    fill_auction(engine, state.range(0));
+    
+    lob::OrderId id = state.range(0) + 1;
+    for (auto _ : state) {
+        // One new order per iteration forces a recompute of the curves
+        (void)engine.submit_order(id++, lob::Side::Buy, lob::OrderType::Limit, 100, 1);
+        benchmark::DoNotOptimize(engine.indicative_uncross());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AuctionIndicativePrice)->Arg(10000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+
+// Same flow over a crossing range of range(0) levels per side
+static void BM_AuctionIndicativeWideBook(benchmark::State& state) {
+    lob::MatchingEngine engine;
+    engine.start_auction();
+    const auto levels = static_cast<lob::Price>(state.range(0));
+    lob::OrderId id = 1;
+    for (lob::Price level = 0; level < levels; ++level) {
+        (void)engine.submit_order(id++, lob::Side::Buy, lob::OrderType::Limit, 1'000 + level, 1 + level % 7);
+        (void)engine.submit_order(id++, lob::Side::Sell, lob::OrderType::Limit, 1'000 + level, 1 + level % 5);
+    }
+    
+    for (auto _ : state) {
+        const lob::Price price = 1'000 + static_cast<lob::Price>(id * 7919) % levels;
+        (void)engine.submit_order(id++, lob::Side::Buy, lob::OrderType::Limit, price, 1);
+        benchmark::DoNotOptimize(engine.indicative_uncross());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AuctionIndicativeWideBook)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+static void BM_AuctionUncross(benchmark::State& state) {
+    const std::size_t num_orders = state.range(0);
+    for (auto _ : state) {
+        state.PauseTiming();
+        lob::MatchingEngine engine;
+        fill_auction(engine, num_orders);
+        state.ResumeTiming();
+        
+        benchmark::DoNotOptimize(engine.uncross());
+    }
+    state.SetItemsProcessed(state.iterations() * num_orders);
+}
+BENCHMARK(BM_AuctionUncross)->Arg(10000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+// Aggressor takes half of a single deep level under each allocation policy
+template<typename Engine>
+static void BM_LevelAllocation(benchmark::State& state) {
+    const std::size_t orders_per_level = state.range(0);
+    
+    lob::OrderId id = 1;
+    for (auto _ : state) {
+        state.PauseTiming();
+        Engine engine;
+        for (std::size_t i = 0; i < orders_per_level; ++i) {
+            (void)engine.submit_order(id++, lob::Side::Sell, lob::OrderType::Limit, 100,
+                                      10 + (i % 7) * 10);
+        }
+        const lob::Quantity half = engine.get_order_book().depth_at_price(lob::Side::Sell, 100) / 2;
+        state.ResumeTiming();
+        
+        benchmark::DoNotOptimize(
+            engine.submit_order(id++, lob::Side::Buy, lob::OrderType::Limit, 100, half)
+        );
+    }
+    state.SetItemsProcessed(state.iterations() * orders_per_level);
+}
+BENCHMARK_TEMPLATE(BM_LevelAllocation, lob::MatchingEngine)
+    ->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_LevelAllocation, lob::ProRataMatchingEngine)
+    ->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_LevelAllocation, lob::TopOrderProRataMatchingEngine)
+    ->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
@@ -1,5 +1,6 @@
 #include <benchmark/benchmark.h>
 #include "order_book.hpp"
+#include <algorithm>
 #include <random>
 #include <vector>
 
@@ -147,3 +148,127 @@ static void BM_DepthAtPrice(benchmark::State& state) {
 }
 BENCHMARK(BM_DepthAtPrice)->Unit(benchmark::kNanosecond);
 
+
+// Cancel-on-disconnect: one participant holding N of the book's 2N orders
+static void BM_MassCancelParticipant(benchmark::State& state) {
+    const std::size_t num_orders = state.range(0);
+    
+    for (auto _ : state) {
+        state.PauseTiming();
+        lob::OrderBook book;
+        for (lob::OrderId id = 1; id <= 2 * num_orders; ++id) {
+            (void)book.add_order(id, (id % 4 < 2) ? lob::Side::Buy : lob::Side::Sell,
+                                 lob::OrderType::Limit,
+                                 (id % 4 < 2) ? 100 - static_cast<lob::Price>(id % 50)
+                                              : 101 + static_cast<lob::Price>(id % 50),
+                                 10, lob::TimeInForce::GTC, {},
+                                 (id % 2 == 0) ? 7 : 9);
+        }
+        state.ResumeTiming();
+        
+        benchmark::DoNotOptimize(book.cancel_all(7));
+    }
+    state.SetItemsProcessed(state.iterations() * num_orders);
+}
+BENCHMARK(BM_MassCancelParticipant)->Arg(1000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+// Quantity ahead of an order near the back of a single deep level
+static void BM_QueuePosition(benchmark::State& state) {
+    lob::OrderBook book;
+    const lob::OrderId depth = state.range(0);
+    for (lob::OrderId id = 1; id <= depth; ++id) {
+        (void)book.add_order(id, lob::Side::Buy, lob::OrderType::Limit, 100, 10);
+    }
+    
+    lob::OrderId id = depth;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book.queue_position(id));
+        id = id == 1 ? depth : id - 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_QueuePosition)->Arg(100)->Arg(10000)->Arg(100000)->Unit(benchmark::kNanosecond);
+
+// Add/cancel churn on one deep level: the per-level tree must stay cheap under cancels
+static void BM_QueueChurn(benchmark::State& state) {
+    lob::OrderBook book;
+    const lob::OrderId depth = state.range(0);
+    for (lob::OrderId id = 1; id <= depth; ++id) {
+        (void)book.add_order(id, lob::Side::Sell, lob::OrderType::Limit, 100, 10);
+    }
+    
+    lob::OrderId oldest = 1;
+    lob::OrderId next = depth + 1;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book.cancel_order(oldest++));
+        benchmark::DoNotOptimize(
+            book.add_order(next++, lob::Side::Sell, lob::OrderType::Limit, 100, 10));
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_QueueChurn)->Arg(100)->Arg(10000)->Unit(benchmark::kNanosecond);
+
+// Cost of buying through range(0) levels, walked in place
+static void BM_SweepCost(benchmark::State& state) {
+    lob::OrderBook book;
+    const lob::Price levels = state.range(0);
+    lob::OrderId id = 1;
+    for (lob::Price price = 100; price < 100 + 2 * levels; ++price) {
+        (void)book.add_order(id++, lob::Side::Sell, lob::OrderType::Limit, price, 10);
+    }
+    
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book.sweep_cost(lob::Side::Buy, 10 * levels));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SweepCost)->Arg(5)->Arg(20)->Arg(100)->Unit(benchmark::kNanosecond);
+
+// Same answer via get_levels, which allocates and copies
+static void BM_SweepCostViaGetLevels(benchmark::State& state) {
+    lob::OrderBook book;
+    const lob::Price levels = state.range(0);
+    lob::OrderId id = 1;
+    for (lob::Price price = 100; price < 100 + 2 * levels; ++price) {
+        (void)book.add_order(id++, lob::Side::Sell, lob::OrderType::Limit, price, 10);
+    }
+    
+    for (auto _ : state) {
+        lob::Quantity left = 10 * levels;
+        lob::Notional notional = 0;
+        for (const auto& [price, quantity] : book.get_levels(lob::Side::Sell, levels)) {
+            const lob::Quantity taken = std::min(left, quantity);
+            notional += price * static_cast<lob::Notional>(taken);
+            left -= taken;
+        }
+        benchmark::DoNotOptimize(notional);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SweepCostViaGetLevels)->Arg(5)->Arg(20)->Arg(100)->Unit(benchmark::kNanosecond);
+
+// Add and cancel at the touch while range(0) levels rest far behind it, spread over
+// prices well outside the near-touch window
+static void BM_TouchChurnWithFarLevels(benchmark::State& state) {
+    lob::OrderBook book;
+    lob::OrderId id = 1;
+    for (lob::Price level = 0; level < state.range(0); ++level) {
+        (void)book.add_order(id++, lob::Side::Buy, lob::OrderType::Limit, 900'000 - 37 * level, 10);
+        (void)book.add_order(id++, lob::Side::Sell, lob::OrderType::Limit, 1'100'000 + 37 * level, 10);
+    }
+    (void)book.add_order(id++, lob::Side::Buy, lob::OrderType::Limit, 999'990, 10);
+    (void)book.add_order(id++, lob::Side::Sell, lob::OrderType::Limit, 1'000'010, 10);
+
+    lob::Price offset = 0;
+    for (auto _ : state) {
+        const lob::OrderId order = id++;
+        (void)book.add_order(order, lob::Side::Buy, lob::OrderType::Limit, 999'991 + offset, 5);
+        benchmark::DoNotOptimize(book.best_bid());
+        benchmark::DoNotOptimize(book.depth_at_price(lob::Side::Sell, 1'000'010));
+        (void)book.cancel_order(order);
+        offset = (offset + 1) % 16;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TouchChurnWithFarLevels)->Arg(0)->Arg(1000)->Arg(100000)->Unit(benchmark::kNanosecond);
@@ -0,0 +1,121 @@
+#include <benchmark/benchmark.h>
+#include "matching_engine.hpp"
+#include "replication.hpp"
+#include "tcp_gateway.hpp"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+// Gateway thread plus, when replicated, a backup engine applying on a thread of its own
+class ReplicatedGateway {
+public:
+    explicit ReplicatedGateway(bool replicated)
+        : gateway_(lob::TcpGateway::create(engine_, 0, 4))
+    {
+        const std::string path = "/tmp/lob_benchmark_replication_" + std::to_string(::getpid()) + ".sock";
+        if (replicated) {
+            primary_ = lob::ReplicationPrimary::create(path);
+            backup_ = primary_ ? lob::ReplicationBackup::connect(backup_engine_, path) : nullptr;
+            ok_ = backup_ && primary_->accept_backup(std::chrono::seconds(1)) &&
+                  gateway_->set_replication(primary_.get());
+            if (ok_) {
+                backup_thread_ = std::thread([this] {
+                    while (!backup_->primary_lost()) {
+                        backup_->poll(std::chrono::milliseconds(1));
+                    }
+                });
+            }
+        }
+        thread_ = std::thread([this] {
+            while (!stop_.load(std::memory_order_relaxed)) {
+                gateway_->poll(std::chrono::milliseconds(1));
+            }
+        });
+    }
+    ~ReplicatedGateway() {
+        stop_.store(true, std::memory_order_relaxed);
+        thread_.join();
+        gateway_->set_replication(nullptr);
+        primary_.reset();  // The backup sees the stream end
+        if (backup_thread_.joinable()) {
+            backup_thread_.join();
+        }
+    }
+    [[nodiscard]] bool ok() const noexcept {
+        return ok_;
+    }
+    [[nodiscard]] std::uint16_t port() const noexcept {
+        return gateway_->port();
+    }
+
+private:
+    lob::MatchingEngine engine_;
+    lob::MatchingEngine backup_engine_;
+    std::unique_ptr<lob::TcpGateway> gateway_;
+    std::unique_ptr<lob::ReplicationPrimary> primary_;
+    std::unique_ptr<lob::ReplicationBackup> backup_;
+    bool ok_{true};
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+    std::thread backup_thread_;
+};
+
+} // namespace
+
+// One IOC per round trip without (arg 0) or with (arg 1) a backup acking every command
+static void BM_ReplicationRoundTrip(benchmark::State& state) {
+    ReplicatedGateway server(state.range(0) != 0);
+    auto client = lob::TcpOrderClient::connect("127.0.0.1", server.port());
+    if (!server.ok() || !client) {
+        state.SkipWithError("replication unavailable");
+        return;
+    }
+    lob::OrderCommand command{.price = 100, .quantity = 1, .order_type = lob::OrderType::IOC};
+    lob::ExecutionReport report;
+
+    for (auto _ : state) {
+        ++command.id;
+        client->send(command);
+        if (!client->flush() || !client->receive(report)) {
+            state.SkipWithError("gateway did not answer");
+            break;
+        }
+        benchmark::DoNotOptimize(report);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReplicationRoundTrip)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+// Pipelined windows of N commands: one ack covers many commands, so throughput is
+// not bound by the backup's round trip
+static void BM_ReplicationPipelined(benchmark::State& state) {
+    ReplicatedGateway server(state.range(1) != 0);
+    auto client = lob::TcpOrderClient::connect("127.0.0.1", server.port());
+    if (!server.ok() || !client) {
+        state.SkipWithError("replication unavailable");
+        return;
+    }
+    const auto window = static_cast<std::size_t>(state.range(0));
+    lob::OrderCommand command{.price = 100, .quantity = 1, .order_type = lob::OrderType::IOC};
+    lob::ExecutionReport report;
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < window; ++i) {
+            ++command.id;
+            client->send(command);
+        }
+        bool ok = client->flush();
+        for (std::size_t i = 0; ok && i < window; ++i) {
+            ok = client->receive(report);
+        }
+        if (!ok) {
+            state.SkipWithError("gateway did not answer");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(window));
+}
+BENCHMARK(BM_ReplicationPipelined)->Args({256, 0})->Args({256, 1})->Unit(benchmark::kMicrosecond)->UseRealTime();
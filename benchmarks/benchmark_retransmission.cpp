@@ -0,0 +1,118 @@
+#include <benchmark/benchmark.h>
+#include "market_data.hpp"
+#include "matching_engine.hpp"
+#include "retransmission.hpp"
+#include <atomic>
+#include <filesystem>
+#include <thread>
+
+namespace {
+
+// One engine message plus a flush, so every call publishes an incremental packet
+void publish_one(lob::MatchingEngine& engine, lob::MarketDataPublisher& publisher, lob::OrderId& id) {
+    const lob::Side side = id % 2 ? lob::Side::Buy : lob::Side::Sell;
+    (void)engine.submit_order(id, side, lob::OrderType::Limit,
+                              side == lob::Side::Buy ? 90 + static_cast<lob::Price>(id % 20)
+                                                     : 111 + static_cast<lob::Price>(id % 20), 5);
+    if (id % 2 == 0) {
+        (void)engine.cancel_order(id - 1);
+    }
+    ++id;
+    publisher.flush();
+}
+
+} // namespace
+
+// Packets per second served to a client fetching 512-packet ranges that reach into
+// the spill file, with (arg 1) or without a thread publishing live into the history
+static void BM_RetransmitThroughput(benchmark::State& state) {
+    const auto path = (std::filesystem::temp_directory_path() / "lob_benchmark_history.bin").string();
+    lob::MatchingEngine engine;
+    auto publisher = lob::MarketDataPublisher::create(engine, lob::MarketDataOptions{
+        .incremental_group = "239.255.78.3",
+        .incremental_port = 39203,
+        .snapshot_group = "239.255.78.4",
+        .snapshot_port = 39204
+    });
+    auto history = lob::PacketHistory::create(lob::PacketHistoryOptions{
+        .memory_packets = 4096,
+        .spill_path = path,
+        .spill_packets = 1 << 16,
+        .max_packet = lob::mdp::DEFAULT_PACKET_SIZE
+    });
+    if (!publisher || !history) {
+        state.SkipWithError("publisher or history unavailable");
+        return;
+    }
+    publisher->set_history(history.get());
+    lob::OrderId id = 1;
+    for (int i = 0; i < 20'000; ++i) {
+        publish_one(engine, *publisher, id);
+    }
+
+    auto server = lob::RetransmissionServer::create(*history, 0);
+    auto client = server ? lob::RetransmissionClient::connect("127.0.0.1", server->port()) : std::nullopt;
+    if (!client) {
+        state.SkipWithError("retransmission sockets unavailable");
+        return;
+    }
+    std::atomic<bool> stop{false};
+    std::thread serving([&] {
+        while (!stop.load(std::memory_order_relaxed)) {
+            server->poll(std::chrono::milliseconds(1));
+        }
+    });
+    std::thread live;
+    if (state.range(0)) {
+        live = std::thread([&] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                publish_one(engine, *publisher, id);
+            }
+        });
+    }
+
+    constexpr std::uint32_t RANGE = 512;
+    std::size_t packets = 0;
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        const std::uint64_t first = history->newest() - 8192;  // Spilled packets included
+        packets += client->fetch(first, RANGE, [&bytes](std::span<const std::byte> packet) {
+            bytes += packet.size();
+        });
+    }
+    stop.store(true, std::memory_order_relaxed);
+    serving.join();
+    if (live.joinable()) {
+        live.join();
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(packets));
+    state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+
+    publisher.reset();
+    history.reset();
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_RetransmitThroughput)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+// Cost on the publishing thread of keeping every packet in the history
+static void BM_PacketHistoryAppend(benchmark::State& state) {
+    auto history = lob::PacketHistory::create(lob::PacketHistoryOptions{
+        .memory_packets = 4096,
+        .spill_path = (std::filesystem::temp_directory_path() / "lob_benchmark_append.bin").string(),
+        .spill_packets = 1 << 16,
+        .max_packet = lob::mdp::DEFAULT_PACKET_SIZE
+    });
+    if (!history) {
+        state.SkipWithError("history unavailable");
+        return;
+    }
+    std::vector<std::byte> packet(static_cast<std::size_t>(state.range(0)));
+    std::uint64_t sequence = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(history->append(++sequence, packet));
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0));
+    history.reset();
+    std::filesystem::remove(std::filesystem::temp_directory_path() / "lob_benchmark_append.bin");
+}
+BENCHMARK(BM_PacketHistoryAppend)->Arg(256)->Arg(1472)->Unit(benchmark::kNanosecond);
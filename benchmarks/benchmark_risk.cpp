@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+#include "risk_gate.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+lob::RiskGate make_gate(std::size_t symbols, std::size_t accounts) {
+    lob::RiskGate gate(symbols, accounts);
+    for (lob::SymbolId s = 0; s < symbols; ++s) {
+        gate.set_symbol_limits(s, lob::SymbolRiskLimits{
+            .max_order_quantity = 10000,
+            .max_order_notional = 10000000,
+            .collar_ticks = 50});
+        gate.set_reference_price(s, 1000);
+    }
+    for (lob::ParticipantId a = 1; a < accounts; ++a) {
+        gate.set_credit_limit(a, 1000000000);
+    }
+    return gate;
+}
+
+} // namespace
+
+// Full check (quantity, collar, notional, credit) on an accepted order
+static void BM_RiskCheck(benchmark::State& state) {
+    lob::RiskGate gate = make_gate(1, 2);
+    lob::Price price = 990;
+    
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            gate.check(0, 1, lob::Side::Buy, lob::OrderType::Limit, price, 100));
+        price = price == 1010 ? 990 : price + 1;
+    }
+    
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RiskCheck);
+
+// Checks spread across many symbols and accounts (cache misses on the tables)
+static void BM_RiskCheckScattered(benchmark::State& state) {
+    const std::size_t symbols = state.range(0);
+    const std::size_t accounts = state.range(0);
+    lob::RiskGate gate = make_gate(symbols, accounts);
+    
+    std::vector<std::pair<lob::SymbolId, lob::ParticipantId>> keys;
+    std::uint64_t x = 88172645463325252ull;
+    for (int i = 0; i < 4096; ++i) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        keys.emplace_back(static_cast<lob::SymbolId>(x % symbols),
+                          static_cast<lob::ParticipantId>(1 + (x >> 32) % (accounts - 1)));
+    }
+    
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const auto [symbol, account] = keys[i++ & 4095];
+        benchmark::DoNotOptimize(
+            gate.check(symbol, account, lob::Side::Sell, lob::OrderType::Limit, 1000, 100));
+    }
+    
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RiskCheckScattered)->Arg(64)->Arg(65536);
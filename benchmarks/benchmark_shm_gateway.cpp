@@ -0,0 +1,75 @@
+#include <benchmark/benchmark.h>
+#include "matching_engine.hpp"
+#include "shm_gateway.hpp"
+#include <atomic>
+#include <new>
+#include <string>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Round trip from a client process through a forked engine process and back
+// Each command is an IOC against an empty book, so the engine does one lookup
+// and answers with a single Ack.
+static void BM_ShmGatewayRoundTrip(benchmark::State& state) {
+    const auto mode = static_cast<lob::WaitMode>(state.range(0));
+    const std::string name = "lob_cpp_bench_gw_" + std::to_string(::getpid());
+    
+    lob::MatchingEngine engine;
+    auto server = lob::ShmGatewayServer::create(name, engine, 1);
+    if (!server) {
+        state.SkipWithError("cannot create shared memory gateway");
+        return;
+    }
+    void* flag_memory = ::mmap(nullptr, sizeof(std::atomic<bool>), PROT_READ | PROT_WRITE,
+                               MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    auto* stop = new (flag_memory) std::atomic<bool>(false);
+    
+    const pid_t engine_pid = ::fork();
+    if (engine_pid == 0) {
+        while (!stop->load(std::memory_order_acquire)) {
+            server->wait_and_poll(mode, std::chrono::milliseconds(10));
+        }
+        ::_exit(0);
+    }
+    
+    auto client = lob::ShmGatewayClient::connect(name);
+    lob::OrderCommand command{.price = 100, .quantity = 1, .order_type = lob::OrderType::IOC};
+    lob::ExecutionReport report;
+    for (auto _ : state) {
+        ++command.client_seq;
+        ++command.id;
+        while (!client->send(command)) {
+        }
+        if (!client->receive(report, mode)) {
+            state.SkipWithError("engine process did not answer");
+            break;
+        }
+        benchmark::DoNotOptimize(report);
+    }
+    state.SetItemsProcessed(state.iterations());
+    
+    client.reset();
+    stop->store(true, std::memory_order_release);
+    ::waitpid(engine_pid, nullptr, 0);
+    ::munmap(flag_memory, sizeof(std::atomic<bool>));
+}
+BENCHMARK(BM_ShmGatewayRoundTrip)
+    ->Arg(static_cast<int>(lob::WaitMode::BusyPoll))
+    ->Arg(static_cast<int>(lob::WaitMode::Futex))
+    ->Unit(benchmark::kNanosecond)
+    ->UseRealTime();
+
+// In-process ring hop, the floor under the cross-process numbers
+static void BM_SpscRingPushPop(benchmark::State& state) {
+    auto ring = std::make_unique<lob::SpscRing<lob::OrderCommand, lob::GATEWAY_RING_CAPACITY>>();
+    lob::OrderCommand command{};
+    
+    for (auto _ : state) {
+        ++command.client_seq;
+        benchmark::DoNotOptimize(ring->try_push(command));
+        benchmark::DoNotOptimize(ring->try_pop(command));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SpscRingPushPop)->Unit(benchmark::kNanosecond);
@@ -0,0 +1,59 @@
+#include <benchmark/benchmark.h>
+#include "market_signals.hpp"
+#include "matching_engine.hpp"
+#include "seqlock.hpp"
+#include <chrono>
+#include <random>
+
+// Mixed add/cross/cancel flow with and without the signals observer attached
+static void BM_SignalsObserverOverhead(benchmark::State& state) {
+    lob::MatchingEngine engine;
+    lob::MarketSignals signals(std::chrono::seconds(1));
+    if (state.range(0)) {
+        engine.add_observer(&signals);
+    }
+    
+    for (lob::OrderId id = 1; id <= 500; ++id) {
+        engine.submit_order(id, (id % 2 == 0) ? lob::Side::Buy : lob::Side::Sell,
+                            lob::OrderType::Limit, (id % 2 == 0) ? 95 - (id % 10) : 105 + (id % 10), 10);
+    }
+    
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<lob::Price> price_dist(90, 110);
+    lob::OrderId id = 1000;
+    for (auto _ : state) {
+        const lob::Side side = (id % 2 == 0) ? lob::Side::Buy : lob::Side::Sell;
+        benchmark::DoNotOptimize(
+            engine.submit_order(id, side, lob::OrderType::Limit, price_dist(gen), 5));
+        if (id % 3 == 0) {
+            benchmark::DoNotOptimize(engine.cancel_order(id));
+        }
+        ++id;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SignalsObserverOverhead)->Arg(0)->Arg(1)->Unit(benchmark::kNanosecond);
+
+// Uncontended reader side of the signals slot
+static void BM_SignalsSnapshotRead(benchmark::State& state) {
+    lob::MarketSignals signals(std::chrono::seconds(1));
+    
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(signals.snapshot());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SignalsSnapshotRead)->Unit(benchmark::kNanosecond);
+
+static void BM_SeqLockStore(benchmark::State& state) {
+    lob::SeqLock<lob::MarketSignalSnapshot> lock;
+    lob::MarketSignalSnapshot snapshot;
+    
+    for (auto _ : state) {
+        ++snapshot.sequence;
+        lock.store(snapshot);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SeqLockStore)->Unit(benchmark::kNanosecond);
@@ -0,0 +1,80 @@
+#include <benchmark/benchmark.h>
+#include "matching_engine.hpp"
+#include "tcp_gateway.hpp"
+#include <atomic>
+#include <thread>
+
+namespace {
+
+// Engine and gateway on their own thread for the lifetime of one benchmark
+class GatewayThread {
+public:
+    GatewayThread() : gateway_(lob::TcpGateway::create(engine_, 0, 4)) {
+        thread_ = std::thread([this] {
+            while (!stop_.load(std::memory_order_relaxed)) {
+                gateway_->poll(std::chrono::milliseconds(1));
+            }
+        });
+    }
+    ~GatewayThread() {
+        stop_.store(true, std::memory_order_relaxed);
+        thread_.join();
+    }
+    [[nodiscard]] std::uint16_t port() const noexcept {
+        return gateway_->port();
+    }
+
+private:
+    lob::MatchingEngine engine_;
+    std::unique_ptr<lob::TcpGateway> gateway_;
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+} // namespace
+
+// One IOC against an empty book per round trip: send, engine, ack, receive
+static void BM_TcpGatewayRoundTrip(benchmark::State& state) {
+    GatewayThread server;
+    auto client = lob::TcpOrderClient::connect("127.0.0.1", server.port());
+    lob::OrderCommand command{.price = 100, .quantity = 1, .order_type = lob::OrderType::IOC};
+    lob::ExecutionReport report;
+    
+    for (auto _ : state) {
+        ++command.id;
+        client->send(command);
+        if (!client->flush() || !client->receive(report)) {
+            state.SkipWithError("gateway did not answer");
+            break;
+        }
+        benchmark::DoNotOptimize(report);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TcpGatewayRoundTrip)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+// Pipelined windows of N commands per flush; measures message throughput
+static void BM_TcpGatewayPipelined(benchmark::State& state) {
+    GatewayThread server;
+    auto client = lob::TcpOrderClient::connect("127.0.0.1", server.port());
+    const auto window = static_cast<std::size_t>(state.range(0));
+    lob::OrderCommand command{.price = 100, .quantity = 1, .order_type = lob::OrderType::IOC};
+    lob::ExecutionReport report;
+    
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < window; ++i) {
+            ++command.id;
+            client->send(command);
+        }
+        bool ok = client->flush();
+        for (std::size_t i = 0; ok && i < window; ++i) {
+            ok = client->receive(report);
+        }
+        if (!ok) {
+            state.SkipWithError("gateway did not answer");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(window));
+}
+BENCHMARK(BM_TcpGatewayPipelined)->Arg(16)->Arg(256)->Unit(benchmark::kMicrosecond)->UseRealTime();
@@ -0,0 +1,60 @@
+#include <benchmark/benchmark.h>
+#include "matching_engine.hpp"
+#include "top_of_book.hpp"
+#include <atomic>
+#include <random>
+#include <thread>
+
+// Mixed add/cancel flow with and without the top-of-book publisher attached
+static void BM_TopOfBookPublishOverhead(benchmark::State& state) {
+    lob::MatchingEngine engine;
+    lob::TopOfBookPublisher publisher;
+    if (state.range(0)) {
+        engine.add_observer(&publisher);
+    }
+    
+    for (lob::OrderId id = 1; id <= 500; ++id) {
+        engine.submit_order(id, (id % 2 == 0) ? lob::Side::Buy : lob::Side::Sell,
+                            lob::OrderType::Limit, (id % 2 == 0) ? 95 - (id % 10) : 105 + (id % 10), 10);
+    }
+    
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<lob::Price> price_dist(90, 110);
+    lob::OrderId id = 1000;
+    for (auto _ : state) {
+        const lob::Side side = (id % 2 == 0) ? lob::Side::Buy : lob::Side::Sell;
+        benchmark::DoNotOptimize(
+            engine.submit_order(id, side, lob::OrderType::Limit, price_dist(gen), 5));
+        if (id % 3 == 0) {
+            benchmark::DoNotOptimize(engine.cancel_order(id));
+        }
+        ++id;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TopOfBookPublishOverhead)->Arg(0)->Arg(1)->Unit(benchmark::kNanosecond);
+
+// Reader latency while another thread republishes continuously
+static void BM_TopOfBookContendedRead(benchmark::State& state) {
+    lob::MatchingEngine engine;
+    lob::TopOfBookPublisher publisher;
+    engine.add_observer(&publisher);
+    
+    std::atomic<bool> stop{false};
+    std::thread writer([&] {
+        lob::OrderId id = 1;
+        while (!stop.load(std::memory_order_relaxed)) {
+            (void)engine.submit_order(id, lob::Side::Buy, lob::OrderType::Limit, 100 - (id % 8), 10);
+            (void)engine.cancel_order(id);
+            ++id;
+        }
+    });
+    
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(publisher.snapshot());
+    }
+    stop.store(true, std::memory_order_relaxed);
+    writer.join();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TopOfBookContendedRead)->Unit(benchmark::kNanosecond);
@@ -0,0 +1,112 @@
+#include <benchmark/benchmark.h>
+#include "matching_engine.hpp"
+#include "trade_tape.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::uint64_t DAY_TRADES = 4'000'000;
+
+std::string tape_path() {
+    return "/tmp/lob_benchmark_trade_tape_" + std::to_string(::getpid()) + ".tape";
+}
+
+// A trading day of fills: ~6.5 hours, prices walking around 10000 ticks
+lob::Trade day_trade(std::uint64_t i) {
+    const std::uint64_t mix = i * 0x9E3779B97F4A7C15ULL;
+    return lob::Trade{
+        .buy_order_id = 2 * i + (mix >> 60),
+        .sell_order_id = 2 * i + 1 + (mix >> 61),
+        .price = 10'000 + static_cast<lob::Price>((mix >> 40) % 64) - 32,
+        .quantity = 1 + (mix >> 20) % 1000,
+        .timestamp = lob::Timestamp{static_cast<std::int64_t>(i * 5'850'000 + (mix >> 44))},
+        .buy_participant = static_cast<lob::ParticipantId>(1 + (mix >> 32) % 200),
+        .sell_participant = static_cast<lob::ParticipantId>(1 + (mix >> 24) % 200),
+        .aggressor = (mix >> 63) ? lob::Side::Sell : lob::Side::Buy
+    };
+}
+
+// Written once and shared by the scan benchmarks
+const std::string& day_tape() {
+    static const std::string path = [] {
+        const std::string name = tape_path();
+        std::remove(name.c_str());
+        lob::MatchingEngine engine;
+        auto writer = lob::TradeTapeWriter::create(engine, name);
+        for (std::uint64_t i = 0; writer && i < DAY_TRADES; ++i) {
+            writer->on_trade(day_trade(i));
+        }
+        return name;
+    }();
+    static const bool cleanup = std::atexit([] { std::remove(path.c_str()); }) == 0;
+    (void)cleanup;
+    return path;
+}
+
+} // namespace
+
+// Matching-thread cost of the drop copy: one ring push per fill
+static void BM_TradeTapeOnTrade(benchmark::State& state) {
+    const std::string path = tape_path() + ".write";
+    lob::MatchingEngine engine;
+    auto writer = lob::TradeTapeWriter::create(engine, path);
+    if (!writer) {
+        state.SkipWithError("tape unavailable");
+        return;
+    }
+    std::uint64_t i = 0;
+    for (auto _ : state) {
+        writer->on_trade(day_trade(i++));
+    }
+    writer->flush();
+    state.SetItemsProcessed(state.iterations());
+    state.counters["bytes_per_trade"] = static_cast<double>(writer->bytes_written()) /
+                                        static_cast<double>(writer->trades_written());
+    state.counters["stalls"] = static_cast<double>(writer->stalls());
+    writer.reset();
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_TradeTapeOnTrade);
+
+// Decode every column of the day; bytes are the uncompressed Trade equivalent
+static void BM_TradeTapeReadBlocks(benchmark::State& state) {
+    auto reader = lob::TradeTapeReader::open(day_tape());
+    if (!reader || reader->trades() != DAY_TRADES) {
+        state.SkipWithError("tape unavailable");
+        return;
+    }
+    std::vector<lob::Trade> trades;
+    for (auto _ : state) {
+        for (std::size_t block = 0; block < reader->blocks(); ++block) {
+            trades.clear();
+            reader->read_block(block, trades);
+            benchmark::DoNotOptimize(trades.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(reader->trades()));
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(reader->trades() * sizeof(lob::Trade)));
+    state.counters["file_mb"] = static_cast<double>(reader->file_bytes()) / (1 << 20);
+}
+BENCHMARK(BM_TradeTapeReadBlocks)->Unit(benchmark::kMillisecond);
+
+// VWAP and volume per interval (arg, in seconds) over the whole day
+static void BM_TradeTapeBars(benchmark::State& state) {
+    auto reader = lob::TradeTapeReader::open(day_tape());
+    if (!reader || reader->trades() != DAY_TRADES) {
+        state.SkipWithError("tape unavailable");
+        return;
+    }
+    const lob::Timestamp begin{reader->block_header(0).first_timestamp};
+    const lob::Timestamp end{reader->block_header(reader->blocks() - 1).last_timestamp + 1};
+    const lob::Timestamp interval = std::chrono::seconds(state.range(0));
+    for (auto _ : state) {
+        auto bars = reader->bars(begin, end, interval);
+        benchmark::DoNotOptimize(bars.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(reader->trades()));
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(reader->trades() * sizeof(lob::Trade)));
+}
+BENCHMARK(BM_TradeTapeBars)->Arg(1)->Arg(60)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,93 @@
+#include <benchmark/benchmark.h>
+#include "matching_engine.hpp"
+#include "tcp_gateway.hpp"
+#include "uring_gateway.hpp"
+#include <atomic>
+#include <thread>
+
+namespace {
+
+// Engine and io_uring gateway on their own thread; stop() joins it so the
+// gateway's counters can be read without a race
+class UringGatewayThread {
+public:
+    explicit UringGatewayThread(bool sqpoll)
+        : gateway_(lob::UringGateway::create(engine_, 0, 4, lob::UringGateway::Options{.sqpoll = sqpoll, .journal_path = {}})) {
+        if (!gateway_) {
+            return;
+        }
+        thread_ = std::thread([this] {
+            while (!stop_.load(std::memory_order_relaxed)) {
+                commands_ += gateway_->poll(std::chrono::milliseconds(1));
+            }
+        });
+    }
+    ~UringGatewayThread() {
+        stop();
+    }
+    void stop() {
+        stop_.store(true, std::memory_order_relaxed);
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+    [[nodiscard]] lob::UringGateway* gateway() const noexcept {
+        return gateway_.get();
+    }
+    [[nodiscard]] std::uint64_t commands() const noexcept {
+        return commands_;
+    }
+
+private:
+    lob::MatchingEngine engine_;
+    std::unique_ptr<lob::UringGateway> gateway_;
+    std::atomic<bool> stop_{false};
+    std::uint64_t commands_{0};
+    std::thread thread_;
+};
+
+// Same workload as BM_TcpGatewayPipelined, so the two backends compare directly.
+// Arg 0: window of commands per flush; arg 1: SQPOLL off/on.
+void run_pipelined(benchmark::State& state, UringGatewayThread& server) {
+    auto client = lob::TcpOrderClient::connect("127.0.0.1", server.gateway()->port());
+    const auto window = static_cast<std::size_t>(state.range(0));
+    lob::OrderCommand command{.price = 100, .quantity = 1, .order_type = lob::OrderType::IOC};
+    lob::ExecutionReport report;
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < window; ++i) {
+            ++command.id;
+            client->send(command);
+        }
+        bool ok = client->flush();
+        for (std::size_t i = 0; ok && i < window; ++i) {
+            ok = client->receive(report);
+        }
+        if (!ok) {
+            state.SkipWithError("gateway did not answer");
+            break;
+        }
+    }
+    server.stop();
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(window));
+    // Gateway-side kernel entries per message; the epoll gateway makes at least
+    // a wait, a read and a write per batch
+    state.counters["syscalls/msg"] = server.commands()
+        ? static_cast<double>(server.gateway()->syscalls()) / static_cast<double>(server.commands())
+        : 0.0;
+}
+
+} // namespace
+
+static void BM_UringGatewayPipelined(benchmark::State& state) {
+    UringGatewayThread server(state.range(1) != 0);
+    if (!server.gateway()) {
+        state.SkipWithError("io_uring unavailable");
+        return;
+    }
+    run_pipelined(state, server);
+}
+BENCHMARK(BM_UringGatewayPipelined)
+    ->Args({1, 0})->Args({16, 0})->Args({256, 0})
+    ->Args({1, 1})->Args({16, 1})->Args({256, 1})
+    ->Unit(benchmark::kMicrosecond)->UseRealTime();
@@ -13,9 +13,28 @@ echo "Building lob_cpp..."
 g++ -std=c++23 -I include -O3 -Wall -Wextra -c src/slab_allocator.cpp -o "$BUILD_DIR/slab_allocator.o"
 g++ -std=c++23 -I include -O3 -Wall -Wextra -c src/order_book.cpp -o "$BUILD_DIR/order_book.o"
 g++ -std=c++23 -I include -O3 -Wall -Wextra -c src/matching_engine.cpp -o "$BUILD_DIR/matching_engine.o"
+g++ -std=c++23 -I include -O3 -Wall -Wextra -c src/risk_gate.cpp -o "$BUILD_DIR/risk_gate.o"
+g++ -std=c++23 -I include -O3 -Wall -Wextra -c src/market_signals.cpp -o "$BUILD_DIR/market_signals.o"
+g++ -std=c++23 -I include -O3 -Wall -Wextra -c src/top_of_book.cpp -o "$BUILD_DIR/top_of_book.o"
+g++ -std=c++23 -I include -O3 -Wall -Wextra -c src/shm_gateway.cpp -o "$BUILD_DIR/shm_gateway.o"
+g++ -std=c++23 -I include -O3 -Wall -Wextra -c src/order_entry.cpp -o "$BUILD_DIR/order_entry.o"
+g++ -std=c++23 -I include -O3 -Wall -Wextra -c src/tcp_gateway.cpp -o "$BUILD_DIR/tcp_gateway.o"
+g++ -std=c++23 -I include -O3 -Wall -Wextra -c src/io_uring.cpp -o "$BUILD_DIR/io_uring.o"
+g++ -std=c++23 -I include -O3 -Wall -Wextra -c src/uring_gateway.cpp -o "$BUILD_DIR/uring_gateway.o"
+g++ -std=c++23 -I include -O3 -Wall -Wextra -c src/fix_protocol.cpp -o "$BUILD_DIR/fix_protocol.o"
+g++ -std=c++23 -I include -O3 -Wall -Wextra -c src/fix_session.cpp -o "$BUILD_DIR/fix_session.o"
+g++ -std=c++23 -I include -O3 -Wall -Wextra -c src/market_data.cpp -o "$BUILD_DIR/market_data.o"
+g++ -std=c++23 -I include -O3 -Wall -Wextra -c src/retransmission.cpp -o "$BUILD_DIR/retransmission.o"
+g++ -std=c++23 -I include -O3 -Wall -Wextra -c src/replication.cpp -o "$BUILD_DIR/replication.o"
+g++ -std=c++23 -I include -O3 -Wall -Wextra -c src/trade_tape.cpp -o "$BUILD_DIR/trade_tape.o"
+g++ -std=c++23 -I include -O3 -Wall -Wextra -c src/indexed_journal.cpp -o "$BUILD_DIR/indexed_journal.o"
+g++ -std=c++23 -I include -O3 -Wall -Wextra -c src/backtester.cpp -o "$BUILD_DIR/backtester.o"
+g++ -std=c++23 -I include -O3 -Wall -Wextra -c src/backtest_runner.cpp -o "$BUILD_DIR/backtest_runner.o"
+g++ -std=c++23 -I include -O3 -Wall -Wextra -c src/exchange_simulator.cpp -o "$BUILD_DIR/exchange_simulator.o"
+g++ -std=c++23 -I include -O3 -Wall -Wextra -c src/auction_curves.cpp -o "$BUILD_DIR/auction_curves.o"
 
 # Create static library
-ar rcs "$BUILD_DIR/liblob_cpp.a" "$BUILD_DIR/slab_allocator.o" "$BUILD_DIR/order_book.o" "$BUILD_DIR/matching_engine.o"
+ar rcs "$BUILD_DIR/liblob_cpp.a" "$BUILD_DIR/slab_allocator.o" "$BUILD_DIR/order_book.o" "$BUILD_DIR/matching_engine.o" "$BUILD_DIR/risk_gate.o" "$BUILD_DIR/market_signals.o" "$BUILD_DIR/top_of_book.o" "$BUILD_DIR/shm_gateway.o" "$BUILD_DIR/order_entry.o" "$BUILD_DIR/tcp_gateway.o" "$BUILD_DIR/io_uring.o" "$BUILD_DIR/uring_gateway.o" "$BUILD_DIR/fix_protocol.o" "$BUILD_DIR/fix_session.o" "$BUILD_DIR/market_data.o" "$BUILD_DIR/retransmission.o" "$BUILD_DIR/replication.o" "$BUILD_DIR/trade_tape.o" "$BUILD_DIR/indexed_journal.o" "$BUILD_DIR/backtester.o" "$BUILD_DIR/backtest_runner.o" "$BUILD_DIR/exchange_simulator.o" "$BUILD_DIR/auction_curves.o"
 
 # Build example
 g++ -std=c++23 -I include -O3 -Wall -Wextra examples/basic_example.cpp -L"$BUILD_DIR" -llob_cpp -o "$BUILD_DIR/example_basic"
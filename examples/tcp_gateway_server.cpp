@@ -0,0 +1,33 @@
+#include "matching_engine.hpp"
+#include "tcp_gateway.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <print>
+
+// Runs a matching engine behind the TCP order-entry gateway until killed
+// Usage: example_tcp_gateway_server [port] [max_sessions]
+int main(int argc, char** argv) {
+    const auto port = static_cast<std::uint16_t>(argc > 1 ? std::atoi(argv[1]) : 9000);
+    const auto max_sessions = static_cast<std::size_t>(argc > 2 ? std::atoi(argv[2]) : 64);
+    
+    lob::MatchingEngine engine;
+    auto gateway = lob::TcpGateway::create(engine, port, max_sessions);
+    if (!gateway) {
+        std::println("Cannot listen on 127.0.0.1:{}", port);
+        return 1;
+    }
+    std::println("Listening on 127.0.0.1:{} ({} sessions max)", gateway->port(), max_sessions);
+    
+    std::size_t commands = 0;
+    auto next_report = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (true) {
+        commands += gateway->poll(std::chrono::milliseconds(100));
+        if (std::chrono::steady_clock::now() >= next_report) {
+            std::println("{} commands/s, {} sessions, {} resting orders",
+                         commands, gateway->open_sessions(),
+                         engine.get_order_book().order_count());
+            commands = 0;
+            next_report += std::chrono::seconds(1);
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#include "tcp_gateway.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <print>
+#include <random>
+#include <vector>
+
+// Drives a running gateway with pipelined windows of random orders and reports
+// throughput and per-window round-trip latency
+// Usage: example_tcp_load_generator [port] [orders] [window]
+int main(int argc, char** argv) {
+    using Clock = std::chrono::steady_clock;
+    const auto port = static_cast<std::uint16_t>(argc > 1 ? std::atoi(argv[1]) : 9000);
+    const auto orders = static_cast<std::size_t>(argc > 2 ? std::atoll(argv[2]) : 1'000'000);
+    const auto window = static_cast<std::size_t>(argc > 3 ? std::atoi(argv[3]) : 64);
+    
+    auto client = lob::TcpOrderClient::connect("127.0.0.1", port);
+    if (!client) {
+        std::println("Cannot connect to 127.0.0.1:{}", port);
+        return 1;
+    }
+    
+    std::mt19937_64 gen(42);
+    std::uniform_int_distribution<lob::Price> price_dist(95, 105);
+    std::uniform_int_distribution<lob::Quantity> quantity_dist(1, 100);
+    std::vector<double> latencies_us;
+    latencies_us.reserve(orders / window + 1);
+    
+    // Each window: mostly limit orders plus a cancel of the oldest id still in flight
+    lob::OrderId next_id = 1;
+    std::size_t acks = 0;
+    std::size_t fills = 0;
+    const auto start = Clock::now();
+    for (std::size_t sent = 0; sent < orders; sent += window) {
+        const auto window_start = Clock::now();
+        std::size_t expected = 0;
+        for (std::size_t i = 0; i < window; ++i, ++expected) {
+            const lob::OrderId id = next_id++;
+            if (i == window - 1 && id > window) {
+                client->send(lob::OrderCommand{.id = id - window, .type = lob::CommandType::Cancel});
+                continue;
+            }
+            client->send(lob::OrderCommand{
+                .id = id,
+                .price = price_dist(gen),
+                .quantity = quantity_dist(gen),
+                .type = lob::CommandType::New,
+                .side = (id % 2 == 0) ? lob::Side::Buy : lob::Side::Sell
+            });
+        }
+        if (!client->flush()) {
+            std::println("Connection lost");
+            return 1;
+        }
+        // Fills may interleave with acks; the window is done once every command is acked
+        lob::ExecutionReport report;
+        while (expected > 0) {
+            if (!client->receive(report)) {
+                std::println("Gateway stopped answering");
+                return 1;
+            }
+            if (report.type == lob::ReportType::Ack) {
+                --expected;
+                ++acks;
+            } else {
+                ++fills;
+            }
+        }
+        latencies_us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - window_start).count());
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    
+    std::ranges::sort(latencies_us);
+    const auto percentile = [&](double p) {
+        return latencies_us[static_cast<std::size_t>(p * static_cast<double>(latencies_us.size() - 1))];
+    };
+    std::println("{} commands in {:.3f}s: {:.0f} commands/s, {} fills", acks, seconds,
+                 static_cast<double>(acks) / seconds, fills);
+    std::println("Window of {} round trip: p50 {:.1f}us  p99 {:.1f}us  max {:.1f}us",
+                 window, percentile(0.50), percentile(0.99), latencies_us.back());
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "types.hpp"
+
+namespace lob {
+
+// Allocation policies select how an aggressor's quantity is shared among the
+// resting orders of a price level. The policy is a template parameter of
+// BasicMatchingEngine, so the choice is made at compile time per book.
+
+// Strict price-time priority: the oldest order at the level fills first
+struct FifoAllocation {
+    static constexpr bool pro_rata = false;
+    static constexpr bool top_order_first = false;
+};
+
+// Pro-rata by remaining quantity. Shares below min_lot are dropped and the
+// rounding residual is handed out in time priority.
+struct ProRataAllocation {
+    static constexpr bool pro_rata = true;
+    static constexpr bool top_order_first = false;
+
+    Quantity min_lot{1};
+};
+
+// The oldest order at the level fills first (FIFO), the rest is allocated pro-rata
+struct TopOrderProRataAllocation {
+    static constexpr bool pro_rata = true;
+    static constexpr bool top_order_first = true;
+
+    Quantity min_lot{1};
+};
+
+} // namespace lob
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "fenwick_tree.hpp"
+#include "types.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace lob {
+
+// Equilibrium of a call auction: the price maximizing executable volume
+struct AuctionUncross {
+    Price price{0};
+    Quantity volume{0};         // Executable quantity at price
+    std::int64_t imbalance{0};  // Demand minus supply at price (positive = buy surplus)
+};
+
+// Demand and supply curves of a call auction, kept up to date one level change at a time
+// Bid and ask quantities over a window of ticks around the crossing range sit in Fenwick
+// trees, so a change costs O(log n) and the equilibrium comes out of a handful of tree
+// descents instead of a walk over every crossing level. Demand at p is the bid quantity
+// at p or higher and supply the ask quantity at p or lower; volume min(demand, supply)
+// rises with p while supply is short and falls after, so the best price is the last level
+// before supply catches up or the first one after, or on a run of levels tied with it.
+// Levels outside the window are not tracked; track() re-centers it when the crossing
+// range leaves it.
+class AuctionCurves {
+public:
+    static constexpr std::size_t MIN_WINDOW = 1024;
+    static constexpr std::size_t MAX_WINDOW = std::size_t{1} << 16;  // Ticks; 48 bytes each
+
+    [[nodiscard]] bool active() const noexcept {
+        return size_ != 0;
+    }
+    // Whether [low, high] lies inside the tracked window
+    [[nodiscard]] bool covers(Price low, Price high) const noexcept {
+        return active() && low >= low_ && high - low_ < static_cast<Price>(size_);
+    }
+
+    // Window around the crossing range [best_ask, best_bid], seeded from both sides' levels
+    // (best first); false, and inactive, when the range is wider than MAX_WINDOW
+    template<typename BidLevels, typename AskLevels>
+    bool track(Price best_bid, Price best_ask, const BidLevels& bids, const AskLevels& asks) {
+        const auto span = static_cast<std::size_t>(best_bid - best_ask) + 1;
+        if (span > MAX_WINDOW) {
+            deactivate();
+            return false;
+        }
+        const std::size_t size = std::min(std::bit_ceil(std::max(MIN_WINDOW, 2 * span)), MAX_WINDOW);
+        const Price low = best_ask - static_cast<Price>((size - span) / 2);
+        const Price high = low + static_cast<Price>(size) - 1;
+
+        bid_quantity_.assign(size, 0);
+        ask_quantity_.assign(size, 0);
+        for (const auto& level : bids) {
+            if (level.price < low) {
+                break;
+            }
+            if (level.price <= high) {
+                bid_quantity_[static_cast<std::size_t>(level.price - low)] = level.total_quantity;
+            }
+        }
+        for (const auto& level : asks) {
+            if (level.price > high) {
+                break;
+            }
+            if (level.price >= low) {
+                ask_quantity_[static_cast<std::size_t>(level.price - low)] = level.total_quantity;
+            }
+        }
+        low_ = low;
+        size_ = size;
+        rebuild_trees();
+        return true;
+    }
+
+    void deactivate() noexcept {
+        size_ = 0;
+    }
+
+    // Level quantity after a change; ignored outside the window
+    void set(Side side, Price price, Quantity quantity) noexcept {
+        if (price < low_ || price - low_ >= static_cast<Price>(size_)) {
+            return;
+        }
+        const auto slot = static_cast<std::size_t>(price - low_);
+        Quantity& current = side == Side::Buy ? bid_quantity_[slot] : ask_quantity_[slot];
+        const Quantity delta = quantity - current;  // Wraps on a decrease, as FenwickTree expects
+        current = quantity;
+        levels_.add(slot, delta);
+        if (side == Side::Buy) {
+            bids_.add(slot, delta);
+            if (slot + 1 < size_) {
+                crossing_.add(slot + 1, delta);
+            }
+        } else {
+            asks_.add(slot, delta);
+            crossing_.add(slot, delta);
+        }
+    }
+
+    // Equilibrium over the levels in [best_ask, best_bid], which covers() must hold for:
+    // most volume, then least surplus, then closest to reference, then lowest price
+    [[nodiscard]] std::optional<AuctionUncross> solve(Price best_bid, Price best_ask,
+                                                      std::optional<Price> reference) const noexcept;
+
+private:
+    void rebuild_trees();
+
+    std::vector<Quantity> bid_quantity_;  // By slot (tick - low_)
+    std::vector<Quantity> ask_quantity_;
+    FenwickTree<Quantity> bids_;
+    FenwickTree<Quantity> asks_;
+    FenwickTree<Quantity> levels_;    // Bid plus ask quantity: non-zero at every level
+    FenwickTree<Quantity> crossing_;  // Ask quantity plus the bid quantity one tick lower
+    Price low_{0};                    // Tick of slot 0
+    std::size_t size_{0};             // Window width; 0 when inactive
+};
+
+} // namespace lob
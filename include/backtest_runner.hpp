@@ -0,0 +1,81 @@
+#pragma once
+
+#include "backtester.hpp"
+#include "command_journal.hpp"
+#include "types.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace lob {
+
+// One independent run: a journal file (one day of one symbol, as written by a gateway)
+// replayed against the strategy the factory makes for parameter
+struct BacktestTask {
+    std::string journal;
+    JournalFormat format{JournalFormat::Raw};
+    std::uint64_t parameter{0};  // Sweep point, interpreted by the strategy factory
+    BacktestOptions options{};
+};
+
+struct BacktestResult {
+    bool completed{false};  // False if the journal could not be mapped or nothing could be built
+    std::int64_t position{0};
+    Notional cash{0};
+    std::optional<Price> mark;  // Last trade price at the end, to value the position
+    std::uint64_t records{0};
+    std::uint64_t commands_sent{0};
+    std::uint64_t fills{0};
+    std::uint64_t dropped{0};
+    Timestamp elapsed{0};      // Wall time of the run
+    std::uint32_t worker{0};   // Thread that ran it
+};
+
+struct BacktestRunnerOptions {
+    std::size_t threads{0};             // 0: one per hardware thread
+    std::size_t decode_batch{1 << 12};  // Records decoded at a time from compressed journals
+};
+
+// Runs independent backtests on a work-stealing pool
+// Every distinct journal is mapped read-only once per run() and shared by the tasks
+// replaying it; raw journals are replayed straight from the mapping, compressed ones
+// through a per-worker decode buffer. Each task builds its own engine, strategy and
+// backtester on the worker and frees them when it ends, so memory held at any time is
+// one book per thread. Tasks are dealt round-robin into per-worker deques; a worker
+// takes from the back of its own and steals from the front of the others once it is
+// empty. Tasks are whole replays, so one lock per deque costs nothing measurable.
+class BacktestRunner {
+public:
+    using Options = BacktestRunnerOptions;
+    // Called on the worker running the task (so it must be thread-safe); index is the
+    // task's position, for strategies that write their own results somewhere.
+    // Returning nullptr skips the task.
+    using StrategyFactory = std::function<std::unique_ptr<BacktestStrategy>(const BacktestTask&, std::size_t index)>;
+
+    explicit BacktestRunner(const Options& options = {});
+
+    // Blocks until every task has run; results are in task order whatever the schedule
+    [[nodiscard]] std::vector<BacktestResult> run(std::span<const BacktestTask> tasks,
+                                                  const StrategyFactory& factory);
+
+    [[nodiscard]] std::size_t threads() const noexcept {
+        return threads_;
+    }
+    // Tasks taken from another worker's deque during the last run()
+    [[nodiscard]] std::uint64_t steals() const noexcept {
+        return steals_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::size_t threads_;
+    std::size_t decode_batch_;
+    std::atomic<std::uint64_t> steals_{0};
+};
+
+} // namespace lob
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "command_journal.hpp"
+#include "matching_engine.hpp"
+#include "order_command.hpp"
+#include "top_of_book.hpp"
+#include "types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace lob {
+
+class Backtester;
+
+// A historical record as the strategy receives it, feed_latency after the exchange
+// applied it, with the top of book as it stood right after (quantity 0: empty side)
+struct MarketEvent {
+    JournalRecord record;
+    BookLevel bid;
+    BookLevel ask;
+};
+
+// Strategy under test; hooks run inside Backtester::run() and may send through it
+class BacktestStrategy {
+public:
+    virtual ~BacktestStrategy() = default;
+
+    virtual void on_market_data(const MarketEvent& event, Backtester& backtester) {
+        (void)event;
+        (void)backtester;
+    }
+    // Acks and fills of the strategy's own orders, response_latency after the exchange
+    virtual void on_report(const ExecutionReport& report, Backtester& backtester) {
+        (void)report;
+        (void)backtester;
+    }
+};
+
+struct BacktestOptions {
+    Timestamp feed_latency{0};      // Exchange applies a record -> strategy sees it
+    Timestamp order_latency{0};     // Strategy sends -> exchange applies
+    Timestamp response_latency{0};  // Exchange acks or fills -> strategy sees it
+    ParticipantId participant{UINT32_MAX};  // Tag of strategy orders; not used by the history
+    OrderId first_order_id{1ULL << 63};     // Strategy ids count up from here
+    std::size_t queue_capacity{1 << 16};    // Per direction, a power of two
+};
+
+// Event-driven replay of a historical command stream with one simulated strategy
+// The history (L3 records in timestamp order, executions as IOCs at the resting price,
+// the same form as a command journal) is executed into the engine as it happened;
+// strategy orders go into the same book, so they hold a real place in the price level
+// FIFOs, trade with the historical flow and can take liquidity it later misses (the
+// history itself never reacts). Fills are read from the engine's trades after each
+// command instead of through an observer, which would turn on level updates; the
+// backtester turns on the engine's trade keeping.
+// Latencies are constant, so each direction is a FIFO and the loop is a merge of the
+// history with three preallocated queues: it allocates nothing beyond what the book
+// does for new orders and levels. At equal times the exchange goes first: history,
+// then arriving strategy orders, then deliveries. Queues that are full refuse sends
+// (submit() returns 0) and drop deliveries, which are counted; size queue_capacity
+// for the latency times the peak event rate.
+class Backtester {
+public:
+    using Options = BacktestOptions;
+
+    // nullptr if queue_capacity is not a power of two or participant is NO_PARTICIPANT
+    [[nodiscard]] static std::unique_ptr<Backtester> create(MatchingEngine& engine, BacktestStrategy& strategy,
+                                                            const Options& options = {});
+    ~Backtester() = default;
+
+    Backtester(const Backtester&) = delete;
+    Backtester& operator=(const Backtester&) = delete;
+
+    // Replay records after everything queued before the first of them; may be called
+    // again with the chunks that follow
+    void run(std::span<const JournalRecord> records);
+    // Process what is queued up to and including until (the end of the data)
+    void advance(Timestamp until);
+
+    // Strategy side: sent now, applied by the exchange order_latency later
+    // New GTC order with the next strategy id; 0 if the order queue is full
+    OrderId submit(Side side, OrderType type, Price price, Quantity quantity);
+    [[nodiscard]] bool cancel(OrderId id);
+    // quantity includes what has filled, as in CommandType::Modify
+    [[nodiscard]] bool modify(OrderId id, Price price, Quantity quantity);
+
+    // Simulation clock: the time of the event being processed
+    [[nodiscard]] Timestamp now() const noexcept {
+        return now_;
+    }
+    // Where a strategy order stands in its level at the exchange right now (not as the
+    // strategy would know it); nullopt unless it is resting
+    [[nodiscard]] std::optional<QueuePosition> queue_position(OrderId id) const noexcept;
+
+    // Net filled quantity (bought minus sold) and cash (sold minus bought notional)
+    [[nodiscard]] std::int64_t position() const noexcept {
+        return position_;
+    }
+    [[nodiscard]] Notional cash() const noexcept {
+        return cash_;
+    }
+    [[nodiscard]] std::uint64_t records() const noexcept {
+        return records_;
+    }
+    [[nodiscard]] std::uint64_t commands_sent() const noexcept {
+        return commands_sent_;
+    }
+    [[nodiscard]] std::uint64_t fills() const noexcept {
+        return fills_;
+    }
+    [[nodiscard]] std::uint64_t dropped() const noexcept {
+        return dropped_;
+    }
+
+private:
+    // Fixed-capacity FIFO of timed events, filled in time order by construction
+    template<typename T>
+    class Queue {
+    public:
+        explicit Queue(std::size_t capacity) : slots_(capacity), mask_(capacity - 1) {}
+
+        [[nodiscard]] bool empty() const noexcept {
+            return head_ == tail_;
+        }
+        [[nodiscard]] bool full() const noexcept {
+            return tail_ - head_ == slots_.size();
+        }
+        [[nodiscard]] T& front() noexcept {
+            return slots_[head_ & mask_];
+        }
+        // Caller checks full()
+        T& push() noexcept {
+            return slots_[tail_++ & mask_];
+        }
+        void pop() noexcept {
+            ++head_;
+        }
+
+    private:
+        std::vector<T> slots_;
+        std::size_t mask_;
+        std::size_t head_{0};
+        std::size_t tail_{0};
+    };
+
+    struct PendingCommand {
+        Timestamp time;
+        OrderCommand command;
+    };
+    struct PendingMarket {
+        Timestamp time;
+        MarketEvent event;
+    };
+    struct PendingReport {
+        Timestamp time;
+        ExecutionReport report;
+    };
+
+    Backtester(MatchingEngine& engine, BacktestStrategy& strategy, const Options& options);
+
+    // Process queued events stamped strictly before end, in merged time order
+    void process_before(Timestamp end);
+    void apply_record(const JournalRecord& record);
+    void apply_command(const OrderCommand& command);
+    // Fill reports for the strategy's side of the trades the last command caused
+    void settle_trades();
+    bool send(const OrderCommand& command);
+    void report(const ExecutionReport& report);
+
+    MatchingEngine& engine_;
+    BacktestStrategy& strategy_;
+    Timestamp feed_latency_;
+    Timestamp order_latency_;
+    Timestamp response_latency_;
+    ParticipantId participant_;
+
+    Queue<PendingCommand> commands_;
+    Queue<PendingMarket> market_;
+    Queue<PendingReport> reports_;
+    Timestamp now_{0};
+    OrderId next_id_;
+    std::uint64_t client_seq_{0};
+    std::int64_t position_{0};
+    Notional cash_{0};
+    std::uint64_t records_{0};
+    std::uint64_t commands_sent_{0};
+    std::uint64_t fills_{0};
+    std::uint64_t dropped_{0};
+};
+
+} // namespace lob
@@ -0,0 +1,258 @@
+#pragma once
+
+#include "order_command.hpp"
+#include "types.hpp"
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace lob {
+
+// One sequenced inbound command as written to the command journal
+// Records are fixed-width and appended in the order the engine executed them,
+// so replaying a journal through execute_command() rebuilds the same book.
+struct JournalRecord {
+    std::uint64_t sequence{0};      // Engine-wide, starting at 1
+    std::int64_t timestamp{0};      // Wall clock at receipt, nanoseconds since the epoch
+    ParticipantId participant{NO_PARTICIPANT};
+    std::uint32_t reserved{0};
+    OrderCommand command;
+};
+
+static_assert(std::is_trivially_copyable_v<JournalRecord> && sizeof(JournalRecord) == 72);
+
+enum class JournalFormat : std::uint8_t {
+    Raw = 0,        // JournalRecord as-is
+    Compressed = 1  // JournalEncoder stream
+};
+
+namespace journal {
+
+// Compressed record: a control byte, four tag bytes and up to eight field codes
+// Control holds type (bits 0-1), side (2), order type (3-4), time in force (5-6) and
+// whether the price is non-zero (7).
+// Each tag byte holds the byte lengths (0-8) of two codes, low nibble first, and the
+// codes follow back to back as truncated little-endian integers, in FIELDS order:
+//   sequence     - previous sequence - 1
+//   timestamp    zigzag delta from the previous record
+//   participant  zigzag delta from the previous record
+//   client_seq   zigzag delta from the previous record of the same participant slot
+//   id           zigzag delta from the previous record
+//   price        zigzag delta from the last non-zero price
+//   quantity     as is
+//   expire_time  zigzag
+// Lengths come from the tag bytes alone, so every field offset is known before any
+// payload byte is read, and each code is one unaligned 8-byte load and a mask: no
+// per-byte continuation branches as in LEB128. Reserved fields are not stored.
+
+enum Field : std::size_t {
+    SequenceField = 0,
+    TimestampField,
+    ParticipantField,
+    ClientSeqField,
+    IdField,
+    PriceField,
+    QuantityField,
+    ExpireField,
+    FIELDS
+};
+
+inline constexpr std::size_t TAG_BYTES = FIELDS / 2;  // One 32-bit word
+inline constexpr std::size_t MAX_RECORD = 1 + TAG_BYTES + 8 * FIELDS;
+// client_seq history is kept per participant modulo this
+inline constexpr std::size_t CLIENT_SLOTS = 64;
+
+static_assert(std::endian::native == std::endian::little, "Codes are copied as-is");
+
+constexpr std::uint64_t zigzag(std::int64_t value) noexcept {
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+constexpr std::int64_t unzigzag(std::uint64_t code) noexcept {
+    return static_cast<std::int64_t>((code >> 1) ^ (0 - (code & 1)));
+}
+
+constexpr std::uint64_t wrap_delta(std::int64_t value, std::int64_t previous) noexcept {
+    return zigzag(static_cast<std::int64_t>(static_cast<std::uint64_t>(value) -
+                                            static_cast<std::uint64_t>(previous)));
+}
+
+constexpr std::int64_t apply_delta(std::int64_t previous, std::uint64_t code) noexcept {
+    return static_cast<std::int64_t>(static_cast<std::uint64_t>(previous) +
+                                     static_cast<std::uint64_t>(unzigzag(code)));
+}
+
+inline constexpr std::array<std::uint64_t, 9> LENGTH_MASK = {
+    0, 0xFF, 0xFFFF, 0xFFFFFF, 0xFFFFFFFF, 0xFFFFFFFFFF, 0xFFFFFFFFFFFF, 0xFFFFFFFFFFFFFF, ~std::uint64_t{0}
+};
+
+// Delta state shared by the encoder and the decoder; both start from zero
+struct CodecState {
+    std::uint64_t sequence{0};
+    std::int64_t timestamp{0};
+    std::int64_t participant{0};
+    std::int64_t id{0};
+    std::int64_t price{0};
+    std::array<std::int64_t, CLIENT_SLOTS> client_seq{};
+
+    [[nodiscard]] std::int64_t& client_seq_of(ParticipantId participant) noexcept {
+        return client_seq[participant % CLIENT_SLOTS];
+    }
+};
+
+} // namespace journal
+
+// Appends records to a compressed journal stream
+// Deltas run across the whole stream, so a stream is decoded from its start by a
+// JournalDecoder that has seen every earlier record.
+class JournalEncoder {
+public:
+    static constexpr std::size_t MAX_RECORD = journal::MAX_RECORD;
+
+    // Write record at out, which must have MAX_RECORD bytes of room; returns bytes used
+    std::size_t encode(const JournalRecord& record, std::byte* out) noexcept {
+        using namespace journal;
+        const OrderCommand& command = record.command;
+        std::int64_t& client_seq = state_.client_seq_of(record.participant);
+        const bool priced = command.price != 0;
+        const std::array<std::uint64_t, FIELDS> codes = {
+            record.sequence - state_.sequence - 1,
+            wrap_delta(record.timestamp, state_.timestamp),
+            wrap_delta(record.participant, state_.participant),
+            wrap_delta(static_cast<std::int64_t>(command.client_seq), client_seq),
+            wrap_delta(static_cast<std::int64_t>(command.id), state_.id),
+            priced ? wrap_delta(command.price, state_.price) : 0,
+            command.quantity,
+            zigzag(command.expire_time)
+        };
+        state_.sequence = record.sequence;
+        state_.timestamp = record.timestamp;
+        state_.participant = record.participant;
+        client_seq = static_cast<std::int64_t>(command.client_seq);
+        state_.id = static_cast<std::int64_t>(command.id);
+        if (priced) {
+            state_.price = command.price;
+        }
+
+        out[0] = static_cast<std::byte>((static_cast<unsigned>(command.type) & 3) |
+                                        (static_cast<unsigned>(command.side) & 1) << 2 |
+                                        (static_cast<unsigned>(command.order_type) & 3) << 3 |
+                                        (static_cast<unsigned>(command.time_in_force) & 3) << 5 |
+                                        (priced ? 0x80u : 0u));
+        std::uint32_t tags = 0;
+        std::byte* at = out + 1 + TAG_BYTES;
+        for (std::size_t field = 0; field < FIELDS; ++field) {
+            const auto length = static_cast<std::uint32_t>(std::bit_width(codes[field]) + 7) / 8;
+            tags |= length << (4 * field);
+            std::memcpy(at, &codes[field], 8);  // Within MAX_RECORD; only length bytes count
+            at += length;
+        }
+        std::memcpy(out + 1, &tags, TAG_BYTES);
+        return static_cast<std::size_t>(at - out);
+    }
+
+    void reset() noexcept {
+        state_ = {};
+    }
+
+private:
+    journal::CodecState state_;
+};
+
+// Reads records back from a compressed journal stream
+class JournalDecoder {
+public:
+    // Decode the record at the front of data into record; returns the bytes it took,
+    // or 0 if data holds only part of a record or is not a compressed record
+    std::size_t decode(const std::byte* data, std::size_t size, JournalRecord& record) noexcept {
+        using namespace journal;
+        if (size < 1 + TAG_BYTES) {
+            return 0;
+        }
+        const auto control = static_cast<unsigned>(data[0]);
+        if ((control >> 5 & 3) > static_cast<unsigned>(TimeInForce::GTT)) {
+            return 0;
+        }
+        std::uint32_t tags;
+        std::memcpy(&tags, data + 1, TAG_BYTES);
+        // All eight nibbles at once: none above 8, and their sum is the payload size
+        constexpr std::uint32_t ONES = 0x11111111;
+        if ((tags >> 3 & ONES & ((tags | tags >> 1 | tags >> 2) & ONES)) != 0) {
+            return 0;
+        }
+        const std::uint32_t pairs = (tags & 0x0F0F0F0F) + (tags >> 4 & 0x0F0F0F0F);
+        const std::size_t total = 1 + TAG_BYTES + ((pairs * 0x01010101) >> 24);
+        if (total > size) {
+            return 0;
+        }
+
+        // Whole 8-byte loads need slack past the record; near the end of the data, copy it out
+        const std::byte* at = data + 1 + TAG_BYTES;
+        std::array<std::byte, MAX_RECORD + 8> padded;
+        if (size < total + 8) {
+            padded = {};
+            std::memcpy(padded.data(), at, total - (1 + TAG_BYTES));
+            at = padded.data();
+        }
+        std::array<std::uint64_t, FIELDS> codes;
+        for (std::size_t field = 0; field < FIELDS; ++field) {
+            std::uint64_t word;
+            std::memcpy(&word, at, 8);
+            const std::uint32_t length = tags >> (4 * field) & 0xF;
+            codes[field] = word & LENGTH_MASK[length];
+            at += length;
+        }
+
+        record.sequence = state_.sequence + codes[SequenceField] + 1;
+        record.timestamp = apply_delta(state_.timestamp, codes[TimestampField]);
+        record.participant = static_cast<ParticipantId>(apply_delta(state_.participant, codes[ParticipantField]));
+        record.reserved = 0;
+        std::int64_t& client_seq = state_.client_seq_of(record.participant);
+        OrderCommand& command = record.command;
+        command.client_seq = static_cast<std::uint64_t>(apply_delta(client_seq, codes[ClientSeqField]));
+        command.id = static_cast<OrderId>(apply_delta(state_.id, codes[IdField]));
+        command.price = control & 0x80 ? apply_delta(state_.price, codes[PriceField]) : 0;
+        command.quantity = codes[QuantityField];
+        command.expire_time = unzigzag(codes[ExpireField]);
+        command.type = static_cast<CommandType>(control & 3);
+        command.side = static_cast<Side>(control >> 2 & 1);
+        command.order_type = static_cast<OrderType>(control >> 3 & 3);
+        command.time_in_force = static_cast<TimeInForce>(control >> 5 & 3);
+        command.reserved = 0;
+
+        state_.sequence = record.sequence;
+        state_.timestamp = record.timestamp;
+        state_.participant = record.participant;
+        client_seq = static_cast<std::int64_t>(command.client_seq);
+        state_.id = static_cast<std::int64_t>(command.id);
+        if (command.price != 0) {
+            state_.price = command.price;
+        }
+        return total;
+    }
+
+    // Append every whole record of data to out; returns the bytes consumed
+    std::size_t decode_all(std::span<const std::byte> data, std::vector<JournalRecord>& out) {
+        std::size_t offset = 0;
+        JournalRecord record;
+        while (const std::size_t used = decode(data.data() + offset, data.size() - offset, record)) {
+            out.push_back(record);
+            offset += used;
+        }
+        return offset;
+    }
+
+    void reset() noexcept {
+        state_ = {};
+    }
+
+private:
+    journal::CodecState state_;
+};
+
+} // namespace lob
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "types.hpp"
+#include <span>
+
+namespace lob {
+
+class OrderBook;
+
+// Passive listener attached to a matching engine (see BasicMatchingEngine::add_observer)
+// All hooks run on the matching thread, in this order per inbound message:
+// trades as they execute, the coalesced level batch, then on_message_processed
+// once the book is consistent. Implementations must not call back into the engine.
+class EngineObserver {
+public:
+    virtual ~EngineObserver() = default;
+
+    virtual void on_trade(const Trade& trade) {
+        (void)trade;
+    }
+    virtual void on_level_updates(std::span<const LevelUpdate> updates) {
+        (void)updates;
+    }
+    virtual void on_message_processed(const OrderBook& book) {
+        (void)book;
+    }
+};
+
+} // namespace lob
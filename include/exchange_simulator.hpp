@@ -0,0 +1,340 @@
+#pragma once
+
+#include "matching_engine.hpp"
+#include "order_command.hpp"
+#include "order_entry.hpp"
+#include "top_of_book.hpp"
+#include "types.hpp"
+#include "wire_protocol.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <vector>
+
+namespace lob {
+
+class ExchangeSimulator;
+
+// splitmix64: one word of state per agent, the same sequence on every platform
+class AgentRng {
+public:
+    using result_type = std::uint64_t;
+
+    explicit AgentRng(std::uint64_t seed) noexcept : state_(seed) {}
+
+    static constexpr result_type min() noexcept {
+        return 0;
+    }
+    static constexpr result_type max() noexcept {
+        return std::numeric_limits<result_type>::max();
+    }
+    result_type operator()() noexcept {
+        std::uint64_t x = (state_ += 0x9e3779b97f4a7c15ULL);
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+    // Uniform in [1, 2 * mean], so mean on average and never zero
+    Timestamp delay(Timestamp mean) noexcept {
+        const auto span = static_cast<std::uint64_t>(std::max<std::int64_t>(2 * mean.count(), 1));
+        return Timestamp{static_cast<std::int64_t>(1 + (*this)() % span)};
+    }
+
+private:
+    std::uint64_t state_;
+};
+
+// Log-linear histogram of durations: four buckets per power of two, so percentiles
+// are within 25% and recording is a few instructions
+class LatencyHistogram {
+public:
+    void record(Timestamp duration) noexcept;
+    // Upper bound of the bucket holding the p-th fraction of samples (0 if empty)
+    [[nodiscard]] Timestamp percentile(double p) const noexcept;
+    [[nodiscard]] std::uint64_t count() const noexcept {
+        return count_;
+    }
+    [[nodiscard]] Timestamp max() const noexcept {
+        return max_;
+    }
+
+private:
+    static constexpr std::size_t BUCKETS = 4 * 64;
+
+    std::array<std::uint64_t, BUCKETS> buckets_{};
+    std::uint64_t count_{0};
+    Timestamp max_{0};
+};
+
+// The market as an agent sees it when it wakes: the book as it stands at that moment
+struct MarketView {
+    BookLevel bid;  // quantity 0: empty side
+    BookLevel ask;
+    Price reference{0};  // Last trade price, else the mid, else the simulator's initial price
+    std::uint64_t trades{0};  // Trades so far
+    Timestamp now{0};
+};
+
+// An agent's handle on the simulator: its clock, random numbers and order entry
+class AgentContext {
+public:
+    // Encoded as a wire frame and delivered to the agent's session after order_latency
+    void send(const OrderCommand& command);
+    // Ids are unique across agents: the agent's number in the high bits
+    [[nodiscard]] OrderId next_order_id() noexcept {
+        return (static_cast<OrderId>(index_ + 1) << 40) | ++order_count_;
+    }
+    [[nodiscard]] AgentRng& rng() noexcept {
+        return rng_;
+    }
+    [[nodiscard]] Timestamp now() const noexcept;
+    [[nodiscard]] std::size_t index() const noexcept {
+        return index_;
+    }
+
+private:
+    friend class ExchangeSimulator;
+
+    AgentContext(ExchangeSimulator& simulator, std::size_t index, std::uint64_t seed) noexcept
+        : simulator_(&simulator), index_(index), rng_(seed) {}
+
+    ExchangeSimulator* simulator_;
+    std::size_t index_;
+    AgentRng rng_;
+    OrderId order_count_{0};
+    std::uint32_t outbound_seq_{0};
+    bool reaction_pending_{false};
+};
+
+// Synthetic participant; every hook runs on the simulator's clock and may send
+class SimulatedAgent {
+public:
+    virtual ~SimulatedAgent() = default;
+
+    // First called at a random point of the simulator's start_window; returns the
+    // delay to the next call (nullopt: no more)
+    virtual std::optional<Timestamp> on_timer(const MarketView& market, AgentContext& context) = 0;
+    // Book or trade change, market_data_latency later; only if reacts_to_market()
+    virtual void on_market(const MarketView& market, AgentContext& context) {
+        (void)market;
+        (void)context;
+    }
+    // Acks and fills of the agent's own orders, response_latency after the exchange
+    virtual void on_report(const ExecutionReport& report, AgentContext& context) {
+        (void)report;
+        (void)context;
+    }
+    [[nodiscard]] virtual bool reacts_to_market() const noexcept {
+        return false;
+    }
+};
+
+// Two-sided quotes of size around the reference, skewed against inventory;
+// requotes when the reference moves or a quote fills, and on every refresh
+class MarketMakerAgent : public SimulatedAgent {
+public:
+    MarketMakerAgent(Quantity size, Price half_spread, Timestamp refresh) noexcept
+        : size_(size), half_spread_(half_spread), refresh_(refresh) {}
+
+    std::optional<Timestamp> on_timer(const MarketView& market, AgentContext& context) override;
+    void on_market(const MarketView& market, AgentContext& context) override;
+    void on_report(const ExecutionReport& report, AgentContext& context) override;
+    [[nodiscard]] bool reacts_to_market() const noexcept override {
+        return true;
+    }
+
+    [[nodiscard]] std::int64_t inventory() const noexcept {
+        return inventory_;
+    }
+
+private:
+    struct Quote {
+        OrderId id{0};
+        Price price{0};
+    };
+
+    void quote(const MarketView& market, AgentContext& context);
+    void place(Quote& quote, Side side, Price price, AgentContext& context);
+
+    Quantity size_;
+    Price half_spread_;
+    Timestamp refresh_;
+    std::array<Quote, 2> quotes_{};  // By Side
+    std::int64_t inventory_{0};
+};
+
+// Market orders of size on a random side, mean_interval apart on average
+class TakerAgent : public SimulatedAgent {
+public:
+    TakerAgent(Quantity size, Timestamp mean_interval) noexcept
+        : size_(size), mean_interval_(mean_interval) {}
+
+    std::optional<Timestamp> on_timer(const MarketView& market, AgentContext& context) override;
+
+private:
+    Quantity size_;
+    Timestamp mean_interval_;
+};
+
+// Limit orders up to depth ticks either side of the reference, cancelling its oldest
+// once it has a few resting
+class NoiseTraderAgent : public SimulatedAgent {
+public:
+    NoiseTraderAgent(Quantity max_size, Price depth, Timestamp mean_interval) noexcept
+        : max_size_(max_size), depth_(depth), mean_interval_(mean_interval) {}
+
+    std::optional<Timestamp> on_timer(const MarketView& market, AgentContext& context) override;
+
+private:
+    static constexpr std::size_t MAX_LIVE = 8;
+
+    Quantity max_size_;
+    Price depth_;
+    Timestamp mean_interval_;
+    std::array<OrderId, MAX_LIVE> live_{};  // Ring, oldest at live_count_ % MAX_LIVE once full
+    std::size_t live_count_{0};
+};
+
+struct ExchangeSimulatorOptions {
+    std::uint64_t seed{1};
+    Timestamp order_latency{std::chrono::microseconds(20)};        // Agent sends -> exchange receives
+    Timestamp response_latency{std::chrono::microseconds(20)};     // Exchange reports -> agent
+    Timestamp market_data_latency{std::chrono::microseconds(10)};  // Book change -> reacting agents
+    Timestamp service_time{std::chrono::nanoseconds(500)};         // Simulated matching time per command
+    Timestamp start_window{std::chrono::milliseconds(1)};          // First timers spread over it
+    Price initial_price{10'000};
+    bool measure_processing{true};  // Wall-clock time of each command in processing()
+};
+
+// Closed-loop, deterministic exchange simulation
+// Each agent owns an order-entry session and sends wire frames through
+// OrderEntrySessions, the path production gateways use, so a command callback on
+// sessions() sees (and can journal) exactly what a gateway would. The exchange is one
+// server on the simulated clock: frames queue in arrival order and each costs
+// service_time, so when agents send faster than it can match, queueing latency emerges
+// and feeds back into what they see. Events are ordered by time, then by the order
+// they were scheduled in, and all randomness comes from per-agent generators seeded
+// from seed, so a run depends only on the agents and options. The simulator turns on
+// the engine's trade keeping, and reads and clears the kept trades after each command.
+class ExchangeSimulator {
+public:
+    using Options = ExchangeSimulatorOptions;
+
+    // nullptr if there are no agents or one is null
+    [[nodiscard]] static std::unique_ptr<ExchangeSimulator>
+    create(MatchingEngine& engine, std::vector<std::unique_ptr<SimulatedAgent>> agents, const Options& options = {});
+
+    ExchangeSimulator(const ExchangeSimulator&) = delete;
+    ExchangeSimulator& operator=(const ExchangeSimulator&) = delete;
+
+    // Process every event stamped at or before until; returns the events processed
+    std::uint64_t run_until(Timestamp until);
+
+    [[nodiscard]] Timestamp now() const noexcept {
+        return now_;
+    }
+    [[nodiscard]] OrderEntrySessions& sessions() noexcept {
+        return *sessions_;
+    }
+    [[nodiscard]] SimulatedAgent& agent(std::size_t index) noexcept {
+        return *agents_[index];
+    }
+    [[nodiscard]] std::size_t agent_count() const noexcept {
+        return agents_.size();
+    }
+
+    // Simulated time from a frame reaching the exchange to its command completing
+    // (queueing plus service); a round trip adds order_latency and response_latency
+    [[nodiscard]] const LatencyHistogram& exchange_latency() const noexcept {
+        return exchange_latency_;
+    }
+    // Wall-clock time the engine and sessions took per command
+    [[nodiscard]] const LatencyHistogram& processing() const noexcept {
+        return processing_;
+    }
+    [[nodiscard]] std::uint64_t events() const noexcept {
+        return events_;
+    }
+    [[nodiscard]] std::uint64_t commands() const noexcept {
+        return commands_;
+    }
+    [[nodiscard]] std::uint64_t trades() const noexcept {
+        return trades_;
+    }
+    [[nodiscard]] std::size_t max_queue_depth() const noexcept {
+        return max_queue_depth_;
+    }
+
+private:
+    friend class AgentContext;
+
+    enum class EventKind : std::uint8_t {
+        Timer,
+        Market,
+        Arrival,  // A frame reaches the exchange
+        Service,  // The exchange takes the next queued frame
+        Report
+    };
+
+    struct Event {
+        Timestamp time;
+        std::uint64_t order;  // Scheduling order, for ties
+        EventKind kind;
+        std::uint32_t agent;
+        std::uint8_t length;                           // Of frame
+        std::array<std::byte, wire::MAX_FRAME> frame;  // Arrival
+        ExecutionReport report;                        // Report
+
+        // std::priority_queue keeps the greatest on top
+        bool operator<(const Event& other) const noexcept {
+            return time != other.time ? time > other.time : order > other.order;
+        }
+    };
+
+    struct Inbound {
+        Timestamp arrival;
+        std::uint32_t agent;
+        std::uint8_t length;
+        std::array<std::byte, wire::MAX_FRAME> frame;
+    };
+
+    ExchangeSimulator(MatchingEngine& engine, std::vector<std::unique_ptr<SimulatedAgent>> agents,
+                      const Options& options);
+
+    // Stamped with the next scheduling order; the caller fills the payload and pushes it
+    [[nodiscard]] Event next_event(Timestamp time, EventKind kind, std::uint32_t agent) noexcept;
+    void send(AgentContext& context, const OrderCommand& command);
+    void serve();
+    [[nodiscard]] MarketView market_view() const noexcept;
+
+    MatchingEngine& engine_;
+    std::vector<std::unique_ptr<SimulatedAgent>> agents_;
+    std::vector<AgentContext> contexts_;
+    std::vector<std::uint32_t> reacting_;  // Agents woken by market changes
+    std::unique_ptr<OrderEntrySessions> sessions_;
+    Options options_;
+
+    std::priority_queue<Event> schedule_;
+    std::deque<Inbound> inbound_;
+    Timestamp now_{0};
+    Timestamp busy_until_{0};
+    bool service_scheduled_{false};
+    std::uint64_t next_order_{0};
+
+    BookLevel last_bid_;
+    BookLevel last_ask_;
+    LatencyHistogram exchange_latency_;
+    LatencyHistogram processing_;
+    std::uint64_t events_{0};
+    std::uint64_t commands_{0};
+    std::uint64_t trades_{0};
+    std::size_t max_queue_depth_{0};
+};
+
+} // namespace lob
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace lob {
+
+// Binary indexed tree over a fixed number of slots: point add and prefix sum in O(log n)
+// T is expected to be an unsigned integer; negative deltas rely on modular wraparound,
+// so prefix sums stay exact as long as the true sums are non-negative.
+template<typename T>
+class FenwickTree {
+public:
+    // Reset to capacity slots, all zero
+    void assign(std::size_t capacity) {
+        tree_.assign(capacity + 1, T{0});
+    }
+    
+    // Reset to capacity slots, fill the first count from next_value() in order, build in O(n)
+    template<typename F>
+    void build(std::size_t capacity, std::size_t count, F&& next_value) {
+        tree_.assign(capacity + 1, T{0});
+        for (std::size_t i = 1; i <= count; ++i) {
+            tree_[i] = next_value();
+        }
+        for (std::size_t i = 1; i < tree_.size(); ++i) {
+            const std::size_t parent = i + (i & (~i + 1));
+            if (parent < tree_.size()) {
+                tree_[parent] += tree_[i];
+            }
+        }
+    }
+    
+    void add(std::size_t slot, T delta) noexcept {
+        for (std::size_t i = slot + 1; i < tree_.size(); i += i & (~i + 1)) {
+            tree_[i] += delta;
+        }
+    }
+    
+    // Sum of slots [0, slot)
+    [[nodiscard]] T prefix_sum(std::size_t slot) const noexcept {
+        T sum{0};
+        for (std::size_t i = slot; i > 0; i &= i - 1) {
+            sum += tree_[i];
+        }
+        return sum;
+    }
+    
+    // First slot whose running sum [0, slot] reaches target, or capacity(); O(log n).
+    // Needs every slot non-negative, so the running sum is monotonic.
+    [[nodiscard]] std::size_t lower_bound(T target) const noexcept {
+        std::size_t position = 0;
+        T sum{0};
+        for (std::size_t step = std::bit_floor(capacity()); step > 0; step >>= 1) {
+            if (position + step < tree_.size() && sum + tree_[position + step] < target) {
+                position += step;
+                sum += tree_[position];
+            }
+        }
+        return position;
+    }
+    
+    [[nodiscard]] std::size_t capacity() const noexcept {
+        return tree_.empty() ? 0 : tree_.size() - 1;
+    }
+    
+private:
+    std::vector<T> tree_;  // 1-based; tree_[0] unused
+};
+
+} // namespace lob
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "types.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace lob::fix {
+
+// FIX 4.4 tag=value codec, parsed in place
+// decode_message() checks BeginString, BodyLength and CheckSum (SSE2 where available)
+// and then walks the fields once, finding each value's SOH with memchr.
+// Message only holds views into the input, so it is valid until that buffer is
+// reused. Unknown tags are skipped and repeating groups are not interpreted.
+
+inline constexpr char SOH = '\x01';
+inline constexpr std::string_view BEGIN_STRING = "8=FIX.4.4\x01" "9=";
+inline constexpr std::size_t MAX_MESSAGE = 4096;  // Longer inbound messages are Invalid
+
+enum class Tag : std::uint32_t {
+    AvgPx = 6,
+    ClOrdID = 11,
+    CumQty = 14,
+    ExecID = 17,
+    LastPx = 31,
+    LastQty = 32,
+    MsgSeqNum = 34,
+    MsgType = 35,
+    OrderID = 37,
+    OrderQty = 38,
+    OrdStatus = 39,
+    OrdType = 40,
+    OrigClOrdID = 41,
+    Price = 44,
+    RefSeqNum = 45,
+    SenderCompID = 49,
+    SendingTime = 52,
+    Side = 54,
+    Symbol = 55,
+    TargetCompID = 56,
+    Text = 58,
+    TimeInForce = 59,
+    EncryptMethod = 98,
+    CxlRejReason = 102,
+    HeartBtInt = 108,
+    TestReqID = 112,
+    ExecType = 150,
+    LeavesQty = 151,
+    CxlRejResponseTo = 434
+};
+
+enum class DecodeStatus : std::uint8_t {
+    Ok = 0,
+    NeedMore = 1,  // Incomplete message at the front of the buffer
+    Invalid = 2    // Bad framing, checksum or field syntax
+};
+
+struct DecodeResult {
+    DecodeStatus status;
+    std::size_t consumed{0};  // Message length when Ok
+};
+
+// The fields the session layer acts on; empty views and zero chars when absent
+struct Message {
+    std::string_view msg_type;
+    std::uint64_t seq{0};
+    std::string_view sender_comp_id;
+    std::string_view target_comp_id;
+    std::string_view cl_ord_id;
+    std::string_view orig_cl_ord_id;
+    std::string_view symbol;
+    std::string_view price;
+    std::string_view order_qty;
+    std::string_view heart_bt_int;
+    std::string_view test_req_id;
+    char side{0};
+    char ord_type{0};
+    char time_in_force{0};
+};
+
+// Decode the message at the front of buffer
+[[nodiscard]] DecodeResult decode_message(std::span<const char> buffer, Message& message) noexcept;
+
+// Sum of the bytes modulo 256, as carried in CheckSum (10)
+[[nodiscard]] std::uint8_t checksum(std::span<const char> bytes) noexcept;
+
+[[nodiscard]] constexpr bool parse_uint(std::string_view text, std::uint64_t& value) noexcept {
+    if (text.empty() || text.size() > 19) {
+        return false;
+    }
+    value = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        value = value * 10 + static_cast<std::uint64_t>(c - '0');
+    }
+    return true;
+}
+
+// Decimal price to ticks with decimals digits after the point; false if off-tick
+[[nodiscard]] constexpr bool parse_price(std::string_view text, unsigned decimals, Price& price) noexcept {
+    const bool negative = !text.empty() && text.front() == '-';
+    if (negative) {
+        text.remove_prefix(1);
+    }
+    const std::size_t point = text.find('.');
+    std::string_view fraction = point == std::string_view::npos ? std::string_view{} : text.substr(point + 1);
+    text = text.substr(0, point);
+    while (!fraction.empty() && fraction.back() == '0') {
+        fraction.remove_suffix(1);
+    }
+    std::uint64_t whole = 0;
+    std::uint64_t part = 0;
+    if (!parse_uint(text, whole) || fraction.size() > decimals ||
+        (!fraction.empty() && !parse_uint(fraction, part))) {
+        return false;
+    }
+    for (std::size_t i = fraction.size(); i < decimals; ++i) {
+        part *= 10;
+    }
+    std::uint64_t scale = 1;
+    for (unsigned i = 0; i < decimals; ++i) {
+        scale *= 10;
+    }
+    const auto ticks = static_cast<Price>(whole * scale + part);
+    price = negative ? -ticks : ticks;
+    return true;
+}
+
+// Composes one outbound message. Fields go into a fixed scratch body; finish()
+// writes BeginString, BodyLength, the body and CheckSum to the destination in one
+// pass, so the caller only needs size() bytes of room there.
+class MessageBuilder {
+public:
+    static constexpr std::size_t MAX_BODY = 2 * MAX_MESSAGE;
+    // BeginString, a five-digit BodyLength and the trailer
+    static constexpr std::size_t MAX_OVERHEAD = BEGIN_STRING.size() + 6 + 7;
+
+    // Starts a message with the standard header fields
+    void begin(std::string_view msg_type, std::string_view sender, std::string_view target,
+               std::uint64_t seq, std::string_view sending_time) noexcept {
+        length_ = 0;
+        add(Tag::MsgType, msg_type);
+        add(Tag::SenderCompID, sender);
+        add(Tag::TargetCompID, target);
+        add(Tag::MsgSeqNum, seq);
+        add(Tag::SendingTime, sending_time);
+    }
+
+    MessageBuilder& add(Tag tag, std::string_view value) noexcept;
+    MessageBuilder& add(Tag tag, char value) noexcept {
+        return add(tag, std::string_view(&value, 1));
+    }
+    MessageBuilder& add(Tag tag, std::uint64_t value) noexcept;
+    MessageBuilder& add_price(Tag tag, Price value, unsigned decimals) noexcept;
+
+    [[nodiscard]] std::size_t size() const noexcept;
+    // Write the complete message to out (size() bytes); returns its length
+    std::size_t finish(char* out) const noexcept;
+
+private:
+    std::array<char, MAX_BODY> body_;
+    std::size_t length_{0};
+};
+
+} // namespace lob::fix
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "fix_protocol.hpp"
+#include "matching_engine.hpp"
+#include "order_command.hpp"
+#include "session_slots.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lob {
+
+struct FixSessionConfig {
+    std::string comp_id;          // Ours: SenderCompID out, TargetCompID in
+    std::string symbol;           // The instrument the engine trades
+    unsigned price_decimals{0};   // Digits after the point in Price (44) per tick
+};
+
+// FIX 4.4 counterpart of OrderEntrySessions, with the same transport interface
+// (open/process/pending_output/consume_output/drain_dirty). TcpGateway and
+// UringGateway hold an OrderEntrySessions, so serving FIX takes a transport loop
+// of its own driving this class the same way. A session must log on first; it
+// then trades as its slot's participant, from a block reserved from the engine,
+// and closing it cancels its resting orders.
+//  - NewOrderSingle (D), OrderCancelRequest (F) and OrderCancelReplaceRequest (G)
+//    become OrderCommands; ClOrdID must be a decimal integer and is the OrderId,
+//    and cancels/replaces address the order by OrigClOrdID
+//  - every command is answered with an ExecutionReport (8), or an
+//    OrderCancelReject (9) when a cancel/replace fails; fills go to both owners
+//  - Heartbeat, TestRequest and Logout are handled; there is no resend, so any
+//    sequence gap or malformed message ends the session
+// AvgPx is not tracked and always sent as 0.
+class FixSessions : public EngineObserver {
+public:
+    struct ProcessResult {
+        std::size_t consumed{0};  // Bytes of complete messages taken from the input
+        std::size_t commands{0};
+        bool error{false};        // Protocol violation; close the session
+        bool logout{false};       // Logout answered; close once the output is flushed
+    };
+
+    FixSessions(MatchingEngine& engine, std::size_t max_sessions, FixSessionConfig config);
+    ~FixSessions() override;
+
+    FixSessions(const FixSessions&) = delete;
+    FixSessions& operator=(const FixSessions&) = delete;
+
+    // std::nullopt when every slot is in use
+    [[nodiscard]] std::optional<std::size_t> open();
+    void close(std::size_t slot);
+
+    // Decode and handle every complete message at the front of input
+    ProcessResult process(std::size_t slot, std::span<const std::byte> input);
+
+    [[nodiscard]] std::span<const std::byte> pending_output(std::size_t slot) const noexcept {
+        return slots_.pending_output(slot);
+    }
+    void consume_output(std::size_t slot, std::size_t bytes) noexcept {
+        slots_.consume_output(slot, bytes);
+    }
+    template<typename F>
+    void drain_dirty(F&& f) {
+        slots_.drain_dirty(std::forward<F>(f));
+    }
+
+    [[nodiscard]] bool logged_on(std::size_t slot) const noexcept {
+        return slots_.is_open(slot) && slots_.state(slot).logged_on;
+    }
+    [[nodiscard]] std::size_t open_sessions() const noexcept {
+        return slots_.open_sessions();
+    }
+    // Participant the session in slot trades as
+    [[nodiscard]] ParticipantId participant(std::size_t slot) const noexcept {
+        return slots_.participant(slot);
+    }
+
+    void on_trade(const Trade& trade) override;
+
+private:
+    struct Session {
+        std::string peer_comp_id;       // Their SenderCompID, from the Logon
+        std::uint64_t inbound_seq{0};   // Last accepted MsgSeqNum
+        std::uint64_t outbound_seq{0};
+        bool logged_on{false};
+    };
+
+    // false: the session must be closed
+    bool handle(std::size_t slot, const fix::Message& message, ProcessResult& result);
+    void handle_order(std::size_t slot, const fix::Message& message);
+    void reject_order(std::size_t slot, const fix::Message& message, std::string_view reason);
+
+    fix::MessageBuilder& start(std::size_t slot, std::string_view msg_type);
+    void send(std::size_t slot);
+    void add_report_fields(const ExecutionReport& report, char exec_type, Side side, Quantity cum_qty);
+    void route_fill(ParticipantId participant, OrderId id, const Trade& trade);
+    std::string_view sending_time();
+
+    MatchingEngine& engine_;
+    FixSessionConfig config_;
+    SessionSlots<Session> slots_;
+    std::uint64_t exec_id_{0};
+    fix::MessageBuilder builder_;
+
+    // Fills of the command being executed, for its acknowledgement's CumQty
+    OrderId active_id_{0};
+    Quantity active_cum_{0};
+
+    // SendingTime is reformatted only when the second changes
+    std::int64_t time_second_{-1};
+    char time_text_[21]{};  // YYYYMMDD-HH:MM:SS.sss
+};
+
+} // namespace lob
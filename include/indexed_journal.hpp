@@ -0,0 +1,224 @@
+#pragma once
+
+#include "command_journal.hpp"
+#include "matching_engine.hpp"
+#include "types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace lob {
+
+namespace journal {
+
+// On-disk layout of an indexed journal directory, little-endian throughout:
+//   journal    the command records, raw or compressed (see JournalFormat)
+//   index      an IndexHeader, then one IndexEntry every index_interval records
+//   snapshots  SnapshotHeader blocks, each followed by its SnapshotOrder array
+// The journal is cut into segments of snapshot_interval records. A segment starts
+// with a snapshot of the book as it was before its first record, and a compressed
+// segment restarts the encoder, so replay can begin at any segment. Files are
+// appended in the order journal, snapshots, index: an index entry never points
+// past what was written before it, and torn tails are ignored by readers.
+// Times are on the wall clock the records are stamped with: GTT expiries in records
+// are converted from the engine's steady clock, which means nothing to another process,
+// and a snapshot keeps expiries and the session close relative to when it was taken,
+// at the time of its segment's first record.
+
+inline constexpr std::uint32_t INDEX_MAGIC = 0x5844494A;     // "JIDX"
+inline constexpr std::uint32_t SNAPSHOT_MAGIC = 0x50414E53;  // "SNAP"
+inline constexpr std::uint64_t NO_SNAPSHOT = UINT64_MAX;
+
+struct IndexHeader {
+    std::uint32_t magic;
+    JournalFormat format;
+    std::uint8_t reserved[3];
+};
+
+struct IndexEntry {
+    std::uint64_t sequence;  // Of the first record at offset
+    std::int64_t timestamp;  // Of that record
+    std::uint64_t offset;    // In the journal file
+    std::uint64_t snapshot;  // Offset of the segment's snapshot, or NO_SNAPSHOT mid-segment
+};
+
+struct SnapshotHeader {
+    std::uint32_t magic;
+    std::uint32_t next_arrival;   // OrderBook::next_arrival()
+    std::uint64_t sequence;       // Last record reflected (the segment starts after it)
+    std::uint64_t orders;         // SnapshotOrders that follow, in for_each_order() order
+    std::uint64_t state_hash;     // OrderBook::state_hash(), checked after a restore
+    Price reference_price;
+    Price last_trade_price;
+    std::int64_t session_close;   // Nanoseconds after the snapshot was taken
+    SessionState session_state;
+    SelfTradePrevention self_trade_prevention;
+    std::uint8_t has_reference_price;
+    std::uint8_t has_last_trade_price;
+    std::uint8_t has_session_close;
+    std::uint8_t reserved[3];
+};
+
+struct SnapshotOrder {
+    OrderId id;
+    Price price;
+    Quantity quantity;
+    Quantity filled_quantity;
+    std::int64_t expire_time;     // Nanoseconds after the snapshot was taken; 0 for GTC
+    ParticipantId participant;
+    std::uint32_t arrival;
+    Side side;
+    OrderType type;
+    TimeInForce time_in_force;
+    OrderStatus status;
+    std::uint8_t reserved[4];
+};
+
+static_assert(sizeof(IndexHeader) == 8);
+static_assert(sizeof(IndexEntry) == 32);
+static_assert(sizeof(SnapshotHeader) == 64);
+static_assert(sizeof(SnapshotOrder) == 56);
+
+} // namespace journal
+
+struct IndexedJournalOptions {
+    JournalFormat format{JournalFormat::Raw};
+    std::size_t index_interval{4096};       // Records between index entries
+    std::size_t snapshot_interval{1 << 18}; // Records per segment; a multiple of index_interval
+    std::size_t write_bytes{1 << 20};       // Records gathered per journal write()
+};
+
+// Command journal with a sparse time index and a book snapshot per segment
+// append() takes each command before the engine executes it (it matches
+// OrderEntrySessions::CommandCallback); at a segment boundary it first snapshots the
+// engine, which costs a walk of the resting orders on the calling thread. Writes are
+// buffered and synchronous, and nothing is fsync'ed.
+class IndexedJournalWriter {
+public:
+    using Options = IndexedJournalOptions;
+
+    // Creates directory if needed and truncates its files; nullptr on failure or
+    // if snapshot_interval is not a non-zero multiple of index_interval
+    [[nodiscard]] static std::unique_ptr<IndexedJournalWriter>
+    create(const MatchingEngine& engine, const std::string& directory, const Options& options = {});
+    // Writes what is still buffered
+    ~IndexedJournalWriter();
+
+    IndexedJournalWriter(const IndexedJournalWriter&) = delete;
+    IndexedJournalWriter& operator=(const IndexedJournalWriter&) = delete;
+
+    // Stamped with the wall clock, a GTT expiry moved from the engine's clock onto it
+    void append(std::uint64_t sequence, ParticipantId participant, const OrderCommand& command);
+    // Timestamp and any GTT expiry already on one clock
+    void append(const JournalRecord& record);
+    // Hand everything buffered to the files
+    void flush();
+
+    [[nodiscard]] std::uint64_t records() const noexcept {
+        return records_;
+    }
+    [[nodiscard]] std::uint64_t snapshots() const noexcept {
+        return snapshots_;
+    }
+    [[nodiscard]] std::uint64_t journal_bytes() const noexcept {
+        return journal_offset_;
+    }
+    [[nodiscard]] std::uint64_t write_errors() const noexcept {
+        return write_errors_;
+    }
+
+private:
+    IndexedJournalWriter(const MatchingEngine& engine, int journal_fd, int index_fd, int snapshot_fd,
+                         const Options& options);
+
+    void write_snapshot(std::uint64_t sequence);
+    void write_all(int fd, std::span<const std::byte> data);
+
+    const MatchingEngine& engine_;
+    int journal_fd_;
+    int index_fd_;
+    int snapshot_fd_;
+    JournalFormat format_;
+    std::size_t index_interval_;
+    std::size_t snapshot_interval_;
+    std::size_t write_bytes_;
+
+    JournalEncoder encoder_;
+    std::vector<std::byte> journal_buffer_;
+    std::vector<journal::IndexEntry> index_buffer_;
+    std::vector<std::byte> snapshot_buffer_;
+    std::uint64_t records_{0};
+    std::uint64_t snapshots_{0};
+    std::uint64_t journal_offset_{0};   // Written plus buffered
+    std::uint64_t snapshot_offset_{0};
+    std::uint64_t write_errors_{0};
+};
+
+// Where a seek left the engine
+struct JournalPosition {
+    std::uint64_t sequence{0};  // Last record applied (or reflected by the snapshot)
+    std::uint64_t replayed{0};  // Records executed after restoring the snapshot
+};
+
+// Random access to an indexed journal through private memory mappings
+// seek() restores the last snapshot at or before the target and replays only the
+// records between it and the target, so the cost is bounded by one segment.
+// Index timestamps are assumed not to go backwards.
+class IndexedJournalReader {
+public:
+    // nullptr if the directory does not hold an indexed journal
+    [[nodiscard]] static std::unique_ptr<IndexedJournalReader> open(const std::string& directory);
+    ~IndexedJournalReader();
+
+    IndexedJournalReader(const IndexedJournalReader&) = delete;
+    IndexedJournalReader& operator=(const IndexedJournalReader&) = delete;
+
+    // Rebuild in engine, which must be empty, the book as of the last record stamped at
+    // or before time (as of the first snapshot if none is); nullopt if the engine is not
+    // empty or the journal has no usable snapshot, which leaves an empty engine empty.
+    // Replay pins the engine's clock to the journal's, shifted so the target is now, then
+    // unpins it: orders expire as they did, and the rest keep the time they had left at
+    // the target. Const: one reader serves many threads.
+    std::optional<JournalPosition> seek(Timestamp time, MatchingEngine& engine) const;
+    // Same, up to and including the record with this sequence
+    std::optional<JournalPosition> seek_sequence(std::uint64_t sequence, MatchingEngine& engine) const;
+
+    [[nodiscard]] JournalFormat format() const noexcept {
+        return format_;
+    }
+    [[nodiscard]] std::span<const journal::IndexEntry> index() const noexcept {
+        return index_;
+    }
+
+private:
+    struct Mapping {
+        const std::byte* data{nullptr};
+        std::size_t size{0};
+    };
+
+    IndexedJournalReader(Mapping journal, Mapping index, Mapping snapshots, JournalFormat format);
+
+    // Decode from offset while f(record) and before end
+    template<typename F>
+    void for_each_record(std::size_t offset, std::size_t end, F&& f) const;
+    // Restore the snapshot of the segment holding entry, then replay while keep(record)
+    template<typename Keep>
+    std::optional<JournalPosition> replay(std::size_t entry, MatchingEngine& engine, Keep&& keep) const;
+    // Sequence the snapshot reflects, its relative times counted from taken on the engine's
+    // clock; nullopt, and engine cleared, if it is torn, holds an invalid order or does not
+    // hash as recorded
+    [[nodiscard]] std::optional<std::uint64_t> restore(std::uint64_t snapshot, MatchingEngine& engine,
+                                                       Timestamp taken) const;
+
+    Mapping journal_;
+    Mapping index_file_;
+    Mapping snapshots_;
+    JournalFormat format_;
+    std::span<const journal::IndexEntry> index_;
+};
+
+} // namespace lob
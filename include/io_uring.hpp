@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <linux/io_uring.h>
+#include <memory>
+#include <span>
+#include <sys/uio.h>
+
+namespace lob {
+
+// Thin owner of one io_uring instance, driven through the raw syscalls
+// SQEs are filled in place and published in bulk by submit(); completions are read
+// straight from the shared CQ ring. Without SQPOLL one submit() is one syscall; with
+// SQPOLL a kernel thread polls the SQ and submit() only enters the kernel to wake it
+// or to wait for completions. Single-threaded: all calls from the owning thread.
+class IoUring {
+public:
+    struct Options {
+        unsigned entries{256};          // SQ size (CQ is four times larger)
+        bool sqpoll{false};
+        unsigned sqpoll_idle_ms{1000};  // Idle time before the SQ thread sleeps
+    };
+
+    // nullptr if io_uring is unavailable (old kernel, seccomp, missing privileges)
+    [[nodiscard]] static std::unique_ptr<IoUring> create(const Options& options);
+    ~IoUring();
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    // Next free SQE, zeroed; nullptr while the SQ is full (submit() and retry)
+    [[nodiscard]] io_uring_sqe* get_sqe() noexcept;
+    // Publish queued SQEs and wait for min_complete completions (bounded by timeout
+    // when non-zero); returns false on an error other than a timeout or signal
+    bool submit(unsigned min_complete = 0, std::chrono::nanoseconds timeout = {});
+
+    // Visit and retire every completion currently in the CQ; returns the count
+    template<typename F>
+    unsigned drain_completions(F&& f) {
+        const unsigned head = cq_head_->load(std::memory_order_relaxed);
+        const unsigned tail = cq_tail_->load(std::memory_order_acquire);
+        for (unsigned i = head; i != tail; ++i) {
+            f(cqes_[i & cq_mask_]);
+        }
+        cq_head_->store(tail, std::memory_order_release);
+        return tail - head;
+    }
+    [[nodiscard]] bool completions_ready() const noexcept {
+        return cq_head_->load(std::memory_order_relaxed) != cq_tail_->load(std::memory_order_acquire);
+    }
+
+    // Fixed buffers for IORING_OP_READ_FIXED / WRITE_FIXED (sqe->buf_index)
+    [[nodiscard]] bool register_buffers(std::span<const iovec> buffers) noexcept;
+    // Provided-buffer ring for buffer selection (multishot receive); entries is a power of two
+    [[nodiscard]] io_uring_buf_ring* register_buffer_ring(std::uint16_t group, unsigned entries) noexcept;
+
+    // io_uring_enter calls made so far
+    [[nodiscard]] std::uint64_t enters() const noexcept {
+        return enters_;
+    }
+    [[nodiscard]] bool sqpoll() const noexcept {
+        return sqpoll_;
+    }
+
+private:
+    IoUring() = default;
+
+    int fd_{-1};
+    bool sqpoll_{false};
+    void* sq_ring_{nullptr};
+    std::size_t sq_ring_size_{0};
+    io_uring_sqe* sqes_{nullptr};
+    std::size_t sqes_size_{0};
+
+    std::atomic<unsigned>* sq_head_{nullptr};
+    std::atomic<unsigned>* sq_tail_{nullptr};
+    std::atomic<unsigned>* sq_flags_{nullptr};
+    unsigned sq_mask_{0};
+    unsigned sq_entries_{0};
+    unsigned sqe_tail_{0};  // Local tail; published by submit()
+    std::atomic<unsigned>* cq_head_{nullptr};
+    std::atomic<unsigned>* cq_tail_{nullptr};
+    io_uring_cqe* cqes_{nullptr};
+    unsigned cq_mask_{0};
+
+    void* buffer_ring_{nullptr};
+    std::size_t buffer_ring_size_{0};
+    std::uint64_t enters_{0};
+};
+
+// Hand buffer bid (of len bytes at addr) to a provided-buffer ring; visible after publish
+inline void add_ring_buffer(io_uring_buf_ring* ring, unsigned mask, unsigned offset,
+                            void* addr, unsigned len, std::uint16_t bid) noexcept {
+    const unsigned tail = std::atomic_ref(ring->tail).load(std::memory_order_relaxed);
+    // Indexed from the ring base, not bufs[]: older uapi headers put bufs behind an
+    // empty struct, which shifts it by one byte (padded to eight) in C++
+    io_uring_buf& buffer = reinterpret_cast<io_uring_buf*>(ring)[(tail + offset) & mask];
+    buffer.addr = reinterpret_cast<std::uint64_t>(addr);
+    buffer.len = len;
+    buffer.bid = bid;
+}
+
+inline void publish_ring_buffers(io_uring_buf_ring* ring, unsigned count) noexcept {
+    std::atomic_ref tail(ring->tail);
+    tail.store(static_cast<std::uint16_t>(tail.load(std::memory_order_relaxed) + count),
+               std::memory_order_release);
+}
+
+} // namespace lob
@@ -0,0 +1,311 @@
+#pragma once
+
+#include "types.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <type_traits>
+#include <vector>
+
+namespace lob {
+
+// The price levels of one book side, best first, in two tiers
+// The hot tier is a ring of HOT slots indexed by price that covers a window from a
+// little better than the best price to HOT prices behind it, so finding, adding and
+// removing a level near the touch is an array index and a bit flip, and the best level
+// comes out of a two-level occupancy bitmap. Levels behind the window, rarely touched,
+// sit in a std::map. The window re-centers when a better price arrives outside it or
+// the best drifts past its middle, moving levels across tiers; the levels themselves
+// live in a pool and never move, so a reference stays valid until its level is erased.
+// Level needs a price member and reset(price), which empties it for reuse.
+template<typename Level, bool Descending, std::size_t HOT = 4096>
+class LevelStore {
+    static_assert(std::has_single_bit(HOT) && HOT >= 64 && HOT <= 64 * 64, "one summary word");
+
+    using Compare = std::conditional_t<Descending, std::greater<Price>, std::less<Price>>;
+    using ColdLevels = std::map<Price, Level*, Compare>;
+
+    static constexpr std::size_t MASK = HOT - 1;
+    static constexpr std::size_t WORDS = HOT / 64;
+    static constexpr std::int64_t HEADROOM = HOT / 8;  // Window prices better than the best
+
+public:
+    // Forward iteration best first: the hot window, then the cold levels
+    class const_iterator {
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Level;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Level*;
+        using reference = const Level&;
+
+        const_iterator() = default;
+
+        reference operator*() const noexcept {
+            return offset_ < HOT ? *store_->hot_[slot_] : *cold_->second;
+        }
+        pointer operator->() const noexcept {
+            return &**this;
+        }
+        const_iterator& operator++() noexcept {
+            if (offset_ >= HOT) {
+                ++cold_;
+                return *this;
+            }
+            // Usually the next level is in the same bitmap word
+            const std::size_t slot = (slot_ + 1) & MASK;
+            if (const std::uint64_t rest = store_->bits_[slot / 64] >> (slot % 64)) {
+                const auto skip = static_cast<std::size_t>(std::countr_zero(rest));
+                if (offset_ + 1 + skip < HOT) {
+                    offset_ += 1 + skip;
+                    slot_ = slot + skip;
+                    return *this;
+                }
+            }
+            offset_ = store_->next_offset(offset_ + 1);
+            slot_ = store_->slot_at(offset_);
+            return *this;
+        }
+        const_iterator operator++(int) noexcept {
+            const_iterator copy = *this;
+            ++*this;
+            return copy;
+        }
+        friend bool operator==(const const_iterator& a, const const_iterator& b) noexcept {
+            return a.offset_ == b.offset_ && (a.offset_ < HOT || a.cold_ == b.cold_);
+        }
+
+    private:
+        friend class LevelStore;
+
+        const_iterator(const LevelStore* store, std::size_t offset, typename ColdLevels::const_iterator cold) noexcept
+            : store_(store), offset_(offset), slot_(store->slot_at(offset)), cold_(cold) {}
+
+        const LevelStore* store_{nullptr};
+        std::size_t offset_{HOT};  // In the window; HOT once on the cold levels
+        std::size_t slot_{0};      // Of offset_
+        typename ColdLevels::const_iterator cold_{};
+    };
+
+    LevelStore() : hot_(HOT) {}
+
+    [[nodiscard]] Level* find(Price price) noexcept {
+        return lookup(price);
+    }
+    [[nodiscard]] const Level* find(Price price) const noexcept {
+        return lookup(price);
+    }
+
+    // Empty level at price, which must not be present
+    Level& emplace(Price price) {
+        const std::int64_t r = rank(price);
+        if (size_ == 0) {
+            low_ = r - HEADROOM;
+            best_ = HOT;
+        } else if (r < low_) {
+            recenter(r - HEADROOM);
+        }
+        Level* level;
+        if (free_.empty()) {
+            level = &pool_.emplace_back();
+        } else {
+            level = free_.back();
+            free_.pop_back();
+        }
+        level->reset(price);
+        const std::int64_t offset = r - low_;
+        if (offset < static_cast<std::int64_t>(HOT)) {
+            const std::size_t slot = slot_of(r);
+            hot_[slot] = level;
+            set_bit(slot);
+            best_ = std::min(best_, static_cast<std::size_t>(offset));
+        } else {
+            cold_.emplace(price, level);
+        }
+        ++size_;
+        return *level;
+    }
+
+    void erase(Price price) {
+        const std::int64_t r = rank(price);
+        if (r >= low_ && r - low_ < static_cast<std::int64_t>(HOT)) {
+            const std::size_t slot = slot_of(r);
+            if (!test_bit(slot)) {
+                return;
+            }
+            free_.push_back(hot_[slot]);
+            clear_bit(slot);
+            const auto offset = static_cast<std::size_t>(r - low_);
+            if (offset == best_) {
+                best_ = next_offset(offset + 1);
+            }
+        } else {
+            const auto it = cold_.find(price);
+            if (it == cold_.end()) {
+                return;
+            }
+            free_.push_back(it->second);
+            cold_.erase(it);
+        }
+        --size_;
+        // Keep the best near the front of the window, and in it while any level is left
+        if (best_ == HOT) {
+            if (!cold_.empty()) {
+                recenter(rank(cold_.begin()->first) - HEADROOM);
+            }
+        } else if (best_ > HOT / 2) {
+            recenter(low_ + static_cast<std::int64_t>(best_) - HEADROOM);
+        }
+    }
+
+    // nullptr when the side is empty; the best level is always in the window
+    [[nodiscard]] const Level* best() const noexcept {
+        return best_ < HOT ? hot_[slot_at(best_)] : nullptr;
+    }
+
+    [[nodiscard]] const_iterator begin() const noexcept {
+        return {this, best_, cold_.begin()};
+    }
+    [[nodiscard]] const_iterator end() const noexcept {
+        return {this, HOT, cold_.end()};
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return size_ == 0;
+    }
+    [[nodiscard]] std::size_t size() const noexcept {
+        return size_;
+    }
+    [[nodiscard]] std::size_t cold_size() const noexcept {
+        return cold_.size();
+    }
+
+    // Pooled levels are kept for reuse
+    void clear() noexcept {
+        bits_.fill(0);
+        summary_ = 0;
+        cold_.clear();
+        free_.clear();
+        for (Level& level : pool_) {
+            free_.push_back(&level);
+        }
+        best_ = HOT;
+        size_ = 0;
+    }
+
+private:
+    // Lower is better on both sides
+    static std::int64_t rank(Price price) noexcept {
+        return Descending ? -price : price;
+    }
+    static std::size_t slot_of(std::int64_t rank) noexcept {
+        return static_cast<std::size_t>(rank) & MASK;
+    }
+    std::size_t slot_at(std::size_t offset) const noexcept {
+        return (slot_of(low_) + offset) & MASK;
+    }
+
+    bool test_bit(std::size_t slot) const noexcept {
+        return bits_[slot / 64] >> (slot % 64) & 1;
+    }
+    void set_bit(std::size_t slot) noexcept {
+        bits_[slot / 64] |= std::uint64_t{1} << (slot % 64);
+        summary_ |= std::uint64_t{1} << (slot / 64);
+    }
+    void clear_bit(std::size_t slot) noexcept {
+        bits_[slot / 64] &= ~(std::uint64_t{1} << (slot % 64));
+        if (bits_[slot / 64] == 0) {
+            summary_ &= ~(std::uint64_t{1} << (slot / 64));
+        }
+    }
+    // First occupied slot in [slot, HOT), or HOT
+    std::size_t first_set(std::size_t slot) const noexcept {
+        const std::size_t word = slot / 64;
+        if (const std::uint64_t bits = bits_[word] & (~std::uint64_t{0} << (slot % 64))) {
+            return word * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+        }
+        if (word + 1 < WORDS) {
+            if (const std::uint64_t words = summary_ & (~std::uint64_t{0} << (word + 1))) {
+                const auto next = static_cast<std::size_t>(std::countr_zero(words));
+                return next * 64 + static_cast<std::size_t>(std::countr_zero(bits_[next]));
+            }
+        }
+        return HOT;
+    }
+    // Window offset of the first level at or behind offset, or HOT. Walking the ring
+    // from that slot meets the rest of the window and then wraps to its front.
+    std::size_t next_offset(std::size_t offset) const noexcept {
+        if (offset >= HOT) {
+            return HOT;
+        }
+        const std::size_t base = slot_of(low_);
+        const std::size_t start = (base + offset) & MASK;
+        std::size_t slot = first_set(start);
+        if (slot == HOT && start > 0) {
+            slot = first_set(0);
+            slot = slot < start ? slot : HOT;
+        }
+        if (slot == HOT) {
+            return HOT;
+        }
+        const std::size_t found = (slot - base) & MASK;
+        return found >= offset ? found : HOT;
+    }
+
+    Level* lookup(Price price) const noexcept {
+        const std::int64_t r = rank(price);
+        if (r < low_) {
+            return nullptr;
+        }
+        if (r - low_ < static_cast<std::int64_t>(HOT)) {
+            const std::size_t slot = slot_of(r);
+            return test_bit(slot) ? hot_[slot] : nullptr;
+        }
+        const auto it = cold_.find(price);
+        return it == cold_.end() ? nullptr : it->second;
+    }
+
+    // Move the window to start at low; nothing rests better than low
+    void recenter(std::int64_t low) {
+        const std::int64_t end = low + static_cast<std::int64_t>(HOT);
+        if (end < low_ + static_cast<std::int64_t>(HOT)) {
+            // Hot levels now behind the window go cold; they are better than every cold
+            // level, so each goes in just after the previous one
+            auto hint = cold_.begin();
+            const std::int64_t keep = end - low_;
+            for (std::size_t offset = next_offset(keep > 0 ? static_cast<std::size_t>(keep) : 0); offset < HOT;
+                 offset = next_offset(offset + 1)) {
+                const std::size_t slot = slot_at(offset);
+                hint = std::next(cold_.emplace_hint(hint, hot_[slot]->price, hot_[slot]));
+                clear_bit(slot);
+            }
+        }
+        low_ = low;
+        while (!cold_.empty() && rank(cold_.begin()->first) < end) {
+            const std::size_t slot = slot_of(rank(cold_.begin()->first));
+            hot_[slot] = cold_.begin()->second;
+            set_bit(slot);
+            cold_.erase(cold_.begin());
+        }
+        best_ = next_offset(0);
+    }
+
+    std::vector<Level*> hot_;  // By slot, valid where the bit is set
+    std::array<std::uint64_t, WORDS> bits_{};
+    std::uint64_t summary_{0};  // Bit w set when bits_[w] is non-zero
+    std::int64_t low_{0};       // Rank of window offset 0
+    std::size_t best_{HOT};     // Window offset of the best level, HOT when empty
+    ColdLevels cold_;
+    std::deque<Level> pool_;    // Never moves its elements
+    std::vector<Level*> free_;
+    std::size_t size_{0};
+};
+
+} // namespace lob
@@ -0,0 +1,252 @@
+#pragma once
+
+#include "engine_observer.hpp"
+#include "matching_engine.hpp"
+#include "types.hpp"
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lob {
+
+namespace mdp {
+
+// UDP market-data packets, little-endian with no padding like the wire protocol
+// A packet is a PacketHeader followed by count fixed-size Entries. Each channel
+// numbers its packets from 1. Incremental packets carry level changes and trades
+// in engine order; a snapshot is one or more packets (SnapshotBegin on the first,
+// SnapshotEnd on the last) holding every level of the book as of incremental
+// packet incremental_seq, so a receiver applies the incrementals after it.
+// Lost incrementals can also be fetched again from a RetransmissionServer.
+
+static_assert(std::endian::native == std::endian::little, "Packet structs are copied as-is");
+
+enum class Channel : std::uint8_t {
+    Incremental = 1,
+    Snapshot = 2,
+    RetransmitEnd = 3  // Header only: ends a retransmission, sequence = first packet not sent
+};
+
+enum PacketFlags : std::uint8_t {
+    SnapshotBegin = 1,
+    SnapshotEnd = 2
+};
+
+enum class EntryType : std::uint8_t {
+    Level = 1,  // Aggregate quantity at side/price; 0 removes the level
+    Trade = 2   // side is the aggressor unless NoAggressor is set
+};
+
+enum EntryFlags : std::uint8_t {
+    NoAggressor = 1  // Auction uncross fill
+};
+
+struct PacketHeader {
+    std::uint64_t sequence;         // Per channel, from 1
+    std::uint64_t incremental_seq;  // Snapshot: last incremental packet it reflects
+    std::uint16_t length;           // Whole packet, header included
+    std::uint16_t count;            // Entries that follow
+    Channel channel;
+    std::uint8_t flags;
+    std::uint8_t reserved[2];
+};
+
+struct Entry {
+    Price price;
+    Quantity quantity;
+    EntryType type;
+    Side side;
+    std::uint8_t flags;
+    std::uint8_t reserved[5];
+};
+
+// Unicast datagram asking a RetransmissionServer for incremental packets
+struct RetransmitRequest {
+    std::uint64_t first;  // Sequence of the first packet wanted
+    std::uint32_t count;
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(PacketHeader) == 24);
+static_assert(sizeof(Entry) == 24);
+static_assert(sizeof(RetransmitRequest) == 16);
+
+// Largest UDP payload that fits a 1500-byte Ethernet MTU without fragmentation
+inline constexpr std::size_t DEFAULT_PACKET_SIZE = 1500 - 20 - 8;
+
+} // namespace mdp
+
+class PacketHistory;
+
+struct MarketDataOptions {
+    std::string incremental_group{"239.255.0.1"};
+    std::uint16_t incremental_port{30001};
+    std::string snapshot_group{"239.255.0.2"};
+    std::uint16_t snapshot_port{30002};
+    std::string interface{"127.0.0.1"};  // Local address multicast is sent from and joined on
+    std::uint8_t ttl{1};
+    std::size_t packet_size{mdp::DEFAULT_PACKET_SIZE};
+    // Send a snapshot after this many engine messages; 0 leaves it to publish_snapshot()
+    std::uint64_t snapshot_interval{0};
+};
+
+// Observer publishing the engine's book over UDP multicast
+// Level changes and trades are appended to the open incremental packet as they
+// happen; a packet goes out when the next entry would not fit in packet_size, or
+// on flush(), which the owner calls once per event-loop turn. Snapshots flush the
+// incremental packet first so their incremental_seq is exact. Sends are
+// fire-and-forget: a datagram the kernel refuses is counted and not retried, which
+// receivers see as a sequence gap and repair from the next snapshot.
+class MarketDataPublisher : public EngineObserver {
+public:
+    using Options = MarketDataOptions;
+
+    // nullptr if the socket cannot be set up or an address does not parse
+    [[nodiscard]] static std::unique_ptr<MarketDataPublisher> create(MatchingEngine& engine,
+                                                                     const Options& options = {});
+    ~MarketDataPublisher() override;
+
+    MarketDataPublisher(const MarketDataPublisher&) = delete;
+    MarketDataPublisher& operator=(const MarketDataPublisher&) = delete;
+
+    void on_trade(const Trade& trade) override;
+    void on_level_updates(std::span<const LevelUpdate> updates) override;
+    void on_message_processed(const OrderBook& book) override;
+
+    // Send the open incremental packet, if it has entries
+    void flush();
+    // Flush, then send every level of the book on the snapshot channel
+    void publish_snapshot();
+    // Keep every incremental packet sent from now on in history for retransmission
+    // (not owned; nullptr stops it)
+    void set_history(PacketHistory* history) noexcept {
+        history_ = history;
+    }
+
+    [[nodiscard]] std::uint64_t incremental_seq() const noexcept {
+        return incremental_seq_;
+    }
+    [[nodiscard]] std::uint64_t snapshot_seq() const noexcept {
+        return snapshot_seq_;
+    }
+    [[nodiscard]] std::uint64_t packets_sent() const noexcept {
+        return packets_sent_;
+    }
+    [[nodiscard]] std::uint64_t send_errors() const noexcept {
+        return send_errors_;
+    }
+
+private:
+    // Group addresses in network byte order
+    MarketDataPublisher(MatchingEngine& engine, const Options& options, int fd,
+                        std::uint32_t incremental_group, std::uint32_t snapshot_group);
+
+    void append(const mdp::Entry& entry);
+    void send(std::vector<std::byte>& packet, std::uint16_t count, mdp::Channel channel,
+              std::uint64_t sequence, std::uint8_t flags);
+    void send_snapshot_packet(std::uint16_t count, std::uint8_t flags);
+
+    MatchingEngine& engine_;
+    PacketHistory* history_{nullptr};
+    int fd_;
+    std::uint32_t incremental_group_;  // Network byte order, like the ports
+    std::uint16_t incremental_port_;
+    std::uint32_t snapshot_group_;
+    std::uint16_t snapshot_port_;
+    std::size_t max_entries_;
+    std::uint64_t snapshot_interval_;
+    std::uint64_t messages_since_snapshot_{0};
+
+    std::vector<std::byte> incremental_;  // Open packet; header filled in on send
+    std::uint16_t incremental_count_{0};
+    std::vector<std::byte> snapshot_;
+    std::uint64_t incremental_seq_{0};
+    std::uint64_t snapshot_seq_{0};
+    std::uint64_t packets_sent_{0};
+    std::uint64_t send_errors_{0};
+};
+
+// Reference receiver: rebuilds the L2 book from a MarketDataPublisher's groups
+// Until it is synced, incremental packets are buffered; the first complete
+// snapshot seeds the book and the buffered packets after its incremental_seq are
+// replayed. After an incremental gap the book is held at the last packet applied
+// and later packets are buffered; missing() names the lost range, so retransmitted
+// packets fed to handle_packet() close it, or else the next snapshot resyncs.
+// handle_packet() holds the logic, so it can also be driven without sockets.
+class MarketDataReceiver {
+public:
+    static constexpr std::size_t MAX_BUFFERED = 4096;  // Incremental packets kept while unsynced
+
+    // nullptr if the sockets cannot bind or join the groups
+    [[nodiscard]] static std::unique_ptr<MarketDataReceiver> create(const MarketDataOptions& options = {});
+    MarketDataReceiver();
+    ~MarketDataReceiver();
+
+    MarketDataReceiver(const MarketDataReceiver&) = delete;
+    MarketDataReceiver& operator=(const MarketDataReceiver&) = delete;
+
+    // Wait up to timeout for datagrams and handle all that are queued; returns packets read
+    std::size_t poll(std::chrono::milliseconds timeout);
+    // false if the packet is malformed
+    bool handle_packet(std::span<const std::byte> packet);
+
+    // The book is current: seeded and with no gap outstanding
+    [[nodiscard]] bool synced() const noexcept {
+        return synced_;
+    }
+    // Incremental packets lost after the last one applied, as [first, last]
+    [[nodiscard]] std::optional<std::pair<std::uint64_t, std::uint64_t>> missing() const noexcept;
+    // Last incremental packet applied to the book
+    [[nodiscard]] std::uint64_t incremental_seq() const noexcept {
+        return incremental_seq_;
+    }
+    [[nodiscard]] std::uint64_t gaps() const noexcept {
+        return gaps_;
+    }
+    [[nodiscard]] std::uint64_t trades() const noexcept {
+        return trades_;
+    }
+    [[nodiscard]] Quantity traded_quantity() const noexcept {
+        return traded_quantity_;
+    }
+    // Levels from the best price, as OrderBook::get_levels
+    [[nodiscard]] std::vector<std::pair<Price, Quantity>> get_levels(Side side, std::size_t n = SIZE_MAX) const;
+
+private:
+    MarketDataReceiver(int incremental_fd, int snapshot_fd);
+
+    void apply(std::span<const mdp::Entry> entries);
+    void handle_snapshot(const mdp::PacketHeader& header, std::span<const mdp::Entry> entries);
+    void handle_incremental(const mdp::PacketHeader& header, std::span<const mdp::Entry> entries,
+                            std::span<const std::byte> packet);
+    void replay_buffered();
+
+    int incremental_fd_{-1};
+    int snapshot_fd_{-1};
+    std::map<Price, Quantity, std::greater<>> bids_;
+    std::map<Price, Quantity> asks_;
+
+    bool seeded_{false};  // The book reflects incremental_seq_
+    bool synced_{false};
+    std::uint64_t incremental_seq_{0};
+    std::uint64_t gaps_{0};
+    std::uint64_t trades_{0};
+    Quantity traded_quantity_{0};
+    std::map<std::uint64_t, std::vector<std::byte>> buffered_;  // Incremental packets by sequence, while unsynced
+
+    // Snapshot being assembled
+    bool assembling_{false};
+    std::uint64_t snapshot_next_{0};  // Snapshot sequence expected next
+    std::vector<mdp::Entry> snapshot_entries_;
+};
+
+} // namespace lob
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "engine_observer.hpp"
+#include "seqlock.hpp"
+#include "types.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace lob {
+
+// Signal values as of the last engine message, published one cache line apart from the writer's state
+struct alignas(64) MarketSignalSnapshot {
+    std::uint64_t sequence{0};  // Engine messages observed
+    Price best_bid{0};          // 0 when that side is empty
+    Price best_ask{0};
+    Quantity bid_quantity{0};
+    Quantity ask_quantity{0};
+    double imbalance{0.0};             // (bid - ask) / (bid + ask) quantity at the touch, in [-1, 1]
+    double microprice{0.0};            // Touch prices weighted by the opposite side's quantity
+    double vwap{0.0};                  // Over the rolling trade window
+    double trade_flow_imbalance{0.0};  // (buy - sell) aggressor volume / window volume, in [-1, 1]
+    Quantity window_volume{0};
+};
+
+// Opt-in analytics attached with engine.add_observer(&signals)
+// Maintains the touch from level batches (re-reading the book only when the best level
+// is emptied) and the rolling window from trades, each in O(1) per event. Window trades
+// are kept in a preallocated ring; the window is measured in trade time and the oldest
+// trade is also dropped when the ring is full. One snapshot is published per message
+// that changed anything; snapshot() may be called from any thread.
+class MarketSignals : public EngineObserver {
+public:
+    static constexpr std::size_t DEFAULT_WINDOW_TRADES = 4096;
+
+    explicit MarketSignals(Timestamp window, std::size_t max_window_trades = DEFAULT_WINDOW_TRADES);
+
+    void on_trade(const Trade& trade) override;
+    void on_level_updates(std::span<const LevelUpdate> updates) override;
+    void on_message_processed(const OrderBook& book) override;
+
+    [[nodiscard]] MarketSignalSnapshot snapshot() const noexcept {
+        return published_.load();
+    }
+    [[nodiscard]] bool try_snapshot(MarketSignalSnapshot& out) const noexcept {
+        return published_.try_load(out);
+    }
+
+private:
+    struct WindowTrade {
+        Timestamp timestamp;
+        Notional notional;
+        Quantity quantity;
+        std::int64_t flow;  // Signed by aggressor side, 0 for auction fills
+    };
+
+    void evict_before(Timestamp cutoff) noexcept;
+    void pop_oldest() noexcept;
+    void recompute() noexcept;
+
+    Timestamp window_;
+    std::vector<WindowTrade> ring_;
+    std::size_t head_{0};
+    std::size_t count_{0};
+    Notional window_notional_{0};
+    Quantity window_volume_{0};
+    std::int64_t window_flow_{0};
+
+    bool bid_stale_{false};
+    bool ask_stale_{false};
+    bool changed_{false};
+    MarketSignalSnapshot current_;
+    SeqLock<MarketSignalSnapshot> published_;
+};
+
+} // namespace lob
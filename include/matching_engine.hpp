@@ -1,22 +1,156 @@
 #pragma once
 
 #include "order_book.hpp"
+#include "auction_curves.hpp"
+#include "allocation_policy.hpp"
+#include "engine_observer.hpp"
 #include "types.hpp"
+#include <chrono>
 #include <vector>
 #include <functional>
+#include <optional>
+#include <span>
 
 namespace lob {
 
-class MatchingEngine {
+// The steady clock engines run on unless pinned (see pin_clock())
+[[nodiscard]] inline Timestamp steady_time() noexcept {
+    return std::chrono::duration_cast<Timestamp>(std::chrono::steady_clock::now().time_since_epoch());
+}
+// Steady-clock reading of a wall-clock time (nanoseconds since the epoch), for times
+// set by clients, which cannot see the engine's clock
+[[nodiscard]] inline Timestamp steady_from_wall(std::int64_t wall) noexcept {
+    const auto now = std::chrono::duration_cast<Timestamp>(std::chrono::system_clock::now().time_since_epoch());
+    return steady_time() + (Timestamp{wall} - now);
+}
+
+// Engine state outside the book that decides how later commands execute
+struct EngineState {
+    SessionState session_state{SessionState::Continuous};
+    SelfTradePrevention self_trade_prevention{SelfTradePrevention::None};
+    std::optional<Price> reference_price;
+    std::optional<Price> last_trade_price;
+    Timestamp session_close{0};
+};
+
+// Matching engine for one book; AllocationPolicy (see allocation_policy.hpp)
+// decides how fills are shared within a price level
+template<typename AllocationPolicy>
+class BasicMatchingEngine {
 public:
     using TradeCallback = std::function<void(const Trade&)>;
     
-    explicit MatchingEngine(TradeCallback trade_callback = nullptr);
+    // Expirations processed ahead of each inbound command (bounds expiry-storm latency)
+    static constexpr std::size_t DEFAULT_EXPIRY_BATCH = 64;
+    
+    explicit BasicMatchingEngine(TradeCallback trade_callback = nullptr,
+                                 AllocationPolicy policy = {});
     
     [[nodiscard]] OrderStatus submit_order(OrderId id, Side side, OrderType type,
                                            Price price, Quantity quantity);
+    // Day orders expire at the session close; GTT orders at expire_time.
+    // Time in force only applies to resting limit orders.
+    // participant tags the order for self-trade prevention.
+    [[nodiscard]] OrderStatus submit_order(OrderId id, Side side, OrderType type,
+                                           Price price, Quantity quantity,
+                                           TimeInForce tif, Timestamp expire_time = Timestamp{0},
+                                           ParticipantId participant = NO_PARTICIPANT);
     [[nodiscard]] bool cancel_order(OrderId id);
     [[nodiscard]] bool modify_order(OrderId id, Price new_price, Quantity new_quantity);
+    
+    // Call auction: between start_auction() and uncross() orders rest without matching
+    // (only limit orders are accepted). Ties on volume are broken by smallest surplus,
+    // then by distance to the reference price (or last trade price), then lower price.
+    void start_auction() noexcept {
+        session_state_ = SessionState::Auction;
+    }
+    [[nodiscard]] SessionState session_state() const noexcept {
+        return session_state_;
+    }
+    void set_reference_price(Price price) noexcept {
+        reference_price_ = price;
+        indicative_version_ = UINT64_MAX;  // Tie-break input of the cached uncross
+    }
+    // Indicative price/volume. The first call of a call period sets up demand and supply
+    // curves that then follow every book change, so later calls cost O(log n) in the width
+    // of the crossing range rather than a walk over its levels (a range too wide for
+    // AuctionCurves falls back to that walk). Cached until the book or the reference price changes.
+    [[nodiscard]] std::optional<AuctionUncross> indicative_uncross();
+    // Execute all fills at the equilibrium price in one batch and resume continuous trading
+    std::optional<AuctionUncross> uncross();
+    [[nodiscard]] std::optional<Price> last_trade_price() const noexcept {
+        return last_trade_price_;
+    }
+    
+    // Cancel-on-disconnect / kill switch; returns number of orders cancelled
+    std::size_t mass_cancel(ParticipantId participant);
+    std::size_t mass_cancel(ParticipantId participant, Side side);
+    std::size_t mass_cancel(ParticipantId participant, Side side, Price min_price, Price max_price);
+    
+    // Session close used as the expiry of Day orders (Day orders are rejected until set)
+    void set_session_close(Timestamp close) noexcept {
+        session_close_ = close;
+    }
+    void set_expiry_batch_limit(std::size_t limit) noexcept {
+        expiry_batch_limit_ = limit;
+    }
+    // Expiries, GTT checks and trade timestamps read the steady clock, or time while
+    // pinned; a replica pinned to the primary's time of each command expires the same
+    // orders as the primary
+    void pin_clock(Timestamp time) noexcept {
+        pinned_clock_ = time;
+    }
+    void unpin_clock() noexcept {
+        pinned_clock_.reset();
+    }
+    // Applies to orders of the same (non-zero) participant meeting in the matching loop
+    void set_self_trade_prevention(SelfTradePrevention mode) noexcept {
+        stp_mode_ = mode;
+    }
+    [[nodiscard]] SelfTradePrevention self_trade_prevention() const noexcept {
+        return stp_mode_;
+    }
+    // Captured with the book in snapshots, restored into a fresh engine
+    [[nodiscard]] EngineState engine_state() const noexcept {
+        return EngineState{
+            .session_state = session_state_,
+            .self_trade_prevention = stp_mode_,
+            .reference_price = reference_price_,
+            .last_trade_price = last_trade_price_,
+            .session_close = session_close_
+        };
+    }
+    void restore_engine_state(const EngineState& state) noexcept {
+        session_state_ = state.session_state;
+        stp_mode_ = state.self_trade_prevention;
+        reference_price_ = state.reference_price;
+        last_trade_price_ = state.last_trade_price;
+        session_close_ = state.session_close;
+        indicative_version_ = UINT64_MAX;
+        if (session_state_ != SessionState::Auction) {
+            order_book_.auction_curves_.deactivate();
+        }
+    }
+    // Expire at most max_batch due orders; returns number expired (0 once caught up)
+    std::size_t expire_orders(Timestamp now, std::size_t max_batch = DEFAULT_EXPIRY_BATCH) {
+        MessageScope scope(*this);
+        return order_book_.expire_orders(now, max_batch);
+    }
+    
+    // Participant ids for a front end's sessions, [first, first + count): never handed out
+    // twice, so front ends sharing the engine do not route, cancel or self-trade-match
+    // each other's orders
+    [[nodiscard]] ParticipantId reserve_participants(std::size_t count) noexcept {
+        const ParticipantId first = next_participant_;
+        next_participant_ += static_cast<ParticipantId>(count);
+        return first;
+    }
+    
+    // Observers see trades, level batches and message boundaries (not owned; must outlive
+    // the engine or be removed). Costs nothing per message while none are attached.
+    void add_observer(EngineObserver* observer);
+    void remove_observer(EngineObserver* observer);
+    
     [[nodiscard]] const OrderBook& get_order_book() const noexcept {
         return order_book_;
     }
@@ -28,20 +162,98 @@ public:
         trades_.swap(result);
         return result;
     }
+    // Keep trades for get_trades()/trades(); off by default, so an engine whose trades
+    // nobody drains (behind a gateway) does not grow
+    void set_keep_trades(bool keep) noexcept {
+        keep_trades_ = keep;
+    }
+    // Trades kept since the last get_trades() or clear_trades(), oldest first
+    [[nodiscard]] std::span<const Trade> trades() const noexcept {
+        return trades_;
+    }
+    // Drop the kept trades but not their storage, so steady-state replay does not allocate
+    void clear_trades() noexcept {
+        trades_.clear();
+    }
     
 private:
+    // Marks one inbound message; declared ahead of the UpdateBatch so observers are
+    // notified after the level batch has been flushed
+    class MessageScope {
+    public:
+        explicit MessageScope(BasicMatchingEngine& engine) noexcept : engine_(engine) {}
+        ~MessageScope() {
+            for (EngineObserver* observer : engine_.observers_) {
+                observer->on_message_processed(engine_.order_book_);
+            }
+        }
+        MessageScope(const MessageScope&) = delete;
+        MessageScope& operator=(const MessageScope&) = delete;
+    private:
+        BasicMatchingEngine& engine_;
+    };
+    
     void match_order(Order* order);
     void match_limit_order(Order* order);
     void match_market_order(Order* order);
     void match_ioc_order(Order* order);
     void match_fok_order(Order* order);
     
-    void execute_trade(Order* buy_order, Order* sell_order, Price price, Quantity quantity);
+    // Shared matching kernel, specialized per aggressor side and on whether STP is active
+    void match_against_book(Order* order, bool price_limited);
+    template<Side AggressorSide, bool SelfTradeCheck>
+    void match_side(Order* order, bool price_limited);
+    // Applies stp_mode_; returns false when the aggressor can no longer trade
+    bool prevent_self_trade(Order* order, Order* resting);
+    // Pro-rata fill of one level starting at first; returns false when the aggressor must stop
+    template<Side AggressorSide, bool SelfTradeCheck>
+    bool allocate_level(Order* order, Order* first, Price match_price);
+    // Trade quantity against one resting order and settle its level/removal
+    template<Side AggressorSide>
+    void fill_resting(Order* order, Order* resting, Price match_price, Quantity quantity);
+    
+    void execute_trade(Order* buy_order, Order* sell_order, Price price, Quantity quantity,
+                       std::optional<Side> aggressor);
+    void process_due_expiries();
+    [[nodiscard]] Timestamp clock() const noexcept;
+    std::optional<AuctionUncross> compute_uncross();
+    std::optional<AuctionUncross> scan_uncross(Price best_bid, Price best_ask);
     
     OrderBook order_book_;
     std::vector<Trade> trades_;
+    bool keep_trades_{false};
     TradeCallback trade_callback_;
+    std::vector<EngineObserver*> observers_;
+    AllocationPolicy policy_;
+    Timestamp session_close_{0};
+    std::size_t expiry_batch_limit_{DEFAULT_EXPIRY_BATCH};
+    std::optional<Timestamp> pinned_clock_;
+    ParticipantId next_participant_{1};
+    SelfTradePrevention stp_mode_{SelfTradePrevention::None};
+    
+    SessionState session_state_{SessionState::Continuous};
+    std::optional<Price> reference_price_;
+    std::optional<Price> last_trade_price_;
+    // Cached indicative uncross, valid while the book version is unchanged
+    std::optional<AuctionUncross> indicative_;
+    std::uint64_t indicative_version_{UINT64_MAX};
+    // Reused per-price scratch (ascending price) for scan_uncross
+    std::vector<Price> auction_prices_;
+    std::vector<Quantity> auction_bids_;
+    std::vector<Quantity> auction_asks_;
+    std::vector<std::pair<Price, Quantity>> auction_bid_levels_;  // Crossing bids, best first
+    // Reused per-order scratch for pro-rata allocation (grows, never shrinks)
+    std::vector<Order*> level_orders_;
+    std::vector<Quantity> level_quantities_;
 };
 
+extern template class BasicMatchingEngine<FifoAllocation>;
+extern template class BasicMatchingEngine<ProRataAllocation>;
+extern template class BasicMatchingEngine<TopOrderProRataAllocation>;
+
+using MatchingEngine = BasicMatchingEngine<FifoAllocation>;
+using ProRataMatchingEngine = BasicMatchingEngine<ProRataAllocation>;
+using TopOrderProRataMatchingEngine = BasicMatchingEngine<TopOrderProRataAllocation>;
+
 } // namespace lob
 
@@ -2,18 +2,32 @@
 
 #include "types.hpp"
 #include "allocator/slab_allocator.hpp"
+#include "timing_wheel.hpp"
+#include "fenwick_tree.hpp"
+#include "level_store.hpp"
+#include "auction_curves.hpp"
+#include <array>
 #include <map>
 #include <unordered_map>
 #include <vector>
 #include <optional>
 #include <functional>
+#include <span>
 #include <source_location>  // C++23: std::source_location
 
 namespace lob {
 
+template<typename AllocationPolicy>
+class BasicMatchingEngine;
+
 class OrderBook {
 public:
     using TradeCallback = std::function<void(const Trade&)>;
+    // Receives every level changed by one book operation (or one engine command) as a single batch
+    using LevelUpdateCallback = std::function<void(std::span<const LevelUpdate>)>;
+    
+    // Resolution of the GTT/Day expiry wheel
+    static constexpr Timestamp EXPIRY_TICK = std::chrono::milliseconds(1);
     
     explicit OrderBook(TradeCallback trade_callback = nullptr);
     ~OrderBook();
@@ -26,6 +40,9 @@ public:
     
     [[nodiscard]] bool add_order(OrderId id, Side side, OrderType type, 
                                   Price price, Quantity quantity,
+                                  TimeInForce tif = TimeInForce::GTC,
+                                  Timestamp expire_time = Timestamp{0},
+                                  ParticipantId participant = NO_PARTICIPANT,
                                   std::source_location loc = std::source_location::current());
     
     [[nodiscard]] bool cancel_order(OrderId id);
@@ -33,29 +50,119 @@ public:
     [[nodiscard]] std::optional<Price> best_bid() const noexcept;
     [[nodiscard]] std::optional<Price> best_ask() const noexcept;
     [[nodiscard]] std::optional<Price> spread() const noexcept;
+    // Best price on side with its aggregate quantity
+    [[nodiscard]] std::optional<std::pair<Price, Quantity>> top_level(Side side) const noexcept;
     [[nodiscard]] Quantity depth_at_price(Side side, Price price) const noexcept;
     [[nodiscard]] std::vector<std::pair<Price, Quantity>> 
     get_levels(Side side, std::size_t n = 10) const;
+    // Visit up to n levels from the best price as f(price, quantity), without copying
+    template<typename F>
+    void for_each_level(Side side, std::size_t n, F&& f) const {
+        auto visit = [n, &f](const auto& levels) {
+            std::size_t count = 0;
+            for (auto it = levels.begin(); it != levels.end() && count < n; ++it, ++count) {
+                f(it->price, it->total_quantity);
+            }
+        };
+        side == Side::Buy ? visit(bid_levels_) : visit(ask_levels_);
+    }
     [[nodiscard]] const Order* get_order(OrderId id) const noexcept;
+    // Visit every resting order in priority order: bids from the best price, then asks,
+    // each level oldest first (the order restore_order() rebuilds queues in)
+    template<typename F>
+    void for_each_order(F&& f) const {
+        auto visit = [&f](const auto& levels) {
+            for (const PriceLevel& level : levels) {
+                for (const Order* order = level.first_order; order; order = order->next) {
+                    f(*order);
+                }
+            }
+        };
+        visit(bid_levels_);
+        visit(ask_levels_);
+    }
+    
+    // Cost of an aggressor on side sweeping the opposite levels from the best price,
+    // walked in place without copying; stops at quantity, or at what budget can buy
+    [[nodiscard]] SweepCost sweep_cost(Side side, Quantity quantity) const noexcept;
+    [[nodiscard]] SweepCost sweep_cost_notional(Side side, Notional budget) const noexcept;
+    // Quantity resting ahead of a live order at its price, O(log n) in the level's queue length
+    [[nodiscard]] std::optional<QueuePosition> queue_position(OrderId id) const noexcept;
     [[nodiscard]] std::size_t order_count() const noexcept {
         return orders_.size();
     }
     void clear();
+    
+    // Cancel at most max_batch Day/GTT orders whose expire_time is <= now
+    // Bounded so that expiry storms can be spread across inbound commands
+    std::size_t expire_orders(Timestamp now, std::size_t max_batch);
+    [[nodiscard]] std::size_t pending_expiries() const noexcept {
+        return expiry_wheel_.size();
+    }
+    
+    // Mass cancel via the per-participant order lists; cost is proportional to the
+    // orders removed (the price-range variant visits the participant's orders on that side)
+    std::size_t cancel_all(ParticipantId participant);
+    std::size_t cancel_side(ParticipantId participant, Side side);
+    std::size_t cancel_price_range(ParticipantId participant, Side side,
+                                   Price min_price, Price max_price);
+    
+    // Incremented on every level change; cheap staleness check for derived views
+    [[nodiscard]] std::uint64_t version() const noexcept {
+        return version_;
+    }
+    // Order-independent hash of the resting orders (id, side, price, remaining quantity
+    // and arrival number), kept up to date in O(1) per change. Books that executed the
+    // same commands from empty hash equal, so a replica or a replay is checked with one
+    // compare; level_hash() narrows a mismatch down to a price (0 for an empty level).
+    [[nodiscard]] std::uint64_t state_hash() const noexcept {
+        return state_hash_;
+    }
+    [[nodiscard]] std::uint64_t level_hash(Side side, Price price) const noexcept;
+    
+    // Snapshot restore: re-create a resting order captured from another book at the back
+    // of its level, keeping its fill and arrival number, without matching. Restoring a
+    // for_each_order() walk and then its next_arrival() gives the same state_hash().
+    [[nodiscard]] bool restore_order(const Order& order);
+    [[nodiscard]] std::uint32_t next_arrival() const noexcept {
+        return next_arrival_;
+    }
+    void set_next_arrival(std::uint32_t arrival) noexcept {
+        next_arrival_ = arrival;
+    }
+    // Expiry ticks count from the book's creation, and earlier times all share the first
+    // tick. A restore replaying times from before then moves the origin back to its
+    // earliest; false unless the book is empty.
+    bool set_expiry_origin(Timestamp origin) noexcept;
+    
+    void set_level_update_callback(LevelUpdateCallback callback) {
+        level_update_callback_ = std::move(callback);
+    }
     [[nodiscard]] Order* get_first_order_at_price(Side side, Price price) noexcept;
     void remove_order_from_level(Order* order);
     void remove_filled_order(Order* order);
     void update_price_level_quantity_incremental(Order* order, Quantity old_remaining);
     
-    friend class MatchingEngine;
+    template<typename AllocationPolicy>
+    friend class BasicMatchingEngine;
     
 private:
     // Price level maintains a doubly-linked list of orders at the same price
     // Orders are added to the tail (FIFO) to maintain time priority
+    // A Fenwick tree over arrival slots holds each order's remaining quantity, so the
+    // quantity ahead of any order is a prefix sum. Slots are handed out in arrival order
+    // and never reused; when they run out the live orders are renumbered in list order.
     struct PriceLevel {
         Price price;
         Quantity total_quantity{0};  // Sum of remaining quantities at this price
         Order* first_order{nullptr};  // Head of FIFO queue (oldest order)
         Order* last_order{nullptr};  // Tail of FIFO queue (newest order)
+        std::uint64_t update_epoch{0};  // Batch this level last reported in
+        std::uint32_t update_index{0};  // Position of that report in pending_updates_
+        std::uint32_t order_count{0};
+        std::uint32_t next_slot{0};
+        std::uint64_t hash{0};  // Sum of hash_order() over the queue
+        FenwickTree<Quantity> queue;  // Remaining quantity by arrival slot
         
         // Add order to tail of linked list (maintains FIFO ordering)
         void add_order(Order* order) {
@@ -68,6 +175,15 @@ private:
             }
             last_order = order;
             total_quantity += order->remaining();
+            hash += hash_order(*order, order->remaining());
+            ++order_count;
+            
+            if (next_slot == queue.capacity()) {
+                compact_queue();
+            } else {
+                order->queue_slot = next_slot++;
+                queue.add(order->queue_slot, order->remaining());
+            }
         }
         
         // Remove order from linked list (O(1) operation)
@@ -83,13 +199,26 @@ private:
                 last_order = order->prev;  // Was tail
             }
             total_quantity -= order->remaining();
+            hash -= hash_order(*order, order->remaining());
+            --order_count;
+            queue.add(order->queue_slot, Quantity{0} - order->remaining());
         }
         
         // Efficiently update total quantity when an order's remaining qty changes
         void update_quantity(Order* order, Quantity old_remaining) {
             total_quantity = total_quantity - old_remaining + order->remaining();
+            hash += hash_order(*order, order->remaining()) - hash_order(*order, old_remaining);
+            queue.add(order->queue_slot, order->remaining() - old_remaining);
+        }
+        
+        [[nodiscard]] Quantity quantity_ahead(const Order* order) const noexcept {
+            return queue.prefix_sum(order->queue_slot);
         }
         
+        // Renumber live orders 0..n-1 in list order and rebuild the tree with room to grow.
+        // Amortized O(1) per add: at least order_count adds happen between compactions.
+        void compact_queue();
+        
         // Recalculate total quantity by walking the list (used for validation/debugging)
         // TODO: Consider removing if not needed, or add validation flag
         void update_order_quantity() {
@@ -104,25 +233,101 @@ private:
         [[nodiscard]] bool empty() const noexcept {
             return first_order == nullptr;
         }
+        
+        // Empty level at a new price, keeping the queue's storage (LevelStore reuses levels)
+        void reset(Price level_price) {
+            price = level_price;
+            total_quantity = 0;
+            first_order = nullptr;
+            last_order = nullptr;
+            update_epoch = 0;
+            update_index = 0;
+            order_count = 0;
+            next_slot = 0;
+            hash = 0;
+            queue.assign(queue.capacity());
+        }
     };
     
-    // Bid levels: descending order (highest price first) using std::greater
-    // Ask levels: ascending order (lowest price first) using default std::less
-    using BidLevels = std::map<Price, PriceLevel, std::greater<Price>>;
-    using AskLevels = std::map<Price, PriceLevel>;
+    // Open/close a level-update batch; the outermost scope flushes to the callback
+    class UpdateBatch {
+    public:
+        explicit UpdateBatch(OrderBook& book) noexcept : book_(book) {
+            ++book_.batch_depth_;
+        }
+        ~UpdateBatch() {
+            if (--book_.batch_depth_ == 0) {
+                book_.flush_level_updates();
+            }
+        }
+        UpdateBatch(const UpdateBatch&) = delete;
+        UpdateBatch& operator=(const UpdateBatch&) = delete;
+    private:
+        OrderBook& book_;
+    };
+    
+    // Two rounds of the splitmix64 finalizer over the fields; summing these keeps the
+    // book hash independent of the order in which changes are applied
+    static std::uint64_t hash_order(const Order& order, Quantity remaining) noexcept {
+        auto mix = [](std::uint64_t x) noexcept {
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+            return x ^ (x >> 31);
+        };
+        const std::uint64_t key = mix(order.id ^ std::uint64_t{order.arrival} << 32);
+        return mix(key ^ static_cast<std::uint64_t>(order.price) * 0x9e3779b97f4a7c15ULL ^
+                   (remaining << 1 | static_cast<std::uint64_t>(order.side)));
+    }
+    
+    // Heads of one participant's resting orders, indexed by Side
+    struct ParticipantOrders {
+        std::array<Order*, 2> head{nullptr, nullptr};
+    };
+    
+    // Bid levels: descending order (highest price first)
+    // Ask levels: ascending order (lowest price first)
+    // Levels near the touch sit in a dense window and outliers in an ordered map; see LevelStore
+    using BidLevels = LevelStore<PriceLevel, true>;
+    using AskLevels = LevelStore<PriceLevel, false>;
     
     void add_order_to_level(Order* order, PriceLevel& level);
     PriceLevel* get_price_level(Side side, Price price);
     const PriceLevel* get_price_level(Side side, Price price) const;
     
+    // Unlink order from its level, the expiry wheel and its participant list
+    void detach_order(Order* order);
+    void link_participant(Order* order);
+    void unlink_participant(Order* order);
+    template<typename Predicate>
+    std::size_t cancel_participant_side(ParticipantId participant, Side side, Predicate&& matches);
+    void record_level_update(Side side, PriceLevel& level);
+    void flush_level_updates();
+    
+    template<typename Levels, typename Take>
+    static SweepCost sweep(const Levels& levels, Take&& take) noexcept;
+    
     Timestamp get_timestamp() const noexcept;
+    std::uint64_t to_expiry_tick(Timestamp time) const noexcept;
     
     BidLevels bid_levels_;
     AskLevels ask_levels_;
     std::unordered_map<OrderId, Order*> orders_;
+    std::unordered_map<ParticipantId, ParticipantOrders> participants_;
     
     allocator::SlabAllocator<Order> allocator_;
+    TimingWheel<Order> expiry_wheel_;
+    Timestamp expiry_origin_;
     TradeCallback trade_callback_;
+    
+    AuctionCurves auction_curves_;  // Active while the engine tracks a call auction
+    LevelUpdateCallback level_update_callback_;
+    LevelUpdateCallback observer_callback_;  // Installed by the engine for its observers
+    std::vector<LevelUpdate> pending_updates_;
+    std::uint64_t update_epoch_{1};
+    std::uint64_t version_{0};
+    std::uint64_t state_hash_{0};  // Sum of the level hashes
+    std::uint32_t next_arrival_{0};
+    std::uint32_t batch_depth_{0};
 };
 
 } // namespace lob
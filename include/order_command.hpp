@@ -0,0 +1,109 @@
+#pragma once
+
+#include "order_book.hpp"
+#include "types.hpp"
+#include <cstdint>
+#include <type_traits>
+
+namespace lob {
+
+// Fixed-size records exchanged with out-of-process clients. Both are trivially
+// copyable and padding-free so they can be copied straight into rings and buffers.
+
+enum class CommandType : std::uint8_t {
+    New = 0,
+    Cancel = 1,
+    Modify = 2,  // price/quantity replace the order's (quantity includes what has filled)
+    MassCancel = 3  // Every resting order of the participant; issued by gateways on disconnect
+};
+
+struct OrderCommand {
+    std::uint64_t client_seq{0};   // Echoed in the acknowledgement
+    OrderId id{0};
+    Price price{0};
+    Quantity quantity{0};
+    std::int64_t expire_time{0};   // Nanoseconds, GTT only
+    CommandType type{CommandType::New};
+    Side side{Side::Buy};
+    OrderType order_type{OrderType::Limit};
+    TimeInForce time_in_force{TimeInForce::GTC};
+    std::uint32_t reserved{0};
+};
+
+enum class ReportType : std::uint8_t {
+    Ack = 0,  // Outcome of one command, after any fills it caused
+    Fill = 1  // One execution against an order of the receiving client
+};
+
+struct ExecutionReport {
+    std::uint64_t client_seq{0};  // Of the acknowledged command (0 for fills)
+    OrderId id{0};
+    Price price{0};               // Fill price; order price for acks
+    Quantity quantity{0};         // Fill quantity; 0 for acks
+    Quantity leaves{0};           // Quantity still resting after this report
+    ReportType type{ReportType::Ack};
+    OrderStatus status{OrderStatus::New};
+    std::uint8_t reserved[6]{};
+};
+
+static_assert(std::is_trivially_copyable_v<OrderCommand> && sizeof(OrderCommand) == 48);
+static_assert(std::is_trivially_copyable_v<ExecutionReport> && sizeof(ExecutionReport) == 48);
+
+// Whether the enum bytes of a new order are in range. Commands come from untrusted
+// memory, and the book indexes arrays by side.
+[[nodiscard]] constexpr bool valid_order_fields(Side side, OrderType order_type,
+                                                TimeInForce time_in_force) noexcept {
+    return side <= Side::Sell && order_type <= OrderType::FOK && time_in_force <= TimeInForce::GTT;
+}
+
+// Apply one decoded command to engine on behalf of participant and build its acknowledgement.
+// Cancels and modifies are only honoured for the participant's own orders.
+template<typename Engine>
+ExecutionReport execute_command(Engine& engine, const OrderCommand& command,
+                                ParticipantId participant) {
+    ExecutionReport report{.client_seq = command.client_seq, .id = command.id, .price = command.price};
+    const OrderBook& book = engine.get_order_book();
+
+    switch (command.type) {
+        case CommandType::New:
+            if (!valid_order_fields(command.side, command.order_type, command.time_in_force)) {
+                report.status = OrderStatus::Rejected;
+                break;
+            }
+            report.status = engine.submit_order(command.id, command.side, command.order_type,
+                                                command.price, command.quantity,
+                                                command.time_in_force,
+                                                Timestamp{command.expire_time}, participant);
+            break;
+        case CommandType::Cancel: {
+            const Order* order = book.get_order(command.id);
+            report.status = order && order->participant == participant && engine.cancel_order(command.id)
+                ? OrderStatus::Cancelled : OrderStatus::Rejected;
+            break;
+        }
+        case CommandType::Modify: {
+            const Order* order = book.get_order(command.id);
+            report.status = order && order->participant == participant &&
+                            engine.modify_order(command.id, command.price, command.quantity)
+                ? OrderStatus::New : OrderStatus::Rejected;
+            break;
+        }
+        case CommandType::MassCancel:
+            (void)engine.mass_cancel(participant);
+            report.status = OrderStatus::Cancelled;
+            break;
+        default:
+            report.status = OrderStatus::Rejected;
+            break;
+    }
+
+    if (const Order* order = book.get_order(command.id); order && order->participant == participant) {
+        report.leaves = order->remaining();
+        if (report.status == OrderStatus::New && order->filled_quantity > 0) {
+            report.status = OrderStatus::PartiallyFilled;
+        }
+    }
+    return report;
+}
+
+} // namespace lob
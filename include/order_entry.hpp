@@ -0,0 +1,121 @@
+#pragma once
+
+#include "engine_observer.hpp"
+#include "matching_engine.hpp"
+#include "order_command.hpp"
+#include "session_slots.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace lob {
+
+// Transport-independent half of the network gateways: per-session sequencing,
+// wire decoding into the engine and buffered encoding of execution reports.
+// A transport opens a session per connection, feeds it received bytes and
+// writes out whatever output becomes pending; everything runs on the matching
+// thread. Each session slot trades as its own participant, from a block reserved
+// from the engine, so fills are routed to the owning session and closing a
+// session cancels its resting orders. GTT expiries arrive on the wall clock and are
+// moved onto the engine's before execution.
+// With the output hold on, reports caused by command n stay buffered until
+// release(n), so nothing reaches a client before (for instance) a backup has
+// the command.
+class OrderEntrySessions : public EngineObserver {
+public:
+    // Sees every command just before it is executed, in execution order, including
+    // the MassCancel issued when a session closes; sequence counts them from 1
+    using CommandCallback = std::function<void(std::uint64_t sequence, ParticipantId, const OrderCommand&)>;
+
+    struct ProcessResult {
+        std::size_t consumed{0};  // Bytes of complete frames taken from the input
+        std::size_t commands{0};
+        bool error{false};        // Malformed frame or sequence gap; close the session
+    };
+
+    OrderEntrySessions(MatchingEngine& engine, std::size_t max_sessions);
+    ~OrderEntrySessions() override;
+
+    OrderEntrySessions(const OrderEntrySessions&) = delete;
+    OrderEntrySessions& operator=(const OrderEntrySessions&) = delete;
+
+    void set_command_callback(CommandCallback callback) {
+        command_callback_ = std::move(callback);
+    }
+
+    // std::nullopt when every slot is in use
+    [[nodiscard]] std::optional<std::size_t> open();
+    void close(std::size_t slot);
+
+    // Decode and execute every complete frame at the front of input
+    ProcessResult process(std::size_t slot, std::span<const std::byte> input);
+
+    // Encoded reports released but not yet handed to the transport
+    [[nodiscard]] std::span<const std::byte> pending_output(std::size_t slot) const noexcept {
+        return slots_.pending_output(slot);
+    }
+    void consume_output(std::size_t slot, std::size_t bytes) noexcept {
+        slots_.consume_output(slot, bytes);
+    }
+    // Pending plus held bytes, for backpressure
+    [[nodiscard]] std::size_t buffered_output(std::size_t slot) const noexcept {
+        return slots_.buffered_output(slot);
+    }
+
+    // Turning the hold off releases everything held
+    void set_output_hold(bool hold);
+    // Release the reports of commands up to sequence; their sessions become dirty
+    void release(std::uint64_t sequence);
+    [[nodiscard]] std::uint64_t command_sequence() const noexcept {
+        return command_seq_;
+    }
+    // Open slots that gained output since the last call (each listed once)
+    template<typename F>
+    void drain_dirty(F&& f) {
+        slots_.drain_dirty(std::forward<F>(f));
+    }
+
+    [[nodiscard]] std::size_t max_sessions() const noexcept {
+        return slots_.size();
+    }
+    [[nodiscard]] std::size_t open_sessions() const noexcept {
+        return slots_.open_sessions();
+    }
+    // Participant the session in slot trades as
+    [[nodiscard]] ParticipantId participant(std::size_t slot) const noexcept {
+        return slots_.participant(slot);
+    }
+
+    void on_trade(const Trade& trade) override;
+
+private:
+    struct Session {
+        std::uint32_t inbound_seq{0};  // Last accepted client sequence number
+        std::uint32_t outbound_seq{0};
+    };
+
+    // Output of one session up to end, produced while command sequence ran
+    struct Hold {
+        std::uint64_t sequence;
+        std::uint32_t slot;
+        std::size_t end;
+    };
+
+    void execute(std::size_t slot, const OrderCommand& command);
+    void append_report(std::size_t slot, const ExecutionReport& report);
+    void route_fill(ParticipantId participant, OrderId id, const Trade& trade);
+
+    MatchingEngine& engine_;
+    CommandCallback command_callback_;
+    SessionSlots<Session> slots_;
+    std::deque<Hold> holds_;                 // In sequence order
+    std::uint64_t command_seq_{0};
+    bool hold_output_{false};
+};
+
+} // namespace lob
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "command_journal.hpp"
+#include "matching_engine.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lob {
+
+// Primary half of active/passive replication over a Unix-domain stream socket
+// The primary streams every command its sessions execute to one backup as a
+// JournalRecord, and the backup answers with the cumulative sequence it has
+// applied (8 bytes). Nothing blocks: replicate() only buffers, flush() writes what
+// the socket takes and poll_acks() reads what has arrived, so any number of
+// commands are in flight while their reports wait in the sessions' output hold
+// (see TcpGateway::set_replication). Records carry the primary engine's clock for
+// the command (not the wall clock) and the backup pins its engine to it, so both expire
+// the same orders. Once the backup is lost the primary stays standalone; a new backup
+// would have to start from the same book, which only an empty engine guarantees.
+class ReplicationPrimary {
+public:
+    // Listen at socket_path (replacing a stale socket file); nullptr on socket errors
+    [[nodiscard]] static std::unique_ptr<ReplicationPrimary> create(const std::string& socket_path);
+    ~ReplicationPrimary();
+
+    ReplicationPrimary(const ReplicationPrimary&) = delete;
+    ReplicationPrimary& operator=(const ReplicationPrimary&) = delete;
+
+    // Wait up to timeout for the backup to connect; true once one is connected
+    bool accept_backup(std::chrono::milliseconds timeout);
+
+    // OrderEntrySessions::CommandCallback arguments plus the time the primary engine is
+    // pinned to for the command; dropped without a backup
+    void replicate(std::uint64_t sequence, ParticipantId participant, const OrderCommand& command,
+                   Timestamp time);
+    // Write buffered records until the socket is full; false once the backup is lost
+    bool flush();
+    // Read the acks that have arrived; returns the acked sequence
+    std::uint64_t poll_acks();
+
+    [[nodiscard]] bool connected() const noexcept {
+        return backup_fd_ >= 0;
+    }
+    // Backup socket, for readiness polling (-1 without a backup)
+    [[nodiscard]] int fd() const noexcept {
+        return backup_fd_;
+    }
+    [[nodiscard]] std::uint64_t replicated() const noexcept {
+        return replicated_;
+    }
+    [[nodiscard]] std::uint64_t acked() const noexcept {
+        return acked_;
+    }
+
+private:
+    ReplicationPrimary(int listen_fd, std::string socket_path);
+    void drop_backup() noexcept;
+
+    int listen_fd_;
+    int backup_fd_{-1};
+    bool backup_seen_{false};
+    std::string socket_path_;
+    std::vector<std::byte> output_;
+    std::size_t output_offset_{0};
+    std::byte ack_[sizeof(std::uint64_t)]{};
+    std::size_t ack_bytes_{0};    // Of a partially received ack
+    std::uint64_t replicated_{0};  // Last sequence buffered
+    std::uint64_t acked_{0};
+};
+
+// Backup half: applies the primary's records to its own engine in sequence order
+// poll() is meant for a thread (or process) of its own that owns the engine until
+// primary_lost(); the engine then holds exactly the primary's book as of the last
+// record received, ready to be promoted behind a new gateway. The engine must be set up
+// like the primary's (expiry batch limit, self-trade prevention, session close) and
+// runs on the primary's clock until the primary is lost.
+class ReplicationBackup {
+public:
+    // Connect to the primary at socket_path; nullptr if it is not listening
+    [[nodiscard]] static std::unique_ptr<ReplicationBackup> connect(MatchingEngine& engine,
+                                                                    const std::string& socket_path);
+    ~ReplicationBackup();
+
+    ReplicationBackup(const ReplicationBackup&) = delete;
+    ReplicationBackup& operator=(const ReplicationBackup&) = delete;
+
+    // Wait up to timeout for records, apply every complete one and ack the last;
+    // returns records applied
+    std::size_t poll(std::chrono::milliseconds timeout);
+
+    // Safe to read from other threads
+    [[nodiscard]] std::uint64_t applied() const noexcept {
+        return applied_.load(std::memory_order_acquire);
+    }
+    // The primary closed the stream, or sent a sequence gap
+    [[nodiscard]] bool primary_lost() const noexcept {
+        return lost_.load(std::memory_order_acquire);
+    }
+
+private:
+    ReplicationBackup(MatchingEngine& engine, int fd);
+    void disconnect() noexcept;
+
+    MatchingEngine& engine_;
+    int fd_;
+    std::vector<std::byte> input_;
+    std::size_t received_{0};
+    std::atomic<std::uint64_t> applied_{0};
+    std::atomic<bool> lost_{false};
+};
+
+} // namespace lob
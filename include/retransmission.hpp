@@ -0,0 +1,144 @@
+#pragma once
+
+#include "market_data.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace lob {
+
+struct PacketHistoryOptions {
+    std::size_t memory_packets{4096};  // Most recent packets, kept in process memory
+    std::string spill_path;            // Memory-mapped file for older packets; empty for none
+    std::size_t spill_packets{65536};  // Packets the file holds before the oldest are overwritten
+    std::size_t max_packet{mdp::DEFAULT_PACKET_SIZE};
+};
+
+// Sequence-indexed history of outbound packets, written by one thread and read
+// concurrently by any number of others
+// Packet n lives in slot n % memory_packets of an in-memory ring. Before a slot
+// is reused, its packet is copied to slot n % spill_packets of the spill file, so
+// the history reaches memory_packets + spill_packets back. Every slot is guarded by
+// a sequence stamp (odd while written, 2n once packet n is complete) that readers
+// check before and after copying, so the writer never waits for them.
+class PacketHistory {
+public:
+    using Options = PacketHistoryOptions;
+
+    // nullptr if the spill file cannot be created and mapped
+    [[nodiscard]] static std::unique_ptr<PacketHistory> create(const Options& options = {});
+    ~PacketHistory();
+
+    PacketHistory(const PacketHistory&) = delete;
+    PacketHistory& operator=(const PacketHistory&) = delete;
+
+    // Writer side: sequences must follow each other; false (not kept) if the packet
+    // is larger than max_packet or out of order
+    bool append(std::uint64_t sequence, std::span<const std::byte> packet) noexcept;
+
+    // Copy packet sequence into out (at least max_packet bytes); returns its length,
+    // or 0 if it is not (or no longer) held
+    [[nodiscard]] std::size_t read(std::uint64_t sequence, std::span<std::byte> out) const noexcept;
+
+    // Latest sequence appended (0 before the first)
+    [[nodiscard]] std::uint64_t newest() const noexcept {
+        return newest_.load(std::memory_order_acquire);
+    }
+    // Oldest sequence still held
+    [[nodiscard]] std::uint64_t oldest() const noexcept;
+    [[nodiscard]] std::size_t max_packet() const noexcept {
+        return max_packet_;
+    }
+
+private:
+    PacketHistory(const Options& options, std::uint64_t* spill, std::size_t spill_bytes);
+
+    static std::size_t slot_words(std::size_t max_packet) noexcept;
+    std::uint64_t* memory_slot(std::uint64_t sequence) const noexcept;
+    std::uint64_t* spill_slot(std::uint64_t sequence) const noexcept;
+
+    std::size_t max_packet_;
+    std::size_t slot_words_;  // Stamp, length and payload, rounded to a cache line
+    std::size_t memory_packets_;
+    std::size_t spill_packets_;
+    std::unique_ptr<std::uint64_t[]> memory_;
+    std::uint64_t* spill_;    // nullptr without a spill file
+    std::size_t spill_bytes_;
+    std::atomic<std::uint64_t> newest_{0};
+};
+
+// Serves retransmission requests for a PacketHistory over unicast UDP
+// Each mdp::RetransmitRequest is answered with the held packets of its range,
+// exactly as first published, in sendmmsg batches, followed by an
+// mdp::Channel::RetransmitEnd header naming the first packet not sent. poll() is
+// meant for a thread of its own; it only reads the history, so serving never
+// touches the matching thread.
+class RetransmissionServer {
+public:
+    static constexpr std::uint32_t MAX_REQUEST = 1024;  // Packets served per request
+    static constexpr std::size_t BATCH = 64;            // Datagrams per sendmmsg
+
+    // Listen on address:port (port 0 picks a free one); nullptr on socket errors
+    [[nodiscard]] static std::unique_ptr<RetransmissionServer>
+    create(const PacketHistory& history, std::uint16_t port, const std::string& address = "127.0.0.1");
+    ~RetransmissionServer();
+
+    RetransmissionServer(const RetransmissionServer&) = delete;
+    RetransmissionServer& operator=(const RetransmissionServer&) = delete;
+
+    // Wait up to timeout for requests and answer all that are queued; returns packets resent
+    std::size_t poll(std::chrono::milliseconds timeout);
+
+    [[nodiscard]] std::uint16_t port() const noexcept {
+        return port_;
+    }
+
+private:
+    RetransmissionServer(const PacketHistory& history, int fd, std::uint16_t port);
+
+    std::size_t serve(const mdp::RetransmitRequest& request, const void* peer, unsigned peer_length);
+
+    const PacketHistory& history_;
+    int fd_;
+    std::uint16_t port_;
+    std::vector<std::byte> buffers_;  // BATCH packets of history_.max_packet() bytes
+};
+
+// Blocking client fetching lost packets from a RetransmissionServer
+// Answers are read up to RetransmissionServer::BATCH datagrams per recvmmsg.
+class RetransmissionClient {
+public:
+    using PacketCallback = std::function<void(std::span<const std::byte>)>;
+
+    // max_packet: the publisher's packet_size; longer datagrams are truncated and dropped
+    [[nodiscard]] static std::optional<RetransmissionClient>
+    connect(const std::string& address, std::uint16_t port, std::size_t max_packet = mdp::DEFAULT_PACKET_SIZE);
+    ~RetransmissionClient();
+
+    RetransmissionClient(RetransmissionClient&& other) noexcept;
+    RetransmissionClient& operator=(RetransmissionClient&& other) noexcept;
+    RetransmissionClient(const RetransmissionClient&) = delete;
+    RetransmissionClient& operator=(const RetransmissionClient&) = delete;
+
+    // Request count packets from first and pass each one received to on_packet (for
+    // instance MarketDataReceiver::handle_packet). Returns the packets received; stops
+    // at the server's end marker or once timeout passes without a datagram.
+    std::size_t fetch(std::uint64_t first, std::uint32_t count, const PacketCallback& on_packet,
+                      std::chrono::milliseconds timeout = std::chrono::seconds(1));
+
+private:
+    RetransmissionClient(int fd, std::size_t max_packet);
+
+    int fd_;
+    std::size_t max_packet_;
+    std::vector<std::byte> buffer_;  // BATCH datagrams of max_packet_ bytes
+};
+
+} // namespace lob
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "types.hpp"
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace lob {
+
+using SymbolId = std::uint32_t;
+
+enum class RiskResult : std::uint8_t {
+    Accepted = 0,
+    UnknownSymbol = 1,
+    UnknownAccount = 2,
+    MaxQuantityExceeded = 3,
+    MaxNotionalExceeded = 4,
+    PriceOutsideCollar = 5,
+    NoReferencePrice = 6,   // Market order before any reference price is known
+    CreditLimitExceeded = 7
+};
+
+struct SymbolRiskLimits {
+    Quantity max_order_quantity{std::numeric_limits<Quantity>::max()};
+    Notional max_order_notional{std::numeric_limits<Notional>::max()};
+    // Band half-width around the reference; finite so a market order has a worst-case price
+    Price collar_ticks{10'000};
+};
+
+// Pre-trade risk stage in front of MatchingEngine::submit_order
+// Symbols and accounts live in flat tables indexed by id, sized at construction,
+// so check() never allocates, hashes or locks. Price bands are precomputed
+// whenever the reference moves, making the collar two compares.
+// Account exposure is the signed executed notional (buys positive), updated
+// on every fill. Resting orders reserve their notional at their limit price,
+// per side, from on_order_resting() until filled or on_order_closed(); an
+// order is accepted if exposure plus every open order on its side plus its
+// own worst-case fill stays within the account's credit limit. A market
+// order's worst case is the top of the band on either side: the most a buy
+// can cost and the largest short a sell can open. Reservations sit in a hash
+// map by order id, touched only by the hooks.
+class RiskGate {
+public:
+    RiskGate(std::size_t max_symbols, std::size_t max_accounts);
+
+    void set_symbol_limits(SymbolId symbol, const SymbolRiskLimits& limits);
+    // Accounts without a credit limit are rejected
+    void set_credit_limit(ParticipantId account, Notional limit);
+
+    // Recompute the symbol's collar around reference
+    void set_reference_price(SymbolId symbol, Price reference) noexcept;
+    // Reference from the engine's last trade, falling back to the BBO midpoint
+    template<typename Engine>
+    void refresh_reference(SymbolId symbol, const Engine& engine) noexcept {
+        if (auto last = engine.last_trade_price()) {
+            set_reference_price(symbol, *last);
+            return;
+        }
+        const auto& book = engine.get_order_book();
+        auto bid = book.best_bid();
+        auto ask = book.best_ask();
+        if (bid && ask) {
+            set_reference_price(symbol, *bid + (*ask - *bid) / 2);
+        }
+    }
+
+    [[nodiscard]] RiskResult check(SymbolId symbol, ParticipantId account, Side side,
+                                   OrderType type, Price price, Quantity quantity) const noexcept {
+        if (symbol >= symbols_.size()) [[unlikely]] {
+            return RiskResult::UnknownSymbol;
+        }
+        if (account >= accounts_.size() || !accounts_[account].enabled) [[unlikely]] {
+            return RiskResult::UnknownAccount;
+        }
+        const SymbolState& sym = symbols_[symbol];
+        if (quantity > sym.limits.max_order_quantity) {
+            return RiskResult::MaxQuantityExceeded;
+        }
+
+        if (type == OrderType::Market) {
+            if (!sym.has_reference) {
+                return RiskResult::NoReferencePrice;
+            }
+            price = sym.band_high;
+        } else if (sym.has_reference && (price < sym.band_low || price > sym.band_high)) {
+            return RiskResult::PriceOutsideCollar;
+        }
+
+        Notional notional;
+        if (__builtin_mul_overflow(price, quantity, &notional) ||
+            notional > sym.limits.max_order_notional) {
+            return RiskResult::MaxNotionalExceeded;
+        }
+
+        const AccountState& acct = accounts_[account];
+        Notional worst;
+        if (side == Side::Buy) {
+            if (__builtin_add_overflow(acct.exposure, acct.open_buy, &worst) ||
+                __builtin_add_overflow(worst, notional, &worst) || worst > acct.credit_limit) {
+                return RiskResult::CreditLimitExceeded;
+            }
+        } else if (__builtin_sub_overflow(acct.exposure, acct.open_sell, &worst) ||
+                   __builtin_sub_overflow(worst, notional, &worst) || worst < -acct.credit_limit) {
+            return RiskResult::CreditLimitExceeded;
+        }
+        return RiskResult::Accepted;
+    }
+
+    // Order hooks: reserve what an accepted order leaves resting (after any fills on
+    // entry), and again with the new price and quantity after a modify; release the
+    // rest when it is cancelled or expires. A missed release only makes check() stricter.
+    void on_order_resting(OrderId id, ParticipantId account, Side side, Price price, Quantity remaining);
+    void on_order_closed(OrderId id) noexcept;
+
+    // Fill hook: wire to the engine's trade callback
+    void on_trade(const Trade& trade) noexcept {
+        const Notional notional = value(trade.price, trade.quantity);
+        if (trade.buy_participant < accounts_.size()) {
+            accumulate(accounts_[trade.buy_participant].exposure, notional);
+        }
+        if (trade.sell_participant < accounts_.size()) {
+            accumulate(accounts_[trade.sell_participant].exposure, -notional);
+        }
+        if (!reservations_.empty()) {
+            release(trade.buy_order_id, trade.quantity);
+            release(trade.sell_order_id, trade.quantity);
+        }
+    }
+
+    [[nodiscard]] Notional exposure(ParticipantId account) const noexcept {
+        return account < accounts_.size() ? accounts_[account].exposure : 0;
+    }
+    // Notional reserved by the account's resting orders on side
+    [[nodiscard]] Notional open_notional(ParticipantId account, Side side) const noexcept {
+        if (account >= accounts_.size()) {
+            return 0;
+        }
+        return side == Side::Buy ? accounts_[account].open_buy : accounts_[account].open_sell;
+    }
+    [[nodiscard]] std::optional<std::pair<Price, Price>> collar(SymbolId symbol) const noexcept;
+
+private:
+    // Saturating, so an account past the representable range stays blocked instead of wrapping
+    static void accumulate(Notional& exposure, Notional delta) noexcept {
+        if (__builtin_add_overflow(exposure, delta, &exposure)) {
+            exposure = delta > 0 ? std::numeric_limits<Notional>::max() : std::numeric_limits<Notional>::min();
+        }
+    }
+    static Notional value(Price price, Quantity quantity) noexcept {
+        Notional notional;
+        if (__builtin_mul_overflow(price, quantity, &notional)) {
+            notional = price < 0 ? -std::numeric_limits<Notional>::max() : std::numeric_limits<Notional>::max();
+        }
+        return notional;
+    }
+    // Release up to quantity of order id's reservation
+    void release(OrderId id, Quantity quantity) noexcept;
+
+    struct SymbolState {
+        SymbolRiskLimits limits;
+        Price reference{0};
+        Price band_low{std::numeric_limits<Price>::min()};
+        Price band_high{std::numeric_limits<Price>::max()};
+        bool has_reference{false};
+    };
+
+    struct AccountState {
+        Notional credit_limit{0};
+        Notional exposure{0};
+        Notional open_buy{0};   // Reserved by resting orders
+        Notional open_sell{0};
+        bool enabled{false};
+    };
+
+    struct Reservation {
+        ParticipantId account;
+        Side side;
+        Price price;
+        Quantity remaining;
+    };
+
+    std::vector<SymbolState> symbols_;
+    std::vector<AccountState> accounts_;
+    std::unordered_map<OrderId, Reservation> reservations_;
+};
+
+} // namespace lob
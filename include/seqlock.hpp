@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace lob {
+
+// Spin hint for busy-wait loops
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+// Single-writer sequence lock publishing a trivially copyable T
+// The writer never waits: it bumps the sequence to odd, copies, and bumps it back
+// to even. Readers copy optimistically and retry if the sequence moved underneath.
+// The payload is held in relaxed atomic words so concurrent reads are race-free,
+// and everything is address-free, so a SeqLock may be placed in shared memory.
+template<typename T>
+class alignas(64) SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock payload must be trivially copyable");
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+public:
+    SeqLock() noexcept {
+        for (auto& word : data_) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    // Writer side (one thread only)
+    void store(const T& value) noexcept {
+        std::array<std::uint64_t, WORDS> words{};
+        std::memcpy(words.data(), &value, sizeof(T));
+
+        const std::uint64_t seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < WORDS; ++i) {
+            data_[i].store(words[i], std::memory_order_relaxed);
+        }
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+
+    // Single attempt; false if a write was in progress or raced with the copy
+    [[nodiscard]] bool try_load(T& out) const noexcept {
+        const std::uint64_t before = sequence_.load(std::memory_order_acquire);
+        if (before & 1) {
+            return false;
+        }
+        std::array<std::uint64_t, WORDS> words;
+        for (std::size_t i = 0; i < WORDS; ++i) {
+            words[i] = data_[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+        std::memcpy(static_cast<void*>(&out), words.data(), sizeof(T));
+        return true;
+    }
+
+    // Spin until a consistent copy is read
+    [[nodiscard]] T load() const noexcept {
+        T value{};
+        while (!try_load(value)) {
+            cpu_relax();
+        }
+        return value;
+    }
+
+    // Even when idle; advances by 2 per store (0 = never written)
+    [[nodiscard]] std::uint64_t sequence() const noexcept {
+        return sequence_.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr std::size_t WORDS = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    std::atomic<std::uint64_t> sequence_{0};
+    std::array<std::atomic<std::uint64_t>, WORDS> data_;
+};
+
+} // namespace lob
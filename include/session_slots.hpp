@@ -0,0 +1,154 @@
+#pragma once
+
+#include "types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace lob {
+
+// Session plumbing shared by the order-entry protocols (OrderEntrySessions, FixSessions)
+// Slot i trades as participant first_participant + i (a block reserved from the engine)
+// and open() hands out the lowest free slot. Each
+// open slot buffers its encoded output; the part below the released mark may be handed
+// to the transport, and a slot that gains released output is listed once for
+// drain_dirty(). State is the protocol's own per-session data, reset by open().
+template<typename State>
+class SessionSlots {
+public:
+    SessionSlots(std::size_t max_sessions, ParticipantId first_participant)
+        : slots_(max_sessions)
+        , first_participant_(first_participant)
+    {
+        free_slots_.reserve(max_sessions);
+        for (std::size_t slot = max_sessions; slot > 0; --slot) {
+            free_slots_.push_back(static_cast<std::uint32_t>(slot - 1));
+        }
+        dirty_.reserve(max_sessions);
+    }
+
+    // std::nullopt when every slot is in use
+    [[nodiscard]] std::optional<std::size_t> open() {
+        if (free_slots_.empty()) {
+            return std::nullopt;
+        }
+        const std::size_t slot = free_slots_.back();
+        free_slots_.pop_back();
+        Slot& entry = slots_[slot];
+        entry.output.clear();
+        entry.output_offset = 0;
+        entry.released = 0;
+        entry.state = State{};
+        entry.open = true;
+        ++open_count_;
+        return slot;
+    }
+    // false if slot was not open
+    bool close(std::size_t slot) {
+        Slot& entry = slots_[slot];
+        if (!entry.open) {
+            return false;
+        }
+        entry.open = false;
+        free_slots_.push_back(static_cast<std::uint32_t>(slot));
+        --open_count_;
+        return true;
+    }
+
+    [[nodiscard]] bool is_open(std::size_t slot) const noexcept {
+        return slots_[slot].open;
+    }
+    [[nodiscard]] ParticipantId participant(std::size_t slot) const noexcept {
+        return first_participant_ + static_cast<ParticipantId>(slot);
+    }
+    // Slot of participant while its session is open
+    [[nodiscard]] std::optional<std::size_t> slot_of(ParticipantId participant) const noexcept {
+        if (participant < first_participant_ || participant - first_participant_ >= slots_.size() ||
+            !slots_[participant - first_participant_].open) {
+            return std::nullopt;
+        }
+        return static_cast<std::size_t>(participant - first_participant_);
+    }
+    [[nodiscard]] State& state(std::size_t slot) noexcept {
+        return slots_[slot].state;
+    }
+    [[nodiscard]] const State& state(std::size_t slot) const noexcept {
+        return slots_[slot].state;
+    }
+
+    // Encoded output is appended here, then released
+    [[nodiscard]] std::vector<std::byte>& output(std::size_t slot) noexcept {
+        return slots_[slot].output;
+    }
+    // Output below end may be handed out; the slot becomes dirty
+    void release(std::size_t slot, std::size_t end) {
+        Slot& entry = slots_[slot];
+        entry.released = end;
+        if (!entry.dirty) {
+            entry.dirty = true;
+            dirty_.push_back(static_cast<std::uint32_t>(slot));
+        }
+    }
+    void release(std::size_t slot) {
+        release(slot, slots_[slot].output.size());
+    }
+
+    // Released output not yet handed to the transport
+    [[nodiscard]] std::span<const std::byte> pending_output(std::size_t slot) const noexcept {
+        const Slot& entry = slots_[slot];
+        return std::span<const std::byte>(entry.output.data() + entry.output_offset,
+                                          entry.released - entry.output_offset);
+    }
+    void consume_output(std::size_t slot, std::size_t bytes) noexcept {
+        Slot& entry = slots_[slot];
+        entry.output_offset += bytes;
+        if (entry.output_offset == entry.output.size()) {
+            entry.output.clear();  // Keeps capacity for the next batch
+            entry.output_offset = 0;
+            entry.released = 0;
+        }
+    }
+    // Released or not, for backpressure
+    [[nodiscard]] std::size_t buffered_output(std::size_t slot) const noexcept {
+        return slots_[slot].output.size() - slots_[slot].output_offset;
+    }
+
+    // Open slots that gained output since the last call (each listed once)
+    template<typename F>
+    void drain_dirty(F&& f) {
+        for (std::uint32_t slot : dirty_) {
+            slots_[slot].dirty = false;
+            if (slots_[slot].open) {
+                f(static_cast<std::size_t>(slot));
+            }
+        }
+        dirty_.clear();
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return slots_.size();
+    }
+    [[nodiscard]] std::size_t open_sessions() const noexcept {
+        return open_count_;
+    }
+
+private:
+    struct Slot {
+        std::vector<std::byte> output;
+        std::size_t output_offset{0};  // Bytes already handed to the transport
+        std::size_t released{0};       // Output below this may be handed out
+        State state{};
+        bool open{false};
+        bool dirty{false};
+    };
+
+    std::vector<Slot> slots_;
+    ParticipantId first_participant_;
+    std::vector<std::uint32_t> free_slots_;  // Stack; lowest slot on top
+    std::vector<std::uint32_t> dirty_;
+    std::size_t open_count_{0};
+};
+
+} // namespace lob
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "engine_observer.hpp"
+#include "matching_engine.hpp"
+#include "order_command.hpp"
+#include "spsc_ring.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace lob {
+
+// How a consumer waits for an empty ring to fill
+enum class WaitMode : std::uint8_t {
+    BusyPoll = 0,  // Spin with a pause hint (lowest latency, burns the core)
+    Futex = 1      // Sleep in the kernel until the producer rings the doorbell
+};
+
+// Doorbell for one sleeping consumer, usable across processes (shared futex)
+// Producers pay one fence and one load per notify while nobody sleeps.
+struct alignas(64) FutexEvent {
+    std::atomic<std::uint32_t> epoch{0};
+    std::atomic<std::uint32_t> waiting{0};
+
+    void notify() noexcept;
+    // Sleep until ready() holds, the event is notified or timeout passes; returns ready()
+    template<typename Ready>
+    bool wait(Ready&& ready, std::chrono::nanoseconds timeout) {
+        const std::uint32_t key = epoch.load(std::memory_order_acquire);
+        waiting.store(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!ready()) {
+            sleep(key, timeout);
+        }
+        waiting.store(0, std::memory_order_relaxed);
+        return ready();
+    }
+
+private:
+    void sleep(std::uint32_t key, std::chrono::nanoseconds timeout) noexcept;
+};
+
+inline constexpr std::size_t GATEWAY_RING_CAPACITY = 1024;
+
+// One client's pair of rings; slot i trades as participant first_participant + i
+struct ShmClientChannel {
+    enum State : std::uint32_t {
+        Free = 0,
+        Connected = 1,
+        Closing = 2  // Client left; the engine cancels its orders and frees the slot
+    };
+
+    alignas(64) std::atomic<std::uint32_t> state{Free};
+    std::atomic<std::uint32_t> overflowed{0};  // A fill was dropped on a full response ring
+    SpscRing<OrderCommand, GATEWAY_RING_CAPACITY> requests;
+    SpscRing<ExecutionReport, GATEWAY_RING_CAPACITY> responses;
+    FutexEvent response_event;
+};
+
+// Head of the gateway's shared memory object, followed by max_clients channels
+struct ShmGatewayHeader {
+    static constexpr std::uint64_t MAGIC = 0x4c4f4247'5753'0002;  // "LOBGWS", layout 2
+
+    std::atomic<std::uint64_t> magic{0};
+    std::uint32_t max_clients{0};
+    std::uint32_t channel_size{sizeof(ShmClientChannel)};
+    ParticipantId first_participant{1};  // Reserved from the engine by the server
+    FutexEvent request_event;  // Shared by all clients; the engine is the only sleeper
+};
+
+// Engine side of the shared memory transport (/dev/shm/<name>)
+// poll() drains every connected client's request ring into the engine on the calling
+// (matching) thread and answers each command with an Ack; fills are routed to the
+// owning clients as they happen. Commands are submitted under the client's
+// participant id, so self-trade prevention and mass cancel work per client, and a
+// disconnecting client's resting orders are cancelled. A client is only read while
+// its response ring has room for the reports one command can cause in the common
+// case; passive fills arriving at a full ring are dropped and flag the channel.
+class ShmGatewayServer : public EngineObserver {
+public:
+    static constexpr std::size_t DEFAULT_POLL_BATCH = 64;
+
+    // nullptr if the object cannot be created (for instance because the name is taken)
+    [[nodiscard]] static std::unique_ptr<ShmGatewayServer>
+    create(const std::string& name, MatchingEngine& engine, std::size_t max_clients);
+    ~ShmGatewayServer() override;
+
+    ShmGatewayServer(const ShmGatewayServer&) = delete;
+    ShmGatewayServer& operator=(const ShmGatewayServer&) = delete;
+
+    // Process up to max_per_client commands from each client; returns commands processed
+    std::size_t poll(std::size_t max_per_client = DEFAULT_POLL_BATCH);
+    // Block until some client has a request pending (or timeout), then poll
+    std::size_t wait_and_poll(WaitMode mode, std::chrono::nanoseconds timeout,
+                              std::size_t max_per_client = DEFAULT_POLL_BATCH);
+
+    [[nodiscard]] std::size_t connected_clients() const noexcept;
+
+    void on_trade(const Trade& trade) override;
+
+private:
+    ShmGatewayServer(ShmGatewayHeader* header, std::size_t mapped_size, std::string shm_name,
+                     MatchingEngine& engine, ParticipantId first_participant);
+
+    [[nodiscard]] ShmClientChannel& channel(std::size_t slot) const noexcept;
+    [[nodiscard]] bool requests_pending() const noexcept;
+    void route_fill(ParticipantId participant, OrderId id, const Trade& trade);
+    void push_report(ShmClientChannel& channel, const ExecutionReport& report);
+    void release_slot(std::size_t slot);
+
+    ShmGatewayHeader* header_;
+    std::size_t mapped_size_;
+    std::string shm_name_;
+    MatchingEngine& engine_;
+    ParticipantId first_participant_;
+};
+
+// Client side: claims a free channel in a running gateway
+class ShmGatewayClient {
+public:
+    // std::nullopt if there is no compatible gateway under name or every channel is taken
+    [[nodiscard]] static std::optional<ShmGatewayClient> connect(const std::string& name);
+    // Hands the channel back to the engine, which cancels the client's resting orders
+    ~ShmGatewayClient();
+
+    ShmGatewayClient(ShmGatewayClient&& other) noexcept;
+    ShmGatewayClient& operator=(ShmGatewayClient&& other) noexcept;
+    ShmGatewayClient(const ShmGatewayClient&) = delete;
+    ShmGatewayClient& operator=(const ShmGatewayClient&) = delete;
+
+    // False if the request ring is full
+    [[nodiscard]] bool send(const OrderCommand& command) noexcept;
+    [[nodiscard]] bool try_receive(ExecutionReport& report) noexcept;
+    // Wait for the next report; false on timeout
+    [[nodiscard]] bool receive(ExecutionReport& report, WaitMode mode,
+                               std::chrono::nanoseconds timeout = std::chrono::seconds(1));
+
+    // Participant id the engine assigned to this client's orders
+    [[nodiscard]] ParticipantId participant() const noexcept {
+        return participant_;
+    }
+    // Whether a fill report was dropped because this client fell behind
+    [[nodiscard]] bool overflowed() const noexcept {
+        return channel_->overflowed.load(std::memory_order_acquire) != 0;
+    }
+
+private:
+    ShmGatewayClient(ShmGatewayHeader* header, std::size_t mapped_size, ShmClientChannel* channel,
+                     ParticipantId participant) noexcept
+        : header_(header), mapped_size_(mapped_size), channel_(channel), participant_(participant) {}
+
+    void disconnect() noexcept;
+
+    ShmGatewayHeader* header_;
+    std::size_t mapped_size_;
+    ShmClientChannel* channel_;
+    ParticipantId participant_;
+};
+
+} // namespace lob
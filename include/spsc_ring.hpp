@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace lob {
+
+// Bounded single-producer/single-consumer ring of trivially copyable records
+// Head and tail live on separate cache lines, each next to a cached copy of the
+// other side's index, so the common case touches no line owned by the other core.
+// Indices are free-running and everything is address-free, so a ring may be
+// placed in shared memory and used across processes.
+template<typename T, std::size_t Capacity>
+class SpscRing {
+    static_assert(std::is_trivially_copyable_v<T>, "SpscRing records must be trivially copyable");
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+public:
+    SpscRing() = default;
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer side
+    [[nodiscard]] bool try_push(const T& value) noexcept {
+        const std::uint64_t tail = producer_.index.load(std::memory_order_relaxed);
+        if (tail - producer_.cached_other == Capacity) {
+            producer_.cached_other = consumer_.index.load(std::memory_order_acquire);
+            if (tail - producer_.cached_other == Capacity) {
+                return false;
+            }
+        }
+        slots_[tail & (Capacity - 1)] = value;
+        producer_.index.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    [[nodiscard]] bool try_pop(T& out) noexcept {
+        const std::uint64_t head = consumer_.index.load(std::memory_order_relaxed);
+        if (head == consumer_.cached_other) {
+            consumer_.cached_other = producer_.index.load(std::memory_order_acquire);
+            if (head == consumer_.cached_other) {
+                return false;
+            }
+        }
+        out = slots_[head & (Capacity - 1)];
+        consumer_.index.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate from any thread; exact from the consumer for empty(), producer for free_slots()
+    [[nodiscard]] bool empty() const noexcept {
+        return consumer_.index.load(std::memory_order_acquire) ==
+               producer_.index.load(std::memory_order_acquire);
+    }
+    [[nodiscard]] std::size_t free_slots() const noexcept {
+        return Capacity - static_cast<std::size_t>(producer_.index.load(std::memory_order_acquire) -
+                                                   consumer_.index.load(std::memory_order_acquire));
+    }
+    [[nodiscard]] static constexpr std::size_t capacity() noexcept {
+        return Capacity;
+    }
+
+    // Only while neither side is active
+    void reset() noexcept {
+        producer_.index.store(0, std::memory_order_relaxed);
+        producer_.cached_other = 0;
+        consumer_.index.store(0, std::memory_order_relaxed);
+        consumer_.cached_other = 0;
+    }
+
+private:
+    struct alignas(64) Cursor {
+        std::atomic<std::uint64_t> index{0};
+        std::uint64_t cached_other{0};  // Owner's last view of the opposite index
+    };
+
+    Cursor producer_;
+    Cursor consumer_;
+    std::array<T, Capacity> slots_{};
+};
+
+} // namespace lob
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "matching_engine.hpp"
+#include "order_entry.hpp"
+#include "replication.hpp"
+#include "wire_protocol.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace lob {
+
+// Order-entry gateway on non-blocking TCP sockets and edge-triggered epoll
+// poll() runs one event-loop turn on the matching thread: every readable socket is
+// read until EAGAIN into its session's receive buffer, complete frames are decoded
+// in place and executed, and each session with new reports is flushed with as few
+// send() calls as its socket accepts. A session with more than OUTPUT_HIGH_WATER
+// bytes unsent (held or pending) is not read again until the client drains it.
+class TcpGateway {
+public:
+    static constexpr std::size_t RECEIVE_BUFFER = 64 * 1024;
+    static constexpr std::size_t OUTPUT_HIGH_WATER = 1024 * 1024;
+
+    // Listen on address:port (port 0 picks a free one); nullptr on socket errors
+    [[nodiscard]] static std::unique_ptr<TcpGateway>
+    create(MatchingEngine& engine, std::uint16_t port, std::size_t max_sessions,
+           const std::string& address = "127.0.0.1");
+    ~TcpGateway();
+
+    TcpGateway(const TcpGateway&) = delete;
+    TcpGateway& operator=(const TcpGateway&) = delete;
+
+    // Wait up to timeout for socket events and handle them; returns commands executed
+    std::size_t poll(std::chrono::milliseconds timeout);
+
+    // Stream every executed command to primary's backup and hold each report until the
+    // backup has acked its command; poll() then also flushes records and reads acks.
+    // The engine's clock is pinned to the time of each command as it is replicated.
+    // false if primary has no backup connected or the gateway has already executed
+    // commands (the backup starts from an empty book). If the backup is lost, held
+    // reports go out and the gateway carries on alone. nullptr detaches (releasing
+    // everything held and unpinning the clock); primary must stay alive until then.
+    bool set_replication(ReplicationPrimary* primary);
+
+    [[nodiscard]] std::uint16_t port() const noexcept {
+        return port_;
+    }
+    [[nodiscard]] std::size_t open_sessions() const noexcept {
+        return sessions_.open_sessions();
+    }
+
+private:
+    struct Connection {
+        int fd{-1};
+        std::size_t received{0};  // Bytes buffered in input
+        bool readable{false};     // Not yet read to EAGAIN (edge already consumed)
+        bool writable{true};
+        std::vector<std::byte> input;
+    };
+
+    TcpGateway(MatchingEngine& engine, std::size_t max_sessions, int listen_fd, int epoll_fd,
+               std::uint16_t port);
+
+    void accept_connections();
+    std::size_t read_connection(std::size_t slot);
+    void flush_connection(std::size_t slot);
+    void close_connection(std::size_t slot);
+    void poll_replication();
+
+    MatchingEngine& engine_;
+    OrderEntrySessions sessions_;
+    ReplicationPrimary* replication_{nullptr};
+    std::vector<Connection> connections_;  // Indexed by session slot
+    std::vector<std::uint32_t> backlog_;   // Slots left readable by output backpressure
+    int listen_fd_;
+    int epoll_fd_;
+    std::uint16_t port_;
+};
+
+// Blocking loopback client for tests and load generation
+// Commands are encoded into a local buffer with consecutive sequence numbers and
+// go out together on flush(); receive() reads reports in batches.
+class TcpOrderClient {
+public:
+    [[nodiscard]] static std::optional<TcpOrderClient> connect(const std::string& address,
+                                                               std::uint16_t port);
+    ~TcpOrderClient();
+
+    TcpOrderClient(TcpOrderClient&& other) noexcept;
+    TcpOrderClient& operator=(TcpOrderClient&& other) noexcept;
+    TcpOrderClient(const TcpOrderClient&) = delete;
+    TcpOrderClient& operator=(const TcpOrderClient&) = delete;
+
+    // Queue a command; returns its sequence number (echoed as client_seq in the Ack)
+    std::uint32_t send(const OrderCommand& command);
+    // Write all queued commands; false if the connection failed
+    bool flush();
+    // Next report; false on timeout, disconnect or an out-of-sequence frame
+    [[nodiscard]] bool receive(ExecutionReport& report,
+                               std::chrono::milliseconds timeout = std::chrono::seconds(1));
+
+    [[nodiscard]] bool connected() const noexcept {
+        return fd_ >= 0;
+    }
+
+private:
+    explicit TcpOrderClient(int fd);
+    void disconnect() noexcept;
+
+    int fd_;
+    std::uint32_t next_seq_{1};
+    std::uint32_t inbound_seq_{0};
+    std::vector<std::byte> output_;
+    std::vector<std::byte> input_;
+    std::size_t input_begin_{0};
+    std::size_t input_end_{0};
+};
+
+} // namespace lob
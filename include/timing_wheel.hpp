@@ -0,0 +1,197 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace lob {
+
+// Intrusive hierarchical timing wheel (Varghese & Lauck)
+// Four levels of 256 slots cover 2^32 ticks ahead of the current tick; anything
+// further out waits in an overflow list until the top level wraps.
+// Nodes carry their own links, so schedule/cancel are O(1) with no allocation.
+// T must provide: T* timer_next, T* timer_prev, std::uint64_t timer_deadline,
+// std::uint32_t timer_slot (initialised to NO_SLOT).
+template<typename T>
+class TimingWheel {
+public:
+    static constexpr std::uint32_t LEVELS = 4;
+    static constexpr std::uint32_t SLOT_BITS = 8;
+    static constexpr std::uint32_t SLOTS = 1u << SLOT_BITS;
+    static constexpr std::uint32_t OVERFLOW_SLOT = LEVELS * SLOTS;
+    static constexpr std::uint32_t NO_SLOT = std::numeric_limits<std::uint32_t>::max();
+
+    explicit TimingWheel(std::uint64_t start_tick = 0) noexcept
+        : current_(start_tick)
+    {
+        heads_.fill(nullptr);
+        for (auto& level : occupied_) {
+            level.fill(0);
+        }
+    }
+
+    // Schedule node to fire at deadline (absolute tick); past deadlines fire on the next advance
+    void schedule(T* node, std::uint64_t deadline) noexcept {
+        node->timer_deadline = deadline;
+        link(node, slot_for(std::max(deadline, current_)));
+        ++size_;
+    }
+
+    // Remove node from the wheel (no-op if it is not scheduled)
+    void cancel(T* node) noexcept {
+        if (node->timer_slot != NO_SLOT) {
+            unlink(node);
+            --size_;
+        }
+    }
+
+    // Advance wheel to now, invoking on_expire for at most max_expired due nodes.
+    // Stops early when the budget is exhausted; the next call resumes where this one left off.
+    // Empty stretches of the wheel are skipped using per-level occupancy bitmaps.
+    template<typename F>
+    std::size_t advance(std::uint64_t now, std::size_t max_expired, F&& on_expire) {
+        std::size_t expired = 0;
+        for (;;) {
+            // Drain the level-0 slot for the current tick
+            const std::uint32_t slot = static_cast<std::uint32_t>(current_ & (SLOTS - 1));
+            while (T* node = heads_[slot]) {
+                if (expired == max_expired) {
+                    return expired;
+                }
+                unlink(node);
+                --size_;
+                ++expired;
+                on_expire(node);
+            }
+            if (current_ >= now) {
+                return expired;
+            }
+            step_to(next_stop(now));
+        }
+    }
+
+    // Drop all nodes without firing them (owner is responsible for node storage)
+    void clear() noexcept {
+        heads_.fill(nullptr);
+        for (auto& level : occupied_) {
+            level.fill(0);
+        }
+        size_ = 0;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    [[nodiscard]] std::uint64_t current_tick() const noexcept { return current_; }
+
+private:
+    static constexpr std::uint32_t WORDS = SLOTS / 64;
+    static constexpr std::uint32_t WHEEL_BITS = LEVELS * SLOT_BITS;
+
+    // Lowest level whose higher-order bits agree with the current tick
+    [[nodiscard]] std::uint32_t slot_for(std::uint64_t deadline) const noexcept {
+        const std::uint64_t diff = deadline ^ current_;
+        for (std::uint32_t level = 0; level < LEVELS; ++level) {
+            if ((diff >> (SLOT_BITS * (level + 1))) == 0) {
+                return level * SLOTS +
+                       static_cast<std::uint32_t>((deadline >> (SLOT_BITS * level)) & (SLOTS - 1));
+            }
+        }
+        return OVERFLOW_SLOT;
+    }
+
+    void link(T* node, std::uint32_t slot) noexcept {
+        node->timer_slot = slot;
+        node->timer_prev = nullptr;
+        node->timer_next = heads_[slot];
+        if (heads_[slot]) {
+            heads_[slot]->timer_prev = node;
+        } else if (slot != OVERFLOW_SLOT) {
+            occupied_[slot / SLOTS][(slot % SLOTS) / 64] |= 1ull << (slot % 64);
+        }
+        heads_[slot] = node;
+    }
+
+    void unlink(T* node) noexcept {
+        const std::uint32_t slot = node->timer_slot;
+        if (node->timer_prev) {
+            node->timer_prev->timer_next = node->timer_next;
+        } else {
+            heads_[slot] = node->timer_next;
+            if (!heads_[slot] && slot != OVERFLOW_SLOT) {
+                occupied_[slot / SLOTS][(slot % SLOTS) / 64] &= ~(1ull << (slot % 64));
+            }
+        }
+        if (node->timer_next) {
+            node->timer_next->timer_prev = node->timer_prev;
+        }
+        node->timer_next = nullptr;
+        node->timer_prev = nullptr;
+        node->timer_slot = NO_SLOT;
+    }
+
+    // First occupied slot index >= from at the given level, or SLOTS if none
+    [[nodiscard]] std::uint32_t find_occupied(std::uint32_t level, std::uint32_t from) const noexcept {
+        for (std::uint32_t word = from / 64; word < WORDS; ++word) {
+            std::uint64_t bits = occupied_[level][word];
+            if (word == from / 64) {
+                bits &= ~0ull << (from % 64);
+            }
+            if (bits) {
+                return word * 64 + static_cast<std::uint32_t>(std::countr_zero(bits));
+            }
+        }
+        return SLOTS;
+    }
+
+    // Earliest tick <= now at which a slot needs draining or cascading
+    [[nodiscard]] std::uint64_t next_stop(std::uint64_t now) const noexcept {
+        std::uint64_t stop = now;
+        for (std::uint32_t level = 0; level < LEVELS; ++level) {
+            const std::uint32_t shift = SLOT_BITS * level;
+            const std::uint32_t index = static_cast<std::uint32_t>((current_ >> shift) & (SLOTS - 1));
+            const std::uint32_t next = find_occupied(level, index + 1);
+            if (next < SLOTS) {
+                const std::uint64_t base = (current_ >> (shift + SLOT_BITS)) << (shift + SLOT_BITS);
+                stop = std::min(stop, base | (static_cast<std::uint64_t>(next) << shift));
+            }
+        }
+        if (heads_[OVERFLOW_SLOT]) {
+            stop = std::min(stop, ((current_ >> WHEEL_BITS) + 1) << WHEEL_BITS);
+        }
+        return stop;
+    }
+
+    // Move to tick and cascade every slot whose span starts there (highest level first)
+    void step_to(std::uint64_t tick) noexcept {
+        current_ = tick;
+        if ((tick & ((1ull << WHEEL_BITS) - 1)) == 0) {
+            cascade(OVERFLOW_SLOT);
+        }
+        for (std::uint32_t level = LEVELS - 1; level > 0; --level) {
+            const std::uint32_t shift = SLOT_BITS * level;
+            if ((tick & ((1ull << shift) - 1)) == 0) {
+                cascade(level * SLOTS + static_cast<std::uint32_t>((tick >> shift) & (SLOTS - 1)));
+            }
+        }
+    }
+
+    void cascade(std::uint32_t slot) noexcept {
+        T* node = heads_[slot];
+        while (node) {
+            T* next = node->timer_next;
+            unlink(node);
+            link(node, slot_for(std::max(node->timer_deadline, current_)));
+            node = next;
+        }
+    }
+
+    std::array<T*, LEVELS * SLOTS + 1> heads_;
+    std::array<std::array<std::uint64_t, WORDS>, LEVELS> occupied_;
+    std::uint64_t current_;
+    std::size_t size_{0};
+};
+
+} // namespace lob
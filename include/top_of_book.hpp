@@ -0,0 +1,110 @@
+#pragma once
+
+#include "engine_observer.hpp"
+#include "seqlock.hpp"
+#include "types.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace lob {
+
+struct BookLevel {
+    Price price{0};
+    Quantity quantity{0};
+};
+
+// Best levels of both sides as of the last engine message that changed the book
+struct TopOfBookSnapshot {
+    static constexpr std::size_t DEPTH = 5;
+
+    std::uint64_t sequence{0};      // Engine messages observed
+    std::uint64_t book_version{0};  // OrderBook::version() when published
+    std::uint32_t bid_depth{0};     // Valid entries in bids/asks, best first
+    std::uint32_t ask_depth{0};
+    std::array<BookLevel, DEPTH> bids{};
+    std::array<BookLevel, DEPTH> asks{};
+
+    [[nodiscard]] std::optional<BookLevel> best_bid() const noexcept {
+        return bid_depth ? std::optional{bids[0]} : std::nullopt;
+    }
+    [[nodiscard]] std::optional<BookLevel> best_ask() const noexcept {
+        return ask_depth ? std::optional{asks[0]} : std::nullopt;
+    }
+};
+
+// Publication slot; address-free, so it may live in a POSIX shared memory object.
+// magic is set last by the creator, and readers refuse a region until it matches.
+struct TopOfBookRegion {
+    static constexpr std::uint64_t MAGIC = 0x4c4f42544f42'0001;  // "LOBTOB", layout 1
+
+    std::atomic<std::uint64_t> magic{0};
+    std::uint32_t depth{TopOfBookSnapshot::DEPTH};
+    std::uint32_t snapshot_size{sizeof(TopOfBookSnapshot)};
+    SeqLock<TopOfBookSnapshot> slot;
+};
+
+// Opt-in observer publishing the top DEPTH levels per side for other threads
+// Republishes once per message that moved the book version, copying the levels in
+// place from the book; messages that change nothing only bump the local sequence.
+// Readers spin on the seqlock and never stall the matching thread.
+class TopOfBookPublisher : public EngineObserver {
+public:
+    // Slot in process memory
+    TopOfBookPublisher();
+    // Slot in a new shared memory object (/dev/shm/<name>), unlinked again on destruction;
+    // nullptr if it cannot be created (for instance because the name is taken)
+    [[nodiscard]] static std::unique_ptr<TopOfBookPublisher> create_shared(const std::string& name);
+    ~TopOfBookPublisher() override;
+
+    TopOfBookPublisher(const TopOfBookPublisher&) = delete;
+    TopOfBookPublisher& operator=(const TopOfBookPublisher&) = delete;
+
+    void on_message_processed(const OrderBook& book) override;
+
+    [[nodiscard]] TopOfBookSnapshot snapshot() const noexcept {
+        return region_->slot.load();
+    }
+    [[nodiscard]] bool try_snapshot(TopOfBookSnapshot& out) const noexcept {
+        return region_->slot.try_load(out);
+    }
+
+private:
+    TopOfBookPublisher(TopOfBookRegion* region, std::string shm_name);
+
+    TopOfBookRegion* region_;
+    std::string shm_name_;  // Empty for the process-local slot
+    std::uint64_t sequence_{0};
+    std::uint64_t published_version_{UINT64_MAX};
+    TopOfBookSnapshot current_;
+};
+
+// Read-only view of a TopOfBookPublisher::create_shared slot from another process
+class TopOfBookReader {
+public:
+    // std::nullopt if the object does not exist or is not a compatible, initialized slot
+    [[nodiscard]] static std::optional<TopOfBookReader> open(const std::string& name);
+    ~TopOfBookReader();
+
+    TopOfBookReader(TopOfBookReader&& other) noexcept;
+    TopOfBookReader& operator=(TopOfBookReader&& other) noexcept;
+    TopOfBookReader(const TopOfBookReader&) = delete;
+    TopOfBookReader& operator=(const TopOfBookReader&) = delete;
+
+    [[nodiscard]] TopOfBookSnapshot snapshot() const noexcept {
+        return region_->slot.load();
+    }
+    [[nodiscard]] bool try_snapshot(TopOfBookSnapshot& out) const noexcept {
+        return region_->slot.try_load(out);
+    }
+
+private:
+    explicit TopOfBookReader(const TopOfBookRegion* region) noexcept : region_(region) {}
+
+    const TopOfBookRegion* region_;
+};
+
+} // namespace lob
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "engine_observer.hpp"
+#include "matching_engine.hpp"
+#include "spsc_ring.hpp"
+#include "types.hpp"
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lob {
+
+namespace tape {
+
+// On-disk trade tape: a sequence of self-contained blocks, little-endian
+// A block is a BlockHeader followed by one bit-packed column per field, each
+// padded to a whole number of 64-bit words. Every column stores per-trade codes
+// of width[c] bits that are added to base[c]: timestamps, prices and order ids as
+// zigzag deltas from the previous trade in the block (base = the first value),
+// quantities and participants as offsets from the block minimum, the aggressor
+// as 0 (none), 1 (buy) or 2 (sell). Timestamps are wall clock, nanoseconds since
+// the epoch: the engine's steady-clock trade times plus the block's clock_offset.
+// Appending blocks to an existing tape is always valid, and a torn block at the end
+// is ignored by readers.
+
+static_assert(std::endian::native == std::endian::little, "Tape blocks are copied as-is");
+
+inline constexpr std::uint32_t BLOCK_MAGIC = 0x45504154;  // "TAPE"
+
+enum Column : std::size_t {
+    TimeColumn = 0,
+    PriceColumn,
+    QuantityColumn,
+    BuyOrderColumn,
+    SellOrderColumn,
+    BuyParticipantColumn,
+    SellParticipantColumn,
+    AggressorColumn,
+    COLUMNS
+};
+
+struct BlockHeader {
+    std::uint32_t magic;
+    std::uint32_t count;            // Trades in the block
+    std::uint64_t bytes;            // Whole block, header included
+    std::int64_t first_timestamp;   // Zone map: interval scans skip blocks outside
+    std::int64_t last_timestamp;
+    std::int64_t clock_offset;      // Wall minus steady clock as the block was started
+    std::array<std::int64_t, COLUMNS> base;
+    std::array<std::uint8_t, COLUMNS> width;
+};
+
+static_assert(sizeof(BlockHeader) == 112 && sizeof(BlockHeader) % 8 == 0);
+
+} // namespace tape
+
+struct TradeTapeOptions {
+    std::size_t block_trades{4096};                  // Trades per block (the last may hold fewer)
+    std::size_t write_bytes{4 << 20};                // Encoded blocks gathered per write()
+    std::chrono::milliseconds flush_interval{1000};  // Longest a trade waits in memory
+};
+
+// Drop copy of every fill, appended to a columnar tape file by a background thread
+// on_trade() (matching thread) only copies the trade into an SPSC ring. The writer
+// thread stages trades column by column, encodes a block every block_trades, and
+// hands the file write_bytes at a time, so the disk sees large sequential writes.
+// No fill is dropped: while the ring is full the matching thread waits (counted in
+// stalls()).
+class TradeTapeWriter : public EngineObserver {
+public:
+    using Options = TradeTapeOptions;
+    static constexpr std::size_t QUEUE = 1 << 16;  // Trades in flight to the writer
+
+    // Appends to path, creating it; nullptr if it cannot be opened
+    [[nodiscard]] static std::unique_ptr<TradeTapeWriter> create(MatchingEngine& engine, const std::string& path,
+                                                                 const Options& options = {});
+    // Writes everything still queued
+    ~TradeTapeWriter() override;
+
+    TradeTapeWriter(const TradeTapeWriter&) = delete;
+    TradeTapeWriter& operator=(const TradeTapeWriter&) = delete;
+
+    void on_trade(const Trade& trade) override;
+
+    // From the matching thread: return once every trade seen so far is in the file
+    void flush();
+
+    [[nodiscard]] std::uint64_t trades_written() const noexcept {
+        return durable_.load(std::memory_order_acquire);
+    }
+    [[nodiscard]] std::uint64_t bytes_written() const noexcept {
+        return bytes_written_.load(std::memory_order_relaxed);
+    }
+    [[nodiscard]] std::uint64_t write_errors() const noexcept {
+        return write_errors_.load(std::memory_order_relaxed);
+    }
+    [[nodiscard]] std::uint64_t stalls() const noexcept {
+        return stalls_;
+    }
+
+private:
+    TradeTapeWriter(MatchingEngine& engine, int fd, const Options& options);
+
+    void run();
+    void stage(const Trade& trade) noexcept;
+    void encode_block();
+    void write_out();
+
+    MatchingEngine& engine_;
+    int fd_;
+    std::size_t block_trades_;
+    std::size_t write_bytes_;
+    std::chrono::milliseconds flush_interval_;
+
+    // Matching thread
+    std::uint64_t pushed_{0};
+    std::uint64_t stalls_{0};
+
+    // Shared
+    std::unique_ptr<SpscRing<Trade, QUEUE>> ring_;
+    std::atomic<std::uint64_t> flush_target_{0};
+    std::atomic<std::uint64_t> durable_{0};
+    std::atomic<std::uint64_t> bytes_written_{0};
+    std::atomic<std::uint64_t> write_errors_{0};
+    std::atomic<bool> stop_{false};
+
+    // Writer thread
+    std::array<std::vector<std::int64_t>, tape::COLUMNS> staged_;
+    std::size_t staged_count_{0};
+    std::int64_t clock_offset_{0};   // Of the staged block
+    std::uint64_t encoded_{0};       // Trades in blocks (written or in buffer_)
+    std::vector<std::uint64_t> codes_;
+    std::vector<std::byte> buffer_;  // Encoded blocks not yet written
+    std::thread thread_;
+};
+
+// Aggregates of the trades in one interval of a TradeTapeReader::bars() scan
+struct TradeBar {
+    Timestamp start{0};
+    std::uint64_t trades{0};
+    Quantity volume{0};
+    Notional notional{0};  // Sum of price x quantity
+    Price high{0};
+    Price low{0};
+
+    [[nodiscard]] double vwap() const noexcept {
+        return volume ? static_cast<double>(notional) / static_cast<double>(volume) : 0.0;
+    }
+};
+
+// Read-only view of a tape file through a private memory mapping
+// Blocks are indexed once at open(); bars() decodes only the timestamp, price and
+// quantity columns of the blocks whose zone map overlaps the range.
+class TradeTapeReader {
+public:
+    // nullptr if the file cannot be mapped or does not start with a block
+    [[nodiscard]] static std::unique_ptr<TradeTapeReader> open(const std::string& path);
+    ~TradeTapeReader();
+
+    TradeTapeReader(const TradeTapeReader&) = delete;
+    TradeTapeReader& operator=(const TradeTapeReader&) = delete;
+
+    [[nodiscard]] std::size_t blocks() const noexcept {
+        return blocks_.size();
+    }
+    [[nodiscard]] std::uint64_t trades() const noexcept {
+        return trades_;
+    }
+    [[nodiscard]] std::size_t file_bytes() const noexcept {
+        return size_;
+    }
+    [[nodiscard]] const tape::BlockHeader& block_header(std::size_t block) const noexcept {
+        return *blocks_[block];
+    }
+
+    // Append every trade of block to out, in tape order
+    void read_block(std::size_t block, std::vector<Trade>& out) const;
+    // One bar per interval from begin until end (exclusive, wall clock), covering the
+    // trades with begin <= timestamp < end
+    [[nodiscard]] std::vector<TradeBar> bars(Timestamp begin, Timestamp end, Timestamp interval) const;
+
+private:
+    TradeTapeReader(const std::byte* data, std::size_t size, std::vector<const tape::BlockHeader*> blocks);
+
+    const std::byte* data_;
+    std::size_t size_;
+    std::vector<const tape::BlockHeader*> blocks_;
+    std::uint64_t trades_{0};
+};
+
+} // namespace lob
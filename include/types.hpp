@@ -1,16 +1,22 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <chrono>
 #include <compare>
+#include <optional>
 
 namespace lob {
 
 using Price = std::int64_t;  // Price in ticks (e.g., cents for USD)
 using Quantity = std::uint64_t;
+using Notional = std::int64_t;  // Price ticks x quantity
 using OrderId = std::uint64_t;
 using Timestamp = std::chrono::nanoseconds;
+using ParticipantId = std::uint32_t;  // Participant/account tag (0 = untagged)
+
+inline constexpr ParticipantId NO_PARTICIPANT = 0;
 
 enum class Side : std::uint8_t {
     Buy = 0,
@@ -24,6 +30,26 @@ enum class OrderType : std::uint8_t {
     FOK = 3   // Fill or Kill
 };
 
+enum class TimeInForce : std::uint8_t {
+    GTC = 0,  // Good till cancelled
+    Day = 1,  // Expires at the session close
+    GTT = 2   // Good till time (expires at expire_time)
+};
+
+enum class SessionState : std::uint8_t {
+    Continuous = 0,  // Incoming orders match immediately
+    Auction = 1      // Call period: orders accumulate until uncross()
+};
+
+// Action taken when an aggressor would trade against a resting order of the same participant
+enum class SelfTradePrevention : std::uint8_t {
+    None = 0,          // Self-trades allowed
+    CancelNewest = 1,  // Cancel the remainder of the incoming order
+    CancelOldest = 2,  // Cancel the resting order and keep matching
+    CancelBoth = 3,    // Cancel both orders
+    Decrement = 4      // Reduce both by the smaller remaining quantity, cancel whichever hits zero
+};
+
 enum class OrderStatus : std::uint8_t {
     New = 0,
     PartiallyFilled = 1,
@@ -41,9 +67,24 @@ struct Order {
     Quantity filled_quantity{0};
     Timestamp timestamp;
     OrderStatus status{OrderStatus::New};
+    TimeInForce time_in_force{TimeInForce::GTC};
+    ParticipantId participant{NO_PARTICIPANT};
+    Timestamp expire_time{0};  // Only meaningful for Day/GTT orders
     
     Order* next{nullptr};
     Order* prev{nullptr};
+    std::uint32_t queue_slot{0};  // Arrival slot within its price level (see OrderBook::queue_position)
+    std::uint32_t arrival{0};     // Book-wide arrival number (wraps); time priority in OrderBook::state_hash
+    
+    // Intrusive per-participant list (per side), used by mass cancel
+    Order* participant_next{nullptr};
+    Order* participant_prev{nullptr};
+    
+    // Intrusive expiry timer hook (see TimingWheel)
+    Order* timer_next{nullptr};
+    Order* timer_prev{nullptr};
+    std::uint64_t timer_deadline{0};
+    std::uint32_t timer_slot{UINT32_MAX};
     
     auto operator<=>(const Order& other) const noexcept {
         if (side != other.side) {
@@ -78,6 +119,35 @@ struct Trade {
     Price price;
     Quantity quantity;
     Timestamp timestamp;
+    ParticipantId buy_participant{NO_PARTICIPANT};
+    ParticipantId sell_participant{NO_PARTICIPANT};
+    std::optional<Side> aggressor;  // Empty for auction uncross fills
+};
+
+// Aggregated quantity at a price level after a change (quantity 0 = level removed)
+struct LevelUpdate {
+    Side side;
+    Price price;
+    Quantity quantity;
+};
+
+// Resting quantity ahead of an order in its level's time priority
+struct QueuePosition {
+    Quantity quantity_ahead;
+    Quantity level_quantity;  // Total remaining at the level, including the order itself
+};
+
+// Result of walking the opposite side of the book for a hypothetical aggressor
+struct SweepCost {
+    Quantity quantity{0};   // Quantity that would fill
+    Notional notional{0};   // Sum of price x quantity over the fills
+    Price last_price{0};    // Worst price touched (0 if nothing fills)
+    std::size_t levels{0};  // Price levels consumed, including a partially taken last level
+    bool complete{false};   // Whole target could be filled
+    
+    [[nodiscard]] double average_price() const noexcept {
+        return quantity ? static_cast<double>(notional) / static_cast<double>(quantity) : 0.0;
+    }
 };
 
 } // namespace lob
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "command_journal.hpp"
+#include "io_uring.hpp"
+#include "matching_engine.hpp"
+#include "order_entry.hpp"
+#include "wire_protocol.hpp"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lob {
+
+struct UringGatewayOptions {
+    bool sqpoll{false};
+    std::string journal_path;  // Empty: no journal
+    JournalFormat journal_format{JournalFormat::Raw};
+};
+
+// io_uring backend for the order-entry gateway and the command journal
+// Same sessions, wire protocol and decode path as TcpGateway; only the I/O differs:
+//  - one multishot accept and one multishot receive per connection, drawing from a
+//    ring of provided buffers; frames are decoded in place from those buffers
+//  - replies and journal batches are copied into registered buffers and written with
+//    WRITE_FIXED, at most one write in flight per connection
+//  - everything queued during a loop turn goes out in a single submit, which is no
+//    syscall at all under SQPOLL while the SQ thread is awake
+// The journal (optional) receives a JournalRecord per executed command (disconnect
+// cancels included, so replaying it rebuilds the book), raw or through a JournalEncoder,
+// double buffered and written at increasing offsets; it is not fsync'ed. A session whose
+// unsent replies exceed OUTPUT_LIMIT is closed as a slow consumer.
+class UringGateway {
+public:
+    using Options = UringGatewayOptions;
+
+    static constexpr std::size_t RECEIVE_BUFFER = 16 * 1024;
+    static constexpr std::size_t SEND_BUFFER = 64 * 1024;
+    static constexpr std::size_t JOURNAL_BUFFER = 1024 * 1024;
+    static constexpr std::size_t OUTPUT_LIMIT = 16 * 1024 * 1024;
+
+    // nullptr if io_uring (with multishot receive and provided-buffer rings, Linux 6.0+)
+    // is unavailable or the socket/journal cannot be opened
+    [[nodiscard]] static std::unique_ptr<UringGateway>
+    create(MatchingEngine& engine, std::uint16_t port, std::size_t max_sessions,
+           const Options& options = {}, const std::string& address = "127.0.0.1");
+    ~UringGateway();
+
+    UringGateway(const UringGateway&) = delete;
+    UringGateway& operator=(const UringGateway&) = delete;
+
+    // Handle ready completions (waiting up to timeout if there are none) and submit
+    // the resulting sends and journal writes; returns commands executed
+    std::size_t poll(std::chrono::milliseconds timeout);
+
+    [[nodiscard]] std::uint16_t port() const noexcept {
+        return port_;
+    }
+    [[nodiscard]] std::size_t open_sessions() const noexcept {
+        return sessions_.open_sessions();
+    }
+    // Kernel entries so far; divided by commands this is the syscall cost per message
+    [[nodiscard]] std::uint64_t syscalls() const noexcept {
+        return ring_->enters() + extra_syscalls_;
+    }
+    // Bytes of journal handed to the kernel (written or in flight)
+    [[nodiscard]] std::uint64_t journal_bytes() const noexcept {
+        return journal_offset_;
+    }
+    [[nodiscard]] std::uint64_t journal_errors() const noexcept {
+        return journal_errors_;
+    }
+
+private:
+    enum class Op : std::uint8_t {
+        Accept = 1,
+        Receive = 2,
+        Send = 3,
+        Journal = 4
+    };
+
+    struct Connection {
+        int fd{-1};
+        std::uint32_t generation{0};  // Tells completions of a reused slot apart
+        bool receiving{false};        // Multishot receive armed
+        bool sending{false};          // WRITE_FIXED in flight
+        std::size_t send_offset{0};   // Within the staged send buffer
+        std::size_t send_length{0};
+        std::size_t partial{0};       // Bytes of an incomplete frame kept in carry
+        std::array<std::byte, 2 * wire::MAX_FRAME> carry{};
+    };
+
+    struct JournalHalf {
+        std::size_t length{0};
+        std::uint64_t offset{0};  // File offset of the write in flight
+        bool in_flight{false};
+    };
+
+    UringGateway(MatchingEngine& engine, std::size_t max_sessions, std::unique_ptr<IoUring> ring,
+                 int listen_fd, int journal_fd, JournalFormat journal_format, std::uint16_t port);
+    [[nodiscard]] bool setup_buffers();
+
+    [[nodiscard]] io_uring_sqe* next_sqe();
+    void arm_accept();
+    void arm_receive(std::size_t slot);
+    void stage_send(std::size_t slot);
+    void submit_send(std::size_t slot);
+    void handle(const io_uring_cqe& cqe);
+    void on_accept(int result, bool more);
+    void on_receive(std::size_t slot, int result, std::uint32_t flags);
+    void on_send(std::size_t slot, int result);
+    void on_journal(std::size_t half, int result);
+    // Decode in place; a frame split across buffers is completed in the carry area
+    [[nodiscard]] bool feed(std::size_t slot, std::span<const std::byte> data);
+    void recycle_buffer(std::uint16_t bid);
+    void close_connection(std::size_t slot);
+
+    void journal_command(std::uint64_t sequence, ParticipantId participant, const OrderCommand& command);
+    void flush_journal();
+    // Blocking fallback for a full buffer or a short write
+    void write_journal_sync(const std::byte* data, std::size_t length, std::uint64_t offset);
+    [[nodiscard]] std::byte* journal_half(std::size_t half) noexcept {
+        return journal_memory_.get() + half * JOURNAL_BUFFER;
+    }
+
+    [[nodiscard]] std::byte* send_buffer(std::size_t slot) noexcept {
+        return send_memory_.get() + slot * SEND_BUFFER;
+    }
+    [[nodiscard]] std::byte* receive_buffer(std::uint16_t bid) noexcept {
+        return receive_memory_.get() + static_cast<std::size_t>(bid) * RECEIVE_BUFFER;
+    }
+
+    std::unique_ptr<IoUring> ring_;
+    OrderEntrySessions sessions_;
+    std::vector<Connection> connections_;
+    std::size_t commands_{0};  // Executed during the current poll()
+
+    // Aligned to pages so registration pins whole pages
+    struct PageFree {
+        std::size_t size;
+        void operator()(std::byte* memory) const noexcept;
+    };
+    using PageMemory = std::unique_ptr<std::byte[], PageFree>;
+    PageMemory receive_memory_{nullptr, PageFree{0}};
+    PageMemory send_memory_{nullptr, PageFree{0}};
+    PageMemory journal_memory_{nullptr, PageFree{0}};
+    io_uring_buf_ring* buffer_ring_{nullptr};
+    unsigned buffer_count_{0};
+
+    int listen_fd_;
+    int journal_fd_;
+    JournalFormat journal_format_;
+    std::uint16_t port_;
+    JournalEncoder journal_encoder_;
+    std::array<JournalHalf, 2> journal_halves_{};
+    std::size_t journal_active_{0};
+    std::uint64_t journal_offset_{0};
+    std::uint64_t journal_errors_{0};
+    std::uint64_t extra_syscalls_{0};  // Made outside io_uring (accept setup, close, fallback writes)
+};
+
+} // namespace lob
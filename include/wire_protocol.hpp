@@ -0,0 +1,201 @@
+#pragma once
+
+#include "order_command.hpp"
+#include "types.hpp"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+namespace lob::wire {
+
+// Length-prefixed binary order-entry protocol shared by the network gateways
+// Every frame is an 8-byte header followed by a fixed payload for its type, all
+// little-endian with no padding, so frames are decoded straight out of the receive
+// buffer and encoded straight into the send buffer. Header seq is a per-session,
+// per-direction sequence number starting at 1; a gap closes the session.
+
+static_assert(std::endian::native == std::endian::little, "Wire structs are copied as-is");
+
+enum class MessageType : std::uint8_t {
+    NewOrder = 1,
+    CancelOrder = 2,
+    ModifyOrder = 3,
+    ExecReport = 4
+};
+
+struct FrameHeader {
+    std::uint16_t length;  // Whole frame, header included
+    MessageType type;
+    std::uint8_t flags;
+    std::uint32_t seq;
+};
+
+struct NewOrderBody {
+    OrderId id;
+    Price price;
+    Quantity quantity;
+    std::int64_t expire_time;  // Wall clock, nanoseconds since the epoch; GTT only
+    Side side;
+    OrderType order_type;
+    TimeInForce time_in_force;
+    std::uint8_t reserved[5];
+};
+
+struct CancelOrderBody {
+    OrderId id;
+};
+
+struct ModifyOrderBody {
+    OrderId id;
+    Price price;
+    Quantity quantity;
+};
+
+using ExecReportBody = ExecutionReport;
+
+static_assert(sizeof(FrameHeader) == 8);
+static_assert(sizeof(NewOrderBody) == 40);
+static_assert(sizeof(CancelOrderBody) == 8);
+static_assert(sizeof(ModifyOrderBody) == 24);
+
+inline constexpr std::size_t NEW_ORDER_FRAME = sizeof(FrameHeader) + sizeof(NewOrderBody);
+inline constexpr std::size_t CANCEL_ORDER_FRAME = sizeof(FrameHeader) + sizeof(CancelOrderBody);
+inline constexpr std::size_t MODIFY_ORDER_FRAME = sizeof(FrameHeader) + sizeof(ModifyOrderBody);
+inline constexpr std::size_t EXEC_REPORT_FRAME = sizeof(FrameHeader) + sizeof(ExecReportBody);
+inline constexpr std::size_t MAX_FRAME = NEW_ORDER_FRAME > EXEC_REPORT_FRAME ? NEW_ORDER_FRAME : EXEC_REPORT_FRAME;
+
+enum class DecodeStatus : std::uint8_t {
+    Ok = 0,
+    NeedMore = 1,  // Incomplete frame at the front of the buffer
+    Invalid = 2    // Unknown type or a length that does not match it
+};
+
+struct DecodeResult {
+    DecodeStatus status;
+    std::size_t consumed{0};  // Frame length when Ok
+    std::uint32_t seq{0};
+};
+
+[[nodiscard]] constexpr std::size_t frame_length(MessageType type) noexcept {
+    switch (type) {
+        case MessageType::NewOrder: return NEW_ORDER_FRAME;
+        case MessageType::CancelOrder: return CANCEL_ORDER_FRAME;
+        case MessageType::ModifyOrder: return MODIFY_ORDER_FRAME;
+        case MessageType::ExecReport: return EXEC_REPORT_FRAME;
+    }
+    return 0;
+}
+
+template<typename T>
+[[nodiscard]] inline T load(const std::byte* source) noexcept {
+    T value;
+    std::memcpy(&value, source, sizeof(T));
+    return value;
+}
+
+// Decode the client frame at the front of buffer into command (client_seq = frame seq)
+[[nodiscard]] inline DecodeResult decode_command(std::span<const std::byte> buffer,
+                                                 OrderCommand& command) noexcept {
+    if (buffer.size() < sizeof(FrameHeader)) {
+        return {DecodeStatus::NeedMore};
+    }
+    const auto header = load<FrameHeader>(buffer.data());
+    if (header.type == MessageType::ExecReport || header.length != frame_length(header.type)) {
+        return {DecodeStatus::Invalid};
+    }
+    if (buffer.size() < header.length) {
+        return {DecodeStatus::NeedMore};
+    }
+
+    const std::byte* body = buffer.data() + sizeof(FrameHeader);
+    command = OrderCommand{.client_seq = header.seq};
+    switch (header.type) {
+        case MessageType::NewOrder: {
+            const auto order = load<NewOrderBody>(body);
+            if (!valid_order_fields(order.side, order.order_type, order.time_in_force)) {
+                return {DecodeStatus::Invalid};
+            }
+            command.type = CommandType::New;
+            command.id = order.id;
+            command.price = order.price;
+            command.quantity = order.quantity;
+            command.expire_time = order.expire_time;
+            command.side = order.side;
+            command.order_type = order.order_type;
+            command.time_in_force = order.time_in_force;
+            break;
+        }
+        case MessageType::CancelOrder:
+            command.type = CommandType::Cancel;
+            command.id = load<CancelOrderBody>(body).id;
+            break;
+        default: {
+            const auto modify = load<ModifyOrderBody>(body);
+            command.type = CommandType::Modify;
+            command.id = modify.id;
+            command.price = modify.price;
+            command.quantity = modify.quantity;
+            break;
+        }
+    }
+    return {DecodeStatus::Ok, header.length, header.seq};
+}
+
+// Decode the exec report frame at the front of buffer
+[[nodiscard]] inline DecodeResult decode_report(std::span<const std::byte> buffer,
+                                                ExecutionReport& report) noexcept {
+    if (buffer.size() < sizeof(FrameHeader)) {
+        return {DecodeStatus::NeedMore};
+    }
+    const auto header = load<FrameHeader>(buffer.data());
+    if (header.type != MessageType::ExecReport || header.length != EXEC_REPORT_FRAME) {
+        return {DecodeStatus::Invalid};
+    }
+    if (buffer.size() < header.length) {
+        return {DecodeStatus::NeedMore};
+    }
+    report = load<ExecReportBody>(buffer.data() + sizeof(FrameHeader));
+    return {DecodeStatus::Ok, header.length, header.seq};
+}
+
+// Encoders write one frame at out (which must have frame_length(type) bytes) and return its length
+inline std::size_t encode_command(std::byte* out, const OrderCommand& command, std::uint32_t seq) noexcept {
+    switch (command.type) {
+        case CommandType::New: {
+            const FrameHeader header{NEW_ORDER_FRAME, MessageType::NewOrder, 0, seq};
+            const NewOrderBody body{command.id, command.price, command.quantity, command.expire_time,
+                                    command.side, command.order_type, command.time_in_force, {}};
+            std::memcpy(out, &header, sizeof(header));
+            std::memcpy(out + sizeof(header), &body, sizeof(body));
+            return NEW_ORDER_FRAME;
+        }
+        case CommandType::Cancel: {
+            const FrameHeader header{CANCEL_ORDER_FRAME, MessageType::CancelOrder, 0, seq};
+            const CancelOrderBody body{command.id};
+            std::memcpy(out, &header, sizeof(header));
+            std::memcpy(out + sizeof(header), &body, sizeof(body));
+            return CANCEL_ORDER_FRAME;
+        }
+        case CommandType::Modify: {
+            const FrameHeader header{MODIFY_ORDER_FRAME, MessageType::ModifyOrder, 0, seq};
+            const ModifyOrderBody body{command.id, command.price, command.quantity};
+            std::memcpy(out, &header, sizeof(header));
+            std::memcpy(out + sizeof(header), &body, sizeof(body));
+            return MODIFY_ORDER_FRAME;
+        }
+        case CommandType::MassCancel:
+            break;  // Gateway-internal, no frame
+    }
+    return 0;
+}
+
+inline std::size_t encode_report(std::byte* out, const ExecutionReport& report, std::uint32_t seq) noexcept {
+    const FrameHeader header{EXEC_REPORT_FRAME, MessageType::ExecReport, 0, seq};
+    std::memcpy(out, &header, sizeof(header));
+    std::memcpy(out + sizeof(header), &report, sizeof(report));
+    return EXEC_REPORT_FRAME;
+}
+
+} // namespace lob::wire
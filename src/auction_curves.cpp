@@ -0,0 +1,130 @@
+#include "auction_curves.hpp"
+
+namespace lob {
+
+namespace {
+
+constexpr std::size_t NO_SLOT = SIZE_MAX;
+
+// Last non-zero slot at or before slot, or NO_SLOT
+std::size_t at_or_before(const FenwickTree<Quantity>& tree, std::size_t slot) noexcept {
+    const Quantity sum = tree.prefix_sum(slot + 1);
+    return sum == 0 ? NO_SLOT : tree.lower_bound(sum);
+}
+
+// First non-zero slot at or after slot, or the tree's capacity
+std::size_t at_or_after(const FenwickTree<Quantity>& tree, std::size_t slot) noexcept {
+    return tree.lower_bound(tree.prefix_sum(slot) + 1);
+}
+
+} // namespace
+
+void AuctionCurves::rebuild_trees() {
+    std::size_t slot = 0;
+    bids_.build(size_, size_, [&] { return bid_quantity_[slot++]; });
+    slot = 0;
+    asks_.build(size_, size_, [&] { return ask_quantity_[slot++]; });
+    slot = 0;
+    levels_.build(size_, size_, [&] {
+        const Quantity quantity = bid_quantity_[slot] + ask_quantity_[slot];
+        ++slot;
+        return quantity;
+    });
+    slot = 0;
+    crossing_.build(size_, size_, [&] {
+        const Quantity quantity = ask_quantity_[slot] + (slot > 0 ? bid_quantity_[slot - 1] : 0);
+        ++slot;
+        return quantity;
+    });
+}
+
+std::optional<AuctionUncross> AuctionCurves::solve(Price best_bid, Price best_ask,
+                                                   std::optional<Price> reference) const noexcept {
+    const auto first = static_cast<std::size_t>(best_ask - low_);
+    const auto last = static_cast<std::size_t>(best_bid - low_);
+    const Quantity total_bids = bids_.prefix_sum(size_);
+    auto demand = [&](std::size_t slot) { return total_bids - bids_.prefix_sum(slot); };
+    auto supply = [&](std::size_t slot) { return asks_.prefix_sum(slot + 1); };
+
+    // Levels [from, to] sharing the same volume and surplus
+    struct Run {
+        std::size_t from;
+        std::size_t to;
+        Quantity volume;
+        Quantity surplus;
+        std::int64_t imbalance;
+    };
+    std::optional<Run> below;
+    std::optional<Run> above;
+
+    // First slot where supply reaches demand; crossing_ sums to supply plus the bids below
+    const std::size_t meet = crossing_.lower_bound(total_bids);
+    if (meet > first) {
+        // Below it volume is the supply, flat back to the last ask, and the surplus
+        // shrinks with each bid passed, so the run ends at top and starts after both
+        const std::size_t top = at_or_before(levels_, std::min(meet, last + 1) - 1);
+        const Quantity volume = supply(top);
+        if (volume > 0) {
+            std::size_t from = at_or_before(asks_, top);
+            if (const std::size_t bid = top > 0 ? at_or_before(bids_, top - 1) : NO_SLOT; bid != NO_SLOT) {
+                from = std::max(from, bid + 1);
+            }
+            const Quantity surplus = demand(top) - volume;
+            below = Run{at_or_after(levels_, from), top, volume, surplus, static_cast<std::int64_t>(surplus)};
+        }
+    }
+    if (meet <= last) {
+        // From it volume is the demand, flat up to the next bid, and the surplus grows
+        // with each ask passed
+        const std::size_t bottom = at_or_after(levels_, meet);
+        const Quantity volume = demand(bottom);
+        if (volume > 0) {
+            std::size_t to = at_or_after(bids_, bottom);
+            if (const std::size_t ask = at_or_after(asks_, bottom + 1); ask < size_) {
+                to = std::min(to, ask - 1);
+            }
+            const Quantity surplus = supply(bottom) - volume;
+            above = Run{bottom, at_or_before(levels_, to), volume, surplus, -static_cast<std::int64_t>(surplus)};
+        }
+    }
+    if (!below && !above) {
+        return std::nullopt;
+    }
+
+    auto tick = [this](std::size_t slot) { return low_ + static_cast<Price>(slot); };
+    auto distance = [&](std::size_t slot) -> Price {
+        return reference ? (tick(slot) > *reference ? tick(slot) - *reference : *reference - tick(slot)) : 0;
+    };
+    // Level of a run closest to the reference, the lower one on a tie
+    auto pick = [&](const Run& run) {
+        if (!reference || *reference <= tick(run.from)) {
+            return run.from;
+        }
+        if (*reference >= tick(run.to)) {
+            return run.to;
+        }
+        const auto slot = static_cast<std::size_t>(*reference - low_);
+        const std::size_t lower = at_or_before(levels_, slot);
+        const std::size_t upper = at_or_after(levels_, slot);
+        return distance(upper) < distance(lower) ? upper : lower;
+    };
+
+    const Run* run = below ? &*below : &*above;
+    std::size_t slot;
+    if (below && above && below->volume == above->volume && below->surplus == above->surplus) {
+        const std::size_t low = pick(*below);
+        const std::size_t high = pick(*above);
+        run = distance(high) < distance(low) ? &*above : &*below;
+        slot = run == &*above ? high : low;
+    } else {
+        if (below && above &&
+            (above->volume > below->volume ||
+             (above->volume == below->volume && above->surplus < below->surplus))) {
+            run = &*above;
+        }
+        slot = pick(*run);
+    }
+    return AuctionUncross{.price = tick(slot), .volume = run->volume, .imbalance = run->imbalance};
+}
+
+} // namespace lob
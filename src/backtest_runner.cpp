@@ -0,0 +1,187 @@
+#include "backtest_runner.hpp"
+#include "matching_engine.hpp"
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <fcntl.h>
+#include <map>
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace lob {
+
+namespace {
+
+// Shared read-only view of a journal file; every task replaying it reads the same
+// page-cache pages
+struct Mapping {
+    const std::byte* data{nullptr};
+    std::size_t size{0};
+    bool valid{false};
+};
+
+Mapping map_journal(const std::string& path) {
+    Mapping mapping;
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return mapping;
+    }
+    struct stat info{};
+    if (::fstat(fd, &info) == 0) {
+        mapping.size = static_cast<std::size_t>(info.st_size);
+        mapping.valid = true;
+        if (mapping.size > 0) {
+            void* mapped = ::mmap(nullptr, mapping.size, PROT_READ, MAP_SHARED, fd, 0);
+            if (mapped == MAP_FAILED) {
+                mapping = Mapping{};
+            } else {
+                mapping.data = static_cast<const std::byte*>(mapped);
+            }
+        }
+    }
+    ::close(fd);
+    return mapping;
+}
+
+struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<std::size_t> tasks;
+};
+
+} // namespace
+
+BacktestRunner::BacktestRunner(const Options& options)
+    : threads_(options.threads ? options.threads : std::max(1U, std::thread::hardware_concurrency()))
+    , decode_batch_(std::max<std::size_t>(options.decode_batch, 1))
+{
+}
+
+std::vector<BacktestResult> BacktestRunner::run(std::span<const BacktestTask> tasks,
+                                                const StrategyFactory& factory) {
+    steals_.store(0, std::memory_order_relaxed);
+    std::vector<BacktestResult> results(tasks.size());
+    if (tasks.empty()) {
+        return results;
+    }
+
+    std::map<std::string, Mapping> mappings;
+    std::vector<const Mapping*> task_mapping(tasks.size());
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        auto [it, inserted] = mappings.try_emplace(tasks[i].journal);
+        if (inserted) {
+            it->second = map_journal(tasks[i].journal);
+        }
+        task_mapping[i] = &it->second;
+    }
+
+    const std::size_t workers = std::min(threads_, tasks.size());
+    std::vector<WorkerQueue> queues(workers);
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        queues[i % workers].tasks.push_back(i);
+    }
+    // Nothing is queued once workers start, so a sweep that finds every deque empty ends it
+    auto next_task = [&](std::size_t self) -> std::optional<std::size_t> {
+        {
+            std::lock_guard lock(queues[self].mutex);
+            if (!queues[self].tasks.empty()) {
+                const std::size_t task = queues[self].tasks.back();
+                queues[self].tasks.pop_back();
+                return task;
+            }
+        }
+        for (std::size_t k = 1; k < workers; ++k) {
+            WorkerQueue& victim = queues[(self + k) % workers];
+            std::lock_guard lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                const std::size_t task = victim.tasks.front();
+                victim.tasks.pop_front();
+                steals_.fetch_add(1, std::memory_order_relaxed);
+                return task;
+            }
+        }
+        return std::nullopt;
+    };
+
+    auto work = [&](std::size_t self) {
+        std::vector<JournalRecord> batch(decode_batch_);  // Reused by every compressed task
+        while (const std::optional<std::size_t> index = next_task(self)) {
+            const BacktestTask& task = tasks[*index];
+            const Mapping& mapping = *task_mapping[*index];
+            BacktestResult& result = results[*index];
+            result.worker = static_cast<std::uint32_t>(self);
+            if (!mapping.valid) {
+                continue;
+            }
+            const auto start = std::chrono::steady_clock::now();
+            // Built here and gone at the end of the iteration: one book per thread at a time
+            auto engine = std::make_unique<MatchingEngine>();
+            auto strategy = factory(task, *index);
+            auto backtester = strategy ? Backtester::create(*engine, *strategy, task.options) : nullptr;
+            if (!backtester) {
+                continue;
+            }
+
+            std::int64_t last_time = 0;
+            if (task.format == JournalFormat::Raw) {
+                const std::span records(reinterpret_cast<const JournalRecord*>(mapping.data),
+                                        mapping.size / sizeof(JournalRecord));
+                backtester->run(records);
+                last_time = records.empty() ? 0 : records.back().timestamp;
+            } else {
+                JournalDecoder decoder;
+                std::size_t offset = 0;
+                bool more = true;
+                while (more) {
+                    std::size_t count = 0;
+                    while (count < batch.size()) {
+                        const std::size_t used = decoder.decode(mapping.data + offset, mapping.size - offset,
+                                                                batch[count]);
+                        if (used == 0) {
+                            more = false;  // End of the journal, or a torn tail
+                            break;
+                        }
+                        offset += used;
+                        ++count;
+                    }
+                    backtester->run(std::span(batch.data(), count));
+                    last_time = count ? batch[count - 1].timestamp : last_time;
+                }
+            }
+            // Long enough for a reaction to the last record to come back
+            const BacktestOptions& options = task.options;
+            backtester->advance(Timestamp{last_time} + options.feed_latency + options.order_latency +
+                                options.response_latency);
+
+            result.completed = true;
+            result.position = backtester->position();
+            result.cash = backtester->cash();
+            result.mark = engine->last_trade_price();
+            result.records = backtester->records();
+            result.commands_sent = backtester->commands_sent();
+            result.fills = backtester->fills();
+            result.dropped = backtester->dropped();
+            result.elapsed = std::chrono::duration_cast<Timestamp>(std::chrono::steady_clock::now() - start);
+        }
+    };
+
+    {
+        std::vector<std::jthread> pool;
+        pool.reserve(workers - 1);
+        for (std::size_t self = 1; self < workers; ++self) {
+            pool.emplace_back(work, self);
+        }
+        work(0);
+    }
+
+    for (auto& [path, mapping] : mappings) {
+        if (mapping.data) {
+            ::munmap(const_cast<std::byte*>(mapping.data), mapping.size);
+        }
+    }
+    return results;
+}
+
+} // namespace lob
@@ -0,0 +1,193 @@
+#include "backtester.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace lob {
+
+std::unique_ptr<Backtester> Backtester::create(MatchingEngine& engine, BacktestStrategy& strategy,
+                                               const Options& options) {
+    if (!std::has_single_bit(options.queue_capacity) || options.participant == NO_PARTICIPANT) {
+        return nullptr;
+    }
+    // Private constructor, so no make_unique
+    return std::unique_ptr<Backtester>(new Backtester(engine, strategy, options));
+}
+
+Backtester::Backtester(MatchingEngine& engine, BacktestStrategy& strategy, const Options& options)
+    : engine_(engine)
+    , strategy_(strategy)
+    , feed_latency_(options.feed_latency)
+    , order_latency_(options.order_latency)
+    , response_latency_(options.response_latency)
+    , participant_(options.participant)
+    , commands_(options.queue_capacity)
+    , market_(options.queue_capacity)
+    , reports_(options.queue_capacity)
+    , next_id_(options.first_order_id)
+{
+    engine_.set_keep_trades(true);  // Settled after every command
+}
+
+void Backtester::run(std::span<const JournalRecord> records) {
+    for (const JournalRecord& record : records) {
+        process_before(Timestamp{record.timestamp});
+        apply_record(record);
+    }
+}
+
+void Backtester::advance(Timestamp until) {
+    process_before(until + Timestamp{1});
+    now_ = std::max(now_, until);
+}
+
+void Backtester::process_before(Timestamp end) {
+    for (;;) {
+        // Strict compares keep the first source on ties: orders, market data, reports
+        Timestamp next = end;
+        Queue<PendingCommand>* commands = nullptr;
+        Queue<PendingMarket>* market = nullptr;
+        Queue<PendingReport>* reports = nullptr;
+        if (!commands_.empty() && commands_.front().time < next) {
+            next = commands_.front().time;
+            commands = &commands_;
+        }
+        if (!market_.empty() && market_.front().time < next) {
+            next = market_.front().time;
+            commands = nullptr;
+            market = &market_;
+        }
+        if (!reports_.empty() && reports_.front().time < next) {
+            next = reports_.front().time;
+            commands = nullptr;
+            market = nullptr;
+            reports = &reports_;
+        }
+        if (!commands && !market && !reports) {
+            return;
+        }
+
+        now_ = std::max(now_, next);
+        if (commands) {
+            // Copied out: executing it queues reports, and the slot may be reused by a send
+            const OrderCommand command = commands->front().command;
+            commands->pop();
+            apply_command(command);
+        } else if (market) {
+            // Strategies only push commands, so the front stays put during the hook
+            strategy_.on_market_data(market->front().event, *this);
+            market->pop();
+        } else {
+            strategy_.on_report(reports->front().report, *this);
+            reports->pop();
+        }
+    }
+}
+
+void Backtester::apply_record(const JournalRecord& record) {
+    now_ = std::max(now_, Timestamp{record.timestamp});
+    ++records_;
+    (void)execute_command(engine_, record.command, record.participant);
+    settle_trades();
+
+    if (market_.full()) {
+        ++dropped_;
+        return;
+    }
+    const OrderBook& book = engine_.get_order_book();
+    PendingMarket& pending = market_.push();
+    pending.time = now_ + feed_latency_;
+    pending.event.record = record;
+    const auto bid = book.top_level(Side::Buy);
+    const auto ask = book.top_level(Side::Sell);
+    pending.event.bid = bid ? BookLevel{bid->first, bid->second} : BookLevel{};
+    pending.event.ask = ask ? BookLevel{ask->first, ask->second} : BookLevel{};
+}
+
+void Backtester::apply_command(const OrderCommand& command) {
+    const ExecutionReport ack = execute_command(engine_, command, participant_);
+    // Fills go out ahead of the ack, as from a gateway
+    settle_trades();
+    report(ack);
+}
+
+void Backtester::settle_trades() {
+    const std::span<const Trade> trades = engine_.trades();
+    auto fill = [&](std::size_t index, OrderId id, std::int64_t sign) {
+        const Trade& trade = trades[index];
+        position_ += sign * static_cast<std::int64_t>(trade.quantity);
+        cash_ -= sign * trade.price * static_cast<Notional>(trade.quantity);
+        ++fills_;
+        // Leaves as of this fill: what rests now plus what later trades of the command took
+        const Order* order = engine_.get_order_book().get_order(id);
+        Quantity leaves = order ? order->remaining() : 0;
+        for (std::size_t later = index + 1; later < trades.size(); ++later) {
+            if (trades[later].buy_order_id == id || trades[later].sell_order_id == id) {
+                leaves += trades[later].quantity;
+            }
+        }
+        report(ExecutionReport{
+            .id = id,
+            .price = trade.price,
+            .quantity = trade.quantity,
+            .leaves = leaves,
+            .type = ReportType::Fill,
+            .status = leaves ? OrderStatus::PartiallyFilled : OrderStatus::Filled
+        });
+    };
+    for (std::size_t i = 0; i < trades.size(); ++i) {
+        if (trades[i].buy_participant == participant_) {
+            fill(i, trades[i].buy_order_id, 1);
+        }
+        if (trades[i].sell_participant == participant_) {
+            fill(i, trades[i].sell_order_id, -1);
+        }
+    }
+    engine_.clear_trades();
+}
+
+OrderId Backtester::submit(Side side, OrderType type, Price price, Quantity quantity) {
+    const OrderId id = next_id_;
+    if (!send(OrderCommand{.id = id, .price = price, .quantity = quantity, .side = side, .order_type = type})) {
+        return 0;
+    }
+    ++next_id_;
+    return id;
+}
+
+bool Backtester::cancel(OrderId id) {
+    return send(OrderCommand{.id = id, .type = CommandType::Cancel});
+}
+
+bool Backtester::modify(OrderId id, Price price, Quantity quantity) {
+    return send(OrderCommand{.id = id, .price = price, .quantity = quantity, .type = CommandType::Modify});
+}
+
+bool Backtester::send(const OrderCommand& command) {
+    if (commands_.full()) {
+        return false;
+    }
+    PendingCommand& pending = commands_.push();
+    pending.time = now_ + order_latency_;
+    pending.command = command;
+    pending.command.client_seq = ++client_seq_;
+    ++commands_sent_;
+    return true;
+}
+
+void Backtester::report(const ExecutionReport& report) {
+    if (reports_.full()) {
+        ++dropped_;
+        return;
+    }
+    reports_.push() = PendingReport{.time = now_ + response_latency_, .report = report};
+}
+
+std::optional<QueuePosition> Backtester::queue_position(OrderId id) const noexcept {
+    const Order* order = engine_.get_order_book().get_order(id);
+    if (!order || order->participant != participant_) {
+        return std::nullopt;
+    }
+    return engine_.get_order_book().queue_position(id);
+}
+
+} // namespace lob
@@ -0,0 +1,297 @@
+#include "exchange_simulator.hpp"
+#include <bit>
+#include <chrono>
+#include <cmath>
+
+namespace lob {
+
+namespace {
+
+std::size_t bucket_of(std::uint64_t value) noexcept {
+    if (value < 4) {
+        return value;
+    }
+    const auto width = static_cast<std::size_t>(std::bit_width(value));
+    return (width - 2) * 4 + ((value >> (width - 3)) & 3);
+}
+
+std::uint64_t bucket_upper(std::size_t bucket) noexcept {
+    if (bucket < 4) {
+        return bucket;
+    }
+    const std::size_t shift = bucket / 4 - 1;
+    return ((4 + bucket % 4) << shift) + ((std::uint64_t{1} << shift) - 1);
+}
+
+BookLevel level(const OrderBook& book, Side side) noexcept {
+    const auto top = book.top_level(side);
+    return top ? BookLevel{top->first, top->second} : BookLevel{};
+}
+
+bool operator!=(const BookLevel& a, const BookLevel& b) noexcept {
+    return a.price != b.price || a.quantity != b.quantity;
+}
+
+} // namespace
+
+void LatencyHistogram::record(Timestamp duration) noexcept {
+    const auto value = static_cast<std::uint64_t>(std::max<std::int64_t>(duration.count(), 0));
+    ++buckets_[bucket_of(value)];
+    ++count_;
+    max_ = std::max(max_, duration);
+}
+
+Timestamp LatencyHistogram::percentile(double p) const noexcept {
+    if (count_ == 0) {
+        return Timestamp{0};
+    }
+    const auto target = std::max<std::uint64_t>(
+        static_cast<std::uint64_t>(std::ceil(std::clamp(p, 0.0, 1.0) * static_cast<double>(count_))), 1);
+    std::uint64_t seen = 0;
+    for (std::size_t bucket = 0; bucket < BUCKETS; ++bucket) {
+        seen += buckets_[bucket];
+        if (seen >= target) {
+            return std::min(Timestamp{static_cast<std::int64_t>(bucket_upper(bucket))}, max_);
+        }
+    }
+    return max_;
+}
+
+void AgentContext::send(const OrderCommand& command) {
+    simulator_->send(*this, command);
+}
+
+Timestamp AgentContext::now() const noexcept {
+    return simulator_->now_;
+}
+
+std::optional<Timestamp> MarketMakerAgent::on_timer(const MarketView& market, AgentContext& context) {
+    quote(market, context);
+    return refresh_;
+}
+
+void MarketMakerAgent::on_market(const MarketView& market, AgentContext& context) {
+    quote(market, context);
+}
+
+void MarketMakerAgent::on_report(const ExecutionReport& report, AgentContext& context) {
+    (void)context;
+    for (std::size_t side = 0; side < quotes_.size(); ++side) {
+        Quote& quote = quotes_[side];
+        if (quote.id != report.id) {
+            continue;
+        }
+        if (report.type == ReportType::Fill) {
+            const auto quantity = static_cast<std::int64_t>(report.quantity);
+            inventory_ += static_cast<Side>(side) == Side::Buy ? quantity : -quantity;
+        }
+        // Gone from the book: filled, rejected, or cancelled by a requote that crossed it
+        if (report.leaves == 0 && (report.type == ReportType::Fill || report.status != OrderStatus::New)) {
+            quote = Quote{};
+        }
+    }
+}
+
+void MarketMakerAgent::quote(const MarketView& market, AgentContext& context) {
+    const Price limit = half_spread_;
+    const Price skew = std::clamp(static_cast<Price>(inventory_ / static_cast<std::int64_t>(size_)), -limit, limit);
+    const Price center = market.reference - skew;
+    place(quotes_[static_cast<std::size_t>(Side::Buy)], Side::Buy, std::max<Price>(center - half_spread_, 1), context);
+    place(quotes_[static_cast<std::size_t>(Side::Sell)], Side::Sell, center + half_spread_, context);
+}
+
+void MarketMakerAgent::place(Quote& quote, Side side, Price price, AgentContext& context) {
+    if (quote.id && quote.price == price) {
+        return;
+    }
+    if (quote.id) {
+        context.send({.id = quote.id, .type = CommandType::Cancel});
+    }
+    quote = {context.next_order_id(), price};
+    context.send({.id = quote.id, .price = price, .quantity = size_, .side = side});
+}
+
+std::optional<Timestamp> TakerAgent::on_timer(const MarketView& market, AgentContext& context) {
+    (void)market;
+    AgentRng& rng = context.rng();
+    context.send({.id = context.next_order_id(), .quantity = size_, .side = rng() % 2 ? Side::Buy : Side::Sell,
+                  .order_type = OrderType::Market});
+    return rng.delay(mean_interval_);
+}
+
+std::optional<Timestamp> NoiseTraderAgent::on_timer(const MarketView& market, AgentContext& context) {
+    AgentRng& rng = context.rng();
+    OrderId& slot = live_[live_count_ % MAX_LIVE];
+    if (live_count_ >= MAX_LIVE) {
+        context.send({.id = slot, .type = CommandType::Cancel});  // Rejected if it has traded away
+    }
+    const bool buy = rng() % 2;
+    const Price offset = 1 + static_cast<Price>(rng() % static_cast<std::uint64_t>(std::max<Price>(depth_, 1)));
+    slot = context.next_order_id();
+    ++live_count_;
+    context.send({.id = slot, .price = std::max<Price>(market.reference + (buy ? -offset : offset), 1),
+                  .quantity = 1 + rng() % std::max<Quantity>(max_size_, 1), .side = buy ? Side::Buy : Side::Sell});
+    return rng.delay(mean_interval_);
+}
+
+std::unique_ptr<ExchangeSimulator> ExchangeSimulator::create(MatchingEngine& engine,
+                                                             std::vector<std::unique_ptr<SimulatedAgent>> agents,
+                                                             const Options& options) {
+    if (agents.empty() || std::ranges::any_of(agents, [](const auto& agent) { return !agent; })) {
+        return nullptr;
+    }
+    // Private constructor, so no make_unique
+    return std::unique_ptr<ExchangeSimulator>(new ExchangeSimulator(engine, std::move(agents), options));
+}
+
+ExchangeSimulator::ExchangeSimulator(MatchingEngine& engine, std::vector<std::unique_ptr<SimulatedAgent>> agents,
+                                     const Options& options)
+    : engine_(engine)
+    , agents_(std::move(agents))
+    , sessions_(std::make_unique<OrderEntrySessions>(engine, agents_.size()))
+    , options_(options)
+{
+    engine_.set_keep_trades(true);  // Counted and cleared every step
+    contexts_.reserve(agents_.size());
+    for (std::size_t index = 0; index < agents_.size(); ++index) {
+        // Each agent's stream depends on the seed and its index only, so adding an
+        // agent leaves the others' draws alone
+        AgentRng mix(options_.seed ^ (0x9e3779b97f4a7c15ULL * (index + 1)));
+        contexts_.push_back(AgentContext(*this, index, mix()));
+        (void)sessions_->open();  // Lowest free slot first, so agent i has slot i
+        if (agents_[index]->reacts_to_market()) {
+            reacting_.push_back(static_cast<std::uint32_t>(index));
+        }
+        const Timestamp start = contexts_.back().rng_.delay(options_.start_window / 2) - Timestamp{1};
+        schedule_.push(next_event(start, EventKind::Timer, static_cast<std::uint32_t>(index)));
+    }
+}
+
+ExchangeSimulator::Event ExchangeSimulator::next_event(Timestamp time, EventKind kind, std::uint32_t agent) noexcept {
+    Event event;
+    event.time = time;
+    event.order = next_order_++;
+    event.kind = kind;
+    event.agent = agent;
+    event.length = 0;
+    return event;
+}
+
+std::uint64_t ExchangeSimulator::run_until(Timestamp until) {
+    std::uint64_t processed = 0;
+    while (!schedule_.empty() && schedule_.top().time <= until) {
+        const Event event = schedule_.top();
+        schedule_.pop();
+        now_ = event.time;
+        ++processed;
+        AgentContext& context = contexts_[event.agent];
+        switch (event.kind) {
+            case EventKind::Timer:
+                if (const auto next = agents_[event.agent]->on_timer(market_view(), context)) {
+                    schedule_.push(next_event(now_ + std::max(*next, Timestamp{1}), EventKind::Timer, event.agent));
+                }
+                break;
+            case EventKind::Market:
+                context.reaction_pending_ = false;
+                agents_[event.agent]->on_market(market_view(), context);
+                break;
+            case EventKind::Arrival:
+                inbound_.push_back({now_, event.agent, event.length, event.frame});
+                max_queue_depth_ = std::max(max_queue_depth_, inbound_.size());
+                if (!service_scheduled_) {
+                    service_scheduled_ = true;
+                    schedule_.push(next_event(std::max(now_, busy_until_), EventKind::Service, 0));
+                }
+                break;
+            case EventKind::Service:
+                serve();
+                break;
+            case EventKind::Report:
+                agents_[event.agent]->on_report(event.report, context);
+                break;
+        }
+    }
+    now_ = std::max(now_, until);
+    events_ += processed;
+    return processed;
+}
+
+void ExchangeSimulator::send(AgentContext& context, const OrderCommand& command) {
+    Event event = next_event(now_ + options_.order_latency, EventKind::Arrival, static_cast<std::uint32_t>(context.index_));
+    event.length = static_cast<std::uint8_t>(wire::encode_command(event.frame.data(), command, context.outbound_seq_ + 1));
+    if (event.length == 0) {
+        return;  // No frame for it (MassCancel)
+    }
+    ++context.outbound_seq_;
+    schedule_.push(event);
+}
+
+void ExchangeSimulator::serve() {
+    const Inbound& inbound = inbound_.front();
+    const auto start = options_.measure_processing ? std::chrono::steady_clock::now()
+                                                   : std::chrono::steady_clock::time_point{};
+    const auto result = sessions_->process(inbound.agent, std::span(inbound.frame.data(), inbound.length));
+    if (options_.measure_processing) {
+        processing_.record(std::chrono::duration_cast<Timestamp>(std::chrono::steady_clock::now() - start));
+    }
+    commands_ += result.commands;
+
+    const Timestamp done = now_ + options_.service_time;
+    busy_until_ = done;
+    exchange_latency_.record(done - inbound.arrival);
+    inbound_.pop_front();
+
+    const std::size_t trades = engine_.trades().size();
+    trades_ += trades;
+    engine_.clear_trades();
+
+    sessions_->drain_dirty([&](std::size_t slot) {
+        const std::span<const std::byte> output = sessions_->pending_output(slot);
+        std::size_t offset = 0;
+        while (true) {
+            Event event = next_event(done + options_.response_latency, EventKind::Report,
+                                     static_cast<std::uint32_t>(slot));
+            const wire::DecodeResult decoded = wire::decode_report(output.subspan(offset), event.report);
+            if (decoded.status != wire::DecodeStatus::Ok) {
+                break;
+            }
+            offset += decoded.consumed;
+            schedule_.push(event);
+        }
+        sessions_->consume_output(slot, offset);
+    });
+
+    const OrderBook& book = engine_.get_order_book();
+    const BookLevel bid = level(book, Side::Buy);
+    const BookLevel ask = level(book, Side::Sell);
+    if (trades || bid != last_bid_ || ask != last_ask_) {
+        last_bid_ = bid;
+        last_ask_ = ask;
+        for (const std::uint32_t agent : reacting_) {
+            if (!contexts_[agent].reaction_pending_) {
+                contexts_[agent].reaction_pending_ = true;
+                schedule_.push(next_event(done + options_.market_data_latency, EventKind::Market, agent));
+            }
+        }
+    }
+
+    if (inbound_.empty()) {
+        service_scheduled_ = false;
+    } else {
+        schedule_.push(next_event(done, EventKind::Service, 0));
+    }
+}
+
+MarketView ExchangeSimulator::market_view() const noexcept {
+    MarketView view{.bid = last_bid_, .ask = last_ask_, .trades = trades_, .now = now_};
+    if (const auto last = engine_.last_trade_price()) {
+        view.reference = *last;
+    } else if (view.bid.quantity && view.ask.quantity) {
+        view.reference = (view.bid.price + view.ask.price) / 2;
+    } else {
+        view.reference = options_.initial_price;
+    }
+    return view;
+}
+
+} // namespace lob
@@ -0,0 +1,257 @@
+#include "fix_protocol.hpp"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace lob::fix {
+
+namespace {
+
+// Fields kept by the parser, in the order of FIELD_TAGS; slot 0 collects the rest
+constexpr std::array<Tag, 14> FIELD_TAGS{
+    Tag::MsgType, Tag::MsgSeqNum, Tag::SenderCompID, Tag::TargetCompID, Tag::ClOrdID,
+    Tag::OrigClOrdID, Tag::Symbol, Tag::Price, Tag::OrderQty, Tag::HeartBtInt,
+    Tag::TestReqID, Tag::Side, Tag::OrdType, Tag::TimeInForce
+};
+constexpr std::uint32_t MAX_FIELD_TAG = 128;
+
+// Tag -> slot (index in FIELD_TAGS + 1), so storing a field needs no branch per tag
+constexpr auto FIELD_SLOTS = [] {
+    std::array<std::uint8_t, MAX_FIELD_TAG> slots{};
+    for (std::size_t i = 0; i < FIELD_TAGS.size(); ++i) {
+        slots[static_cast<std::uint32_t>(FIELD_TAGS[i])] = static_cast<std::uint8_t>(i + 1);
+    }
+    return slots;
+}();
+
+using FieldViews = std::array<std::string_view, FIELD_TAGS.size() + 1>;
+
+std::string_view field(const FieldViews& views, Tag tag) noexcept {
+    return views[FIELD_SLOTS[static_cast<std::uint32_t>(tag)]];
+}
+
+// Single-character fields: absent is 0, anything longer is invalid
+bool single_char(const FieldViews& views, Tag tag, char& out) noexcept {
+    const std::string_view value = field(views, tag);
+    out = value.empty() ? '\0' : value.front();
+    return value.size() <= 1;
+}
+
+bool fill_message(const FieldViews& views, Message& message) noexcept {
+    message.msg_type = field(views, Tag::MsgType);
+    message.sender_comp_id = field(views, Tag::SenderCompID);
+    message.target_comp_id = field(views, Tag::TargetCompID);
+    message.cl_ord_id = field(views, Tag::ClOrdID);
+    message.orig_cl_ord_id = field(views, Tag::OrigClOrdID);
+    message.symbol = field(views, Tag::Symbol);
+    message.price = field(views, Tag::Price);
+    message.order_qty = field(views, Tag::OrderQty);
+    message.heart_bt_int = field(views, Tag::HeartBtInt);
+    message.test_req_id = field(views, Tag::TestReqID);
+    const std::string_view seq = field(views, Tag::MsgSeqNum);
+    message.seq = 0;
+    return (seq.empty() || parse_uint(seq, message.seq)) &&
+           single_char(views, Tag::Side, message.side) &&
+           single_char(views, Tag::OrdType, message.ord_type) &&
+           single_char(views, Tag::TimeInForce, message.time_in_force);
+}
+
+// The 1-5 tag digits at p as one 64-bit word (SWAR). Eight bytes are always
+// readable: the field's value, its SOH and the 7-byte trailer follow the tag.
+bool parse_tag(const char* p, std::size_t digits, std::uint32_t& tag) noexcept {
+    std::uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    if constexpr (std::endian::native == std::endian::big) {
+        word = std::byteswap(word);
+    }
+    // '0'..'9' -> 0..9, then shift the digits up so the low bytes are leading zeros
+    word = (word ^ 0x3030303030303030ULL) << (8 * (8 - digits));
+    if (((word | (word + 0x7676767676767676ULL)) & 0x8080808080808080ULL) != 0) {
+        return false;  // A byte above 9
+    }
+    word = (word * 10 + (word >> 8)) & 0x00FF00FF00FF00FFULL;
+    word = (word * 100 + (word >> 16)) & 0x0000FFFF0000FFFFULL;
+    tag = static_cast<std::uint32_t>(word * 10000 + (word >> 32));
+    return true;
+}
+
+// One walk over the body's fields: each is tag digits, the first '=' after them, and
+// the value up to the next SOH ('=' inside a value is data). Values are found with
+// memchr, which beats building SOH/'=' bitmaps for messages this short.
+bool parse_fields(const char* body, std::size_t size, Message& message) noexcept {
+    FieldViews views{};
+    std::size_t field = 0;  // Start of the current field
+    while (field < size) {
+        // Tags are one to five digits (parse_tag rejects an SOH among them)
+        std::size_t equals = field;
+        const std::size_t tag_end = std::min(size, field + 6);
+        while (equals < tag_end && body[equals] != '=') {
+            ++equals;
+        }
+        std::uint32_t tag = 0;
+        if (equals == tag_end || equals == field || !parse_tag(body + field, equals - field, tag)) {
+            return false;
+        }
+        // MsgType must lead the body
+        if ((field == 0) != (tag == static_cast<std::uint32_t>(Tag::MsgType))) {
+            return false;
+        }
+        const std::size_t value = equals + 1;
+        const auto* soh = static_cast<const char*>(std::memchr(body + value, SOH, size - value));
+        if (!soh || soh == body + value) {
+            return false;
+        }
+        const auto end = static_cast<std::size_t>(soh - body);
+        views[tag < MAX_FIELD_TAG ? FIELD_SLOTS[tag] : 0] = std::string_view(body + value, end - value);
+        field = end + 1;
+    }
+    return fill_message(views, message);
+}
+
+char* write_uint(char* out, std::uint64_t value) noexcept {
+    return std::to_chars(out, out + 20, value).ptr;
+}
+
+} // namespace
+
+std::uint8_t checksum(std::span<const char> bytes) noexcept {
+    const char* data = bytes.data();
+    std::size_t i = 0;
+    std::uint64_t sum = 0;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lanes = zero;
+    for (; i + 16 <= bytes.size(); i += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        lanes = _mm_add_epi64(lanes, _mm_sad_epu8(chunk, zero));
+    }
+    alignas(16) std::uint64_t partial[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(partial), lanes);
+    sum = partial[0] + partial[1];
+#endif
+    for (; i < bytes.size(); ++i) {
+        sum += static_cast<unsigned char>(data[i]);
+    }
+    return static_cast<std::uint8_t>(sum);
+}
+
+DecodeResult decode_message(std::span<const char> buffer, Message& message) noexcept {
+    const std::size_t prefix = BEGIN_STRING.size();
+    const std::size_t checked = std::min(buffer.size(), prefix);
+    if (std::string_view(buffer.data(), checked) != BEGIN_STRING.substr(0, checked)) {
+        return {DecodeStatus::Invalid};
+    }
+
+    // BodyLength: up to five digits, then SOH
+    std::size_t body_length = 0;
+    std::size_t pos = prefix;
+    for (;; ++pos) {
+        if (pos >= buffer.size()) {
+            return {DecodeStatus::NeedMore};
+        }
+        const char c = buffer[pos];
+        if (c == SOH && pos > prefix) {
+            break;
+        }
+        if (c < '0' || c > '9' || pos - prefix >= 5) {
+            return {DecodeStatus::Invalid};
+        }
+        body_length = body_length * 10 + static_cast<std::size_t>(c - '0');
+    }
+    const std::size_t body_begin = pos + 1;
+    const std::size_t body_end = body_begin + body_length;
+    const std::size_t total = body_end + 7;  // "10=nnn" SOH
+    if (body_length == 0 || total > MAX_MESSAGE) {
+        return {DecodeStatus::Invalid};
+    }
+    if (buffer.size() < total) {
+        return {DecodeStatus::NeedMore};
+    }
+
+    const char* data = buffer.data();
+    std::uint64_t expected = 0;
+    if (data[body_end - 1] != SOH || std::memcmp(data + body_end, "10=", 3) != 0 ||
+        data[total - 1] != SOH || !parse_uint(std::string_view(data + body_end + 3, 3), expected) ||
+        expected != checksum(buffer.first(body_end)) ||
+        !parse_fields(data + body_begin, body_length, message)) {
+        return {DecodeStatus::Invalid};
+    }
+    return {DecodeStatus::Ok, total};
+}
+
+MessageBuilder& MessageBuilder::add(Tag tag, std::string_view value) noexcept {
+    // tag (at most ten digits), '=', value, SOH; a field that does not fit is dropped
+    if (length_ + value.size() + 12 > body_.size()) {
+        return *this;
+    }
+    char* out = write_uint(body_.data() + length_, static_cast<std::uint64_t>(tag));
+    *out++ = '=';
+    std::memcpy(out, value.data(), value.size());
+    out += value.size();
+    *out++ = SOH;
+    length_ = static_cast<std::size_t>(out - body_.data());
+    return *this;
+}
+
+MessageBuilder& MessageBuilder::add(Tag tag, std::uint64_t value) noexcept {
+    char digits[20];
+    const char* end = write_uint(digits, value);
+    return add(tag, std::string_view(digits, static_cast<std::size_t>(end - digits)));
+}
+
+MessageBuilder& MessageBuilder::add_price(Tag tag, Price value, unsigned decimals) noexcept {
+    char text[32];
+    char* out = text;
+    if (value < 0) {
+        *out++ = '-';
+    }
+    const std::uint64_t magnitude = value < 0 ? 0 - static_cast<std::uint64_t>(value)
+                                              : static_cast<std::uint64_t>(value);
+    std::uint64_t scale = 1;
+    for (unsigned i = 0; i < decimals; ++i) {
+        scale *= 10;
+    }
+    out = write_uint(out, magnitude / scale);
+    if (decimals > 0) {
+        *out++ = '.';
+        std::uint64_t fraction = magnitude % scale;
+        for (unsigned i = decimals; i > 0; --i) {
+            out[i - 1] = static_cast<char>('0' + fraction % 10);
+            fraction /= 10;
+        }
+        out += decimals;
+    }
+    return add(tag, std::string_view(text, static_cast<std::size_t>(out - text)));
+}
+
+std::size_t MessageBuilder::size() const noexcept {
+    char digits[20];
+    const auto length_digits = static_cast<std::size_t>(write_uint(digits, length_) - digits);
+    return BEGIN_STRING.size() + length_digits + 1 + length_ + 7;
+}
+
+std::size_t MessageBuilder::finish(char* out) const noexcept {
+    char* p = out;
+    std::memcpy(p, BEGIN_STRING.data(), BEGIN_STRING.size());
+    p = write_uint(p + BEGIN_STRING.size(), length_);
+    *p++ = SOH;
+    std::memcpy(p, body_.data(), length_);
+    p += length_;
+
+    const std::uint8_t sum = checksum(std::span<const char>(out, static_cast<std::size_t>(p - out)));
+    *p++ = '1';
+    *p++ = '0';
+    *p++ = '=';
+    *p++ = static_cast<char>('0' + sum / 100);
+    *p++ = static_cast<char>('0' + sum / 10 % 10);
+    *p++ = static_cast<char>('0' + sum % 10);
+    *p++ = SOH;
+    return static_cast<std::size_t>(p - out);
+}
+
+} // namespace lob::fix
@@ -0,0 +1,338 @@
+#include "fix_session.hpp"
+#include <chrono>
+
+namespace lob {
+
+using fix::Tag;
+
+namespace {
+
+char fix_side(Side side) noexcept {
+    return side == Side::Buy ? '1' : '2';
+}
+
+char fix_ord_status(OrderStatus status) noexcept {
+    switch (status) {
+        case OrderStatus::New: return '0';
+        case OrderStatus::PartiallyFilled: return '1';
+        case OrderStatus::Filled: return '2';
+        case OrderStatus::Cancelled: return '4';
+        case OrderStatus::Rejected: return '8';
+    }
+    return '8';
+}
+
+// ExecType of an acknowledgement, from what the command was and how it ended
+char ack_exec_type(CommandType type, OrderStatus status) noexcept {
+    if (status == OrderStatus::Rejected) {
+        return '8';
+    }
+    if (status == OrderStatus::Cancelled) {
+        return '4';
+    }
+    return type == CommandType::Modify ? '5' : '0';
+}
+
+} // namespace
+
+FixSessions::FixSessions(MatchingEngine& engine, std::size_t max_sessions, FixSessionConfig config)
+    : engine_(engine)
+    , config_(std::move(config))
+    , slots_(max_sessions, engine.reserve_participants(max_sessions))
+{
+    engine_.add_observer(this);
+}
+
+FixSessions::~FixSessions() {
+    engine_.remove_observer(this);
+}
+
+std::optional<std::size_t> FixSessions::open() {
+    return slots_.open();
+}
+
+void FixSessions::close(std::size_t slot) {
+    // Closed before the cancel, so no reports are queued for it
+    if (slots_.close(slot)) {
+        (void)engine_.mass_cancel(slots_.participant(slot));
+    }
+}
+
+FixSessions::ProcessResult FixSessions::process(std::size_t slot, std::span<const std::byte> input) {
+    ProcessResult result;
+    const auto* data = reinterpret_cast<const char*>(input.data());
+    fix::Message message;
+    while (!result.logout) {
+        const fix::DecodeResult decoded = fix::decode_message(
+            std::span<const char>(data + result.consumed, input.size() - result.consumed), message);
+        if (decoded.status == fix::DecodeStatus::NeedMore) {
+            break;
+        }
+        if (decoded.status == fix::DecodeStatus::Invalid) {
+            result.error = true;
+            break;
+        }
+        result.consumed += decoded.consumed;
+        if (!handle(slot, message, result)) {
+            result.error = true;
+            break;
+        }
+    }
+    return result;
+}
+
+bool FixSessions::handle(std::size_t slot, const fix::Message& message, ProcessResult& result) {
+    Session& session = slots_.state(slot);
+    if (message.seq != session.inbound_seq + 1 || message.target_comp_id != config_.comp_id) {
+        return false;
+    }
+    session.inbound_seq = message.seq;
+
+    if (!session.logged_on) {
+        if (message.msg_type != "A" || message.sender_comp_id.empty()) {
+            return false;
+        }
+        session.peer_comp_id = message.sender_comp_id;
+        session.logged_on = true;
+        start(slot, "A")
+            .add(Tag::EncryptMethod, '0')
+            .add(Tag::HeartBtInt, message.heart_bt_int.empty() ? std::string_view("30") : message.heart_bt_int);
+        send(slot);
+        return true;
+    }
+    if (message.sender_comp_id != session.peer_comp_id || message.msg_type.size() != 1) {
+        return false;
+    }
+
+    switch (message.msg_type.front()) {
+        case '0':  // Heartbeat
+            break;
+        case '1':  // TestRequest
+            start(slot, "0").add(Tag::TestReqID, message.test_req_id);
+            send(slot);
+            break;
+        case '5':  // Logout
+            start(slot, "5");
+            send(slot);
+            result.logout = true;
+            break;
+        case 'D':
+        case 'F':
+        case 'G':
+            handle_order(slot, message);
+            ++result.commands;
+            break;
+        case 'A':
+            return false;  // Already logged on
+        default:
+            start(slot, "3")
+                .add(Tag::RefSeqNum, message.seq)
+                .add(Tag::Text, "Unsupported MsgType");
+            send(slot);
+            break;
+    }
+    return true;
+}
+
+void FixSessions::handle_order(std::size_t slot, const fix::Message& message) {
+    const char msg_type = message.msg_type.front();
+    OrderCommand command{.client_seq = message.seq};
+    std::uint64_t id = 0;
+
+    if (msg_type == 'D') {
+        command.type = CommandType::New;
+        if (!fix::parse_uint(message.cl_ord_id, id)) {
+            return reject_order(slot, message, "ClOrdID must be numeric");
+        }
+        if (message.symbol != config_.symbol) {
+            return reject_order(slot, message, "Unknown Symbol");
+        }
+        if (message.side != '1' && message.side != '2') {
+            return reject_order(slot, message, "Unsupported Side");
+        }
+        command.side = message.side == '1' ? Side::Buy : Side::Sell;
+
+        switch (message.ord_type) {
+            case '1': command.order_type = OrderType::Market; break;
+            case '2': command.order_type = OrderType::Limit; break;
+            default: return reject_order(slot, message, "Unsupported OrdType");
+        }
+        switch (message.time_in_force) {
+            case 0:
+            case '0': command.time_in_force = TimeInForce::Day; break;
+            case '1': command.time_in_force = TimeInForce::GTC; break;
+            case '3':
+                if (command.order_type == OrderType::Limit) {
+                    command.order_type = OrderType::IOC;
+                }
+                break;
+            case '4':
+                if (command.order_type == OrderType::Limit) {
+                    command.order_type = OrderType::FOK;
+                }
+                break;
+            default: return reject_order(slot, message, "Unsupported TimeInForce");
+        }
+    } else {
+        command.type = msg_type == 'F' ? CommandType::Cancel : CommandType::Modify;
+        if (!fix::parse_uint(message.orig_cl_ord_id, id)) {
+            return reject_order(slot, message, "Unknown order");
+        }
+    }
+    command.id = id;
+
+    if (command.type != CommandType::Cancel) {
+        const bool priced = command.type == CommandType::Modify || command.order_type != OrderType::Market;
+        if (!fix::parse_uint(message.order_qty, command.quantity) ||
+            (priced && !fix::parse_price(message.price, config_.price_decimals, command.price))) {
+            return reject_order(slot, message, "Invalid OrderQty or Price");
+        }
+    }
+
+    // Side and fills so far for cancels and replaces, which may remove the order
+    const ParticipantId participant = slots_.participant(slot);
+    Side side = command.side;
+    active_cum_ = 0;
+    if (const Order* order = engine_.get_order_book().get_order(id);
+        order && command.type != CommandType::New) {
+        side = order->side;
+        active_cum_ = order->filled_quantity;
+    }
+    active_id_ = id;
+    const ExecutionReport report = execute_command(engine_, command, participant);
+    active_id_ = 0;
+
+    if (command.type != CommandType::New && report.status == OrderStatus::Rejected) {
+        return reject_order(slot, message, "Unknown order");
+    }
+    fix::MessageBuilder& builder = start(slot, "8");
+    builder.add(Tag::ClOrdID, message.cl_ord_id.empty() ? message.orig_cl_ord_id : message.cl_ord_id);
+    if (command.type != CommandType::New) {
+        builder.add(Tag::OrigClOrdID, message.orig_cl_ord_id);
+    }
+    add_report_fields(report, ack_exec_type(command.type, report.status), side, active_cum_);
+    send(slot);
+}
+
+void FixSessions::reject_order(std::size_t slot, const fix::Message& message, std::string_view reason) {
+    if (message.msg_type == "D") {
+        fix::MessageBuilder& builder = start(slot, "8");
+        builder.add(Tag::ClOrdID, message.cl_ord_id.empty() ? std::string_view("NONE") : message.cl_ord_id)
+            .add(Tag::OrderID, "NONE")
+            .add(Tag::ExecID, ++exec_id_)
+            .add(Tag::ExecType, '8')
+            .add(Tag::OrdStatus, '8')
+            .add(Tag::Symbol, config_.symbol)
+            .add(Tag::Side, message.side ? message.side : '1')
+            .add(Tag::LeavesQty, std::uint64_t{0})
+            .add(Tag::CumQty, std::uint64_t{0})
+            .add(Tag::AvgPx, '0')
+            .add(Tag::Text, reason);
+    } else {
+        fix::MessageBuilder& builder = start(slot, "9");
+        builder.add(Tag::OrderID, message.orig_cl_ord_id.empty() ? std::string_view("NONE") : message.orig_cl_ord_id)
+            .add(Tag::ClOrdID, message.cl_ord_id.empty() ? std::string_view("NONE") : message.cl_ord_id)
+            .add(Tag::OrigClOrdID, message.orig_cl_ord_id.empty() ? std::string_view("NONE") : message.orig_cl_ord_id)
+            .add(Tag::OrdStatus, '8')
+            .add(Tag::CxlRejResponseTo, message.msg_type == "F" ? '1' : '2')
+            .add(Tag::CxlRejReason, '1')  // Unknown order
+            .add(Tag::Text, reason);
+    }
+    send(slot);
+}
+
+void FixSessions::add_report_fields(const ExecutionReport& report, char exec_type, Side side, Quantity cum_qty) {
+    builder_.add(Tag::OrderID, report.id)
+        .add(Tag::ExecID, ++exec_id_)
+        .add(Tag::ExecType, exec_type)
+        .add(Tag::OrdStatus, fix_ord_status(report.status))
+        .add(Tag::Symbol, config_.symbol)
+        .add(Tag::Side, fix_side(side))
+        .add(Tag::LeavesQty, report.leaves)
+        .add(Tag::CumQty, cum_qty)
+        .add(Tag::AvgPx, '0');
+    if (report.type == ReportType::Fill) {
+        builder_.add(Tag::LastQty, report.quantity).add_price(Tag::LastPx, report.price, config_.price_decimals);
+    }
+}
+
+fix::MessageBuilder& FixSessions::start(std::size_t slot, std::string_view msg_type) {
+    Session& session = slots_.state(slot);
+    builder_.begin(msg_type, config_.comp_id, session.peer_comp_id, ++session.outbound_seq, sending_time());
+    return builder_;
+}
+
+void FixSessions::send(std::size_t slot) {
+    std::vector<std::byte>& output = slots_.output(slot);
+    const std::size_t offset = output.size();
+    output.resize(offset + builder_.size());
+    builder_.finish(reinterpret_cast<char*>(output.data() + offset));
+    slots_.release(slot);
+}
+
+void FixSessions::on_trade(const Trade& trade) {
+    route_fill(trade.buy_participant, trade.buy_order_id, trade);
+    route_fill(trade.sell_participant, trade.sell_order_id, trade);
+}
+
+void FixSessions::route_fill(ParticipantId participant, OrderId id, const Trade& trade) {
+    const std::optional<std::size_t> slot = slots_.slot_of(participant);
+    if (!slot || !slots_.state(*slot).logged_on) {
+        return;
+    }
+    // Both orders are still in the book while their trade is reported
+    const Order* order = engine_.get_order_book().get_order(id);
+    const Quantity leaves = order ? order->remaining() : 0;
+    const Quantity cum = order ? order->filled_quantity : trade.quantity;
+    const Side side = order ? order->side : (id == trade.buy_order_id ? Side::Buy : Side::Sell);
+    if (id == active_id_) {
+        active_cum_ = cum;
+    }
+
+    start(*slot, "8").add(Tag::ClOrdID, id);
+    add_report_fields(ExecutionReport{
+        .id = id,
+        .price = trade.price,
+        .quantity = trade.quantity,
+        .leaves = leaves,
+        .type = ReportType::Fill,
+        .status = leaves ? OrderStatus::PartiallyFilled : OrderStatus::Filled
+    }, 'F', side, cum);
+    send(*slot);
+}
+
+std::string_view FixSessions::sending_time() {
+    using namespace std::chrono;
+    const auto now = time_point_cast<milliseconds>(system_clock::now());
+    const std::int64_t second = duration_cast<seconds>(now.time_since_epoch()).count();
+    if (second != time_second_) {
+        time_second_ = second;
+        const auto day = floor<days>(now);
+        const year_month_day date{day};
+        const hh_mm_ss time{floor<seconds>(now - day)};
+        const auto put = [this](std::size_t at, unsigned value, unsigned width) {
+            for (std::size_t i = at + width; i > at; --i) {
+                time_text_[i - 1] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            }
+        };
+        put(0, static_cast<unsigned>(static_cast<int>(date.year())), 4);
+        put(4, static_cast<unsigned>(date.month()), 2);
+        put(6, static_cast<unsigned>(date.day()), 2);
+        time_text_[8] = '-';
+        put(9, static_cast<unsigned>(time.hours().count()), 2);
+        time_text_[11] = ':';
+        put(12, static_cast<unsigned>(time.minutes().count()), 2);
+        time_text_[14] = ':';
+        put(15, static_cast<unsigned>(time.seconds().count()), 2);
+        time_text_[17] = '.';
+    }
+    unsigned millis = static_cast<unsigned>(now.time_since_epoch().count() % 1000);
+    for (std::size_t i = 20; i > 17; --i) {
+        time_text_[i] = static_cast<char>('0' + millis % 10);
+        millis /= 10;
+    }
+    return std::string_view(time_text_, sizeof(time_text_));
+}
+
+} // namespace lob
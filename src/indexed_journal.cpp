@@ -0,0 +1,423 @@
+#include "indexed_journal.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace lob {
+
+namespace {
+
+using journal::IndexEntry;
+using journal::IndexHeader;
+using journal::SnapshotHeader;
+using journal::SnapshotOrder;
+
+constexpr const char* JOURNAL_FILE = "/journal";
+constexpr const char* INDEX_FILE = "/index";
+constexpr const char* SNAPSHOT_FILE = "/snapshots";
+
+template<typename T>
+void append_bytes(std::vector<std::byte>& buffer, const T& value) {
+    const std::size_t offset = buffer.size();
+    buffer.resize(offset + sizeof(T));
+    std::memcpy(buffer.data() + offset, &value, sizeof(T));
+}
+
+// Whole file mapped read-only; an empty file maps to nothing
+bool map_file(const std::string& path, const std::byte*& data, std::size_t& size) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info{};
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        return false;
+    }
+    size = static_cast<std::size_t>(info.st_size);
+    data = nullptr;
+    if (size > 0) {
+        void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            ::close(fd);
+            return false;
+        }
+        data = static_cast<const std::byte*>(mapped);
+    }
+    ::close(fd);
+    return true;
+}
+
+void unmap_file(const std::byte* data, std::size_t size) noexcept {
+    if (data) {
+        ::munmap(const_cast<std::byte*>(data), size);
+    }
+}
+
+} // namespace
+
+std::unique_ptr<IndexedJournalWriter> IndexedJournalWriter::create(const MatchingEngine& engine,
+                                                                   const std::string& directory,
+                                                                   const Options& options) {
+    if (options.index_interval == 0 || options.snapshot_interval == 0 ||
+        options.snapshot_interval % options.index_interval != 0) {
+        return nullptr;
+    }
+    if (::mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        return nullptr;
+    }
+    const auto open_file = [&directory](const char* name) {
+        return ::open((directory + name).c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    };
+    const int journal_fd = open_file(JOURNAL_FILE);
+    const int index_fd = open_file(INDEX_FILE);
+    const int snapshot_fd = open_file(SNAPSHOT_FILE);
+    if (journal_fd < 0 || index_fd < 0 || snapshot_fd < 0) {
+        for (int fd : {journal_fd, index_fd, snapshot_fd}) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+        return nullptr;
+    }
+    // Private constructor, so no make_unique
+    return std::unique_ptr<IndexedJournalWriter>(
+        new IndexedJournalWriter(engine, journal_fd, index_fd, snapshot_fd, options));
+}
+
+IndexedJournalWriter::IndexedJournalWriter(const MatchingEngine& engine, int journal_fd, int index_fd,
+                                           int snapshot_fd, const Options& options)
+    : engine_(engine)
+    , journal_fd_(journal_fd)
+    , index_fd_(index_fd)
+    , snapshot_fd_(snapshot_fd)
+    , format_(options.format)
+    , index_interval_(options.index_interval)
+    , snapshot_interval_(options.snapshot_interval)
+    , write_bytes_(options.write_bytes)
+{
+    journal_buffer_.reserve(write_bytes_ + sizeof(JournalRecord));
+    const IndexHeader header{.magic = journal::INDEX_MAGIC, .format = format_, .reserved = {}};
+    write_all(index_fd_, std::as_bytes(std::span(&header, 1)));
+}
+
+IndexedJournalWriter::~IndexedJournalWriter() {
+    flush();
+    ::close(journal_fd_);
+    ::close(index_fd_);
+    ::close(snapshot_fd_);
+}
+
+void IndexedJournalWriter::append(std::uint64_t sequence, ParticipantId participant,
+                                  const OrderCommand& command) {
+    const std::int64_t wall = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    JournalRecord record{.sequence = sequence, .timestamp = wall, .participant = participant, .command = command};
+    if (command.time_in_force == TimeInForce::GTT) {
+        record.command.expire_time += wall - steady_time().count();
+    }
+    append(record);
+}
+
+void IndexedJournalWriter::append(const JournalRecord& record) {
+    if (records_ % index_interval_ == 0) {
+        IndexEntry entry{
+            .sequence = record.sequence,
+            .timestamp = record.timestamp,
+            .offset = journal_offset_,
+            .snapshot = journal::NO_SNAPSHOT
+        };
+        if (records_ % snapshot_interval_ == 0) {
+            // New segment: the book as it stands before this record
+            entry.snapshot = snapshot_offset_;
+            write_snapshot(record.sequence - 1);
+            encoder_.reset();
+        }
+        index_buffer_.push_back(entry);
+    }
+
+    const std::size_t offset = journal_buffer_.size();
+    if (format_ == JournalFormat::Compressed) {
+        journal_buffer_.resize(offset + JournalEncoder::MAX_RECORD);
+        journal_buffer_.resize(offset + encoder_.encode(record, journal_buffer_.data() + offset));
+    } else {
+        append_bytes(journal_buffer_, record);
+    }
+    journal_offset_ += journal_buffer_.size() - offset;
+    ++records_;
+    if (journal_buffer_.size() >= write_bytes_) {
+        flush();
+    }
+}
+
+void IndexedJournalWriter::flush() {
+    // Journal before snapshots before index, so no entry points past written data
+    write_all(journal_fd_, journal_buffer_);
+    journal_buffer_.clear();
+    write_all(snapshot_fd_, snapshot_buffer_);
+    snapshot_buffer_.clear();
+    write_all(index_fd_, std::as_bytes(std::span(index_buffer_)));
+    index_buffer_.clear();
+}
+
+void IndexedJournalWriter::write_snapshot(std::uint64_t sequence) {
+    const OrderBook& book = engine_.get_order_book();
+    const EngineState state = engine_.engine_state();
+    const Timestamp taken = steady_time();
+    const bool has_session_close = state.session_close != Timestamp{0};
+    const SnapshotHeader header{
+        .magic = journal::SNAPSHOT_MAGIC,
+        .next_arrival = book.next_arrival(),
+        .sequence = sequence,
+        .orders = book.order_count(),
+        .state_hash = book.state_hash(),
+        .reference_price = state.reference_price.value_or(0),
+        .last_trade_price = state.last_trade_price.value_or(0),
+        .session_close = has_session_close ? (state.session_close - taken).count() : 0,
+        .session_state = state.session_state,
+        .self_trade_prevention = state.self_trade_prevention,
+        .has_reference_price = state.reference_price.has_value(),
+        .has_last_trade_price = state.last_trade_price.has_value(),
+        .has_session_close = has_session_close,
+        .reserved = {}
+    };
+    const std::size_t start = snapshot_buffer_.size();
+    snapshot_buffer_.reserve(start + sizeof(header) + header.orders * sizeof(SnapshotOrder));
+    append_bytes(snapshot_buffer_, header);
+    book.for_each_order([this, taken](const Order& order) {
+        append_bytes(snapshot_buffer_, SnapshotOrder{
+            .id = order.id,
+            .price = order.price,
+            .quantity = order.quantity,
+            .filled_quantity = order.filled_quantity,
+            .expire_time = order.time_in_force == TimeInForce::GTC ? 0 : (order.expire_time - taken).count(),
+            .participant = order.participant,
+            .arrival = order.arrival,
+            .side = order.side,
+            .type = order.type,
+            .time_in_force = order.time_in_force,
+            .status = order.status,
+            .reserved = {}
+        });
+    });
+    snapshot_offset_ += snapshot_buffer_.size() - start;
+    ++snapshots_;
+}
+
+void IndexedJournalWriter::write_all(int fd, std::span<const std::byte> data) {
+    while (!data.empty()) {
+        const ssize_t written = ::write(fd, data.data(), data.size());
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            ++write_errors_;
+            return;
+        }
+        data = data.subspan(static_cast<std::size_t>(written));
+    }
+}
+
+std::unique_ptr<IndexedJournalReader> IndexedJournalReader::open(const std::string& directory) {
+    Mapping journal;
+    Mapping index;
+    Mapping snapshots;
+    const bool mapped = map_file(directory + JOURNAL_FILE, journal.data, journal.size) &&
+                        map_file(directory + INDEX_FILE, index.data, index.size) &&
+                        map_file(directory + SNAPSHOT_FILE, snapshots.data, snapshots.size);
+    IndexHeader header{};
+    if (mapped && index.size >= sizeof(header)) {
+        std::memcpy(&header, index.data, sizeof(header));
+    }
+    if (header.magic != journal::INDEX_MAGIC || header.format > JournalFormat::Compressed) {
+        unmap_file(journal.data, journal.size);
+        unmap_file(index.data, index.size);
+        unmap_file(snapshots.data, snapshots.size);
+        return nullptr;
+    }
+    // Private constructor, so no make_unique
+    return std::unique_ptr<IndexedJournalReader>(new IndexedJournalReader(journal, index, snapshots, header.format));
+}
+
+IndexedJournalReader::IndexedJournalReader(Mapping journal, Mapping index, Mapping snapshots,
+                                           JournalFormat format)
+    : journal_(journal)
+    , index_file_(index)
+    , snapshots_(snapshots)
+    , format_(format)
+{
+    // Entries are 8-byte aligned behind the header; a torn last entry is left out
+    const auto* entries = reinterpret_cast<const IndexEntry*>(index.data + sizeof(IndexHeader));
+    std::size_t count = (index.size - sizeof(IndexHeader)) / sizeof(IndexEntry);
+    while (count > 0 && entries[count - 1].offset > journal.size) {
+        --count;
+    }
+    index_ = std::span(entries, count);
+}
+
+IndexedJournalReader::~IndexedJournalReader() {
+    unmap_file(journal_.data, journal_.size);
+    unmap_file(index_file_.data, index_file_.size);
+    unmap_file(snapshots_.data, snapshots_.size);
+}
+
+std::optional<JournalPosition> IndexedJournalReader::seek(Timestamp time, MatchingEngine& engine) const {
+    const auto after = std::ranges::upper_bound(index_, time.count(), {}, &IndexEntry::timestamp);
+    const auto entry = static_cast<std::size_t>(after == index_.begin() ? 0 : after - index_.begin() - 1);
+    return replay(entry, engine, [time](const JournalRecord& record) {
+        return record.timestamp <= time.count();
+    });
+}
+
+std::optional<JournalPosition> IndexedJournalReader::seek_sequence(std::uint64_t sequence,
+                                                                   MatchingEngine& engine) const {
+    const auto after = std::ranges::upper_bound(index_, sequence, {}, &IndexEntry::sequence);
+    const auto entry = static_cast<std::size_t>(after == index_.begin() ? 0 : after - index_.begin() - 1);
+    return replay(entry, engine, [sequence](const JournalRecord& record) {
+        return record.sequence <= sequence;
+    });
+}
+
+template<typename F>
+void IndexedJournalReader::for_each_record(std::size_t offset, std::size_t end, F&& f) const {
+    JournalDecoder decoder;
+    JournalRecord record;
+    while (offset < end) {
+        std::size_t used = sizeof(JournalRecord);
+        if (format_ == JournalFormat::Compressed) {
+            used = decoder.decode(journal_.data + offset, end - offset, record);
+        } else if (end - offset >= sizeof(JournalRecord)) {
+            std::memcpy(&record, journal_.data + offset, sizeof(record));
+        } else {
+            used = 0;
+        }
+        if (used == 0 || !f(record)) {
+            return;
+        }
+        offset += used;
+    }
+}
+
+template<typename Keep>
+std::optional<JournalPosition> IndexedJournalReader::replay(std::size_t entry, MatchingEngine& engine,
+                                                            Keep&& keep) const {
+    if (index_.empty() || engine.get_order_book().order_count() != 0) {
+        return std::nullopt;
+    }
+    std::size_t start = entry;
+    while (index_[start].snapshot == journal::NO_SNAPSHOT) {
+        if (start == 0) {
+            return std::nullopt;
+        }
+        --start;
+    }
+
+    // Every later index entry is past the target, so replay stops at the next one
+    const std::size_t end = entry + 1 < index_.size() ? index_[entry + 1].offset : journal_.size;
+    std::int64_t target = index_[start].timestamp;
+    for_each_record(index_[start].offset, end, [&keep, &target](const JournalRecord& record) {
+        if (!keep(record)) {
+            return false;
+        }
+        target = record.timestamp;
+        return true;
+    });
+    // Journal time shifted so the target falls on now: the segment runs on the clock it
+    // was written with, and the rebuilt book keeps what it had left to expire at the target
+    const Timestamp shift = steady_time() - Timestamp{target};
+    const std::optional<std::uint64_t> restored =
+        restore(index_[start].snapshot, engine, Timestamp{index_[start].timestamp} + shift);
+    if (!restored) {
+        return std::nullopt;
+    }
+
+    JournalPosition position{.sequence = *restored};
+    for_each_record(index_[start].offset, end, [&](const JournalRecord& record) {
+        if (!keep(record)) {
+            return false;
+        }
+        OrderCommand command = record.command;
+        if (command.time_in_force == TimeInForce::GTT) {
+            command.expire_time += shift.count();
+        }
+        engine.pin_clock(Timestamp{record.timestamp} + shift);
+        (void)execute_command(engine, command, record.participant);
+        position.sequence = record.sequence;
+        ++position.replayed;
+        return true;
+    });
+    engine.unpin_clock();
+    return position;
+}
+
+std::optional<std::uint64_t> IndexedJournalReader::restore(std::uint64_t snapshot, MatchingEngine& engine,
+                                                           Timestamp taken) const {
+    SnapshotHeader header;
+    if (snapshots_.size < sizeof(header) || snapshot > snapshots_.size - sizeof(header)) {
+        return std::nullopt;
+    }
+    std::memcpy(&header, snapshots_.data + snapshot, sizeof(header));
+    const std::size_t available = snapshots_.size - snapshot - sizeof(header);
+    if (header.magic != journal::SNAPSHOT_MAGIC || header.orders > available / sizeof(SnapshotOrder)) {
+        return std::nullopt;
+    }
+
+    if (header.session_state > SessionState::Auction ||
+        header.self_trade_prevention > SelfTradePrevention::Decrement) {
+        return std::nullopt;
+    }
+
+    OrderBook& book = engine.get_order_book();
+    if (!book.set_expiry_origin(taken)) {
+        return std::nullopt;
+    }
+    const auto fail = [&engine, &book]() -> std::optional<std::uint64_t> {
+        book.clear();
+        engine.restore_engine_state(EngineState{});
+        return std::nullopt;
+    };
+    const std::byte* at = snapshots_.data + snapshot + sizeof(header);
+    for (std::uint64_t i = 0; i < header.orders; ++i, at += sizeof(SnapshotOrder)) {
+        SnapshotOrder captured;
+        std::memcpy(&captured, at, sizeof(captured));
+        if (!valid_order_fields(captured.side, captured.type, captured.time_in_force) ||
+            captured.status > OrderStatus::PartiallyFilled) {
+            return fail();
+        }
+        Order order{};
+        order.id = captured.id;
+        order.side = captured.side;
+        order.type = captured.type;
+        order.price = captured.price;
+        order.quantity = captured.quantity;
+        order.filled_quantity = captured.filled_quantity;
+        order.status = captured.status;
+        order.time_in_force = captured.time_in_force;
+        order.participant = captured.participant;
+        order.expire_time = captured.time_in_force == TimeInForce::GTC ? Timestamp{0}
+                                                                       : taken + Timestamp{captured.expire_time};
+        order.arrival = captured.arrival;
+        if (!book.restore_order(order)) {
+            return fail();
+        }
+    }
+    book.set_next_arrival(header.next_arrival);
+    engine.restore_engine_state(EngineState{
+        .session_state = header.session_state,
+        .self_trade_prevention = header.self_trade_prevention,
+        .reference_price = header.has_reference_price ? std::optional(header.reference_price) : std::nullopt,
+        .last_trade_price = header.has_last_trade_price ? std::optional(header.last_trade_price) : std::nullopt,
+        .session_close = header.has_session_close ? taken + Timestamp{header.session_close} : Timestamp{0}
+    });
+    if (book.state_hash() != header.state_hash) {
+        return fail();
+    }
+    return header.sequence;
+}
+
+} // namespace lob
@@ -0,0 +1,168 @@
+#include "io_uring.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace lob {
+
+namespace {
+
+template<typename T>
+T* ring_field(void* ring, std::uint32_t offset) noexcept {
+    return reinterpret_cast<T*>(static_cast<char*>(ring) + offset);
+}
+
+} // namespace
+
+std::unique_ptr<IoUring> IoUring::create(const Options& options) {
+    io_uring_params params{};
+    params.cq_entries = options.entries * 4;
+    params.flags = IORING_SETUP_CQSIZE;
+    if (options.sqpoll) {
+        params.flags |= IORING_SETUP_SQPOLL;
+        params.sq_thread_idle = options.sqpoll_idle_ms;
+    }
+    const int fd = static_cast<int>(::syscall(__NR_io_uring_setup, options.entries, &params));
+    if (fd < 0) {
+        return nullptr;
+    }
+    // Relies on the single SQ/CQ mapping and on EXT_ARG for timed waits (Linux 5.11+)
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_EXT_ARG)) {
+        ::close(fd);
+        return nullptr;
+    }
+
+    std::unique_ptr<IoUring> ring(new IoUring);
+    ring->fd_ = fd;
+    ring->sqpoll_ = options.sqpoll;
+    // Single mmap: the CQ lives in the SQ ring mapping
+    ring->sq_ring_size_ = std::max(params.sq_off.array + params.sq_entries * sizeof(unsigned),
+                                   params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+    ring->sq_ring_ = ::mmap(nullptr, ring->sq_ring_size_, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ring_ == MAP_FAILED) {
+        ring->sq_ring_ = nullptr;
+        return nullptr;
+    }
+    ring->sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = ::mmap(nullptr, ring->sqes_size_, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        return nullptr;
+    }
+    ring->sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+    void* sq = ring->sq_ring_;
+    ring->sq_head_ = ring_field<std::atomic<unsigned>>(sq, params.sq_off.head);
+    ring->sq_tail_ = ring_field<std::atomic<unsigned>>(sq, params.sq_off.tail);
+    ring->sq_flags_ = ring_field<std::atomic<unsigned>>(sq, params.sq_off.flags);
+    ring->sq_mask_ = *ring_field<unsigned>(sq, params.sq_off.ring_mask);
+    ring->sq_entries_ = *ring_field<unsigned>(sq, params.sq_off.ring_entries);
+    ring->cq_head_ = ring_field<std::atomic<unsigned>>(sq, params.cq_off.head);
+    ring->cq_tail_ = ring_field<std::atomic<unsigned>>(sq, params.cq_off.tail);
+    ring->cq_mask_ = *ring_field<unsigned>(sq, params.cq_off.ring_mask);
+    ring->cqes_ = ring_field<io_uring_cqe>(sq, params.cq_off.cqes);
+
+    // SQEs are always consumed in order, so the indirection array is the identity
+    unsigned* array = ring_field<unsigned>(sq, params.sq_off.array);
+    for (unsigned i = 0; i < ring->sq_entries_; ++i) {
+        array[i] = i;
+    }
+    ring->sqe_tail_ = ring->sq_tail_->load(std::memory_order_relaxed);
+    return ring;
+}
+
+IoUring::~IoUring() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    if (sqes_) {
+        ::munmap(sqes_, sqes_size_);
+    }
+    if (sq_ring_) {
+        ::munmap(sq_ring_, sq_ring_size_);
+    }
+    if (buffer_ring_) {
+        ::munmap(buffer_ring_, buffer_ring_size_);
+    }
+}
+
+io_uring_sqe* IoUring::get_sqe() noexcept {
+    // With SQPOLL the kernel may still be reading entries behind the published tail
+    if (sqe_tail_ - sq_head_->load(std::memory_order_acquire) >= sq_entries_) {
+        return nullptr;
+    }
+    io_uring_sqe* sqe = &sqes_[sqe_tail_ & sq_mask_];
+    ++sqe_tail_;
+    std::memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+bool IoUring::submit(unsigned min_complete, std::chrono::nanoseconds timeout) {
+    const unsigned published = sq_tail_->load(std::memory_order_relaxed);
+    const unsigned to_submit = sqe_tail_ - published;
+    sq_tail_->store(sqe_tail_, std::memory_order_release);
+
+    unsigned flags = min_complete ? IORING_ENTER_GETEVENTS : 0;
+    if (sqpoll_) {
+        // The SQ thread picks entries up by itself unless it went to sleep
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sq_flags_->load(std::memory_order_relaxed) & IORING_SQ_NEED_WAKEUP) {
+            flags |= IORING_ENTER_SQ_WAKEUP;
+        }
+        if (flags == 0) {
+            return true;
+        }
+    } else if (to_submit == 0 && min_complete == 0) {
+        return true;
+    }
+
+    __kernel_timespec ts{};
+    io_uring_getevents_arg arg{};
+    const void* argp = nullptr;
+    std::size_t argsz = 0;
+    if (min_complete && timeout.count() > 0) {
+        ts.tv_sec = timeout.count() / 1'000'000'000;
+        ts.tv_nsec = timeout.count() % 1'000'000'000;
+        arg.ts = reinterpret_cast<std::uint64_t>(&ts);
+        flags |= IORING_ENTER_EXT_ARG;
+        argp = &arg;
+        argsz = sizeof(arg);
+    }
+    ++enters_;
+    const long result = ::syscall(__NR_io_uring_enter, fd_, sqpoll_ ? 0 : to_submit, min_complete,
+                                  flags, argp, argsz);
+    return result >= 0 || errno == ETIME || errno == EINTR || errno == EBUSY;
+}
+
+bool IoUring::register_buffers(std::span<const iovec> buffers) noexcept {
+    return ::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_BUFFERS,
+                     buffers.data(), static_cast<unsigned>(buffers.size())) == 0;
+}
+
+io_uring_buf_ring* IoUring::register_buffer_ring(std::uint16_t group, unsigned entries) noexcept {
+    if (buffer_ring_) {
+        return nullptr;  // One group per ring is all the gateways need
+    }
+    const std::size_t size = entries * sizeof(io_uring_buf);
+    void* memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        return nullptr;
+    }
+    io_uring_buf_reg reg{};
+    reg.ring_addr = reinterpret_cast<std::uint64_t>(memory);
+    reg.ring_entries = entries;
+    reg.bgid = group;
+    if (::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PBUF_RING, &reg, 1) != 0) {
+        ::munmap(memory, size);
+        return nullptr;
+    }
+    buffer_ring_ = memory;
+    buffer_ring_size_ = size;
+    return static_cast<io_uring_buf_ring*>(memory);
+}
+
+} // namespace lob
@@ -0,0 +1,416 @@
+#include "market_data.hpp"
+#include "order_book.hpp"
+#include "retransmission.hpp"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace lob {
+
+namespace {
+
+constexpr std::size_t HEADER = sizeof(mdp::PacketHeader);
+constexpr std::size_t ENTRY = sizeof(mdp::Entry);
+constexpr std::size_t MAX_DATAGRAM = 65507;     // Largest UDP payload over IPv4
+constexpr int RECEIVE_BUFFER = 4 * 1024 * 1024;  // Absorbs bursts between polls
+
+bool parse_address(const std::string& text, std::uint32_t& address) noexcept {
+    in_addr parsed{};
+    if (::inet_pton(AF_INET, text.c_str(), &parsed) != 1) {
+        return false;
+    }
+    address = parsed.s_addr;
+    return true;
+}
+
+// Non-blocking UDP socket bound to group:port and joined to it on interface
+int open_group_socket(std::uint32_t group, std::uint16_t port, std::uint32_t interface) noexcept {
+    const int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    const int one = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &RECEIVE_BUFFER, sizeof(RECEIVE_BUFFER));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = group;
+    ip_mreq membership{};
+    membership.imr_multiaddr.s_addr = group;
+    membership.imr_interface.s_addr = interface;
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void store_entry(std::vector<std::byte>& packet, std::size_t index, const mdp::Entry& entry) noexcept {
+    std::memcpy(packet.data() + HEADER + index * ENTRY, &entry, ENTRY);
+}
+
+} // namespace
+
+std::unique_ptr<MarketDataPublisher> MarketDataPublisher::create(MatchingEngine& engine,
+                                                                 const Options& options) {
+    std::uint32_t incremental_group = 0;
+    std::uint32_t snapshot_group = 0;
+    std::uint32_t interface = 0;
+    if (!parse_address(options.incremental_group, incremental_group) ||
+        !parse_address(options.snapshot_group, snapshot_group) ||
+        !parse_address(options.interface, interface) ||
+        options.packet_size < HEADER + ENTRY || options.packet_size > MAX_DATAGRAM) {
+        return nullptr;
+    }
+
+    const int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return nullptr;
+    }
+    in_addr source{};
+    source.s_addr = interface;
+    const unsigned char ttl = options.ttl;
+    const unsigned char loop = 1;  // Receivers on this host see the groups too
+    if (::setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, &source, sizeof(source)) != 0 ||
+        ::setsockopt(fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) != 0 ||
+        ::setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) != 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    // Private constructor, so no make_unique
+    return std::unique_ptr<MarketDataPublisher>(
+        new MarketDataPublisher(engine, options, fd, incremental_group, snapshot_group));
+}
+
+MarketDataPublisher::MarketDataPublisher(MatchingEngine& engine, const Options& options, int fd,
+                                         std::uint32_t incremental_group, std::uint32_t snapshot_group)
+    : engine_(engine)
+    , fd_(fd)
+    , incremental_group_(incremental_group)
+    , incremental_port_(htons(options.incremental_port))
+    , snapshot_group_(snapshot_group)
+    , snapshot_port_(htons(options.snapshot_port))
+    , max_entries_((options.packet_size - HEADER) / ENTRY)
+    , snapshot_interval_(options.snapshot_interval)
+    , incremental_(HEADER + max_entries_ * ENTRY)
+    , snapshot_(HEADER + max_entries_ * ENTRY)
+{
+    engine_.add_observer(this);
+}
+
+MarketDataPublisher::~MarketDataPublisher() {
+    engine_.remove_observer(this);
+    ::close(fd_);
+}
+
+void MarketDataPublisher::on_trade(const Trade& trade) {
+    append(mdp::Entry{
+        .price = trade.price,
+        .quantity = trade.quantity,
+        .type = mdp::EntryType::Trade,
+        .side = trade.aggressor.value_or(Side::Buy),
+        .flags = trade.aggressor ? std::uint8_t{0} : std::uint8_t{mdp::NoAggressor},
+        .reserved = {}
+    });
+}
+
+void MarketDataPublisher::on_level_updates(std::span<const LevelUpdate> updates) {
+    for (const LevelUpdate& update : updates) {
+        append(mdp::Entry{
+            .price = update.price,
+            .quantity = update.quantity,
+            .type = mdp::EntryType::Level,
+            .side = update.side,
+            .flags = 0,
+            .reserved = {}
+        });
+    }
+}
+
+void MarketDataPublisher::on_message_processed(const OrderBook& book) {
+    (void)book;
+    if (snapshot_interval_ != 0 && ++messages_since_snapshot_ >= snapshot_interval_) {
+        publish_snapshot();
+    }
+}
+
+void MarketDataPublisher::append(const mdp::Entry& entry) {
+    if (incremental_count_ == max_entries_) {
+        flush();
+    }
+    store_entry(incremental_, incremental_count_++, entry);
+}
+
+void MarketDataPublisher::flush() {
+    if (incremental_count_ == 0) {
+        return;
+    }
+    send(incremental_, incremental_count_, mdp::Channel::Incremental, ++incremental_seq_, 0);
+    incremental_count_ = 0;
+}
+
+void MarketDataPublisher::publish_snapshot() {
+    flush();
+    messages_since_snapshot_ = 0;
+
+    std::uint8_t flags = mdp::SnapshotBegin;
+    std::uint16_t count = 0;
+    for (Side side : {Side::Buy, Side::Sell}) {
+        engine_.get_order_book().for_each_level(side, SIZE_MAX, [&](Price price, Quantity quantity) {
+            if (count == max_entries_) {
+                send_snapshot_packet(count, flags);
+                flags = 0;
+                count = 0;
+            }
+            store_entry(snapshot_, count++, mdp::Entry{
+                .price = price,
+                .quantity = quantity,
+                .type = mdp::EntryType::Level,
+                .side = side,
+                .flags = 0,
+                .reserved = {}
+            });
+        });
+    }
+    send_snapshot_packet(count, flags | mdp::SnapshotEnd);
+}
+
+void MarketDataPublisher::send_snapshot_packet(std::uint16_t count, std::uint8_t flags) {
+    send(snapshot_, count, mdp::Channel::Snapshot, ++snapshot_seq_, flags);
+}
+
+void MarketDataPublisher::send(std::vector<std::byte>& packet, std::uint16_t count,
+                               mdp::Channel channel, std::uint64_t sequence, std::uint8_t flags) {
+    const std::size_t length = HEADER + count * ENTRY;
+    const mdp::PacketHeader header{
+        .sequence = sequence,
+        .incremental_seq = incremental_seq_,
+        .length = static_cast<std::uint16_t>(length),
+        .count = count,
+        .channel = channel,
+        .flags = flags,
+        .reserved = {}
+    };
+    std::memcpy(packet.data(), &header, HEADER);
+    if (history_ && channel == mdp::Channel::Incremental) {
+        history_->append(sequence, std::span(packet.data(), length));
+    }
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    const bool incremental = channel == mdp::Channel::Incremental;
+    addr.sin_port = incremental ? incremental_port_ : snapshot_port_;
+    addr.sin_addr.s_addr = incremental ? incremental_group_ : snapshot_group_;
+    if (::sendto(fd_, packet.data(), length, 0, reinterpret_cast<const sockaddr*>(&addr),
+                 sizeof(addr)) == static_cast<ssize_t>(length)) {
+        ++packets_sent_;
+    } else {
+        ++send_errors_;
+    }
+}
+
+std::unique_ptr<MarketDataReceiver> MarketDataReceiver::create(const MarketDataOptions& options) {
+    std::uint32_t incremental_group = 0;
+    std::uint32_t snapshot_group = 0;
+    std::uint32_t interface = 0;
+    if (!parse_address(options.incremental_group, incremental_group) ||
+        !parse_address(options.snapshot_group, snapshot_group) ||
+        !parse_address(options.interface, interface)) {
+        return nullptr;
+    }
+    const int incremental_fd = open_group_socket(incremental_group, options.incremental_port, interface);
+    if (incremental_fd < 0) {
+        return nullptr;
+    }
+    const int snapshot_fd = open_group_socket(snapshot_group, options.snapshot_port, interface);
+    if (snapshot_fd < 0) {
+        ::close(incremental_fd);
+        return nullptr;
+    }
+    // Private constructor, so no make_unique
+    return std::unique_ptr<MarketDataReceiver>(new MarketDataReceiver(incremental_fd, snapshot_fd));
+}
+
+MarketDataReceiver::MarketDataReceiver() = default;
+
+MarketDataReceiver::MarketDataReceiver(int incremental_fd, int snapshot_fd)
+    : incremental_fd_(incremental_fd)
+    , snapshot_fd_(snapshot_fd)
+{
+}
+
+MarketDataReceiver::~MarketDataReceiver() {
+    if (incremental_fd_ >= 0) {
+        ::close(incremental_fd_);
+    }
+    if (snapshot_fd_ >= 0) {
+        ::close(snapshot_fd_);
+    }
+}
+
+std::size_t MarketDataReceiver::poll(std::chrono::milliseconds timeout) {
+    pollfd fds[2] = {{incremental_fd_, POLLIN, 0}, {snapshot_fd_, POLLIN, 0}};
+    if (::poll(fds, 2, static_cast<int>(timeout.count())) <= 0) {
+        return 0;
+    }
+    std::size_t packets = 0;
+    alignas(mdp::PacketHeader) std::byte buffer[MAX_DATAGRAM];
+    for (const pollfd& fd : fds) {
+        for (;;) {
+            const ssize_t received = ::recv(fd.fd, buffer, sizeof(buffer), 0);
+            if (received < 0) {
+                break;  // EAGAIN, or an error the next poll reports again
+            }
+            handle_packet(std::span(buffer, static_cast<std::size_t>(received)));
+            ++packets;
+        }
+    }
+    return packets;
+}
+
+bool MarketDataReceiver::handle_packet(std::span<const std::byte> packet) {
+    if (packet.size() < HEADER) {
+        return false;
+    }
+    mdp::PacketHeader header;
+    std::memcpy(&header, packet.data(), HEADER);
+    if (header.length != packet.size() || header.length != HEADER + header.count * ENTRY) {
+        return false;
+    }
+    // Entries are copied out so the packet needs no particular alignment
+    mdp::Entry entries[MAX_DATAGRAM / ENTRY];
+    std::memcpy(entries, packet.data() + HEADER, header.count * ENTRY);
+    const std::span<const mdp::Entry> view(entries, header.count);
+
+    switch (header.channel) {
+        case mdp::Channel::Incremental:
+            handle_incremental(header, view, packet);
+            return true;
+        case mdp::Channel::Snapshot:
+            handle_snapshot(header, view);
+            return true;
+        case mdp::Channel::RetransmitEnd:
+            return true;
+    }
+    return false;
+}
+
+void MarketDataReceiver::handle_incremental(const mdp::PacketHeader& header,
+                                            std::span<const mdp::Entry> entries,
+                                            std::span<const std::byte> packet) {
+    if (seeded_ && header.sequence <= incremental_seq_) {
+        return;  // Duplicate, or already covered by the snapshot
+    }
+    if (seeded_ && header.sequence == incremental_seq_ + 1) {
+        apply(entries);
+        incremental_seq_ = header.sequence;
+        if (!synced_) {
+            replay_buffered();
+        }
+        return;
+    }
+    if (synced_) {
+        // Lost packets: hold the book until they are retransmitted or a snapshot arrives
+        ++gaps_;
+        synced_ = false;
+    }
+    if (buffered_.size() == MAX_BUFFERED) {
+        buffered_.erase(buffered_.begin());
+    }
+    buffered_.try_emplace(header.sequence, packet.begin(), packet.end());
+}
+
+void MarketDataReceiver::handle_snapshot(const mdp::PacketHeader& header,
+                                         std::span<const mdp::Entry> entries) {
+    if (synced_) {
+        return;
+    }
+    if (header.flags & mdp::SnapshotBegin) {
+        assembling_ = true;
+        snapshot_entries_.clear();
+    } else if (!assembling_ || header.sequence != snapshot_next_) {
+        assembling_ = false;  // Lost a fragment; wait for the next snapshot
+        return;
+    }
+    snapshot_next_ = header.sequence + 1;
+    snapshot_entries_.insert(snapshot_entries_.end(), entries.begin(), entries.end());
+    if (!(header.flags & mdp::SnapshotEnd)) {
+        return;
+    }
+    assembling_ = false;
+    // Packets up to our own book were dropped from the buffer, so an older snapshot
+    // could not be brought forward
+    if (seeded_ && header.incremental_seq < incremental_seq_) {
+        return;
+    }
+
+    bids_.clear();
+    asks_.clear();
+    apply(snapshot_entries_);
+    incremental_seq_ = header.incremental_seq;
+    seeded_ = true;
+    replay_buffered();
+}
+
+// Apply the buffered packets that continue the book; a hole leaves it unsynced
+void MarketDataReceiver::replay_buffered() {
+    mdp::Entry entries[MAX_DATAGRAM / ENTRY];
+    auto it = buffered_.begin();
+    for (; it != buffered_.end() && it->first <= incremental_seq_ + 1; ++it) {
+        if (it->first <= incremental_seq_) {
+            continue;
+        }
+        mdp::PacketHeader header;
+        std::memcpy(&header, it->second.data(), HEADER);
+        std::memcpy(entries, it->second.data() + HEADER, header.count * ENTRY);
+        apply(std::span<const mdp::Entry>(entries, header.count));
+        incremental_seq_ = it->first;
+    }
+    buffered_.erase(buffered_.begin(), it);
+    synced_ = buffered_.empty();
+}
+
+std::optional<std::pair<std::uint64_t, std::uint64_t>> MarketDataReceiver::missing() const noexcept {
+    if (!seeded_ || synced_ || buffered_.empty()) {
+        return std::nullopt;
+    }
+    return std::pair{incremental_seq_ + 1, buffered_.begin()->first - 1};
+}
+
+void MarketDataReceiver::apply(std::span<const mdp::Entry> entries) {
+    for (const mdp::Entry& entry : entries) {
+        if (entry.type == mdp::EntryType::Trade) {
+            ++trades_;
+            traded_quantity_ += entry.quantity;
+            continue;
+        }
+        auto update = [&entry](auto& levels) {
+            if (entry.quantity == 0) {
+                levels.erase(entry.price);
+            } else {
+                levels[entry.price] = entry.quantity;
+            }
+        };
+        entry.side == Side::Buy ? update(bids_) : update(asks_);
+    }
+}
+
+std::vector<std::pair<Price, Quantity>> MarketDataReceiver::get_levels(Side side, std::size_t n) const {
+    std::vector<std::pair<Price, Quantity>> levels;
+    auto collect = [&levels, n](const auto& side_levels) {
+        for (auto it = side_levels.begin(); it != side_levels.end() && levels.size() < n; ++it) {
+            levels.emplace_back(it->first, it->second);
+        }
+    };
+    side == Side::Buy ? collect(bids_) : collect(asks_);
+    return levels;
+}
+
+} // namespace lob
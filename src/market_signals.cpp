@@ -0,0 +1,113 @@
+#include "market_signals.hpp"
+#include "order_book.hpp"
+#include <algorithm>
+
+namespace lob {
+
+MarketSignals::MarketSignals(Timestamp window, std::size_t max_window_trades)
+    : window_(window)
+    , ring_(std::max<std::size_t>(max_window_trades, 1))
+{
+    published_.store(current_);
+}
+
+void MarketSignals::on_trade(const Trade& trade) {
+    evict_before(trade.timestamp - window_);
+    if (count_ == ring_.size()) {
+        pop_oldest();
+    }
+
+    const Notional notional = trade.price * static_cast<Notional>(trade.quantity);
+    const auto quantity = static_cast<std::int64_t>(trade.quantity);
+    const std::int64_t flow = !trade.aggressor ? 0
+                            : *trade.aggressor == Side::Buy ? quantity : -quantity;
+    ring_[(head_ + count_) % ring_.size()] = {trade.timestamp, notional, trade.quantity, flow};
+    ++count_;
+
+    window_notional_ += notional;
+    window_volume_ += trade.quantity;
+    window_flow_ += flow;
+    changed_ = true;
+}
+
+void MarketSignals::on_level_updates(std::span<const LevelUpdate> updates) {
+    for (const LevelUpdate& update : updates) {
+        if (update.side == Side::Buy) {
+            if (update.quantity > 0) {
+                if (current_.bid_quantity == 0 || update.price >= current_.best_bid) {
+                    current_.best_bid = update.price;
+                    current_.bid_quantity = update.quantity;
+                    bid_stale_ = false;
+                }
+            } else if (update.price == current_.best_bid) {
+                bid_stale_ = true;  // Touch emptied; the next best is read from the book
+            }
+        } else {
+            if (update.quantity > 0) {
+                if (current_.ask_quantity == 0 || update.price <= current_.best_ask) {
+                    current_.best_ask = update.price;
+                    current_.ask_quantity = update.quantity;
+                    ask_stale_ = false;
+                }
+            } else if (update.price == current_.best_ask) {
+                ask_stale_ = true;
+            }
+        }
+    }
+    changed_ = true;
+}
+
+void MarketSignals::on_message_processed(const OrderBook& book) {
+    ++current_.sequence;
+    if (!changed_) {
+        return;
+    }
+    if (bid_stale_) {
+        const auto top = book.top_level(Side::Buy);
+        current_.best_bid = top ? top->first : 0;
+        current_.bid_quantity = top ? top->second : 0;
+        bid_stale_ = false;
+    }
+    if (ask_stale_) {
+        const auto top = book.top_level(Side::Sell);
+        current_.best_ask = top ? top->first : 0;
+        current_.ask_quantity = top ? top->second : 0;
+        ask_stale_ = false;
+    }
+    recompute();
+    published_.store(current_);
+    changed_ = false;
+}
+
+void MarketSignals::evict_before(Timestamp cutoff) noexcept {
+    while (count_ > 0 && ring_[head_].timestamp < cutoff) {
+        pop_oldest();
+    }
+}
+
+void MarketSignals::pop_oldest() noexcept {
+    const WindowTrade& oldest = ring_[head_];
+    window_notional_ -= oldest.notional;
+    window_volume_ -= oldest.quantity;
+    window_flow_ -= oldest.flow;
+    head_ = (head_ + 1) % ring_.size();
+    --count_;
+}
+
+void MarketSignals::recompute() noexcept {
+    const auto bid_qty = static_cast<double>(current_.bid_quantity);
+    const auto ask_qty = static_cast<double>(current_.ask_quantity);
+    const double touch = bid_qty + ask_qty;
+    current_.imbalance = touch > 0 ? (bid_qty - ask_qty) / touch : 0.0;
+    current_.microprice = current_.bid_quantity && current_.ask_quantity
+        ? (static_cast<double>(current_.best_bid) * ask_qty +
+           static_cast<double>(current_.best_ask) * bid_qty) / touch
+        : 0.0;
+
+    current_.window_volume = window_volume_;
+    const auto volume = static_cast<double>(window_volume_);
+    current_.vwap = window_volume_ ? static_cast<double>(window_notional_) / volume : 0.0;
+    current_.trade_flow_imbalance = window_volume_ ? static_cast<double>(window_flow_) / volume : 0.0;
+}
+
+} // namespace lob
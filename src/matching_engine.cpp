@@ -1,24 +1,67 @@
 #include "matching_engine.hpp"
 #include <algorithm>
-#include <optional>  // C++23: std::optional monadic operations
+#include <optional>
 
 namespace lob {
 
-MatchingEngine::MatchingEngine(TradeCallback trade_callback)
+template<typename AllocationPolicy>
+BasicMatchingEngine<AllocationPolicy>::BasicMatchingEngine(TradeCallback trade_callback,
+                                                           AllocationPolicy policy)
     : order_book_(trade_callback)
     , trade_callback_(trade_callback)
+    , policy_(policy)
 {
 }
 
-OrderStatus MatchingEngine::submit_order(OrderId id, Side side, OrderType type,
-                                        Price price, Quantity quantity) {
+template<typename AllocationPolicy>
+OrderStatus BasicMatchingEngine<AllocationPolicy>::submit_order(OrderId id, Side side,
+                                                                OrderType type,
+                                                                Price price, Quantity quantity) {
+    return submit_order(id, side, type, price, quantity, TimeInForce::GTC);
+}
+
+template<typename AllocationPolicy>
+OrderStatus BasicMatchingEngine<AllocationPolicy>::submit_order(OrderId id, Side side,
+                                                                OrderType type,
+                                                                Price price, Quantity quantity,
+                                                                TimeInForce tif,
+                                                                Timestamp expire_time,
+                                                                ParticipantId participant) {
+    // Every level touched by this command is published as one batch
+    MessageScope scope(*this);
+    OrderBook::UpdateBatch batch(order_book_);
+    process_due_expiries();
+    
     if (quantity == 0) {
         return OrderStatus::Rejected;
     }
     
-    if (!order_book_.add_order(id, side, type, price, quantity)) {
+    // Only resting limit orders can carry an expiry
+    if (type != OrderType::Limit) {
+        tif = TimeInForce::GTC;
+    }
+    if (tif == TimeInForce::Day) {
+        if (session_close_.count() == 0) {
+            return OrderStatus::Rejected;
+        }
+        expire_time = session_close_;
+    }
+    if (tif != TimeInForce::GTC && expire_time <= clock()) {
+        return OrderStatus::Rejected;
+    }
+    
+    // During the call period only limit orders are accepted, and they never match
+    const bool in_auction = session_state_ == SessionState::Auction;
+    if (in_auction && type != OrderType::Limit) {
+        return OrderStatus::Rejected;
+    }
+    
+    if (!order_book_.add_order(id, side, type, price, quantity, tif, expire_time, participant)) {
         return OrderStatus::Rejected;
     }
+    if (in_auction) {
+        return OrderStatus::New;
+    }
     
     const Order* order = order_book_.get_order(id);
     if (!order) {
@@ -30,29 +73,67 @@ OrderStatus MatchingEngine::submit_order(OrderId id, Side side, OrderType type,
     Order* mutable_order = const_cast<Order*>(order);
     match_order(mutable_order);
     
-    // C++23: Use optional monadic operations for cleaner null checking
-    auto final_status = std::optional<const Order*>{order_book_.get_order(id)}
-        .transform([this](const Order* o) {
-            Order* mutable_o = const_cast<Order*>(o);
-            OrderStatus status = mutable_o->status;
-            if (mutable_o->is_filled()) {
-                order_book_.remove_filled_order(mutable_o);
-                status = OrderStatus::Filled;
-            }
-            return status;
-        })
-        .value_or(OrderStatus::Cancelled);
+    // Orders cancelled during matching (IOC/FOK remainder, self-trade prevention)
+    // are still in the book so the matching loop never touches freed memory
+    if (mutable_order->status == OrderStatus::Cancelled) {
+        if (mutable_order->is_filled()) {
+            order_book_.remove_filled_order(mutable_order);  // Decremented to zero by STP
+        } else {
+            (void)order_book_.cancel_order(id);
+        }
+        return OrderStatus::Cancelled;
+    }
     
-    return final_status;
+    if (mutable_order->is_filled()) {
+        order_book_.remove_filled_order(mutable_order);
+        return OrderStatus::Filled;
+    }
+    return mutable_order->status;
 }
 
-bool MatchingEngine::cancel_order(OrderId id) {
+template<typename AllocationPolicy>
+bool BasicMatchingEngine<AllocationPolicy>::cancel_order(OrderId id) {
+    MessageScope scope(*this);
+    OrderBook::UpdateBatch batch(order_book_);
+    process_due_expiries();
     return order_book_.cancel_order(id);
 }
 
-bool MatchingEngine::modify_order(OrderId id, Price new_price, Quantity new_quantity) {
+template<typename AllocationPolicy>
+std::size_t BasicMatchingEngine<AllocationPolicy>::mass_cancel(ParticipantId participant) {
+    MessageScope scope(*this);
+    OrderBook::UpdateBatch batch(order_book_);
+    process_due_expiries();
+    return order_book_.cancel_all(participant);
+}
+
+template<typename AllocationPolicy>
+std::size_t BasicMatchingEngine<AllocationPolicy>::mass_cancel(ParticipantId participant,
+                                                               Side side) {
+    MessageScope scope(*this);
+    OrderBook::UpdateBatch batch(order_book_);
+    process_due_expiries();
+    return order_book_.cancel_side(participant, side);
+}
+
+template<typename AllocationPolicy>
+std::size_t BasicMatchingEngine<AllocationPolicy>::mass_cancel(ParticipantId participant,
+                                                               Side side,
+                                                               Price min_price, Price max_price) {
+    MessageScope scope(*this);
+    OrderBook::UpdateBatch batch(order_book_);
+    process_due_expiries();
+    return order_book_.cancel_price_range(participant, side, min_price, max_price);
+}
+
+template<typename AllocationPolicy>
+bool BasicMatchingEngine<AllocationPolicy>::modify_order(OrderId id, Price new_price,
+                                                         Quantity new_quantity) {
     // Modification is implemented as cancel + re-add with remaining quantity
     // This preserves filled quantity and maintains order book integrity
+    MessageScope scope(*this);
+    OrderBook::UpdateBatch batch(order_book_);
+    process_due_expiries();
     const Order* old_order = order_book_.get_order(id);
     if (!old_order) {
         return false;
@@ -60,6 +141,9 @@ bool MatchingEngine::modify_order(OrderId id, Price new_price, Quantity new_quan
     
     Side side = old_order->side;
     OrderType type = old_order->type;
+    TimeInForce tif = old_order->time_in_force;
+    Timestamp expire_time = old_order->expire_time;
+    ParticipantId participant = old_order->participant;
     Quantity filled = old_order->filled_quantity;
     
     // Can't reduce quantity below already filled amount
@@ -75,13 +159,170 @@ bool MatchingEngine::modify_order(OrderId id, Price new_price, Quantity new_quan
     // Re-add with new price/quantity (only remaining unfilled portion)
     Quantity remaining = new_quantity - filled;
     if (remaining > 0) {
-        return order_book_.add_order(id, side, type, new_price, remaining);
+        return order_book_.add_order(id, side, type, new_price, remaining, tif, expire_time, participant);
     }
     
     return true;
 }
 
-void MatchingEngine::match_order(Order* order) {
+template<typename AllocationPolicy>
+std::optional<AuctionUncross> BasicMatchingEngine<AllocationPolicy>::indicative_uncross() {
+    if (indicative_version_ != order_book_.version()) {
+        indicative_ = compute_uncross();
+        indicative_version_ = order_book_.version();
+    }
+    return indicative_;
+}
+
+template<typename AllocationPolicy>
+std::optional<AuctionUncross> BasicMatchingEngine<AllocationPolicy>::uncross() {
+    MessageScope scope(*this);
+    OrderBook::UpdateBatch batch(order_book_);
+    std::optional<AuctionUncross> result = indicative_uncross();
+    session_state_ = SessionState::Continuous;
+    order_book_.auction_curves_.deactivate();
+    if (!result) {
+        return std::nullopt;
+    }
+    
+    // Every crossing order trades at the single uncross price, in price-time priority
+    const Price price = result->price;
+    Quantity remaining = result->volume;
+    while (remaining > 0) {
+        auto best_bid = order_book_.best_bid();
+        auto best_ask = order_book_.best_ask();
+        if (!best_bid || !best_ask || *best_bid < price || *best_ask > price) {
+            break;
+        }
+        Order* bid = order_book_.get_first_order_at_price(Side::Buy, *best_bid);
+        Order* ask = order_book_.get_first_order_at_price(Side::Sell, *best_ask);
+        
+        const Quantity trade_qty = std::min({bid->remaining(), ask->remaining(), remaining});
+        const Quantity bid_remaining = bid->remaining();
+        const Quantity ask_remaining = ask->remaining();
+        execute_trade(bid, ask, price, trade_qty, std::nullopt);
+        remaining -= trade_qty;
+        
+        order_book_.update_price_level_quantity_incremental(bid, bid_remaining);
+        order_book_.update_price_level_quantity_incremental(ask, ask_remaining);
+        bid->status = bid->is_filled() ? OrderStatus::Filled : OrderStatus::PartiallyFilled;
+        ask->status = ask->is_filled() ? OrderStatus::Filled : OrderStatus::PartiallyFilled;
+        if (bid->is_filled()) {
+            order_book_.remove_filled_order(bid);
+        }
+        if (ask->is_filled()) {
+            order_book_.remove_filled_order(ask);
+        }
+    }
+    return result;
+}
+
+template<typename AllocationPolicy>
+std::optional<AuctionUncross> BasicMatchingEngine<AllocationPolicy>::compute_uncross() {
+    auto best_bid = order_book_.best_bid();
+    auto best_ask = order_book_.best_ask();
+    if (!best_bid || !best_ask || *best_bid < *best_ask) {
+        return std::nullopt;
+    }
+    
+    AuctionCurves& curves = order_book_.auction_curves_;
+    if (!curves.covers(*best_ask, *best_bid) &&
+        !curves.track(*best_bid, *best_ask, order_book_.bid_levels_, order_book_.ask_levels_)) {
+        return scan_uncross(*best_bid, *best_ask);
+    }
+    return curves.solve(*best_bid, *best_ask, reference_price_ ? reference_price_ : last_trade_price_);
+}
+
+// Walk over every crossing level, for ranges too wide for AuctionCurves
+template<typename AllocationPolicy>
+std::optional<AuctionUncross> BasicMatchingEngine<AllocationPolicy>::scan_uncross(Price best_bid,
+                                                                                  Price best_ask) {
+    // Flatten the crossing range [best ask, best bid] into ascending per-price arrays
+    // (merge of the two sides; everything outside the range never executes). Bid levels
+    // come best first, so the crossing ones are collected and merged from the back.
+    auction_prices_.clear();
+    auction_bids_.clear();
+    auction_asks_.clear();
+    auction_bid_levels_.clear();
+    for (const auto& level : order_book_.bid_levels_) {
+        if (level.price < best_ask) {
+            break;
+        }
+        auction_bid_levels_.emplace_back(level.price, level.total_quantity);
+    }
+    auto ask_it = order_book_.ask_levels_.begin();
+    const auto ask_end = order_book_.ask_levels_.end();
+    auto ask_crosses = [&] { return ask_it != ask_end && ask_it->price <= best_bid; };
+    auto bid_it = auction_bid_levels_.rbegin();
+    const auto bid_end = auction_bid_levels_.rend();
+    while (ask_crosses() || bid_it != bid_end) {
+        const bool take_ask = ask_crosses() &&
+                              (bid_it == bid_end || ask_it->price <= bid_it->first);
+        const bool take_bid = bid_it != bid_end &&
+                              (!ask_crosses() || bid_it->first <= ask_it->price);
+        auction_prices_.push_back(take_ask ? ask_it->price : bid_it->first);
+        auction_asks_.push_back(take_ask ? ask_it->total_quantity : 0);
+        auction_bids_.push_back(take_bid ? bid_it->second : 0);
+        if (take_ask) ++ask_it;
+        if (take_bid) ++bid_it;
+    }
+    
+    // Cumulative curves in place: supply is a prefix sum of asks, demand a suffix sum of bids
+    const std::size_t n = auction_prices_.size();
+    for (std::size_t i = 1; i < n; ++i) {
+        auction_asks_[i] += auction_asks_[i - 1];
+    }
+    for (std::size_t i = n - 1; i-- > 0;) {
+        auction_bids_[i] += auction_bids_[i + 1];
+    }
+    
+    const std::optional<Price> reference = reference_price_ ? reference_price_ : last_trade_price_;
+    auto distance = [&](Price price) {
+        return reference ? (price > *reference ? price - *reference : *reference - price) : 0;
+    };
+    
+    AuctionUncross best;
+    Quantity best_surplus = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const Quantity demand = auction_bids_[i];
+        const Quantity supply = auction_asks_[i];
+        const Quantity volume = std::min(demand, supply);
+        const Quantity surplus = demand > supply ? demand - supply : supply - demand;
+        // Prices are ascending, so strict comparisons keep the lower price on a full tie
+        const bool better = volume > best.volume ||
+                            (volume == best.volume &&
+                             (surplus < best_surplus ||
+                              (surplus == best_surplus &&
+                               distance(auction_prices_[i]) < distance(best.price))));
+        if (i == 0 || better) {
+            best.price = auction_prices_[i];
+            best.volume = volume;
+            best.imbalance = static_cast<std::int64_t>(demand) - static_cast<std::int64_t>(supply);
+            best_surplus = surplus;
+        }
+    }
+    
+    if (best.volume == 0) {
+        return std::nullopt;
+    }
+    return best;
+}
+
+template<typename AllocationPolicy>
+void BasicMatchingEngine<AllocationPolicy>::process_due_expiries() {
+    // Bounded batch between inbound commands; skipped entirely when nothing is scheduled
+    if (order_book_.pending_expiries() != 0 && expiry_batch_limit_ != 0) {
+        order_book_.expire_orders(clock(), expiry_batch_limit_);
+    }
+}
+
+template<typename AllocationPolicy>
+Timestamp BasicMatchingEngine<AllocationPolicy>::clock() const noexcept {
+    return pinned_clock_ ? *pinned_clock_ : steady_time();
+}
+
+template<typename AllocationPolicy>
+void BasicMatchingEngine<AllocationPolicy>::match_order(Order* order) {
     switch (order->type) {
         case OrderType::Limit:
             match_limit_order(order);
@@ -98,110 +339,60 @@ void MatchingEngine::match_order(Order* order) {
     }
 }
 
-void MatchingEngine::match_limit_order(Order* order) {
-    // TODO: Extract common matching logic to reduce duplication between buy/sell paths
-    // The buy and sell matching logic is nearly identical - could be refactored
+template<typename AllocationPolicy>
+void BasicMatchingEngine<AllocationPolicy>::match_limit_order(Order* order) {
+    match_against_book(order, true);
+}
+
+template<typename AllocationPolicy>
+void BasicMatchingEngine<AllocationPolicy>::match_market_order(Order* order) {
+    match_against_book(order, false);
+}
+
+template<typename AllocationPolicy>
+void BasicMatchingEngine<AllocationPolicy>::match_ioc_order(Order* order) {
+    // IOC (Immediate or Cancel): Match immediately, cancel any unfilled portion
+    match_limit_order(order);
+    if (!order->is_filled()) {
+        order->status = OrderStatus::Cancelled;
+    }
+}
+
+template<typename AllocationPolicy>
+void BasicMatchingEngine<AllocationPolicy>::match_fok_order(Order* order) {
+    // FOK (Fill or Kill): Must fill completely or cancel entire order
+    // TODO: Current implementation allows partial fills - should check if full fill
+    // is possible before matching, otherwise reject immediately
+    match_limit_order(order);
+    if (!order->is_filled()) {
+        order->status = OrderStatus::Cancelled;
+    }
+}
+
+template<typename AllocationPolicy>
+void BasicMatchingEngine<AllocationPolicy>::match_against_book(Order* order,
+                                                               bool price_limited) {
+    // The aggressor already rests in the book; its level total is settled once after matching
+    const Quantity old_remaining = order->remaining();
     
+    // STP costs nothing when disabled: the check is compiled out of the loop entirely
+    const bool self_trade_check = stp_mode_ != SelfTradePrevention::None &&
+                                  order->participant != NO_PARTICIPANT;
     if (order->side == Side::Buy) {
-        // Buy order matches against sell orders (asks)
-        // Match as long as our bid price >= best ask price (price-time priority)
-        while (!order->is_filled()) {
-            auto best_ask = order_book_.best_ask();
-            // Stop if no asks available or our price is too low
-            if (!best_ask || order->price < *best_ask) {
-                break;
-            }
-            
-            // Match at the best ask price (price priority)
-            Price match_price = *best_ask;
-            // Get first order at this price level (time priority - FIFO)
-            Order* ask_order = order_book_.get_first_order_at_price(Side::Sell, match_price);
-            if (!ask_order) {
-                break;
-            }
-            
-            // Fill the smaller of the two remaining quantities
-            Quantity trade_qty = std::min(order->remaining(), ask_order->remaining());
-            Quantity old_remaining = ask_order->remaining();
-            
-            order->filled_quantity += trade_qty;
-            ask_order->filled_quantity += trade_qty;
-            
-            // Update price level total quantity efficiently (incremental update)
-            order_book_.update_price_level_quantity_incremental(ask_order, old_remaining);
-            
-            // Record trade if callback exists or we're tracking trades
-            if (trade_callback_ || !trades_.empty()) {
-                Trade trade{
-                    .buy_order_id = order->id,
-                    .sell_order_id = ask_order->id,
-                    .price = match_price,
-                    .quantity = trade_qty,
-                    .timestamp = std::chrono::duration_cast<Timestamp>(
-                        std::chrono::steady_clock::now().time_since_epoch()
-                    )
-                };
-                if (trade_callback_) {
-                    trade_callback_(trade);
-                }
-                trades_.push_back(trade);
-            }
-            
-            // Remove filled orders from the book to maintain FIFO ordering
-            if (ask_order->is_filled()) {
-                order_book_.remove_filled_order(ask_order);
-            }
-        }
+        self_trade_check ? match_side<Side::Buy, true>(order, price_limited)
+                         : match_side<Side::Buy, false>(order, price_limited);
     } else {
-        // Sell order matches against buy orders (bids)
-        // Match as long as our ask price <= best bid price
-        while (!order->is_filled()) {
-            auto best_bid = order_book_.best_bid();
-            // Stop if no bids available or our price is too high
-            if (!best_bid || order->price > *best_bid) {
-                break;
-            }
-            
-            // Match at the best bid price (price priority)
-            Price match_price = *best_bid;
-            // Get first order at this price level (time priority - FIFO)
-            Order* bid_order = order_book_.get_first_order_at_price(Side::Buy, match_price);
-            if (!bid_order) {
-                break;
-            }
-            
-            // Fill the smaller of the two remaining quantities
-            Quantity trade_qty = std::min(order->remaining(), bid_order->remaining());
-            Quantity old_remaining = bid_order->remaining();
-            
-            bid_order->filled_quantity += trade_qty;
-            order->filled_quantity += trade_qty;
-            
-            // Update price level total quantity efficiently (incremental update)
-            order_book_.update_price_level_quantity_incremental(bid_order, old_remaining);
-            
-            if (trade_callback_ || !trades_.empty()) {
-                Trade trade{
-                    .buy_order_id = bid_order->id,
-                    .sell_order_id = order->id,
-                    .price = match_price,
-                    .quantity = trade_qty,
-                    .timestamp = std::chrono::duration_cast<Timestamp>(
-                        std::chrono::steady_clock::now().time_since_epoch()
-                    )
-                };
-                if (trade_callback_) {
-                    trade_callback_(trade);
-                }
-                trades_.push_back(trade);
-            }
-            
-            if (bid_order->is_filled()) {
-                order_book_.remove_filled_order(bid_order);
-            }
-        }
+        self_trade_check ? match_side<Side::Sell, true>(order, price_limited)
+                         : match_side<Side::Sell, false>(order, price_limited);
     }
     
+    if (order->remaining() != old_remaining) {
+        order_book_.update_price_level_quantity_incremental(order, old_remaining);
+    }
+    
+    if (order->status == OrderStatus::Cancelled) {
+        return;
+    }
     if (order->is_filled()) {
         order->status = OrderStatus::Filled;
     } else if (order->filled_quantity > 0) {
@@ -209,131 +400,257 @@ void MatchingEngine::match_limit_order(Order* order) {
     }
 }
 
-void MatchingEngine::match_market_order(Order* order) {
-    if (order->side == Side::Buy) {
-        while (!order->is_filled()) {
-            auto best_ask = order_book_.best_ask();
-            if (!best_ask) break;
-            
-            Order* ask_order = order_book_.get_first_order_at_price(Side::Sell, *best_ask);
-            if (!ask_order) break;
-            
-            Quantity trade_qty = std::min(order->remaining(), ask_order->remaining());
-            Quantity old_remaining = ask_order->remaining();
-            
-            order->filled_quantity += trade_qty;
-            ask_order->filled_quantity += trade_qty;
-            
-            order_book_.update_price_level_quantity_incremental(ask_order, old_remaining);
-            
-            if (trade_callback_ || !trades_.empty()) {
-                Trade trade{
-                    .buy_order_id = order->id,
-                    .sell_order_id = ask_order->id,
-                    .price = *best_ask,
-                    .quantity = trade_qty,
-                    .timestamp = std::chrono::duration_cast<Timestamp>(
-                        std::chrono::steady_clock::now().time_since_epoch()
-                    )
-                };
-                if (trade_callback_) trade_callback_(trade);
-                trades_.push_back(trade);
+template<typename AllocationPolicy>
+template<Side AggressorSide, bool SelfTradeCheck>
+void BasicMatchingEngine<AllocationPolicy>::match_side(Order* order, bool price_limited) {
+    // Buy orders match against asks, sell orders against bids (price-time priority)
+    constexpr Side resting_side = AggressorSide == Side::Buy ? Side::Sell : Side::Buy;
+    
+    while (!order->is_filled()) {
+        auto best = AggressorSide == Side::Buy ? order_book_.best_ask() : order_book_.best_bid();
+        if (!best) {
+            break;
+        }
+        // Limit orders stop once the best opposite price no longer crosses
+        if (price_limited) {
+            if constexpr (AggressorSide == Side::Buy) {
+                if (order->price < *best) break;
+            } else {
+                if (order->price > *best) break;
             }
-            
-            if (ask_order->is_filled()) {
-                order_book_.remove_filled_order(ask_order);
+        }
+        
+        // Match at the resting price against the oldest order at that level (FIFO)
+        Price match_price = *best;
+        Order* resting = order_book_.get_first_order_at_price(resting_side, match_price);
+        if (!resting) {
+            break;
+        }
+        
+        // Pro-rata policies allocate the whole level in one pass
+        if constexpr (AllocationPolicy::pro_rata) {
+            if (!allocate_level<AggressorSide, SelfTradeCheck>(order, resting, match_price)) {
+                break;
             }
+            continue;
         }
-    } else {
-        while (!order->is_filled()) {
-            auto best_bid = order_book_.best_bid();
-            if (!best_bid) break;
-            
-            Order* bid_order = order_book_.get_first_order_at_price(Side::Buy, *best_bid);
-            if (!bid_order) break;
-            
-            Quantity trade_qty = std::min(order->remaining(), bid_order->remaining());
-            Quantity old_remaining = bid_order->remaining();
-            
-            bid_order->filled_quantity += trade_qty;
-            order->filled_quantity += trade_qty;
-            
-            order_book_.update_price_level_quantity_incremental(bid_order, old_remaining);
-            
-            if (trade_callback_ || !trades_.empty()) {
-                Trade trade{
-                    .buy_order_id = bid_order->id,
-                    .sell_order_id = order->id,
-                    .price = *best_bid,
-                    .quantity = trade_qty,
-                    .timestamp = std::chrono::duration_cast<Timestamp>(
-                        std::chrono::steady_clock::now().time_since_epoch()
-                    )
-                };
-                if (trade_callback_) trade_callback_(trade);
-                trades_.push_back(trade);
+        
+        if constexpr (SelfTradeCheck) {
+            if (resting->participant == order->participant) {
+                if (!prevent_self_trade(order, resting)) {
+                    break;
+                }
+                continue;
             }
-            
-            if (bid_order->is_filled()) {
-                order_book_.remove_filled_order(bid_order);
+        }
+        
+        // Fill the smaller of the two remaining quantities
+        fill_resting<AggressorSide>(order, resting, match_price,
+                                    std::min(order->remaining(), resting->remaining()));
+    }
+}
+
+template<typename AllocationPolicy>
+template<Side AggressorSide, bool SelfTradeCheck>
+bool BasicMatchingEngine<AllocationPolicy>::allocate_level(Order* order, Order* first,
+                                                           Price match_price) {
+    Order* resting = first;
+    
+    // Top order priority: the oldest order at the level fills first under FIFO rules
+    if constexpr (AllocationPolicy::top_order_first) {
+        Order* next = resting->next;
+        if (SelfTradeCheck && resting->participant == order->participant) {
+            if (!prevent_self_trade(order, resting)) {
+                return false;
             }
+        } else {
+            fill_resting<AggressorSide>(order, resting, match_price,
+                                        std::min(order->remaining(), resting->remaining()));
         }
+        if (order->is_filled()) {
+            return true;
+        }
+        resting = next;
     }
     
-    if (order->is_filled()) {
-        order->status = OrderStatus::Filled;
-    } else if (order->filled_quantity > 0) {
-        order->status = OrderStatus::PartiallyFilled;
+    // Gather the level into contiguous scratch (capacity is reused across calls)
+    level_orders_.clear();
+    level_quantities_.clear();
+    Quantity level_total = 0;
+    while (resting) {
+        Order* next = resting->next;
+        if constexpr (SelfTradeCheck) {
+            if (resting->participant == order->participant) {
+                if (!prevent_self_trade(order, resting)) {
+                    return false;
+                }
+                resting = next;
+                continue;
+            }
+        }
+        level_orders_.push_back(resting);
+        level_quantities_.push_back(resting->remaining());
+        level_total += resting->remaining();
+        resting = next;
+    }
+    
+    const Quantity incoming = order->remaining();
+    const std::size_t count = level_orders_.size();
+    if (incoming == 0 || count == 0) {
+        return true;
+    }
+    
+    // Shares proportional to resting quantity in one pass; level_quantities_ becomes the allocation
+    // (when the incoming order covers the whole level everything simply fills)
+    if (incoming < level_total) {
+        Quantity allocated = 0;
+        const Quantity min_lot = policy_.min_lot;
+        const bool exact = level_total <= UINT32_MAX;  // q * incoming cannot overflow
+        for (std::size_t i = 0; i < count; ++i) {
+            Quantity share = exact
+                ? level_quantities_[i] * incoming / level_total
+                : static_cast<Quantity>(static_cast<long double>(level_quantities_[i]) *
+                                        incoming / level_total);
+            share = share < min_lot ? 0 : share;
+            level_quantities_[i] = share;
+            allocated += share;
+        }
+        
+        // Rounding residual goes out in time priority, capped by each order's remaining
+        Quantity residual = incoming - allocated;
+        for (std::size_t i = 0; i < count && residual > 0; ++i) {
+            const Quantity extra = std::min(residual,
+                                            level_orders_[i]->remaining() - level_quantities_[i]);
+            level_quantities_[i] += extra;
+            residual -= extra;
+        }
+    }
+    
+    // Execute in time priority so trade ordering stays deterministic
+    for (std::size_t i = 0; i < count; ++i) {
+        const Quantity fill = incoming >= level_total ? level_orders_[i]->remaining()
+                                                      : level_quantities_[i];
+        if (fill > 0) {
+            fill_resting<AggressorSide>(order, level_orders_[i], match_price, fill);
+        }
     }
+    return true;
 }
 
-void MatchingEngine::match_ioc_order(Order* order) {
-    // IOC (Immediate or Cancel): Match immediately, cancel any unfilled portion
-    match_limit_order(order);
-    if (!order->is_filled()) {
-        // Cancel remaining quantity - (void) suppresses unused return value warning
-        (void)order_book_.cancel_order(order->id);
+template<typename AllocationPolicy>
+template<Side AggressorSide>
+void BasicMatchingEngine<AllocationPolicy>::fill_resting(Order* order, Order* resting,
+                                                         Price match_price, Quantity quantity) {
+    Quantity old_remaining = resting->remaining();
+    if constexpr (AggressorSide == Side::Buy) {
+        execute_trade(order, resting, match_price, quantity, AggressorSide);
+    } else {
+        execute_trade(resting, order, match_price, quantity, AggressorSide);
+    }
+    
+    // Update price level total quantity efficiently (incremental update)
+    order_book_.update_price_level_quantity_incremental(resting, old_remaining);
+    
+    // Remove filled orders from the book to maintain FIFO ordering
+    if (resting->is_filled()) {
+        order_book_.remove_filled_order(resting);
     }
 }
 
-void MatchingEngine::match_fok_order(Order* order) {
-    // FOK (Fill or Kill): Must fill completely or cancel entire order
-    // TODO: Current implementation allows partial fills - should check if full fill
-    // is possible before matching, otherwise reject immediately
-    match_limit_order(order);
-    if (!order->is_filled()) {
-        // Cancel remaining quantity - (void) suppresses unused return value warning
-        (void)order_book_.cancel_order(order->id);
+template<typename AllocationPolicy>
+bool BasicMatchingEngine<AllocationPolicy>::prevent_self_trade(Order* order,
+                                                               Order* resting) {
+    switch (stp_mode_) {
+        case SelfTradePrevention::CancelOldest:
+            (void)order_book_.cancel_order(resting->id);
+            return true;
+        case SelfTradePrevention::CancelBoth:
+            (void)order_book_.cancel_order(resting->id);
+            order->status = OrderStatus::Cancelled;
+            return false;
+        case SelfTradePrevention::Decrement: {
+            // Shrink both orders without printing a trade
+            const Quantity decrement = std::min(order->remaining(), resting->remaining());
+            const Quantity old_remaining = resting->remaining();
+            resting->quantity -= decrement;
+            order->quantity -= decrement;
+            order_book_.update_price_level_quantity_incremental(resting, old_remaining);
+            if (resting->remaining() == 0) {
+                order_book_.remove_filled_order(resting);
+            }
+            if (order->remaining() == 0) {
+                order->status = OrderStatus::Cancelled;
+                return false;
+            }
+            return true;
+        }
+        case SelfTradePrevention::CancelNewest:
+        case SelfTradePrevention::None:
+            break;
     }
+    order->status = OrderStatus::Cancelled;
+    return false;
 }
 
-// TODO: This function is currently unused - consider removing or using it to
-// reduce code duplication in match_limit_order/match_market_order
-void MatchingEngine::execute_trade(Order* buy_order, Order* sell_order, 
-                                   Price price, Quantity quantity) {
+template<typename AllocationPolicy>
+void BasicMatchingEngine<AllocationPolicy>::execute_trade(Order* buy_order, Order* sell_order,
+                                                          Price price, Quantity quantity,
+                                                          std::optional<Side> aggressor) {
     Quantity fill_qty = std::min({buy_order->remaining(), 
                                   sell_order->remaining(), 
                                   quantity});
     
     buy_order->filled_quantity += fill_qty;
     sell_order->filled_quantity += fill_qty;
+    last_trade_price_ = price;
     
     Trade trade{
         .buy_order_id = buy_order->id,
         .sell_order_id = sell_order->id,
         .price = price,
         .quantity = fill_qty,
-        .timestamp = std::chrono::duration_cast<Timestamp>(
-            std::chrono::steady_clock::now().time_since_epoch()
-        )
+        .timestamp = clock(),
+        .buy_participant = buy_order->participant,
+        .sell_participant = sell_order->participant,
+        .aggressor = aggressor
     };
     
-    trades_.push_back(trade);
-    
+    if (keep_trades_) {
+        trades_.push_back(trade);
+    }
     if (trade_callback_) {
         trade_callback_(trade);
     }
+    for (EngineObserver* observer : observers_) {
+        observer->on_trade(trade);
+    }
 }
 
-} // namespace lob
+template<typename AllocationPolicy>
+void BasicMatchingEngine<AllocationPolicy>::add_observer(EngineObserver* observer) {
+    if (!observer || std::ranges::find(observers_, observer) != observers_.end()) {
+        return;
+    }
+    observers_.push_back(observer);
+    if (observers_.size() == 1) {
+        order_book_.observer_callback_ = [this](std::span<const LevelUpdate> updates) {
+            for (EngineObserver* o : observers_) {
+                o->on_level_updates(updates);
+            }
+        };
+    }
+}
 
+template<typename AllocationPolicy>
+void BasicMatchingEngine<AllocationPolicy>::remove_observer(EngineObserver* observer) {
+    std::erase(observers_, observer);
+    if (observers_.empty()) {
+        order_book_.observer_callback_ = nullptr;
+    }
+}
+
+template class BasicMatchingEngine<FifoAllocation>;
+template class BasicMatchingEngine<ProRataAllocation>;
+template class BasicMatchingEngine<TopOrderProRataAllocation>;
+
+} // namespace lob
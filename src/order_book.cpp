@@ -1,4 +1,6 @@
 #include "order_book.hpp"
+#include <algorithm>
+#include <bit>
 #include <chrono>
 #include <ranges>  // C++23: std::ranges::to
 #include <source_location>  // C++23: std::source_location
@@ -6,7 +8,8 @@
 namespace lob {
 
 OrderBook::OrderBook(TradeCallback trade_callback)
-    : trade_callback_(std::move(trade_callback))
+    : expiry_origin_(get_timestamp())
+    , trade_callback_(std::move(trade_callback))
 {
 }
 
@@ -16,11 +19,19 @@ OrderBook::~OrderBook() {
 
 bool OrderBook::add_order(OrderId id, Side side, OrderType type, 
                           Price price, Quantity quantity,
+                          TimeInForce tif, Timestamp expire_time,
+                          ParticipantId participant,
                           std::source_location loc) {
     // C++23: std::source_location provides compile-time file/line info for debugging
     if (quantity == 0) {
         return false;
     }
+    UpdateBatch batch(*this);
+    
+    // Day/GTT orders need a concrete expiry (the engine resolves Day to the session close)
+    if (tif != TimeInForce::GTC && expire_time.count() == 0) {
+        return false;
+    }
     
     if (orders_.find(id) != orders_.end()) {
         return false;  // Order ID already exists
@@ -41,30 +52,50 @@ bool OrderBook::add_order(OrderId id, Side side, OrderType type,
     order->filled_quantity = 0;
     order->timestamp = get_timestamp();  // Used for FIFO ordering within price level
     order->status = OrderStatus::New;
+    order->time_in_force = tif;
+    order->expire_time = expire_time;
+    order->participant = participant;
     order->next = nullptr;
     order->prev = nullptr;
     
     // Get or create price level (bids use descending order, asks use ascending)
     PriceLevel* level = get_price_level(side, price);
     if (!level) {
-        // Create new price level if it doesn't exist
-        // TODO: Consider extracting this into a helper function to reduce duplication
-        if (side == Side::Buy) {
-            auto [it, inserted] = bid_levels_.emplace(price, PriceLevel{});
-            level = &it->second;
-            level->price = price;
-        } else {
-            auto [it, inserted] = ask_levels_.emplace(price, PriceLevel{});
-            level = &it->second;
-            level->price = price;
-        }
+        level = side == Side::Buy ? &bid_levels_.emplace(price) : &ask_levels_.emplace(price);
     }
     
     // Add to price level's linked list (maintains FIFO order)
     add_order_to_level(order, *level);
+    record_level_update(side, *level);
     // Track order for O(1) lookup by ID
     orders_[id] = order;
+    link_participant(order);
     
+    // Schedule expiry on the timing wheel (O(1), no allocation)
+    if (tif != TimeInForce::GTC) {
+        expiry_wheel_.schedule(order, to_expiry_tick(expire_time));
+    }
+    
+    return true;
+}
+
+bool OrderBook::restore_order(const Order& order) {
+    if (order.is_filled()) {
+        return false;
+    }
+    const std::uint32_t next = next_arrival_;
+    next_arrival_ = order.arrival;
+    const bool added = add_order(order.id, order.side, order.type, order.price, order.remaining(),
+                                 order.time_in_force, order.expire_time, order.participant);
+    next_arrival_ = next;
+    if (!added) {
+        return false;
+    }
+    // Same remaining quantity, so the level totals and hashes already match
+    Order* restored = orders_.find(order.id)->second;
+    restored->quantity = order.quantity;
+    restored->filled_quantity = order.filled_quantity;
+    restored->status = order.status;
     return true;
 }
 
@@ -79,7 +110,8 @@ bool OrderBook::cancel_order(OrderId id) {
         return false;
     }
     
-    remove_order_from_level(order);
+    UpdateBatch batch(*this);
+    detach_order(order);
     orders_.erase(it);
     allocator_.deallocate(order);
     
@@ -104,9 +136,13 @@ bool OrderBook::modify_order(OrderId id, Price new_price, Quantity new_quantity)
     if (new_quantity < order->filled_quantity) {
         return false;
     }
+    UpdateBatch batch(*this);
     
     Side side = order->side;
     OrderType type = order->type;
+    TimeInForce tif = order->time_in_force;
+    Timestamp expire_time = order->expire_time;
+    ParticipantId participant = order->participant;
     Quantity filled = order->filled_quantity;
     
     // If price hasn't changed and new quantity >= old quantity, just update quantity
@@ -115,25 +151,29 @@ bool OrderBook::modify_order(OrderId id, Price new_price, Quantity new_quantity)
         order->quantity = new_quantity;
         PriceLevel* level = get_price_level(side, new_price);
         if (level) {
+            state_hash_ -= level->hash;
             level->update_quantity(order, old_remaining);
+            state_hash_ += level->hash;
+            record_level_update(side, *level);
         }
         return true;
     }
     
     // Remove old order
-    remove_order_from_level(order);
+    detach_order(order);
     orders_.erase(it);
     allocator_.deallocate(order);
     
     // Add new order with remaining quantity
     Quantity remaining = new_quantity - filled;
     if (remaining > 0) {
-        if (!add_order(id, side, type, new_price, remaining)) {
+        if (!add_order(id, side, type, new_price, remaining, tif, expire_time, participant)) {
             return false;
         }
-        // Restore filled quantity
+        // Restore filled quantity; remaining() is unchanged so the level stays consistent
         auto new_it = orders_.find(id);
         if (new_it != orders_.end()) {
+            new_it->second->quantity = new_quantity;
             new_it->second->filled_quantity = filled;
         }
         return true;
@@ -143,19 +183,21 @@ bool OrderBook::modify_order(OrderId id, Price new_price, Quantity new_quantity)
 }
 
 std::optional<Price> OrderBook::best_bid() const noexcept {
-    // Best bid is highest buy price (begin() of descending map)
-    if (bid_levels_.empty()) {
+    // Best bid is highest buy price
+    const PriceLevel* best = bid_levels_.best();
+    if (!best) {
         return std::nullopt;
     }
-    return bid_levels_.begin()->first;
+    return best->price;
 }
 
 std::optional<Price> OrderBook::best_ask() const noexcept {
-    // Best ask is lowest sell price (begin() of ascending map)
-    if (ask_levels_.empty()) {
+    // Best ask is lowest sell price
+    const PriceLevel* best = ask_levels_.best();
+    if (!best) {
         return std::nullopt;
     }
-    return ask_levels_.begin()->first;
+    return best->price;
 }
 
 std::optional<Price> OrderBook::spread() const noexcept {
@@ -167,6 +209,14 @@ std::optional<Price> OrderBook::spread() const noexcept {
     });
 }
 
+std::optional<std::pair<Price, Quantity>> OrderBook::top_level(Side side) const noexcept {
+    const PriceLevel* best = side == Side::Buy ? bid_levels_.best() : ask_levels_.best();
+    if (!best) {
+        return std::nullopt;
+    }
+    return std::make_pair(best->price, best->total_quantity);
+}
+
 Quantity OrderBook::depth_at_price(Side side, Price price) const noexcept {
     const PriceLevel* level = get_price_level(side, price);
     if (!level) {
@@ -184,21 +234,69 @@ std::vector<std::pair<Price, Quantity>> OrderBook::get_levels(Side side, std::si
         // Bids: iterate from highest to lowest price
         return bid_levels_
             | r::views::take(n)
-            | r::views::transform([](const auto& pair) {
-                return std::make_pair(pair.first, pair.second.total_quantity);
+            | r::views::transform([](const PriceLevel& level) {
+                return std::make_pair(level.price, level.total_quantity);
             })
             | r::to<std::vector>();
     } else {
         // Asks: iterate from lowest to highest price
         return ask_levels_
             | r::views::take(n)
-            | r::views::transform([](const auto& pair) {
-                return std::make_pair(pair.first, pair.second.total_quantity);
+            | r::views::transform([](const PriceLevel& level) {
+                return std::make_pair(level.price, level.total_quantity);
             })
             | r::to<std::vector>();
     }
 }
 
+// take(price, level_quantity) returns how much of the level to consume;
+// taking less than the whole level ends the sweep
+template<typename Levels, typename Take>
+SweepCost OrderBook::sweep(const Levels& levels, Take&& take) noexcept {
+    SweepCost cost;
+    for (const PriceLevel& level : levels) {
+        const Price price = level.price;
+        const Quantity taken = take(price, level.total_quantity);
+        if (taken == 0) {
+            cost.complete = true;
+            break;
+        }
+        cost.quantity += taken;
+        cost.notional += price * static_cast<Notional>(taken);
+        cost.last_price = price;
+        ++cost.levels;
+        if (taken < level.total_quantity) {
+            cost.complete = true;
+            break;
+        }
+    }
+    return cost;
+}
+
+SweepCost OrderBook::sweep_cost(Side side, Quantity quantity) const noexcept {
+    Quantity left = quantity;
+    auto take = [&left](Price, Quantity available) noexcept {
+        const Quantity taken = std::min(left, available);
+        left -= taken;
+        return taken;
+    };
+    SweepCost cost = side == Side::Buy ? sweep(ask_levels_, take) : sweep(bid_levels_, take);
+    cost.complete = left == 0;
+    return cost;
+}
+
+SweepCost OrderBook::sweep_cost_notional(Side side, Notional budget) const noexcept {
+    Notional left = budget;
+    auto take = [&left](Price price, Quantity available) noexcept {
+        // Non-positive prices cost nothing to take
+        const Quantity affordable = price > 0 ? static_cast<Quantity>(left / price) : available;
+        const Quantity taken = std::min(affordable, available);
+        left -= price * static_cast<Notional>(taken);
+        return taken;
+    };
+    return side == Side::Buy ? sweep(ask_levels_, take) : sweep(bid_levels_, take);
+}
+
 const Order* OrderBook::get_order(OrderId id) const noexcept {
     auto it = orders_.find(id);
     if (it == orders_.end()) {
@@ -207,13 +305,71 @@ const Order* OrderBook::get_order(OrderId id) const noexcept {
     return it->second;
 }
 
+std::optional<QueuePosition> OrderBook::queue_position(OrderId id) const noexcept {
+    const Order* order = get_order(id);
+    if (!order) {
+        return std::nullopt;
+    }
+    const PriceLevel* level = get_price_level(order->side, order->price);
+    if (!level) {
+        return std::nullopt;
+    }
+    return QueuePosition{level->quantity_ahead(order), level->total_quantity};
+}
+
 void OrderBook::clear() {
     for (auto& [id, order] : orders_) {
         allocator_.deallocate(order);
     }
     orders_.clear();
+    participants_.clear();
     bid_levels_.clear();
     ask_levels_.clear();
+    expiry_wheel_.clear();
+    pending_updates_.clear();
+    auction_curves_.deactivate();
+    state_hash_ = 0;
+    next_arrival_ = 0;
+    ++version_;
+}
+
+bool OrderBook::set_expiry_origin(Timestamp origin) noexcept {
+    if (!orders_.empty()) {
+        return false;
+    }
+    expiry_origin_ = origin;
+    expiry_wheel_ = TimingWheel<Order>{};
+    return true;
+}
+
+std::size_t OrderBook::expire_orders(Timestamp now, std::size_t max_batch) {
+    const std::uint64_t now_tick = to_expiry_tick(now);
+    UpdateBatch batch(*this);
+    
+    // Orders share a tick with up to EXPIRY_TICK of spread; any not yet due
+    // are pushed to the next tick so nothing expires before its expire_time
+    std::size_t expired = 0;
+    auto on_expire = [&](Order* order) {
+        if (order->expire_time > now) {
+            expiry_wheel_.schedule(order, now_tick + 1);
+            return;
+        }
+        detach_order(order);
+        orders_.erase(order->id);
+        allocator_.deallocate(order);
+        ++expired;
+    };
+    while (expired < max_batch) {
+        if (expiry_wheel_.advance(now_tick, max_batch - expired, on_expire) == 0) {
+            break;
+        }
+    }
+    return expired;
+}
+
+std::uint64_t OrderBook::level_hash(Side side, Price price) const noexcept {
+    const PriceLevel* level = get_price_level(side, price);
+    return level ? level->hash : 0;
 }
 
 Order* OrderBook::get_first_order_at_price(Side side, Price price) noexcept {
@@ -229,9 +385,13 @@ void OrderBook::remove_order_from_level(Order* order) {
         return;
     }
     
+    UpdateBatch batch(*this);
     PriceLevel* level = get_price_level(order->side, order->price);
     if (level) {
+        state_hash_ -= level->hash;
         level->remove_order(order);
+        state_hash_ += level->hash;
+        record_level_update(order->side, *level);
         
         // Remove empty price level
         if (level->empty()) {
@@ -249,7 +409,8 @@ void OrderBook::remove_filled_order(Order* order) {
         return;
     }
     
-    remove_order_from_level(order);
+    UpdateBatch batch(*this);
+    detach_order(order);
     auto it = orders_.find(order->id);
     if (it != orders_.end()) {
         orders_.erase(it);
@@ -264,35 +425,155 @@ void OrderBook::update_price_level_quantity_incremental(Order* order, Quantity o
     
     PriceLevel* level = get_price_level(order->side, order->price);
     if (level) {
+        UpdateBatch batch(*this);
+        state_hash_ -= level->hash;
         level->update_quantity(order, old_remaining);
+        state_hash_ += level->hash;
+        record_level_update(order->side, *level);
+    }
+}
+
+std::size_t OrderBook::cancel_all(ParticipantId participant) {
+    UpdateBatch batch(*this);
+    return cancel_side(participant, Side::Buy) + cancel_side(participant, Side::Sell);
+}
+
+std::size_t OrderBook::cancel_side(ParticipantId participant, Side side) {
+    return cancel_participant_side(participant, side, [](const Order*) { return true; });
+}
+
+std::size_t OrderBook::cancel_price_range(ParticipantId participant, Side side,
+                                          Price min_price, Price max_price) {
+    return cancel_participant_side(participant, side, [=](const Order* order) {
+        return order->price >= min_price && order->price <= max_price;
+    });
+}
+
+template<typename Predicate>
+std::size_t OrderBook::cancel_participant_side(ParticipantId participant, Side side,
+                                               Predicate&& matches) {
+    auto it = participants_.find(participant);
+    if (it == participants_.end()) {
+        return 0;
+    }
+    
+    // All resulting level changes go out as one batch
+    UpdateBatch batch(*this);
+    std::size_t cancelled = 0;
+    Order* order = it->second.head[static_cast<std::size_t>(side)];
+    while (order) {
+        Order* next = order->participant_next;
+        if (matches(order)) {
+            detach_order(order);
+            orders_.erase(order->id);
+            allocator_.deallocate(order);
+            ++cancelled;
+        }
+        order = next;
+    }
+    return cancelled;
+}
+
+void OrderBook::detach_order(Order* order) {
+    remove_order_from_level(order);
+    expiry_wheel_.cancel(order);
+    unlink_participant(order);
+}
+
+void OrderBook::link_participant(Order* order) {
+    if (order->participant == NO_PARTICIPANT) {
+        return;
+    }
+    // Push front: O(1), order within a participant's list is irrelevant to mass cancel
+    Order*& head = participants_[order->participant].head[static_cast<std::size_t>(order->side)];
+    order->participant_prev = nullptr;
+    order->participant_next = head;
+    if (head) {
+        head->participant_prev = order;
+    }
+    head = order;
+}
+
+void OrderBook::unlink_participant(Order* order) {
+    if (order->participant == NO_PARTICIPANT) {
+        return;
+    }
+    if (order->participant_prev) {
+        order->participant_prev->participant_next = order->participant_next;
+    } else {
+        auto it = participants_.find(order->participant);
+        if (it != participants_.end()) {
+            it->second.head[static_cast<std::size_t>(order->side)] = order->participant_next;
+        }
     }
+    if (order->participant_next) {
+        order->participant_next->participant_prev = order->participant_prev;
+    }
+    order->participant_next = nullptr;
+    order->participant_prev = nullptr;
+}
+
+void OrderBook::record_level_update(Side side, PriceLevel& level) {
+    ++version_;
+    if (auction_curves_.active()) [[unlikely]] {
+        auction_curves_.set(side, level.price, level.total_quantity);
+    }
+    if (!level_update_callback_ && !observer_callback_) {
+        return;
+    }
+    // Coalesce repeated changes to the same level within one batch
+    if (level.update_epoch == update_epoch_) {
+        pending_updates_[level.update_index].quantity = level.total_quantity;
+        return;
+    }
+    level.update_epoch = update_epoch_;
+    level.update_index = static_cast<std::uint32_t>(pending_updates_.size());
+    pending_updates_.push_back({side, level.price, level.total_quantity});
+}
+
+void OrderBook::flush_level_updates() {
+    if (pending_updates_.empty()) {
+        return;
+    }
+    ++update_epoch_;
+    const std::span<const LevelUpdate> updates(pending_updates_);
+    if (level_update_callback_) {
+        level_update_callback_(updates);
+    }
+    if (observer_callback_) {
+        observer_callback_(updates);
+    }
+    pending_updates_.clear();
+}
+
+void OrderBook::PriceLevel::compact_queue() {
+    const std::size_t capacity = std::bit_ceil(std::max<std::size_t>(8, 2 * order_count));
+    Order* current = first_order;
+    std::uint32_t slot = 0;
+    queue.build(capacity, order_count, [&current, &slot] {
+        current->queue_slot = slot++;
+        const Quantity remaining = current->remaining();
+        current = current->next;
+        return remaining;
+    });
+    next_slot = slot;
 }
 
 void OrderBook::add_order_to_level(Order* order, PriceLevel& level) {
+    order->arrival = next_arrival_++;
+    state_hash_ -= level.hash;
     level.add_order(order);
+    state_hash_ += level.hash;
 }
 
 OrderBook::PriceLevel* OrderBook::get_price_level(Side side, Price price) {
-    // O(log n) lookup in price level map
-    // TODO: Consider templating this to reduce duplication between const/non-const versions
-    if (side == Side::Buy) {
-        auto it = bid_levels_.find(price);
-        return (it != bid_levels_.end()) ? &it->second : nullptr;
-    } else {
-        auto it = ask_levels_.find(price);
-        return (it != ask_levels_.end()) ? &it->second : nullptr;
-    }
+    // O(1) near the touch, O(log n) among the cold levels
+    return side == Side::Buy ? bid_levels_.find(price) : ask_levels_.find(price);
 }
 
 const OrderBook::PriceLevel* OrderBook::get_price_level(Side side, Price price) const {
     // Const version for read-only access
-    if (side == Side::Buy) {
-        auto it = bid_levels_.find(price);
-        return (it != bid_levels_.end()) ? &it->second : nullptr;
-    } else {
-        auto it = ask_levels_.find(price);
-        return (it != ask_levels_.end()) ? &it->second : nullptr;
-    }
+    return side == Side::Buy ? bid_levels_.find(price) : ask_levels_.find(price);
 }
 
 Timestamp OrderBook::get_timestamp() const noexcept {
@@ -301,4 +582,11 @@ Timestamp OrderBook::get_timestamp() const noexcept {
     );
 }
 
+std::uint64_t OrderBook::to_expiry_tick(Timestamp time) const noexcept {
+    if (time <= expiry_origin_) {
+        return 0;
+    }
+    return static_cast<std::uint64_t>((time - expiry_origin_) / EXPIRY_TICK);
+}
+
 } // namespace lob
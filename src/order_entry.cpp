@@ -0,0 +1,119 @@
+#include "order_entry.hpp"
+#include "wire_protocol.hpp"
+
+namespace lob {
+
+OrderEntrySessions::OrderEntrySessions(MatchingEngine& engine, std::size_t max_sessions)
+    : engine_(engine)
+    , slots_(max_sessions, engine.reserve_participants(max_sessions))
+{
+    engine_.add_observer(this);
+}
+
+OrderEntrySessions::~OrderEntrySessions() {
+    engine_.remove_observer(this);
+}
+
+std::optional<std::size_t> OrderEntrySessions::open() {
+    return slots_.open();
+}
+
+void OrderEntrySessions::close(std::size_t slot) {
+    // Closed before the cancel, so no reports are queued for it
+    if (!slots_.close(slot)) {
+        return;
+    }
+    std::erase_if(holds_, [slot](const Hold& hold) { return hold.slot == slot; });
+    execute(slot, OrderCommand{.type = CommandType::MassCancel});
+}
+
+OrderEntrySessions::ProcessResult OrderEntrySessions::process(std::size_t slot,
+                                                              std::span<const std::byte> input) {
+    ProcessResult result;
+    OrderCommand command;
+    while (true) {
+        const wire::DecodeResult decoded = wire::decode_command(input.subspan(result.consumed), command);
+        if (decoded.status == wire::DecodeStatus::NeedMore) {
+            break;
+        }
+        if (decoded.status == wire::DecodeStatus::Invalid ||
+            decoded.seq != slots_.state(slot).inbound_seq + 1) {
+            result.error = true;
+            break;
+        }
+        slots_.state(slot).inbound_seq = decoded.seq;
+        result.consumed += decoded.consumed;
+        ++result.commands;
+        if (command.type == CommandType::New && command.time_in_force == TimeInForce::GTT) {
+            command.expire_time = steady_from_wall(command.expire_time).count();
+        }
+        execute(slot, command);
+    }
+    return result;
+}
+
+void OrderEntrySessions::execute(std::size_t slot, const OrderCommand& command) {
+    const ParticipantId participant = slots_.participant(slot);
+    ++command_seq_;
+    if (command_callback_) {
+        command_callback_(command_seq_, participant, command);
+    }
+    const ExecutionReport report = execute_command(engine_, command, participant);
+    if (slots_.is_open(slot)) {
+        append_report(slot, report);
+    }
+}
+
+void OrderEntrySessions::set_output_hold(bool hold) {
+    if (!hold) {
+        release(UINT64_MAX);
+    }
+    hold_output_ = hold;
+}
+
+void OrderEntrySessions::release(std::uint64_t sequence) {
+    while (!holds_.empty() && holds_.front().sequence <= sequence) {
+        const Hold& hold = holds_.front();
+        slots_.release(hold.slot, hold.end);
+        holds_.pop_front();
+    }
+}
+
+void OrderEntrySessions::append_report(std::size_t slot, const ExecutionReport& report) {
+    std::vector<std::byte>& output = slots_.output(slot);
+    const std::size_t offset = output.size();
+    output.resize(offset + wire::EXEC_REPORT_FRAME);
+    wire::encode_report(output.data() + offset, report, ++slots_.state(slot).outbound_seq);
+    if (!hold_output_) {
+        slots_.release(slot);
+    } else if (!holds_.empty() && holds_.back().sequence == command_seq_ && holds_.back().slot == slot) {
+        holds_.back().end = output.size();
+    } else {
+        holds_.push_back(Hold{command_seq_, static_cast<std::uint32_t>(slot), output.size()});
+    }
+}
+
+void OrderEntrySessions::on_trade(const Trade& trade) {
+    route_fill(trade.buy_participant, trade.buy_order_id, trade);
+    route_fill(trade.sell_participant, trade.sell_order_id, trade);
+}
+
+void OrderEntrySessions::route_fill(ParticipantId participant, OrderId id, const Trade& trade) {
+    const std::optional<std::size_t> slot = slots_.slot_of(participant);
+    if (!slot) {
+        return;
+    }
+    // Filled quantities are already applied when trades are reported
+    const Order* order = engine_.get_order_book().get_order(id);
+    const Quantity leaves = order ? order->remaining() : 0;
+    append_report(*slot, ExecutionReport{
+        .id = id,
+        .price = trade.price,
+        .quantity = trade.quantity,
+        .leaves = leaves,
+        .type = ReportType::Fill,
+        .status = leaves ? OrderStatus::PartiallyFilled : OrderStatus::Filled
+    });
+}
+
+} // namespace lob
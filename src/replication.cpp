@@ -0,0 +1,238 @@
+#include "replication.hpp"
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <utility>
+
+namespace lob {
+
+namespace {
+
+constexpr std::size_t BACKUP_BUFFER = 4096 * sizeof(JournalRecord);
+
+bool make_address(const std::string& path, sockaddr_un& addr) noexcept {
+    addr = {};
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+} // namespace
+
+std::unique_ptr<ReplicationPrimary> ReplicationPrimary::create(const std::string& socket_path) {
+    sockaddr_un addr;
+    if (!make_address(socket_path, addr)) {
+        return nullptr;
+    }
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return nullptr;
+    }
+    ::unlink(socket_path.c_str());
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(fd, 1) != 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    // Private constructor, so no make_unique
+    return std::unique_ptr<ReplicationPrimary>(new ReplicationPrimary(fd, socket_path));
+}
+
+ReplicationPrimary::ReplicationPrimary(int listen_fd, std::string socket_path)
+    : listen_fd_(listen_fd)
+    , socket_path_(std::move(socket_path))
+{
+}
+
+ReplicationPrimary::~ReplicationPrimary() {
+    drop_backup();
+    ::close(listen_fd_);
+    ::unlink(socket_path_.c_str());
+}
+
+bool ReplicationPrimary::accept_backup(std::chrono::milliseconds timeout) {
+    if (backup_seen_) {
+        return connected();  // A lost backup is not replaced
+    }
+    pollfd descriptor{.fd = listen_fd_, .events = POLLIN, .revents = 0};
+    if (::poll(&descriptor, 1, static_cast<int>(timeout.count())) <= 0) {
+        return false;
+    }
+    const int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    backup_fd_ = fd;
+    backup_seen_ = true;
+    return true;
+}
+
+void ReplicationPrimary::replicate(std::uint64_t sequence, ParticipantId participant,
+                                   const OrderCommand& command, Timestamp time) {
+    if (backup_fd_ < 0) {
+        return;
+    }
+    const JournalRecord record{
+        .sequence = sequence,
+        .timestamp = time.count(),
+        .participant = participant,
+        .command = command
+    };
+    const std::size_t offset = output_.size();
+    output_.resize(offset + sizeof(record));
+    std::memcpy(output_.data() + offset, &record, sizeof(record));
+    replicated_ = sequence;
+}
+
+bool ReplicationPrimary::flush() {
+    while (backup_fd_ >= 0 && output_offset_ < output_.size()) {
+        const ssize_t sent = ::send(backup_fd_, output_.data() + output_offset_,
+                                    output_.size() - output_offset_, MSG_NOSIGNAL);
+        if (sent > 0) {
+            output_offset_ += static_cast<std::size_t>(sent);
+        } else if (sent < 0 && errno == EINTR) {
+            continue;
+        } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;
+        } else {
+            drop_backup();
+        }
+    }
+    output_.clear();  // Keeps capacity for the next batch
+    output_offset_ = 0;
+    return backup_fd_ >= 0;
+}
+
+std::uint64_t ReplicationPrimary::poll_acks() {
+    while (backup_fd_ >= 0) {
+        std::byte buffer[64 * sizeof(std::uint64_t)];
+        const ssize_t received = ::recv(backup_fd_, buffer, sizeof(buffer), 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (received <= 0) {
+            drop_backup();
+            break;
+        }
+        // Acks are cumulative, so only the last complete one matters
+        for (ssize_t i = 0; i < received; ++i) {
+            ack_[ack_bytes_++] = buffer[i];
+            if (ack_bytes_ == sizeof(ack_)) {
+                std::memcpy(&acked_, ack_, sizeof(acked_));
+                ack_bytes_ = 0;
+            }
+        }
+    }
+    return acked_;
+}
+
+void ReplicationPrimary::drop_backup() noexcept {
+    if (backup_fd_ >= 0) {
+        ::close(backup_fd_);
+        backup_fd_ = -1;
+    }
+    output_.clear();
+    output_offset_ = 0;
+}
+
+std::unique_ptr<ReplicationBackup> ReplicationBackup::connect(MatchingEngine& engine,
+                                                              const std::string& socket_path) {
+    sockaddr_un addr;
+    if (!make_address(socket_path, addr)) {
+        return nullptr;
+    }
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return nullptr;
+    }
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    // Private constructor, so no make_unique
+    return std::unique_ptr<ReplicationBackup>(new ReplicationBackup(engine, fd));
+}
+
+ReplicationBackup::ReplicationBackup(MatchingEngine& engine, int fd)
+    : engine_(engine)
+    , fd_(fd)
+    , input_(BACKUP_BUFFER)
+{
+}
+
+ReplicationBackup::~ReplicationBackup() {
+    disconnect();
+}
+
+std::size_t ReplicationBackup::poll(std::chrono::milliseconds timeout) {
+    pollfd descriptor{.fd = fd_, .events = POLLIN, .revents = 0};
+    if (fd_ < 0 || ::poll(&descriptor, 1, static_cast<int>(timeout.count())) <= 0) {
+        return 0;
+    }
+
+    std::size_t applied = 0;
+    std::uint64_t sequence = applied_.load(std::memory_order_relaxed);
+    while (fd_ >= 0) {
+        const ssize_t received = ::recv(fd_, input_.data() + received_, input_.size() - received_,
+                                        MSG_DONTWAIT);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (received <= 0) {
+            disconnect();
+            break;
+        }
+        received_ += static_cast<std::size_t>(received);
+
+        const std::size_t complete = received_ - received_ % sizeof(JournalRecord);
+        for (std::size_t offset = 0; offset < complete; offset += sizeof(JournalRecord)) {
+            JournalRecord record;
+            std::memcpy(&record, input_.data() + offset, sizeof(record));
+            if (record.sequence != sequence + 1) {
+                disconnect();  // Not the primary's book any more
+                break;
+            }
+            engine_.pin_clock(Timestamp{record.timestamp});
+            (void)execute_command(engine_, record.command, record.participant);
+            sequence = record.sequence;
+            ++applied;
+        }
+        received_ -= complete;
+        std::memmove(input_.data(), input_.data() + complete, received_);
+        applied_.store(sequence, std::memory_order_release);  // Before a disconnect shows
+    }
+
+    if (applied > 0) {
+        // One cumulative ack per batch; the primary drains them on every poll, so this
+        // blocks only if it has stopped, and the ack must not be split
+        while (fd_ >= 0 && ::send(fd_, &sequence, sizeof(sequence), MSG_NOSIGNAL) < 0) {
+            if (errno != EINTR) {
+                disconnect();
+            }
+        }
+    }
+    return applied;
+}
+
+void ReplicationBackup::disconnect() noexcept {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+        engine_.unpin_clock();  // Back on its own clock for promotion
+    }
+    lost_.store(true, std::memory_order_release);
+}
+
+} // namespace lob
@@ -0,0 +1,379 @@
+#include "retransmission.hpp"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <utility>
+
+namespace lob {
+
+namespace {
+
+constexpr std::size_t HEADER = sizeof(mdp::PacketHeader);
+constexpr int RECEIVE_BUFFER = 4 * 1024 * 1024;  // Room for a whole MAX_REQUEST answer
+
+// Slot words: [0] stamp, [1] length in bytes, then the payload
+constexpr std::size_t PAYLOAD = 2;
+
+std::uint64_t load_word(std::uint64_t& word, std::memory_order order) noexcept {
+    return std::atomic_ref<std::uint64_t>(word).load(order);
+}
+
+void store_word(std::uint64_t& word, std::uint64_t value, std::memory_order order) noexcept {
+    std::atomic_ref<std::uint64_t>(word).store(value, order);
+}
+
+// Publish length bytes of data as packet sequence in slot (seqlock write)
+void write_slot(std::uint64_t* slot, std::uint64_t sequence, const std::byte* data, std::size_t length) noexcept {
+    store_word(slot[0], 2 * sequence - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    store_word(slot[1], length, std::memory_order_relaxed);
+    const std::size_t full = length / sizeof(std::uint64_t);
+    for (std::size_t i = 0; i < full; ++i) {
+        std::uint64_t word;
+        std::memcpy(&word, data + i * sizeof(word), sizeof(word));
+        store_word(slot[PAYLOAD + i], word, std::memory_order_relaxed);
+    }
+    if (const std::size_t tail = length % sizeof(std::uint64_t)) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, data + full * sizeof(word), tail);
+        store_word(slot[PAYLOAD + full], word, std::memory_order_relaxed);
+    }
+    store_word(slot[0], 2 * sequence, std::memory_order_release);
+}
+
+// Copy packet sequence out of slot; 0 if the slot holds another packet or was
+// rewritten during the copy
+std::size_t read_slot(std::uint64_t* slot, std::uint64_t sequence, std::span<std::byte> out) noexcept {
+    const std::uint64_t stamp = load_word(slot[0], std::memory_order_acquire);
+    if (stamp != 2 * sequence) {
+        return 0;
+    }
+    const auto length = static_cast<std::size_t>(load_word(slot[1], std::memory_order_relaxed));
+    if (length > out.size()) {
+        return 0;  // Torn length; the stamp check below would fail anyway
+    }
+    const std::size_t full = length / sizeof(std::uint64_t);
+    for (std::size_t i = 0; i < full; ++i) {
+        const std::uint64_t word = load_word(slot[PAYLOAD + i], std::memory_order_relaxed);
+        std::memcpy(out.data() + i * sizeof(word), &word, sizeof(word));
+    }
+    if (const std::size_t tail = length % sizeof(std::uint64_t)) {
+        const std::uint64_t word = load_word(slot[PAYLOAD + full], std::memory_order_relaxed);
+        std::memcpy(out.data() + full * sizeof(word), &word, tail);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return load_word(slot[0], std::memory_order_relaxed) == stamp ? length : 0;
+}
+
+bool make_address(const std::string& address, std::uint16_t port, sockaddr_in& addr) noexcept {
+    addr = sockaddr_in{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    return ::inet_pton(AF_INET, address.c_str(), &addr.sin_addr) == 1;
+}
+
+} // namespace
+
+std::unique_ptr<PacketHistory> PacketHistory::create(const Options& options) {
+    if (options.memory_packets == 0 || options.max_packet == 0) {
+        return nullptr;
+    }
+    std::uint64_t* spill = nullptr;
+    std::size_t spill_bytes = 0;
+    if (!options.spill_path.empty() && options.spill_packets > 0) {
+        const std::size_t slot_bytes = PacketHistory::slot_words(options.max_packet) * sizeof(std::uint64_t);
+        spill_bytes = options.spill_packets * slot_bytes;
+        const int fd = ::open(options.spill_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return nullptr;
+        }
+        void* memory = MAP_FAILED;
+        if (::ftruncate(fd, static_cast<off_t>(spill_bytes)) == 0) {
+            memory = ::mmap(nullptr, spill_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        ::close(fd);
+        if (memory == MAP_FAILED) {
+            return nullptr;
+        }
+        spill = static_cast<std::uint64_t*>(memory);
+    }
+    // Private constructor, so no make_unique
+    return std::unique_ptr<PacketHistory>(new PacketHistory(options, spill, spill_bytes));
+}
+
+PacketHistory::PacketHistory(const Options& options, std::uint64_t* spill, std::size_t spill_bytes)
+    : max_packet_(options.max_packet)
+    , slot_words_(slot_words(options.max_packet))
+    , memory_packets_(options.memory_packets)
+    , spill_packets_(spill ? options.spill_packets : 0)
+    , memory_(std::make_unique<std::uint64_t[]>(memory_packets_ * slot_words_))
+    , spill_(spill)
+    , spill_bytes_(spill_bytes)
+{
+}
+
+PacketHistory::~PacketHistory() {
+    if (spill_) {
+        ::munmap(spill_, spill_bytes_);
+    }
+}
+
+std::size_t PacketHistory::slot_words(std::size_t max_packet) noexcept {
+    const std::size_t words = PAYLOAD + (max_packet + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+    return (words + 7) / 8 * 8;
+}
+
+std::uint64_t* PacketHistory::memory_slot(std::uint64_t sequence) const noexcept {
+    return memory_.get() + (sequence % memory_packets_) * slot_words_;
+}
+
+std::uint64_t* PacketHistory::spill_slot(std::uint64_t sequence) const noexcept {
+    return spill_ + (sequence % spill_packets_) * slot_words_;
+}
+
+bool PacketHistory::append(std::uint64_t sequence, std::span<const std::byte> packet) noexcept {
+    const std::uint64_t newest = newest_.load(std::memory_order_relaxed);
+    if (packet.size() > max_packet_ || sequence == 0 || (newest != 0 && sequence != newest + 1)) {
+        return false;
+    }
+    std::uint64_t* slot = memory_slot(sequence);
+    // Only this thread writes, so the slot can be read plainly before it is reused
+    const std::uint64_t evicted = slot[0] / 2;
+    if (evicted != 0 && spill_) {
+        write_slot(spill_slot(evicted), evicted, reinterpret_cast<const std::byte*>(slot + PAYLOAD),
+                   static_cast<std::size_t>(slot[1]));
+    }
+    write_slot(slot, sequence, packet.data(), packet.size());
+    newest_.store(sequence, std::memory_order_release);
+    return true;
+}
+
+std::size_t PacketHistory::read(std::uint64_t sequence, std::span<std::byte> out) const noexcept {
+    if (sequence == 0) {
+        return 0;
+    }
+    const std::size_t length = read_slot(memory_slot(sequence), sequence, out);
+    // A miss may have been spilled meanwhile; the spill is written before the reuse
+    if (length != 0 || !spill_) {
+        return length;
+    }
+    return read_slot(spill_slot(sequence), sequence, out);
+}
+
+std::uint64_t PacketHistory::oldest() const noexcept {
+    const std::uint64_t newest = newest_.load(std::memory_order_acquire);
+    const std::uint64_t capacity = memory_packets_ + spill_packets_;
+    return newest > capacity ? newest - capacity + 1 : std::min<std::uint64_t>(newest, 1);
+}
+
+std::unique_ptr<RetransmissionServer> RetransmissionServer::create(const PacketHistory& history,
+                                                                   std::uint16_t port,
+                                                                   const std::string& address) {
+    sockaddr_in addr{};
+    if (!make_address(address, port, addr)) {
+        return nullptr;
+    }
+    const int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return nullptr;
+    }
+    socklen_t length = sizeof(addr);
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &length) != 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    // Private constructor, so no make_unique
+    return std::unique_ptr<RetransmissionServer>(new RetransmissionServer(history, fd, ntohs(addr.sin_port)));
+}
+
+RetransmissionServer::RetransmissionServer(const PacketHistory& history, int fd, std::uint16_t port)
+    : history_(history)
+    , fd_(fd)
+    , port_(port)
+    , buffers_(BATCH * history.max_packet())
+{
+}
+
+RetransmissionServer::~RetransmissionServer() {
+    ::close(fd_);
+}
+
+std::size_t RetransmissionServer::poll(std::chrono::milliseconds timeout) {
+    pollfd fd{fd_, POLLIN, 0};
+    if (::poll(&fd, 1, static_cast<int>(timeout.count())) <= 0) {
+        return 0;
+    }
+    std::size_t packets = 0;
+    for (;;) {
+        mdp::RetransmitRequest request;
+        sockaddr_in peer{};
+        socklen_t peer_length = sizeof(peer);
+        const ssize_t received = ::recvfrom(fd_, &request, sizeof(request), MSG_DONTWAIT,
+                                            reinterpret_cast<sockaddr*>(&peer), &peer_length);
+        if (received < 0) {
+            break;
+        }
+        if (received == sizeof(request)) {
+            packets += serve(request, &peer, peer_length);
+        }
+    }
+    return packets;
+}
+
+std::size_t RetransmissionServer::serve(const mdp::RetransmitRequest& request, const void* peer,
+                                        unsigned peer_length) {
+    const std::size_t slot_size = history_.max_packet();
+    const std::uint64_t end = request.first + std::min(request.count, MAX_REQUEST);
+    std::uint64_t sequence = std::max<std::uint64_t>(request.first, 1);
+    std::size_t sent = 0;
+
+    iovec vectors[BATCH];
+    mmsghdr messages[BATCH];
+    bool held = true;
+    while (held && sequence < end) {
+        unsigned batch = 0;
+        for (; batch < BATCH && sequence < end; ++batch, ++sequence) {
+            std::byte* buffer = buffers_.data() + batch * slot_size;
+            const std::size_t length = history_.read(sequence, std::span(buffer, slot_size));
+            if (length == 0) {
+                held = false;  // Too old, or not published yet
+                break;
+            }
+            vectors[batch] = {buffer, length};
+            messages[batch] = mmsghdr{};
+            messages[batch].msg_hdr.msg_name = const_cast<void*>(peer);
+            messages[batch].msg_hdr.msg_namelen = peer_length;
+            messages[batch].msg_hdr.msg_iov = &vectors[batch];
+            messages[batch].msg_hdr.msg_iovlen = 1;
+        }
+        for (unsigned done = 0; done < batch;) {
+            const int result = ::sendmmsg(fd_, messages + done, batch - done, 0);
+            if (result <= 0) {
+                break;  // The client asks again for whatever it is still missing
+            }
+            done += static_cast<unsigned>(result);
+            sent += static_cast<std::size_t>(result);
+        }
+    }
+
+    const mdp::PacketHeader marker{
+        .sequence = sequence,
+        .incremental_seq = history_.newest(),
+        .length = static_cast<std::uint16_t>(HEADER),
+        .count = 0,
+        .channel = mdp::Channel::RetransmitEnd,
+        .flags = 0,
+        .reserved = {}
+    };
+    ::sendto(fd_, &marker, sizeof(marker), 0, static_cast<const sockaddr*>(peer), peer_length);
+    return sent;
+}
+
+std::optional<RetransmissionClient> RetransmissionClient::connect(const std::string& address,
+                                                                  std::uint16_t port,
+                                                                  std::size_t max_packet) {
+    sockaddr_in addr{};
+    if (!make_address(address, port, addr)) {
+        return std::nullopt;
+    }
+    const int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &RECEIVE_BUFFER, sizeof(RECEIVE_BUFFER));
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return std::nullopt;
+    }
+    return RetransmissionClient(fd, max_packet);
+}
+
+RetransmissionClient::RetransmissionClient(int fd, std::size_t max_packet)
+    : fd_(fd)
+    , max_packet_(max_packet)
+    , buffer_(RetransmissionServer::BATCH * max_packet)
+{
+}
+
+RetransmissionClient::~RetransmissionClient() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+RetransmissionClient::RetransmissionClient(RetransmissionClient&& other) noexcept
+    : fd_(std::exchange(other.fd_, -1))
+    , max_packet_(other.max_packet_)
+    , buffer_(std::move(other.buffer_))
+{
+}
+
+RetransmissionClient& RetransmissionClient::operator=(RetransmissionClient&& other) noexcept {
+    if (this != &other) {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+        fd_ = std::exchange(other.fd_, -1);
+        max_packet_ = other.max_packet_;
+        buffer_ = std::move(other.buffer_);
+    }
+    return *this;
+}
+
+std::size_t RetransmissionClient::fetch(std::uint64_t first, std::uint32_t count,
+                                        const PacketCallback& on_packet,
+                                        std::chrono::milliseconds timeout) {
+    // Leftovers of an earlier, timed-out fetch
+    while (::recv(fd_, buffer_.data(), max_packet_, MSG_DONTWAIT) >= 0) {
+    }
+
+    const mdp::RetransmitRequest request{.first = first, .count = count, .reserved = 0};
+    if (::send(fd_, &request, sizeof(request), 0) != static_cast<ssize_t>(sizeof(request))) {
+        return 0;
+    }
+    iovec vectors[RetransmissionServer::BATCH];
+    mmsghdr messages[RetransmissionServer::BATCH];
+    for (std::size_t i = 0; i < RetransmissionServer::BATCH; ++i) {
+        vectors[i] = {buffer_.data() + i * max_packet_, max_packet_};
+        messages[i] = mmsghdr{};
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    std::size_t received = 0;
+    for (;;) {
+        pollfd fd{fd_, POLLIN, 0};
+        if (::poll(&fd, 1, static_cast<int>(timeout.count())) <= 0) {
+            return received;
+        }
+        // Everything queued in one call
+        const int batch = ::recvmmsg(fd_, messages, RetransmissionServer::BATCH, MSG_DONTWAIT, nullptr);
+        if (batch < 0) {
+            return received;
+        }
+        for (int i = 0; i < batch; ++i) {
+            const std::size_t length = messages[i].msg_len;
+            if (length < HEADER) {
+                continue;
+            }
+            mdp::PacketHeader header;
+            std::memcpy(&header, vectors[i].iov_base, HEADER);
+            if (header.channel == mdp::Channel::RetransmitEnd) {
+                return received;
+            }
+            if (header.sequence >= first && header.sequence - first < count && length == header.length) {
+                on_packet(std::span<const std::byte>(static_cast<const std::byte*>(vectors[i].iov_base), length));
+                ++received;
+            }
+        }
+    }
+}
+
+} // namespace lob
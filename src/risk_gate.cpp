@@ -0,0 +1,82 @@
+#include "risk_gate.hpp"
+#include <limits>
+
+namespace lob {
+
+RiskGate::RiskGate(std::size_t max_symbols, std::size_t max_accounts)
+    : symbols_(max_symbols)
+    , accounts_(max_accounts)
+{
+}
+
+void RiskGate::set_symbol_limits(SymbolId symbol, const SymbolRiskLimits& limits) {
+    if (symbol >= symbols_.size()) {
+        return;
+    }
+    SymbolState& sym = symbols_[symbol];
+    sym.limits = limits;
+    if (sym.has_reference) {
+        set_reference_price(symbol, sym.reference);
+    }
+}
+
+void RiskGate::set_credit_limit(ParticipantId account, Notional limit) {
+    if (account == NO_PARTICIPANT || account >= accounts_.size()) {
+        return;
+    }
+    accounts_[account].credit_limit = limit;
+    accounts_[account].enabled = true;
+}
+
+void RiskGate::set_reference_price(SymbolId symbol, Price reference) noexcept {
+    if (symbol >= symbols_.size()) {
+        return;
+    }
+    SymbolState& sym = symbols_[symbol];
+    // Saturate so a wide (or default) collar cannot overflow the band
+    constexpr Price lowest = std::numeric_limits<Price>::min();
+    constexpr Price highest = std::numeric_limits<Price>::max();
+    const Price width = sym.limits.collar_ticks;
+    sym.reference = reference;
+    sym.band_low = reference < lowest + width ? lowest : reference - width;
+    sym.band_high = reference > highest - width ? highest : reference + width;
+    sym.has_reference = true;
+}
+
+void RiskGate::on_order_resting(OrderId id, ParticipantId account, Side side, Price price, Quantity remaining) {
+    on_order_closed(id);
+    if (account >= accounts_.size() || remaining == 0) {
+        return;
+    }
+    reservations_.emplace(id, Reservation{.account = account, .side = side, .price = price, .remaining = remaining});
+    AccountState& acct = accounts_[account];
+    accumulate(side == Side::Buy ? acct.open_buy : acct.open_sell, value(price, remaining));
+}
+
+void RiskGate::on_order_closed(OrderId id) noexcept {
+    release(id, std::numeric_limits<Quantity>::max());
+}
+
+void RiskGate::release(OrderId id, Quantity quantity) noexcept {
+    const auto it = reservations_.find(id);
+    if (it == reservations_.end()) {
+        return;
+    }
+    Reservation& reservation = it->second;
+    const Quantity released = quantity < reservation.remaining ? quantity : reservation.remaining;
+    AccountState& acct = accounts_[reservation.account];
+    accumulate(reservation.side == Side::Buy ? acct.open_buy : acct.open_sell, -value(reservation.price, released));
+    reservation.remaining -= released;
+    if (reservation.remaining == 0) {
+        reservations_.erase(it);
+    }
+}
+
+std::optional<std::pair<Price, Price>> RiskGate::collar(SymbolId symbol) const noexcept {
+    if (symbol >= symbols_.size() || !symbols_[symbol].has_reference) {
+        return std::nullopt;
+    }
+    return std::make_pair(symbols_[symbol].band_low, symbols_[symbol].band_high);
+}
+
+} // namespace lob
@@ -0,0 +1,315 @@
+#include "shm_gateway.hpp"
+#include "seqlock.hpp"
+#include <climits>
+#include <ctime>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <utility>
+
+namespace lob {
+
+namespace {
+
+// Response slots a client must have free before another of its commands is taken
+constexpr std::size_t RESPONSE_HEADROOM = 64;
+
+std::string shm_path(const std::string& name) {
+    return name.starts_with('/') ? name : "/" + name;
+}
+
+std::size_t region_size(std::size_t max_clients) {
+    return sizeof(ShmGatewayHeader) + max_clients * sizeof(ShmClientChannel);
+}
+
+ShmClientChannel* channels(ShmGatewayHeader* header) noexcept {
+    return reinterpret_cast<ShmClientChannel*>(reinterpret_cast<char*>(header) + sizeof(ShmGatewayHeader));
+}
+
+} // namespace
+
+void FutexEvent::notify() noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting.load(std::memory_order_relaxed)) {
+        epoch.fetch_add(1, std::memory_order_release);
+        ::syscall(SYS_futex, &epoch, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    }
+}
+
+void FutexEvent::sleep(std::uint32_t key, std::chrono::nanoseconds timeout) noexcept {
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+    timespec relative{.tv_sec = static_cast<time_t>(seconds.count()),
+                      .tv_nsec = static_cast<long>((timeout - seconds).count())};
+    // Returns at once if epoch moved since key was read (the wakeup was not lost)
+    ::syscall(SYS_futex, &epoch, FUTEX_WAIT, key, &relative, nullptr, 0);
+}
+
+std::unique_ptr<ShmGatewayServer> ShmGatewayServer::create(const std::string& name,
+                                                           MatchingEngine& engine,
+                                                           std::size_t max_clients) {
+    if (max_clients == 0 || max_clients > UINT32_MAX) {
+        return nullptr;
+    }
+    const std::string path = shm_path(name);
+    const int fd = ::shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        return nullptr;
+    }
+    const std::size_t size = region_size(max_clients);
+    void* memory = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<off_t>(size)) == 0) {
+        memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        ::shm_unlink(path.c_str());
+        return nullptr;
+    }
+
+    auto* header = new (memory) ShmGatewayHeader;
+    header->max_clients = static_cast<std::uint32_t>(max_clients);
+    header->first_participant = engine.reserve_participants(max_clients);
+    for (std::size_t slot = 0; slot < max_clients; ++slot) {
+        new (channels(header) + slot) ShmClientChannel;
+    }
+    header->magic.store(ShmGatewayHeader::MAGIC, std::memory_order_release);
+    // Private constructor, so no make_unique
+    return std::unique_ptr<ShmGatewayServer>(
+        new ShmGatewayServer(header, size, path, engine, header->first_participant));
+}
+
+ShmGatewayServer::ShmGatewayServer(ShmGatewayHeader* header, std::size_t mapped_size,
+                                   std::string shm_name, MatchingEngine& engine,
+                                   ParticipantId first_participant)
+    : header_(header)
+    , mapped_size_(mapped_size)
+    , shm_name_(std::move(shm_name))
+    , engine_(engine)
+    , first_participant_(first_participant)
+{
+    engine_.add_observer(this);
+}
+
+ShmGatewayServer::~ShmGatewayServer() {
+    engine_.remove_observer(this);
+    ::munmap(header_, mapped_size_);
+    ::shm_unlink(shm_name_.c_str());
+}
+
+ShmClientChannel& ShmGatewayServer::channel(std::size_t slot) const noexcept {
+    return channels(header_)[slot];
+}
+
+std::size_t ShmGatewayServer::poll(std::size_t max_per_client) {
+    std::size_t processed = 0;
+    for (std::size_t slot = 0; slot < header_->max_clients; ++slot) {
+        ShmClientChannel& client = channel(slot);
+        const std::uint32_t state = client.state.load(std::memory_order_acquire);
+        if (state == ShmClientChannel::Closing) {
+            release_slot(slot);
+            continue;
+        }
+        if (state != ShmClientChannel::Connected) {
+            continue;
+        }
+
+        const ParticipantId participant = first_participant_ + static_cast<ParticipantId>(slot);
+        OrderCommand command;
+        for (std::size_t n = 0; n < max_per_client; ++n) {
+            if (client.responses.free_slots() < RESPONSE_HEADROOM || !client.requests.try_pop(command)) {
+                break;
+            }
+            push_report(client, execute_command(engine_, command, participant));
+            ++processed;
+        }
+    }
+    return processed;
+}
+
+std::size_t ShmGatewayServer::wait_and_poll(WaitMode mode, std::chrono::nanoseconds timeout,
+                                            std::size_t max_per_client) {
+    if (const std::size_t processed = poll(max_per_client)) {
+        return processed;
+    }
+    if (mode == WaitMode::Futex) {
+        header_->request_event.wait([this] { return requests_pending(); }, timeout);
+    } else {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!requests_pending() && std::chrono::steady_clock::now() < deadline) {
+            cpu_relax();
+        }
+    }
+    return poll(max_per_client);
+}
+
+bool ShmGatewayServer::requests_pending() const noexcept {
+    for (std::size_t slot = 0; slot < header_->max_clients; ++slot) {
+        const ShmClientChannel& client = channel(slot);
+        const std::uint32_t state = client.state.load(std::memory_order_acquire);
+        if (state == ShmClientChannel::Closing ||
+            (state == ShmClientChannel::Connected && !client.requests.empty())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::size_t ShmGatewayServer::connected_clients() const noexcept {
+    std::size_t count = 0;
+    for (std::size_t slot = 0; slot < header_->max_clients; ++slot) {
+        count += channel(slot).state.load(std::memory_order_acquire) == ShmClientChannel::Connected;
+    }
+    return count;
+}
+
+void ShmGatewayServer::on_trade(const Trade& trade) {
+    route_fill(trade.buy_participant, trade.buy_order_id, trade);
+    route_fill(trade.sell_participant, trade.sell_order_id, trade);
+}
+
+void ShmGatewayServer::route_fill(ParticipantId participant, OrderId id, const Trade& trade) {
+    if (participant < first_participant_ || participant - first_participant_ >= header_->max_clients) {
+        return;  // Not one of this gateway's clients
+    }
+    ShmClientChannel& client = channel(participant - first_participant_);
+    if (client.state.load(std::memory_order_acquire) != ShmClientChannel::Connected) {
+        return;
+    }
+    // Filled quantities are already applied when trades are reported
+    const Order* order = engine_.get_order_book().get_order(id);
+    const Quantity leaves = order ? order->remaining() : 0;
+    push_report(client, ExecutionReport{
+        .id = id,
+        .price = trade.price,
+        .quantity = trade.quantity,
+        .leaves = leaves,
+        .type = ReportType::Fill,
+        .status = leaves ? OrderStatus::PartiallyFilled : OrderStatus::Filled
+    });
+}
+
+void ShmGatewayServer::push_report(ShmClientChannel& client, const ExecutionReport& report) {
+    if (!client.responses.try_push(report)) {
+        client.overflowed.store(1, std::memory_order_release);
+        return;
+    }
+    client.response_event.notify();
+}
+
+void ShmGatewayServer::release_slot(std::size_t slot) {
+    // Cancel-on-disconnect; the client no longer touches either ring
+    ShmClientChannel& client = channel(slot);
+    (void)engine_.mass_cancel(first_participant_ + static_cast<ParticipantId>(slot));
+    client.requests.reset();
+    client.responses.reset();
+    client.overflowed.store(0, std::memory_order_relaxed);
+    client.state.store(ShmClientChannel::Free, std::memory_order_release);
+}
+
+std::optional<ShmGatewayClient> ShmGatewayClient::connect(const std::string& name) {
+    const int fd = ::shm_open(shm_path(name).c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    struct stat info{};
+    void* memory = MAP_FAILED;
+    const auto size = ::fstat(fd, &info) == 0 ? static_cast<std::size_t>(info.st_size) : 0;
+    if (size >= sizeof(ShmGatewayHeader)) {
+        memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        return std::nullopt;
+    }
+
+    auto* header = static_cast<ShmGatewayHeader*>(memory);
+    if (header->magic.load(std::memory_order_acquire) != ShmGatewayHeader::MAGIC ||
+        header->channel_size != sizeof(ShmClientChannel) ||
+        size < region_size(header->max_clients)) {
+        ::munmap(memory, size);
+        return std::nullopt;
+    }
+    for (std::size_t slot = 0; slot < header->max_clients; ++slot) {
+        ShmClientChannel& client = channels(header)[slot];
+        std::uint32_t expected = ShmClientChannel::Free;
+        if (client.state.compare_exchange_strong(expected, ShmClientChannel::Connected,
+                                                 std::memory_order_acq_rel)) {
+            return ShmGatewayClient(header, size, &client,
+                                    header->first_participant + static_cast<ParticipantId>(slot));
+        }
+    }
+    ::munmap(memory, size);
+    return std::nullopt;
+}
+
+ShmGatewayClient::~ShmGatewayClient() {
+    disconnect();
+}
+
+ShmGatewayClient::ShmGatewayClient(ShmGatewayClient&& other) noexcept
+    : header_(std::exchange(other.header_, nullptr))
+    , mapped_size_(other.mapped_size_)
+    , channel_(std::exchange(other.channel_, nullptr))
+    , participant_(other.participant_)
+{
+}
+
+ShmGatewayClient& ShmGatewayClient::operator=(ShmGatewayClient&& other) noexcept {
+    if (this != &other) {
+        disconnect();
+        header_ = std::exchange(other.header_, nullptr);
+        mapped_size_ = other.mapped_size_;
+        channel_ = std::exchange(other.channel_, nullptr);
+        participant_ = other.participant_;
+    }
+    return *this;
+}
+
+void ShmGatewayClient::disconnect() noexcept {
+    if (!header_) {
+        return;
+    }
+    channel_->state.store(ShmClientChannel::Closing, std::memory_order_release);
+    header_->request_event.notify();
+    ::munmap(header_, mapped_size_);
+    header_ = nullptr;
+    channel_ = nullptr;
+}
+
+bool ShmGatewayClient::send(const OrderCommand& command) noexcept {
+    if (!channel_->requests.try_push(command)) {
+        return false;
+    }
+    header_->request_event.notify();
+    return true;
+}
+
+bool ShmGatewayClient::try_receive(ExecutionReport& report) noexcept {
+    return channel_->responses.try_pop(report);
+}
+
+bool ShmGatewayClient::receive(ExecutionReport& report, WaitMode mode,
+                               std::chrono::nanoseconds timeout) {
+    if (try_receive(report)) {
+        return true;
+    }
+    if (mode == WaitMode::Futex) {
+        // The ring is only popped here, so a ready ring stays ready
+        channel_->response_event.wait([this] { return !channel_->responses.empty(); }, timeout);
+        return try_receive(report);
+    }
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!try_receive(report)) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        cpu_relax();
+    }
+    return true;
+}
+
+} // namespace lob
@@ -0,0 +1,412 @@
+#include "tcp_gateway.hpp"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <utility>
+
+namespace lob {
+
+namespace {
+
+constexpr std::uint64_t LISTEN_TOKEN = UINT64_MAX;
+constexpr std::uint64_t REPLICATION_TOKEN = UINT64_MAX - 1;
+constexpr int MAX_EVENTS = 64;
+
+void set_no_delay(int fd) noexcept {
+    const int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+} // namespace
+
+std::unique_ptr<TcpGateway> TcpGateway::create(MatchingEngine& engine, std::uint16_t port,
+                                               std::size_t max_sessions,
+                                               const std::string& address) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (max_sessions == 0 || ::inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
+        return nullptr;
+    }
+
+    const int listen_fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        return nullptr;
+    }
+    const int one = 1;
+    ::setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    socklen_t length = sizeof(addr);
+    if (::bind(listen_fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listen_fd, SOMAXCONN) != 0 ||
+        ::getsockname(listen_fd, reinterpret_cast<sockaddr*>(&addr), &length) != 0) {
+        ::close(listen_fd);
+        return nullptr;
+    }
+
+    const int epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLET;
+    event.data.u64 = LISTEN_TOKEN;
+    if (epoll_fd < 0 || ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event) != 0) {
+        if (epoll_fd >= 0) {
+            ::close(epoll_fd);
+        }
+        ::close(listen_fd);
+        return nullptr;
+    }
+    // Private constructor, so no make_unique
+    return std::unique_ptr<TcpGateway>(
+        new TcpGateway(engine, max_sessions, listen_fd, epoll_fd, ntohs(addr.sin_port)));
+}
+
+TcpGateway::TcpGateway(MatchingEngine& engine, std::size_t max_sessions, int listen_fd,
+                       int epoll_fd, std::uint16_t port)
+    : engine_(engine)
+    , sessions_(engine, max_sessions)
+    , connections_(max_sessions)
+    , listen_fd_(listen_fd)
+    , epoll_fd_(epoll_fd)
+    , port_(port)
+{
+    backlog_.reserve(max_sessions);
+}
+
+TcpGateway::~TcpGateway() {
+    for (std::size_t slot = 0; slot < connections_.size(); ++slot) {
+        close_connection(slot);
+    }
+    ::close(epoll_fd_);
+    ::close(listen_fd_);
+}
+
+std::size_t TcpGateway::poll(std::chrono::milliseconds timeout) {
+    epoll_event events[MAX_EVENTS];
+    // Sessions held back by backpressure are retried without sleeping
+    const int wait_ms = backlog_.empty() ? static_cast<int>(timeout.count()) : 0;
+    const int count = ::epoll_wait(epoll_fd_, events, MAX_EVENTS, wait_ms);
+
+    for (int i = 0; i < count; ++i) {
+        if (events[i].data.u64 == LISTEN_TOKEN) {
+            accept_connections();
+            continue;
+        }
+        if (events[i].data.u64 == REPLICATION_TOKEN) {
+            continue;  // Acks and send space are picked up below
+        }
+        const auto slot = static_cast<std::size_t>(events[i].data.u64);
+        Connection& connection = connections_[slot];
+        if (connection.fd < 0) {
+            continue;
+        }
+        if (events[i].events & EPOLLOUT) {
+            connection.writable = true;
+            flush_connection(slot);
+        }
+        // Hang-ups and errors surface as a failed recv
+        if ((events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) &&
+            connection.fd >= 0 && !connection.readable) {
+            connection.readable = true;
+            backlog_.push_back(static_cast<std::uint32_t>(slot));
+        }
+    }
+
+    std::size_t commands = 0;
+    std::size_t kept = 0;
+    for (std::uint32_t slot : backlog_) {
+        commands += read_connection(slot);
+        if (connections_[slot].fd >= 0 && connections_[slot].readable) {
+            backlog_[kept++] = slot;
+        }
+    }
+    backlog_.resize(kept);
+
+    if (replication_) {
+        poll_replication();
+    }
+    sessions_.drain_dirty([this](std::size_t slot) {
+        flush_connection(slot);
+    });
+    return commands;
+}
+
+bool TcpGateway::set_replication(ReplicationPrimary* primary) {
+    // The backup applies records from sequence 1 to an empty book
+    if (primary && (!primary->connected() || sessions_.command_sequence() != 0)) {
+        return false;
+    }
+    if (replication_ && replication_->connected()) {
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, replication_->fd(), nullptr);
+    }
+    replication_ = primary;
+    if (!primary) {
+        sessions_.set_command_callback(nullptr);
+        sessions_.set_output_hold(false);
+        engine_.unpin_clock();
+        return true;
+    }
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    event.data.u64 = REPLICATION_TOKEN;
+    if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, primary->fd(), &event) != 0) {
+        replication_ = nullptr;
+        return false;
+    }
+    sessions_.set_command_callback([this, primary](std::uint64_t sequence, ParticipantId participant,
+                                                   const OrderCommand& command) {
+        // Both engines run the command at the same time, so expiries match
+        const Timestamp now = steady_time();
+        engine_.pin_clock(now);
+        primary->replicate(sequence, participant, command, now);
+    });
+    sessions_.set_output_hold(true);
+    return true;
+}
+
+void TcpGateway::poll_replication() {
+    // Records go out in the same turn as the commands; reports follow the acks
+    if (replication_->flush()) {
+        sessions_.release(replication_->poll_acks());
+    }
+    if (!replication_->connected()) {
+        sessions_.set_output_hold(false);  // Backup lost: carry on standalone
+    }
+}
+
+void TcpGateway::accept_connections() {
+    while (true) {
+        const int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;  // EAGAIN: queue drained
+        }
+        const std::optional<std::size_t> slot = sessions_.open();
+        if (!slot) {
+            ::close(fd);  // At capacity
+            continue;
+        }
+        set_no_delay(fd);
+        Connection& connection = connections_[*slot];
+        connection.fd = fd;
+        connection.received = 0;
+        connection.writable = true;
+        connection.input.resize(RECEIVE_BUFFER);
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        event.data.u64 = *slot;
+        if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+            close_connection(*slot);
+            continue;
+        }
+        // Bytes may have arrived before registration
+        connection.readable = true;
+        backlog_.push_back(static_cast<std::uint32_t>(*slot));
+    }
+}
+
+std::size_t TcpGateway::read_connection(std::size_t slot) {
+    Connection& connection = connections_[slot];
+    std::size_t commands = 0;
+    while (connection.readable && sessions_.buffered_output(slot) < OUTPUT_HIGH_WATER) {
+        const ssize_t received = ::recv(connection.fd, connection.input.data() + connection.received,
+                                        RECEIVE_BUFFER - connection.received, 0);
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                connection.readable = false;
+                break;
+            }
+            close_connection(slot);
+            break;
+        }
+        if (received == 0) {
+            close_connection(slot);
+            break;
+        }
+
+        connection.received += static_cast<std::size_t>(received);
+        const auto result = sessions_.process(
+            slot, std::span<const std::byte>(connection.input.data(), connection.received));
+        commands += result.commands;
+        if (result.error) {
+            flush_connection(slot);  // Best effort: acks for the frames before the bad one
+            close_connection(slot);
+            break;
+        }
+        // Keep the partial frame at the front; it is shorter than one frame
+        connection.received -= result.consumed;
+        if (connection.received > 0 && result.consumed > 0) {
+            std::memmove(connection.input.data(), connection.input.data() + result.consumed,
+                         connection.received);
+        }
+    }
+    return commands;
+}
+
+void TcpGateway::flush_connection(std::size_t slot) {
+    Connection& connection = connections_[slot];
+    while (connection.fd >= 0 && connection.writable) {
+        const std::span<const std::byte> output = sessions_.pending_output(slot);
+        if (output.empty()) {
+            return;
+        }
+        const ssize_t sent = ::send(connection.fd, output.data(), output.size(), MSG_NOSIGNAL);
+        if (sent > 0) {
+            sessions_.consume_output(slot, static_cast<std::size_t>(sent));
+        } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            connection.writable = false;  // Resumed by the next EPOLLOUT edge
+        } else if (sent < 0 && errno == EINTR) {
+            continue;
+        } else {
+            close_connection(slot);
+        }
+    }
+}
+
+void TcpGateway::close_connection(std::size_t slot) {
+    Connection& connection = connections_[slot];
+    if (connection.fd < 0) {
+        return;
+    }
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, connection.fd, nullptr);
+    ::close(connection.fd);
+    connection.fd = -1;
+    connection.readable = false;
+    sessions_.close(slot);
+}
+
+std::optional<TcpOrderClient> TcpOrderClient::connect(const std::string& address, std::uint16_t port) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (::inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
+        return std::nullopt;
+    }
+    const int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return std::nullopt;
+    }
+    set_no_delay(fd);
+    return TcpOrderClient(fd);
+}
+
+TcpOrderClient::TcpOrderClient(int fd)
+    : fd_(fd)
+    , input_(TcpGateway::RECEIVE_BUFFER)
+{
+}
+
+TcpOrderClient::~TcpOrderClient() {
+    disconnect();
+}
+
+TcpOrderClient::TcpOrderClient(TcpOrderClient&& other) noexcept
+    : fd_(std::exchange(other.fd_, -1))
+    , next_seq_(other.next_seq_)
+    , inbound_seq_(other.inbound_seq_)
+    , output_(std::move(other.output_))
+    , input_(std::move(other.input_))
+    , input_begin_(other.input_begin_)
+    , input_end_(other.input_end_)
+{
+}
+
+TcpOrderClient& TcpOrderClient::operator=(TcpOrderClient&& other) noexcept {
+    if (this != &other) {
+        disconnect();
+        fd_ = std::exchange(other.fd_, -1);
+        next_seq_ = other.next_seq_;
+        inbound_seq_ = other.inbound_seq_;
+        output_ = std::move(other.output_);
+        input_ = std::move(other.input_);
+        input_begin_ = other.input_begin_;
+        input_end_ = other.input_end_;
+    }
+    return *this;
+}
+
+void TcpOrderClient::disconnect() noexcept {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+std::uint32_t TcpOrderClient::send(const OrderCommand& command) {
+    const std::size_t offset = output_.size();
+    output_.resize(offset + wire::MAX_FRAME);
+    const std::uint32_t seq = next_seq_++;
+    output_.resize(offset + wire::encode_command(output_.data() + offset, command, seq));
+    return seq;
+}
+
+bool TcpOrderClient::flush() {
+    std::size_t written = 0;
+    while (fd_ >= 0 && written < output_.size()) {
+        const ssize_t sent = ::send(fd_, output_.data() + written, output_.size() - written, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            disconnect();
+            break;
+        }
+        written += static_cast<std::size_t>(sent);
+    }
+    output_.clear();
+    return fd_ >= 0;
+}
+
+bool TcpOrderClient::receive(ExecutionReport& report, std::chrono::milliseconds timeout) {
+    while (fd_ >= 0) {
+        const auto decoded = wire::decode_report(
+            std::span<const std::byte>(input_.data() + input_begin_, input_end_ - input_begin_), report);
+        if (decoded.status == wire::DecodeStatus::Ok) {
+            input_begin_ += decoded.consumed;
+            if (decoded.seq != ++inbound_seq_) {
+                disconnect();
+                return false;
+            }
+            return true;
+        }
+        if (decoded.status == wire::DecodeStatus::Invalid) {
+            disconnect();
+            return false;
+        }
+
+        // Compact the partial frame to the front and read another batch
+        std::memmove(input_.data(), input_.data() + input_begin_, input_end_ - input_begin_);
+        input_end_ -= input_begin_;
+        input_begin_ = 0;
+        pollfd descriptor{.fd = fd_, .events = POLLIN, .revents = 0};
+        if (::poll(&descriptor, 1, static_cast<int>(timeout.count())) <= 0) {
+            return false;
+        }
+        const ssize_t received = ::recv(fd_, input_.data() + input_end_, input_.size() - input_end_, 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            disconnect();
+            return false;
+        }
+        input_end_ += static_cast<std::size_t>(received);
+    }
+    return false;
+}
+
+} // namespace lob
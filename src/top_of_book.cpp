@@ -0,0 +1,136 @@
+#include "top_of_book.hpp"
+#include "order_book.hpp"
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace lob {
+
+namespace {
+
+std::string shm_path(const std::string& name) {
+    return name.starts_with('/') ? name : "/" + name;
+}
+
+} // namespace
+
+TopOfBookPublisher::TopOfBookPublisher()
+    : TopOfBookPublisher(new TopOfBookRegion, {})
+{
+}
+
+TopOfBookPublisher::TopOfBookPublisher(TopOfBookRegion* region, std::string shm_name)
+    : region_(region)
+    , shm_name_(std::move(shm_name))
+{
+    region_->slot.store(current_);
+    region_->magic.store(TopOfBookRegion::MAGIC, std::memory_order_release);
+}
+
+std::unique_ptr<TopOfBookPublisher> TopOfBookPublisher::create_shared(const std::string& name) {
+    const std::string path = shm_path(name);
+    const int fd = ::shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        return nullptr;
+    }
+    void* memory = MAP_FAILED;
+    if (::ftruncate(fd, sizeof(TopOfBookRegion)) == 0) {
+        memory = ::mmap(nullptr, sizeof(TopOfBookRegion), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        ::shm_unlink(path.c_str());
+        return nullptr;
+    }
+    // Private constructor, so no make_unique
+    return std::unique_ptr<TopOfBookPublisher>(
+        new TopOfBookPublisher(new (memory) TopOfBookRegion, path));
+}
+
+TopOfBookPublisher::~TopOfBookPublisher() {
+    if (shm_name_.empty()) {
+        delete region_;
+        return;
+    }
+    region_->~TopOfBookRegion();
+    ::munmap(region_, sizeof(TopOfBookRegion));
+    ::shm_unlink(shm_name_.c_str());
+}
+
+void TopOfBookPublisher::on_message_processed(const OrderBook& book) {
+    ++sequence_;
+    if (book.version() == published_version_) {
+        return;
+    }
+    published_version_ = book.version();
+
+    current_.sequence = sequence_;
+    current_.book_version = published_version_;
+    current_.bid_depth = 0;
+    book.for_each_level(Side::Buy, TopOfBookSnapshot::DEPTH, [this](Price price, Quantity quantity) {
+        current_.bids[current_.bid_depth++] = {price, quantity};
+    });
+    current_.ask_depth = 0;
+    book.for_each_level(Side::Sell, TopOfBookSnapshot::DEPTH, [this](Price price, Quantity quantity) {
+        current_.asks[current_.ask_depth++] = {price, quantity};
+    });
+    // Clear levels that fell out of view so unused entries stay zero
+    for (std::size_t i = current_.bid_depth; i < TopOfBookSnapshot::DEPTH; ++i) {
+        current_.bids[i] = {};
+    }
+    for (std::size_t i = current_.ask_depth; i < TopOfBookSnapshot::DEPTH; ++i) {
+        current_.asks[i] = {};
+    }
+    region_->slot.store(current_);
+}
+
+std::optional<TopOfBookReader> TopOfBookReader::open(const std::string& name) {
+    const int fd = ::shm_open(shm_path(name).c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    struct stat info{};
+    void* memory = MAP_FAILED;
+    if (::fstat(fd, &info) == 0 && static_cast<std::size_t>(info.st_size) >= sizeof(TopOfBookRegion)) {
+        memory = ::mmap(nullptr, sizeof(TopOfBookRegion), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (memory == MAP_FAILED) {
+        return std::nullopt;
+    }
+
+    const auto* region = static_cast<const TopOfBookRegion*>(memory);
+    if (region->magic.load(std::memory_order_acquire) != TopOfBookRegion::MAGIC ||
+        region->depth != TopOfBookSnapshot::DEPTH ||
+        region->snapshot_size != sizeof(TopOfBookSnapshot)) {
+        ::munmap(memory, sizeof(TopOfBookRegion));
+        return std::nullopt;
+    }
+    return TopOfBookReader(region);
+}
+
+TopOfBookReader::~TopOfBookReader() {
+    if (region_) {
+        ::munmap(const_cast<TopOfBookRegion*>(region_), sizeof(TopOfBookRegion));
+    }
+}
+
+TopOfBookReader::TopOfBookReader(TopOfBookReader&& other) noexcept
+    : region_(std::exchange(other.region_, nullptr))
+{
+}
+
+TopOfBookReader& TopOfBookReader::operator=(TopOfBookReader&& other) noexcept {
+    if (this != &other) {
+        if (region_) {
+            ::munmap(const_cast<TopOfBookRegion*>(region_), sizeof(TopOfBookRegion));
+        }
+        region_ = std::exchange(other.region_, nullptr);
+    }
+    return *this;
+}
+
+} // namespace lob
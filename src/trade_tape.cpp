@@ -0,0 +1,442 @@
+#include "trade_tape.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace lob {
+
+namespace {
+
+using tape::BlockHeader;
+
+constexpr std::uint64_t zigzag(std::int64_t value) noexcept {
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+constexpr std::int64_t unzigzag(std::uint64_t code) noexcept {
+    return static_cast<std::int64_t>((code >> 1) ^ (0 - (code & 1)));
+}
+
+// Columns stored as deltas from the previous trade; the rest as offsets from the minimum
+constexpr bool is_delta_column(std::size_t column) noexcept {
+    return column == tape::TimeColumn || column == tape::PriceColumn ||
+           column == tape::BuyOrderColumn || column == tape::SellOrderColumn;
+}
+
+constexpr std::size_t column_words(std::size_t count, unsigned width) noexcept {
+    return (count * width + 63) / 64;
+}
+
+std::size_t block_bytes(std::size_t count, const std::array<std::uint8_t, tape::COLUMNS>& width) noexcept {
+    std::size_t words = 0;
+    for (std::uint8_t bits : width) {
+        words += column_words(count, bits);
+    }
+    return sizeof(BlockHeader) + 8 * words;
+}
+
+// Write codes of width bits each as consecutive little-endian words at out
+std::byte* pack(std::span<const std::uint64_t> codes, unsigned width, std::byte* out) noexcept {
+    if (width == 0) {
+        return out;
+    }
+    std::uint64_t word = 0;
+    unsigned used = 0;
+    for (std::uint64_t code : codes) {
+        word |= code << used;
+        used += width;
+        if (used >= 64) {
+            std::memcpy(out, &word, 8);
+            out += 8;
+            used -= 64;
+            word = used ? code >> (width - used) : 0;
+        }
+    }
+    if (used) {
+        std::memcpy(out, &word, 8);
+        out += 8;
+    }
+    return out;
+}
+
+// Call f(i, code) for each of count codes of width bits packed at column
+template<typename F>
+void unpack(const std::byte* column, unsigned width, std::size_t count, F&& f) noexcept {
+    if (width == 0) {
+        for (std::size_t i = 0; i < count; ++i) {
+            f(i, std::uint64_t{0});
+        }
+        return;
+    }
+    const std::uint64_t mask = width == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << width) - 1;
+    std::size_t bit = 0;
+    for (std::size_t i = 0; i < count; ++i, bit += width) {
+        const std::size_t word = bit / 64;
+        const unsigned shift = bit % 64;
+        std::uint64_t low;
+        std::memcpy(&low, column + 8 * word, 8);
+        std::uint64_t code = low >> shift;
+        if (shift + width > 64) {
+            std::uint64_t high;
+            std::memcpy(&high, column + 8 * (word + 1), 8);
+            code |= high << (64 - shift);
+        }
+        f(i, code & mask);
+    }
+}
+
+// Start of each column of a block
+std::array<const std::byte*, tape::COLUMNS> column_starts(const BlockHeader& header) noexcept {
+    std::array<const std::byte*, tape::COLUMNS> starts{};
+    const std::byte* at = reinterpret_cast<const std::byte*>(&header) + sizeof(BlockHeader);
+    for (std::size_t column = 0; column < tape::COLUMNS; ++column) {
+        starts[column] = at;
+        at += 8 * column_words(header.count, header.width[column]);
+    }
+    return starts;
+}
+
+// Decode one column of a block into out (header.count values)
+void decode_column(const BlockHeader& header, const std::byte* start, std::size_t column,
+                   std::int64_t* out) noexcept {
+    const std::int64_t base = header.base[column];
+    if (is_delta_column(column)) {
+        std::int64_t value = base;
+        unpack(start, header.width[column], header.count, [&value, out](std::size_t i, std::uint64_t code) {
+            value = static_cast<std::int64_t>(static_cast<std::uint64_t>(value) +
+                                              static_cast<std::uint64_t>(unzigzag(code)));
+            out[i] = value;
+        });
+    } else {
+        unpack(start, header.width[column], header.count, [base, out](std::size_t i, std::uint64_t code) {
+            out[i] = static_cast<std::int64_t>(static_cast<std::uint64_t>(base) + code);
+        });
+    }
+}
+
+} // namespace
+
+std::unique_ptr<TradeTapeWriter> TradeTapeWriter::create(MatchingEngine& engine, const std::string& path,
+                                                         const Options& options) {
+    if (options.block_trades == 0 || options.block_trades > UINT32_MAX) {
+        return nullptr;
+    }
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return nullptr;
+    }
+    // Private constructor, so no make_unique
+    return std::unique_ptr<TradeTapeWriter>(new TradeTapeWriter(engine, fd, options));
+}
+
+TradeTapeWriter::TradeTapeWriter(MatchingEngine& engine, int fd, const Options& options)
+    : engine_(engine)
+    , fd_(fd)
+    , block_trades_(options.block_trades)
+    , write_bytes_(options.write_bytes)
+    , flush_interval_(options.flush_interval)
+    , ring_(std::make_unique<SpscRing<Trade, QUEUE>>())
+    , codes_(options.block_trades)
+{
+    for (auto& column : staged_) {
+        column.resize(block_trades_);
+    }
+    buffer_.reserve(write_bytes_ + block_bytes(block_trades_, {64, 64, 64, 64, 64, 64, 64, 64}));
+    thread_ = std::thread([this] { run(); });
+    engine_.add_observer(this);
+}
+
+TradeTapeWriter::~TradeTapeWriter() {
+    engine_.remove_observer(this);
+    stop_.store(true, std::memory_order_release);
+    thread_.join();
+    ::close(fd_);
+}
+
+void TradeTapeWriter::on_trade(const Trade& trade) {
+    if (!ring_->try_push(trade)) {
+        ++stalls_;
+        while (!ring_->try_push(trade)) {
+            std::this_thread::yield();
+        }
+    }
+    ++pushed_;
+}
+
+void TradeTapeWriter::flush() {
+    flush_target_.store(pushed_, std::memory_order_release);
+    while (durable_.load(std::memory_order_acquire) < pushed_) {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+}
+
+void TradeTapeWriter::run() {
+    auto last_write = std::chrono::steady_clock::now();
+    Trade trade;
+    while (true) {
+        // Read before draining, so everything a flush covers is popped in this pass
+        const bool stopping = stop_.load(std::memory_order_acquire);
+        const std::uint64_t target = flush_target_.load(std::memory_order_acquire);
+        std::size_t popped = 0;
+        while (ring_->try_pop(trade)) {
+            stage(trade);
+            ++popped;
+            if (staged_count_ == block_trades_) {
+                encode_block();
+                if (buffer_.size() >= write_bytes_) {
+                    write_out();
+                    last_write = std::chrono::steady_clock::now();
+                }
+            }
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        const bool pending = staged_count_ > 0 || !buffer_.empty();
+        if (stopping || target > durable_.load(std::memory_order_relaxed) ||
+            (pending && now - last_write >= flush_interval_)) {
+            encode_block();
+            write_out();
+            last_write = now;
+        }
+        if (stopping) {
+            return;
+        }
+        if (popped == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+}
+
+void TradeTapeWriter::stage(const Trade& trade) noexcept {
+    const std::size_t i = staged_count_++;
+    if (i == 0) {
+        // Sampled per block, so the tape follows adjustments of the wall clock
+        clock_offset_ = (std::chrono::duration_cast<Timestamp>(
+            std::chrono::system_clock::now().time_since_epoch()) - steady_time()).count();
+    }
+    staged_[tape::TimeColumn][i] = trade.timestamp.count() + clock_offset_;
+    staged_[tape::PriceColumn][i] = trade.price;
+    staged_[tape::QuantityColumn][i] = static_cast<std::int64_t>(trade.quantity);
+    staged_[tape::BuyOrderColumn][i] = static_cast<std::int64_t>(trade.buy_order_id);
+    staged_[tape::SellOrderColumn][i] = static_cast<std::int64_t>(trade.sell_order_id);
+    staged_[tape::BuyParticipantColumn][i] = trade.buy_participant;
+    staged_[tape::SellParticipantColumn][i] = trade.sell_participant;
+    staged_[tape::AggressorColumn][i] = trade.aggressor ? 1 + static_cast<std::int64_t>(*trade.aggressor) : 0;
+}
+
+void TradeTapeWriter::encode_block() {
+    const std::size_t count = staged_count_;
+    if (count == 0) {
+        return;
+    }
+    BlockHeader header{
+        .magic = tape::BLOCK_MAGIC,
+        .count = static_cast<std::uint32_t>(count),
+        .bytes = 0,
+        .first_timestamp = staged_[tape::TimeColumn][0],
+        .last_timestamp = staged_[tape::TimeColumn][count - 1],
+        .clock_offset = clock_offset_,
+        .base = {},
+        .width = {}
+    };
+
+    // Encode the columns one after another behind room for the header
+    const std::size_t offset = buffer_.size();
+    buffer_.resize(offset + block_bytes(count, {64, 64, 64, 64, 64, 64, 64, 64}));
+    std::byte* out = buffer_.data() + offset + sizeof(BlockHeader);
+    for (std::size_t column = 0; column < tape::COLUMNS; ++column) {
+        const std::int64_t* values = staged_[column].data();
+        std::uint64_t all_bits = 0;
+        if (is_delta_column(column)) {
+            header.base[column] = values[0];
+            codes_[0] = 0;
+            for (std::size_t i = 1; i < count; ++i) {
+                codes_[i] = zigzag(static_cast<std::int64_t>(static_cast<std::uint64_t>(values[i]) -
+                                                             static_cast<std::uint64_t>(values[i - 1])));
+                all_bits |= codes_[i];
+            }
+        } else {
+            const std::int64_t base = *std::min_element(values, values + count);
+            header.base[column] = base;
+            for (std::size_t i = 0; i < count; ++i) {
+                codes_[i] = static_cast<std::uint64_t>(values[i]) - static_cast<std::uint64_t>(base);
+                all_bits |= codes_[i];
+            }
+        }
+        header.width[column] = static_cast<std::uint8_t>(std::bit_width(all_bits));
+        out = pack(std::span<const std::uint64_t>(codes_.data(), count), header.width[column], out);
+    }
+    header.bytes = block_bytes(count, header.width);
+    std::memcpy(buffer_.data() + offset, &header, sizeof(header));
+    buffer_.resize(offset + header.bytes);
+
+    encoded_ += count;
+    staged_count_ = 0;
+}
+
+void TradeTapeWriter::write_out() {
+    std::size_t written = 0;
+    while (written < buffer_.size()) {
+        const ssize_t result = ::write(fd_, buffer_.data() + written, buffer_.size() - written);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            write_errors_.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+        written += static_cast<std::size_t>(result);
+    }
+    bytes_written_.fetch_add(written, std::memory_order_relaxed);
+    buffer_.clear();
+    durable_.store(encoded_, std::memory_order_release);
+}
+
+std::unique_ptr<TradeTapeReader> TradeTapeReader::open(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat info{};
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    const auto size = static_cast<std::size_t>(info.st_size);
+    const std::byte* data = nullptr;
+    if (size > 0) {
+        void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            ::close(fd);
+            return nullptr;
+        }
+        ::madvise(mapped, size, MADV_SEQUENTIAL);
+        data = static_cast<const std::byte*>(mapped);
+    }
+    ::close(fd);
+
+    // Index whole, well-formed blocks; a torn one ends the tape
+    std::vector<const BlockHeader*> blocks;
+    std::size_t offset = 0;
+    while (offset + sizeof(BlockHeader) <= size) {
+        const auto* header = reinterpret_cast<const BlockHeader*>(data + offset);
+        const bool valid = header->magic == tape::BLOCK_MAGIC && header->count > 0 &&
+                           std::ranges::all_of(header->width, [](std::uint8_t bits) { return bits <= 64; }) &&
+                           header->bytes == block_bytes(header->count, header->width) &&
+                           header->bytes <= size - offset;
+        if (!valid) {
+            break;
+        }
+        blocks.push_back(header);
+        offset += header->bytes;
+    }
+    if (size > 0 && blocks.empty()) {
+        ::munmap(const_cast<std::byte*>(data), size);
+        return nullptr;
+    }
+    // Private constructor, so no make_unique
+    return std::unique_ptr<TradeTapeReader>(new TradeTapeReader(data, size, std::move(blocks)));
+}
+
+TradeTapeReader::TradeTapeReader(const std::byte* data, std::size_t size,
+                                 std::vector<const tape::BlockHeader*> blocks)
+    : data_(data)
+    , size_(size)
+    , blocks_(std::move(blocks))
+{
+    for (const BlockHeader* header : blocks_) {
+        trades_ += header->count;
+    }
+}
+
+TradeTapeReader::~TradeTapeReader() {
+    if (data_) {
+        ::munmap(const_cast<std::byte*>(data_), size_);
+    }
+}
+
+void TradeTapeReader::read_block(std::size_t block, std::vector<Trade>& out) const {
+    const BlockHeader& header = *blocks_[block];
+    const auto starts = column_starts(header);
+    std::array<std::vector<std::int64_t>, tape::COLUMNS> columns;
+    for (std::size_t column = 0; column < tape::COLUMNS; ++column) {
+        columns[column].resize(header.count);
+        decode_column(header, starts[column], column, columns[column].data());
+    }
+    for (std::size_t i = 0; i < header.count; ++i) {
+        const std::int64_t aggressor = columns[tape::AggressorColumn][i];
+        out.push_back(Trade{
+            .buy_order_id = static_cast<OrderId>(columns[tape::BuyOrderColumn][i]),
+            .sell_order_id = static_cast<OrderId>(columns[tape::SellOrderColumn][i]),
+            .price = columns[tape::PriceColumn][i],
+            .quantity = static_cast<Quantity>(columns[tape::QuantityColumn][i]),
+            .timestamp = Timestamp{columns[tape::TimeColumn][i]},
+            .buy_participant = static_cast<ParticipantId>(columns[tape::BuyParticipantColumn][i]),
+            .sell_participant = static_cast<ParticipantId>(columns[tape::SellParticipantColumn][i]),
+            .aggressor = aggressor ? std::optional<Side>(static_cast<Side>(aggressor - 1)) : std::nullopt
+        });
+    }
+}
+
+std::vector<TradeBar> TradeTapeReader::bars(Timestamp begin, Timestamp end, Timestamp interval) const {
+    if (interval.count() <= 0 || end <= begin) {
+        return {};
+    }
+    const std::int64_t first = begin.count();
+    const std::int64_t step = interval.count();
+    std::vector<TradeBar> result(static_cast<std::size_t>((end.count() - first + step - 1) / step));
+    for (std::size_t bar = 0; bar < result.size(); ++bar) {
+        result[bar].start = Timestamp{first + static_cast<std::int64_t>(bar) * step};
+    }
+
+    std::vector<std::int64_t> times;
+    std::vector<std::int64_t> prices;
+    std::vector<std::int64_t> quantities;
+    // Trades come in time order, so the current bar's bounds avoid a division per trade
+    std::size_t bar = 0;
+    std::int64_t bar_begin = first;
+    std::int64_t bar_end = first + step;
+    for (const BlockHeader* header : blocks_) {
+        if (header->last_timestamp < first || header->first_timestamp >= end.count()) {
+            continue;
+        }
+        const auto starts = column_starts(*header);
+        times.resize(header->count);
+        prices.resize(header->count);
+        quantities.resize(header->count);
+        decode_column(*header, starts[tape::TimeColumn], tape::TimeColumn, times.data());
+        decode_column(*header, starts[tape::PriceColumn], tape::PriceColumn, prices.data());
+        decode_column(*header, starts[tape::QuantityColumn], tape::QuantityColumn, quantities.data());
+
+        for (std::size_t i = 0; i < header->count; ++i) {
+            const std::int64_t time = times[i];
+            if (time < first || time >= end.count()) {
+                continue;
+            }
+            if (time < bar_begin || time >= bar_end) {
+                bar = static_cast<std::size_t>((time - first) / step);
+                bar_begin = first + static_cast<std::int64_t>(bar) * step;
+                bar_end = bar_begin + step;
+            }
+            TradeBar& out = result[bar];
+            const Price price = prices[i];
+            const auto quantity = static_cast<Quantity>(quantities[i]);
+            if (out.trades == 0) {
+                out.high = price;
+                out.low = price;
+            }
+            ++out.trades;
+            out.volume += quantity;
+            out.notional += price * static_cast<Notional>(quantity);
+            out.high = std::max(out.high, price);
+            out.low = std::min(out.low, price);
+        }
+    }
+    return result;
+}
+
+} // namespace lob
@@ -0,0 +1,473 @@
+#include "uring_gateway.hpp"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace lob {
+
+namespace {
+
+constexpr std::uint16_t BUFFER_GROUP = 0;
+constexpr std::uint16_t SEND_BUFFER_INDEX = 0;
+constexpr std::uint16_t JOURNAL_BUFFER_INDEX = 1;
+constexpr std::uint32_t GENERATION_MASK = 0xffffff;
+
+// user_data: op (8 bits) | generation (24 bits) | slot (32 bits)
+constexpr std::uint64_t make_user_data(std::uint8_t op, std::uint32_t generation, std::size_t slot) noexcept {
+    return (static_cast<std::uint64_t>(op) << 56) |
+           (static_cast<std::uint64_t>(generation & GENERATION_MASK) << 32) |
+           static_cast<std::uint32_t>(slot);
+}
+
+std::byte* map_pages(std::size_t size) noexcept {
+    void* memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return memory == MAP_FAILED ? nullptr : static_cast<std::byte*>(memory);
+}
+
+} // namespace
+
+void UringGateway::PageFree::operator()(std::byte* memory) const noexcept {
+    if (memory) {
+        ::munmap(memory, size);
+    }
+}
+
+std::unique_ptr<UringGateway> UringGateway::create(MatchingEngine& engine, std::uint16_t port,
+                                                   std::size_t max_sessions, const Options& options,
+                                                   const std::string& address) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (max_sessions == 0 || max_sessions > UINT32_MAX ||
+        ::inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
+        return nullptr;
+    }
+    auto ring = IoUring::create(IoUring::Options{.entries = 1024, .sqpoll = options.sqpoll});
+    if (!ring) {
+        return nullptr;
+    }
+
+    const int listen_fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        return nullptr;
+    }
+    const int one = 1;
+    ::setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    socklen_t length = sizeof(addr);
+    if (::bind(listen_fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listen_fd, SOMAXCONN) != 0 ||
+        ::getsockname(listen_fd, reinterpret_cast<sockaddr*>(&addr), &length) != 0) {
+        ::close(listen_fd);
+        return nullptr;
+    }
+
+    int journal_fd = -1;
+    if (!options.journal_path.empty()) {
+        journal_fd = ::open(options.journal_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (journal_fd < 0) {
+            ::close(listen_fd);
+            return nullptr;
+        }
+    }
+
+    // Private constructor, so no make_unique
+    std::unique_ptr<UringGateway> gateway(new UringGateway(engine, max_sessions, std::move(ring),
+                                                           listen_fd, journal_fd, options.journal_format,
+                                                           ntohs(addr.sin_port)));
+    if (!gateway->setup_buffers()) {
+        return nullptr;
+    }
+    gateway->arm_accept();
+    gateway->ring_->submit();
+    return gateway;
+}
+
+UringGateway::UringGateway(MatchingEngine& engine, std::size_t max_sessions,
+                           std::unique_ptr<IoUring> ring, int listen_fd, int journal_fd,
+                           JournalFormat journal_format, std::uint16_t port)
+    : ring_(std::move(ring))
+    , sessions_(engine, max_sessions)
+    , connections_(max_sessions)
+    , listen_fd_(listen_fd)
+    , journal_fd_(journal_fd)
+    , journal_format_(journal_format)
+    , port_(port)
+{
+    if (journal_fd_ >= 0) {
+        sessions_.set_command_callback([this](std::uint64_t sequence, ParticipantId participant,
+                                              const OrderCommand& command) {
+            journal_command(sequence, participant, command);
+        });
+    }
+}
+
+bool UringGateway::setup_buffers() {
+    buffer_count_ = std::bit_ceil(std::clamp<std::size_t>(4 * connections_.size(), 64, 4096));
+    const std::size_t receive_size = buffer_count_ * RECEIVE_BUFFER;
+    const std::size_t send_size = connections_.size() * SEND_BUFFER;
+    receive_memory_ = PageMemory(map_pages(receive_size), PageFree{receive_size});
+    send_memory_ = PageMemory(map_pages(send_size), PageFree{send_size});
+    if (!receive_memory_ || !send_memory_) {
+        return false;
+    }
+
+    std::vector<iovec> fixed{{send_memory_.get(), send_size}};
+    if (journal_fd_ >= 0) {
+        journal_memory_ = PageMemory(map_pages(2 * JOURNAL_BUFFER), PageFree{2 * JOURNAL_BUFFER});
+        if (!journal_memory_) {
+            return false;
+        }
+        fixed.push_back({journal_memory_.get(), 2 * JOURNAL_BUFFER});
+    }
+    if (!ring_->register_buffers(fixed)) {
+        return false;
+    }
+
+    buffer_ring_ = ring_->register_buffer_ring(BUFFER_GROUP, buffer_count_);
+    if (!buffer_ring_) {
+        return false;
+    }
+    for (unsigned bid = 0; bid < buffer_count_; ++bid) {
+        add_ring_buffer(buffer_ring_, buffer_count_ - 1, bid, receive_buffer(static_cast<std::uint16_t>(bid)),
+                        RECEIVE_BUFFER, static_cast<std::uint16_t>(bid));
+    }
+    publish_ring_buffers(buffer_ring_, buffer_count_);
+    return true;
+}
+
+UringGateway::~UringGateway() {
+    for (std::size_t slot = 0; slot < connections_.size(); ++slot) {
+        close_connection(slot);
+    }
+    ::close(listen_fd_);
+
+    if (journal_fd_ >= 0) {
+        // Let journal writes in flight land, then write what is still buffered
+        while (journal_halves_[0].in_flight || journal_halves_[1].in_flight) {
+            ring_->submit(1, std::chrono::milliseconds(100));
+            ring_->drain_completions([this](const io_uring_cqe& cqe) {
+                if (static_cast<Op>(cqe.user_data >> 56) == Op::Journal) {
+                    on_journal(cqe.user_data & 1, cqe.res);
+                }
+            });
+        }
+        JournalHalf& active = journal_halves_[journal_active_];
+        if (active.length) {
+            write_journal_sync(journal_half(journal_active_), active.length, journal_offset_);
+            journal_offset_ += active.length;
+        }
+        ::close(journal_fd_);
+    }
+    // Tear the ring down before the registered memory it points into is unmapped
+    ring_.reset();
+}
+
+io_uring_sqe* UringGateway::next_sqe() {
+    io_uring_sqe* sqe = ring_->get_sqe();
+    while (!sqe) {
+        ring_->submit();  // SQ full: hand the batch to the kernel early
+        sqe = ring_->get_sqe();
+    }
+    return sqe;
+}
+
+void UringGateway::arm_accept() {
+    io_uring_sqe* sqe = next_sqe();
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = listen_fd_;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = make_user_data(static_cast<std::uint8_t>(Op::Accept), 0, 0);
+}
+
+void UringGateway::arm_receive(std::size_t slot) {
+    Connection& connection = connections_[slot];
+    io_uring_sqe* sqe = next_sqe();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = connection.fd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+    sqe->user_data = make_user_data(static_cast<std::uint8_t>(Op::Receive), connection.generation, slot);
+    connection.receiving = true;
+}
+
+void UringGateway::stage_send(std::size_t slot) {
+    Connection& connection = connections_[slot];
+    if (connection.fd < 0 || connection.sending) {
+        return;  // Picked up again when the write in flight completes
+    }
+    const std::span<const std::byte> output = sessions_.pending_output(slot);
+    if (output.empty()) {
+        return;
+    }
+    const std::size_t length = std::min(output.size(), SEND_BUFFER);
+    std::memcpy(send_buffer(slot), output.data(), length);
+    sessions_.consume_output(slot, length);
+    connection.send_offset = 0;
+    connection.send_length = length;
+    submit_send(slot);
+}
+
+void UringGateway::submit_send(std::size_t slot) {
+    Connection& connection = connections_[slot];
+    io_uring_sqe* sqe = next_sqe();
+    sqe->opcode = IORING_OP_WRITE_FIXED;
+    sqe->fd = connection.fd;
+    sqe->addr = reinterpret_cast<std::uint64_t>(send_buffer(slot) + connection.send_offset);
+    sqe->len = static_cast<std::uint32_t>(connection.send_length - connection.send_offset);
+    sqe->off = static_cast<std::uint64_t>(-1);  // Stream: no file position
+    sqe->buf_index = SEND_BUFFER_INDEX;
+    sqe->user_data = make_user_data(static_cast<std::uint8_t>(Op::Send), connection.generation, slot);
+    connection.sending = true;
+}
+
+std::size_t UringGateway::poll(std::chrono::milliseconds timeout) {
+    commands_ = 0;
+    if (!ring_->completions_ready()) {
+        // Waiting for one completion with no timeout would block: a zero timeout only polls
+        if (timeout.count() > 0) {
+            ring_->submit(1, timeout);
+        } else {
+            ring_->submit();
+        }
+    }
+    ring_->drain_completions([this](const io_uring_cqe& cqe) {
+        handle(cqe);
+    });
+    sessions_.drain_dirty([this](std::size_t slot) {
+        stage_send(slot);
+    });
+    flush_journal();
+    ring_->submit();
+    return commands_;
+}
+
+void UringGateway::handle(const io_uring_cqe& cqe) {
+    const auto op = static_cast<Op>(cqe.user_data >> 56);
+    const auto generation = static_cast<std::uint32_t>(cqe.user_data >> 32) & GENERATION_MASK;
+    const auto slot = static_cast<std::size_t>(cqe.user_data & 0xffffffff);
+
+    switch (op) {
+        case Op::Accept:
+            on_accept(cqe.res, cqe.flags & IORING_CQE_F_MORE);
+            return;
+        case Op::Journal:
+            on_journal(slot, cqe.res);
+            return;
+        default:
+            break;
+    }
+
+    Connection& connection = connections_[slot];
+    const bool current = connection.fd >= 0 && (connection.generation & GENERATION_MASK) == generation;
+    if (op == Op::Receive) {
+        if (!current) {
+            if (cqe.flags & IORING_CQE_F_BUFFER) {
+                recycle_buffer(static_cast<std::uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT));
+            }
+            return;
+        }
+        on_receive(slot, cqe.res, cqe.flags);
+    } else if (current) {
+        on_send(slot, cqe.res);
+    }
+}
+
+void UringGateway::on_accept(int result, bool more) {
+    if (result >= 0) {
+        const std::optional<std::size_t> slot = sessions_.open();
+        ++extra_syscalls_;
+        if (!slot) {
+            ::close(result);  // At capacity
+        } else {
+            const int one = 1;
+            ::setsockopt(result, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            Connection& connection = connections_[*slot];
+            connection.fd = result;
+            ++connection.generation;
+            connection.sending = false;
+            connection.partial = 0;
+            arm_receive(*slot);
+        }
+    }
+    if (!more) {
+        arm_accept();  // The multishot accept ended (error or overflow); re-arm it
+    }
+}
+
+void UringGateway::on_receive(std::size_t slot, int result, std::uint32_t flags) {
+    Connection& connection = connections_[slot];
+    if (!(flags & IORING_CQE_F_MORE)) {
+        connection.receiving = false;
+    }
+    if (result > 0) {
+        const auto bid = static_cast<std::uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+        const bool ok = feed(slot, std::span<const std::byte>(receive_buffer(bid), static_cast<std::size_t>(result)));
+        recycle_buffer(bid);
+        if (!ok || sessions_.pending_output(slot).size() > OUTPUT_LIMIT) {
+            close_connection(slot);
+        } else if (!connection.receiving) {
+            arm_receive(slot);
+        }
+        return;
+    }
+    if (result == -ENOBUFS) {
+        arm_receive(slot);  // Every buffer was in use; they are recycled by now
+        return;
+    }
+    close_connection(slot);  // EOF or socket error
+}
+
+bool UringGateway::feed(std::size_t slot, std::span<const std::byte> data) {
+    Connection& connection = connections_[slot];
+    if (connection.partial > 0) {
+        // Complete the split frame in the carry area, then continue in place
+        const std::size_t before = connection.partial;
+        const std::size_t take = std::min(data.size(), connection.carry.size() - before);
+        std::memcpy(connection.carry.data() + before, data.data(), take);
+        const auto result = sessions_.process(slot, std::span<const std::byte>(connection.carry.data(), before + take));
+        commands_ += result.commands;
+        if (result.error) {
+            return false;
+        }
+        if (result.consumed == 0) {
+            connection.partial += take;  // Still incomplete, so all of data fit
+            return true;
+        }
+        data = data.subspan(result.consumed - before);
+        connection.partial = 0;
+    }
+
+    const auto result = sessions_.process(slot, data);
+    commands_ += result.commands;
+    if (result.error) {
+        return false;
+    }
+    connection.partial = data.size() - result.consumed;
+    std::memcpy(connection.carry.data(), data.data() + result.consumed, connection.partial);
+    return true;
+}
+
+void UringGateway::on_send(std::size_t slot, int result) {
+    Connection& connection = connections_[slot];
+    if (result <= 0) {
+        close_connection(slot);
+        return;
+    }
+    connection.send_offset += static_cast<std::size_t>(result);
+    if (connection.send_offset < connection.send_length) {
+        submit_send(slot);  // Short write
+        return;
+    }
+    connection.sending = false;
+    stage_send(slot);
+}
+
+void UringGateway::recycle_buffer(std::uint16_t bid) {
+    add_ring_buffer(buffer_ring_, buffer_count_ - 1, 0, receive_buffer(bid), RECEIVE_BUFFER, bid);
+    publish_ring_buffers(buffer_ring_, 1);
+}
+
+void UringGateway::close_connection(std::size_t slot) {
+    Connection& connection = connections_[slot];
+    if (connection.fd < 0) {
+        return;
+    }
+    // Shutdown ends the armed receive; its last completion is dropped by generation
+    ::shutdown(connection.fd, SHUT_RDWR);
+    ::close(connection.fd);
+    extra_syscalls_ += 2;
+    connection.fd = -1;
+    connection.receiving = false;
+    connection.sending = false;
+    connection.partial = 0;
+    sessions_.close(slot);
+}
+
+void UringGateway::journal_command(std::uint64_t sequence, ParticipantId participant,
+                                   const OrderCommand& command) {
+    const bool compressed = journal_format_ == JournalFormat::Compressed;
+    JournalHalf* half = &journal_halves_[journal_active_];
+    if (half->length + (compressed ? JournalEncoder::MAX_RECORD : sizeof(JournalRecord)) > JOURNAL_BUFFER) {
+        if (!journal_halves_[1 - journal_active_].in_flight) {
+            flush_journal();
+            half = &journal_halves_[journal_active_];
+        } else {
+            // Both halves busy: write this one out in place
+            write_journal_sync(journal_half(journal_active_), half->length, journal_offset_);
+            journal_offset_ += half->length;
+            half->length = 0;
+        }
+    }
+    const JournalRecord record{
+        .sequence = sequence,
+        .timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count(),
+        .participant = participant,
+        .command = command
+    };
+    std::byte* out = journal_half(journal_active_) + half->length;
+    if (compressed) {
+        half->length += journal_encoder_.encode(record, out);
+    } else {
+        std::memcpy(out, &record, sizeof(record));
+        half->length += sizeof(record);
+    }
+}
+
+void UringGateway::flush_journal() {
+    JournalHalf& half = journal_halves_[journal_active_];
+    if (journal_fd_ < 0 || half.length == 0 || journal_halves_[1 - journal_active_].in_flight) {
+        return;  // Keeps filling until the other half has landed
+    }
+    io_uring_sqe* sqe = next_sqe();
+    sqe->opcode = IORING_OP_WRITE_FIXED;
+    sqe->fd = journal_fd_;
+    sqe->addr = reinterpret_cast<std::uint64_t>(journal_half(journal_active_));
+    sqe->len = static_cast<std::uint32_t>(half.length);
+    sqe->off = journal_offset_;
+    sqe->buf_index = JOURNAL_BUFFER_INDEX;
+    sqe->user_data = make_user_data(static_cast<std::uint8_t>(Op::Journal), 0, journal_active_);
+    half.offset = journal_offset_;
+    half.in_flight = true;
+    journal_offset_ += half.length;
+    journal_active_ = 1 - journal_active_;
+}
+
+void UringGateway::on_journal(std::size_t index, int result) {
+    JournalHalf& half = journal_halves_[index];
+    const std::size_t written = result > 0 ? static_cast<std::size_t>(result) : 0;
+    if (written < half.length) {
+        write_journal_sync(journal_half(index) + written, half.length - written, half.offset + written);
+    }
+    half.length = 0;
+    half.in_flight = false;
+}
+
+void UringGateway::write_journal_sync(const std::byte* data, std::size_t length, std::uint64_t offset) {
+    while (length > 0) {
+        ++extra_syscalls_;
+        const ssize_t written = ::pwrite(journal_fd_, data, length, static_cast<off_t>(offset));
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            ++journal_errors_;
+            return;
+        }
+        data += written;
+        length -= static_cast<std::size_t>(written);
+        offset += static_cast<std::uint64_t>(written);
+    }
+}
+
+} // namespace lob
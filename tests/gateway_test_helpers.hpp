@@ -0,0 +1,36 @@
+#pragma once
+
+#include "tcp_gateway.hpp"
+#include "types.hpp"
+#include <chrono>
+
+// Helpers shared by the socket gateway tests (everything runs on the test thread over loopback)
+namespace lob::test {
+
+inline OrderCommand new_order(OrderId id, Side side, Price price, Quantity quantity) {
+    return OrderCommand{.id = id, .price = price, .quantity = quantity,
+                        .type = CommandType::New, .side = side};
+}
+
+// Drive the gateway until pred holds
+template<typename Gateway, typename Predicate>
+bool pump(Gateway& gateway, Predicate&& pred) {
+    for (int i = 0; i < 200 && !pred(); ++i) {
+        gateway.poll(std::chrono::milliseconds{5});
+    }
+    return pred();
+}
+
+// Next report for client, driving the gateway while it is on its way
+template<typename Gateway>
+bool receive(Gateway& gateway, TcpOrderClient& client, ExecutionReport& report) {
+    for (int i = 0; i < 200; ++i) {
+        if (client.receive(report, std::chrono::milliseconds{0})) {
+            return true;
+        }
+        gateway.poll(std::chrono::milliseconds{5});
+    }
+    return false;
+}
+
+} // namespace lob::test
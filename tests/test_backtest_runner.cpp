@@ -0,0 +1,136 @@
+#include <catch2/catch_test_macros.hpp>
+#include "backtest_runner.hpp"
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+using namespace std::chrono_literals;
+
+// A day of adds, cancels and IOC executions around 100
+std::vector<JournalRecord> day(std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<JournalRecord> records;
+    std::int64_t time = 1'000'000;
+    for (std::uint64_t sequence = 1; sequence <= 5000; ++sequence) {
+        time += static_cast<std::int64_t>(rng() % 1000);
+        OrderCommand command{.id = sequence};
+        const std::uint64_t pick = rng() % 10;
+        const bool buy = rng() % 2;
+        command.side = buy ? Side::Buy : Side::Sell;
+        if (pick < 3) {
+            command.id = 1 + rng() % sequence;
+            command.type = CommandType::Cancel;
+        } else if (pick < 5) {
+            command.price = buy ? 102 : 98;
+            command.quantity = 1 + rng() % 20;
+            command.order_type = OrderType::IOC;
+        } else {
+            command.price = buy ? 99 - static_cast<Price>(rng() % 3) : 101 + static_cast<Price>(rng() % 3);
+            command.quantity = 1 + rng() % 20;
+        }
+        records.push_back({.sequence = sequence, .timestamp = time, .participant = 1, .command = command});
+    }
+    return records;
+}
+
+void write_journal(const std::string& path, const std::vector<JournalRecord>& records, JournalFormat format) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (format == JournalFormat::Raw) {
+        out.write(reinterpret_cast<const char*>(records.data()),
+                  static_cast<std::streamsize>(records.size() * sizeof(JournalRecord)));
+        return;
+    }
+    JournalEncoder encoder;
+    std::byte buffer[JournalEncoder::MAX_RECORD];
+    for (const JournalRecord& record : records) {
+        out.write(reinterpret_cast<const char*>(buffer), static_cast<std::streamsize>(encoder.encode(record, buffer)));
+    }
+}
+
+// Quotes size lots on both sides of the touch, following it
+class Quoter : public BacktestStrategy {
+public:
+    explicit Quoter(Quantity size) : size_(size) {}
+
+    void on_market_data(const MarketEvent& event, Backtester& backtester) override {
+        follow(0, Side::Buy, event.bid, backtester);
+        follow(1, Side::Sell, event.ask, backtester);
+    }
+
+private:
+    void follow(std::size_t slot, Side side, const BookLevel& touch, Backtester& backtester) {
+        if (touch.quantity == 0 || touch.price == prices_[slot]) {
+            return;
+        }
+        if (ids_[slot]) {
+            (void)backtester.cancel(ids_[slot]);
+        }
+        ids_[slot] = backtester.submit(side, OrderType::Limit, touch.price, size_);
+        prices_[slot] = touch.price;
+    }
+
+    Quantity size_;
+    OrderId ids_[2]{};
+    Price prices_[2]{};
+};
+
+bool same_outcome(const BacktestResult& a, const BacktestResult& b) {
+    return a.completed == b.completed && a.position == b.position && a.cash == b.cash && a.mark == b.mark &&
+           a.records == b.records && a.commands_sent == b.commands_sent && a.fills == b.fills &&
+           a.dropped == b.dropped;
+}
+
+} // namespace
+
+TEST_CASE("BacktestRunner - Parallel runs match sequential ones, in task order", "[backtest_runner]") {
+    const std::string directory = "/tmp/lob_backtest_runner_test_" + std::to_string(::getpid());
+    std::filesystem::create_directories(directory);
+    std::vector<BacktestTask> tasks;
+    for (std::uint64_t seed : {1, 2, 3}) {
+        const auto records = day(seed);
+        for (const JournalFormat format : {JournalFormat::Raw, JournalFormat::Compressed}) {
+            const std::string path = directory + "/day" + std::to_string(seed) +
+                                     (format == JournalFormat::Raw ? ".raw" : ".packed");
+            write_journal(path, records, format);
+            for (std::uint64_t size : {1, 5, 20}) {
+                tasks.push_back({.journal = path, .format = format, .parameter = size,
+                                 .options = {.feed_latency = 500ns, .order_latency = 300ns}});
+            }
+        }
+    }
+    tasks.push_back({.journal = directory + "/missing"});
+    tasks.push_back({.journal = tasks[0].journal, .parameter = 0});  // The factory declines it
+
+    const BacktestRunner::StrategyFactory factory = [](const BacktestTask& task, std::size_t) {
+        return task.parameter ? std::make_unique<Quoter>(task.parameter) : nullptr;
+    };
+    const auto sequential = BacktestRunner({.threads = 1}).run(tasks, factory);
+    BacktestRunner parallel({.threads = 4, .decode_batch = 100});
+    REQUIRE(parallel.threads() == 4);
+    const auto results = parallel.run(tasks, factory);
+    REQUIRE(results.size() == tasks.size());
+
+    for (std::size_t i = 0; i + 2 < tasks.size(); ++i) {
+        REQUIRE(results[i].completed);
+        REQUIRE(results[i].records == 5000);
+        REQUIRE(results[i].fills > 0);
+        REQUIRE(results[i].mark);
+        REQUIRE(same_outcome(results[i], sequential[i]));
+        // The compressed copy of a day replays exactly like the raw one
+        if (tasks[i].format == JournalFormat::Compressed) {
+            REQUIRE(same_outcome(results[i], results[i - 3]));
+        }
+    }
+    REQUIRE_FALSE(results[tasks.size() - 2].completed);
+    REQUIRE_FALSE(results[tasks.size() - 1].completed);
+
+    REQUIRE(parallel.run({}, factory).empty());
+    std::filesystem::remove_all(directory);
+}
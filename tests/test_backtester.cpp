@@ -0,0 +1,126 @@
+#include <catch2/catch_test_macros.hpp>
+#include "backtester.hpp"
+#include "matching_engine.hpp"
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+using namespace std::chrono_literals;
+
+JournalRecord add(std::int64_t time, OrderId id, Side side, Price price, Quantity quantity) {
+    return JournalRecord{.timestamp = time, .participant = 1,
+                         .command = {.id = id, .price = price, .quantity = quantity, .side = side}};
+}
+
+JournalRecord cancel(std::int64_t time, OrderId id) {
+    return JournalRecord{.timestamp = time, .participant = 1, .command = {.id = id, .type = CommandType::Cancel}};
+}
+
+// An execution in the data: an IOC against the resting side at price
+JournalRecord execute(std::int64_t time, OrderId id, Side side, Price price, Quantity quantity) {
+    return JournalRecord{.timestamp = time, .participant = 2,
+                         .command = {.id = id, .price = price, .quantity = quantity, .side = side,
+                                     .order_type = OrderType::IOC}};
+}
+
+// Joins the bid once, on the first record it sees, and logs what comes back
+struct JoinBid : BacktestStrategy {
+    OrderId order{0};
+    std::vector<Timestamp> seen;
+    std::vector<std::pair<Timestamp, ExecutionReport>> reports;
+
+    void on_market_data(const MarketEvent& event, Backtester& backtester) override {
+        seen.push_back(backtester.now());
+        if (!order && event.bid.quantity > 0) {
+            order = backtester.submit(Side::Buy, OrderType::Limit, event.bid.price, 5);
+        }
+    }
+    void on_report(const ExecutionReport& report, Backtester& backtester) override {
+        reports.emplace_back(backtester.now(), report);
+    }
+};
+
+} // namespace
+
+TEST_CASE("Backtester - Latencies delay what the strategy sees and sends", "[backtester]") {
+    MatchingEngine engine;
+    JoinBid strategy;
+    auto backtester = Backtester::create(engine, strategy, {
+        .feed_latency = 10ns, .order_latency = 20ns, .response_latency = 5ns, .queue_capacity = 8});
+    REQUIRE(backtester);
+
+    const std::vector<JournalRecord> history{
+        add(1000, 1, Side::Buy, 100, 10),
+        add(1015, 2, Side::Buy, 100, 20),  // Seen at 1025, after the strategy sent at 1010
+        add(1031, 3, Side::Buy, 100, 30),  // After the strategy order arrived at 1030
+    };
+    backtester->run(history);
+    backtester->advance(Timestamp{2000});
+
+    REQUIRE(strategy.seen == std::vector<Timestamp>{1010ns, 1025ns, 1041ns});
+    REQUIRE(strategy.order != 0);
+    // Arrived behind the first two orders, ahead of the third
+    REQUIRE(backtester->queue_position(strategy.order)->quantity_ahead == 30);
+    REQUIRE(strategy.reports.size() == 1);
+    REQUIRE(strategy.reports[0].first == 1035ns);
+    REQUIRE(strategy.reports[0].second.type == ReportType::Ack);
+    REQUIRE(strategy.reports[0].second.status == OrderStatus::New);
+    REQUIRE(strategy.reports[0].second.leaves == 5);
+    REQUIRE(backtester->records() == 3);
+    REQUIRE(backtester->commands_sent() == 1);
+    REQUIRE(backtester->now() == 2000ns);
+
+    // Capacity must be a power of two, strategy orders need a participant
+    REQUIRE_FALSE(Backtester::create(engine, strategy, {.queue_capacity = 6}));
+    REQUIRE_FALSE(Backtester::create(engine, strategy, {.participant = NO_PARTICIPANT}));
+}
+
+TEST_CASE("Backtester - Strategy orders keep their place in the FIFO", "[backtester]") {
+    MatchingEngine engine;
+    JoinBid strategy;
+    auto backtester = Backtester::create(engine, strategy, {.queue_capacity = 4});
+    REQUIRE(backtester);
+
+    // Zero latency, yet the order sent on record 1 lands after record 2: same time,
+    // and the history goes first on ties
+    backtester->run(std::vector{add(100, 1, Side::Buy, 100, 10), add(100, 2, Side::Buy, 100, 20)});
+    backtester->run(std::vector{add(101, 3, Side::Buy, 100, 40)});
+    REQUIRE(backtester->queue_position(strategy.order)->quantity_ahead == 30);
+
+    // Cancels ahead move it up, cancels behind do not
+    backtester->run(std::vector{cancel(102, 1), cancel(103, 3)});
+    REQUIRE(backtester->queue_position(strategy.order)->quantity_ahead == 20);
+    REQUIRE(backtester->queue_position(strategy.order)->level_quantity == 25);
+
+    // An execution reaches the strategy after the order ahead, and the history goes on
+    // as recorded even where the strategy took what it would have executed
+    backtester->run(std::vector{execute(104, 10, Side::Sell, 100, 22), execute(105, 11, Side::Sell, 100, 20)});
+    backtester->advance(Timestamp{200});
+    REQUIRE_FALSE(backtester->queue_position(strategy.order));
+    REQUIRE(backtester->fills() == 2);
+    REQUIRE(backtester->position() == 5);
+    REQUIRE(backtester->cash() == -500);
+
+    std::vector<ExecutionReport> fills;
+    for (const auto& [time, report] : strategy.reports) {
+        if (report.type == ReportType::Fill) {
+            fills.push_back(report);
+        }
+    }
+    REQUIRE(fills.size() == 2);
+    REQUIRE(fills[0].quantity == 2);
+    REQUIRE(fills[0].leaves == 3);
+    REQUIRE(fills[0].status == OrderStatus::PartiallyFilled);
+    REQUIRE(fills[1].quantity == 3);
+    REQUIRE(fills[1].status == OrderStatus::Filled);
+    REQUIRE(engine.get_order_book().order_count() == 0);
+
+    // A full order queue refuses sends
+    for (int i = 0; i < 4; ++i) {
+        REQUIRE(backtester->submit(Side::Sell, OrderType::Limit, 110, 1) != 0);
+    }
+    REQUIRE(backtester->submit(Side::Sell, OrderType::Limit, 110, 1) == 0);
+    REQUIRE_FALSE(backtester->cancel(strategy.order));
+}
@@ -0,0 +1,109 @@
+#include <catch2/catch_test_macros.hpp>
+#include "command_journal.hpp"
+#include <cstring>
+#include <limits>
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+bool same_record(const JournalRecord& a, const JournalRecord& b) {
+    return std::memcmp(&a, &b, sizeof(JournalRecord)) == 0;
+}
+
+std::vector<std::byte> encode_all(const std::vector<JournalRecord>& records) {
+    JournalEncoder encoder;
+    std::vector<std::byte> stream(records.size() * JournalEncoder::MAX_RECORD);
+    std::size_t length = 0;
+    for (const JournalRecord& record : records) {
+        length += encoder.encode(record, stream.data() + length);
+    }
+    stream.resize(length);
+    return stream;
+}
+
+} // namespace
+
+TEST_CASE("JournalEncoder - Round trip of every field and command shape", "[command_journal]") {
+    constexpr std::int64_t max = std::numeric_limits<std::int64_t>::max();
+    constexpr std::int64_t min = std::numeric_limits<std::int64_t>::min();
+    std::vector<JournalRecord> records = {
+        {.sequence = 1, .timestamp = 1'700'000'000'000'000'000, .participant = 1,
+         .command = {.client_seq = 1, .id = 42, .price = 10'050, .quantity = 100}},
+        {.sequence = 2, .timestamp = 1'700'000'000'000'000'350, .participant = 1,
+         .command = {.client_seq = 2, .id = 43, .price = 10'049, .quantity = 7, .side = Side::Sell,
+                     .order_type = OrderType::IOC}},
+        {.sequence = 3, .timestamp = 1'700'000'000'000'000'351, .participant = 2,
+         .command = {.client_seq = 1, .id = 42, .type = CommandType::Cancel}},
+        {.sequence = 4, .timestamp = 1'700'000'000'000'000'900, .participant = 1,
+         .command = {.client_seq = 3, .id = 43, .price = 10'060, .quantity = 9, .type = CommandType::Modify}},
+        {.sequence = 5, .timestamp = 1'700'000'000'000'000'901, .participant = 1,
+         .command = {.client_seq = 4, .id = 44, .price = 10'061, .quantity = 1,
+                     .expire_time = 1'700'000'100'000'000'000, .time_in_force = TimeInForce::GTT}},
+        {.sequence = 6, .timestamp = 1'700'000'000'000'000'100, .participant = 2,  // Clock stepped back
+         .command = {.type = CommandType::MassCancel}},
+        {.sequence = 100, .timestamp = max, .participant = std::numeric_limits<ParticipantId>::max(),
+         .command = {.client_seq = std::numeric_limits<std::uint64_t>::max(),
+                     .id = std::numeric_limits<OrderId>::max(), .price = max,
+                     .quantity = std::numeric_limits<Quantity>::max(), .expire_time = min,
+                     .side = Side::Sell, .order_type = OrderType::FOK, .time_in_force = TimeInForce::Day}},
+        {.sequence = 101, .timestamp = min, .participant = 0,
+         .command = {.client_seq = 0, .id = 0, .price = min, .quantity = 0, .expire_time = max,
+                     .order_type = OrderType::Market}},
+        {.sequence = 102, .timestamp = 0, .participant = 65,  // Shares a client_seq slot with 1
+         .command = {.client_seq = 1, .id = 1, .price = -5, .quantity = 3}}
+    };
+
+    const auto stream = encode_all(records);
+    JournalDecoder decoder;
+    std::vector<JournalRecord> decoded;
+    REQUIRE(decoder.decode_all(stream, decoded) == stream.size());
+    REQUIRE(decoded.size() == records.size());
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        REQUIRE(same_record(decoded[i], records[i]));
+    }
+
+    // A cancel right after a new order on the same id is a handful of bytes
+    JournalEncoder encoder;
+    std::byte out[JournalEncoder::MAX_RECORD];
+    (void)encoder.encode(records[0], out);
+    const JournalRecord cancel{.sequence = 2, .timestamp = records[0].timestamp + 200, .participant = 1,
+                               .command = {.client_seq = 2, .id = 42, .type = CommandType::Cancel}};
+    REQUIRE(encoder.encode(cancel, out) == 1 + journal::TAG_BYTES + 3);  // Timestamp (2) and client_seq (1)
+}
+
+TEST_CASE("JournalDecoder - Partial and corrupt records are not decoded", "[command_journal]") {
+    std::vector<JournalRecord> records;
+    for (std::uint64_t i = 1; i <= 1000; ++i) {
+        records.push_back({.sequence = i, .timestamp = static_cast<std::int64_t>(1'000'000 + 997 * i),
+                           .participant = static_cast<ParticipantId>(1 + i % 4),
+                           .command = {.client_seq = i / 4 + 1, .id = i, .price = 100 + static_cast<Price>(i % 13),
+                                       .quantity = 1 + i % 50, .side = i % 2 ? Side::Buy : Side::Sell}});
+    }
+    const auto stream = encode_all(records);
+    REQUIRE(stream.size() * 5 < records.size() * sizeof(JournalRecord));
+
+    // Fed in small pieces, as a reader following a file being written would see it
+    JournalDecoder decoder;
+    std::vector<JournalRecord> decoded;
+    std::size_t consumed = 0;
+    for (std::size_t available = 0; available <= stream.size(); available += 7) {
+        consumed += decoder.decode_all(std::span(stream).subspan(consumed, available - consumed), decoded);
+    }
+    consumed += decoder.decode_all(std::span(stream).subspan(consumed), decoded);
+    REQUIRE(consumed == stream.size());
+    REQUIRE(decoded.size() == records.size());
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        REQUIRE(same_record(decoded[i], records[i]));
+    }
+
+    // A length nibble over 8 or an unknown time in force is rejected
+    std::vector<std::byte> corrupt(stream.begin(), stream.begin() + 64);
+    JournalRecord record;
+    corrupt[1] = std::byte{0x09};
+    REQUIRE(JournalDecoder{}.decode(corrupt.data(), corrupt.size(), record) == 0);
+    corrupt[1] = stream[1];
+    corrupt[0] |= std::byte{0x60};
+    REQUIRE(JournalDecoder{}.decode(corrupt.data(), corrupt.size(), record) == 0);
+}
@@ -0,0 +1,109 @@
+#include <catch2/catch_test_macros.hpp>
+#include "command_journal.hpp"
+#include "exchange_simulator.hpp"
+#include <cstring>
+#include <set>
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+using namespace std::chrono_literals;
+
+std::vector<std::unique_ptr<SimulatedAgent>> population(std::size_t makers, std::size_t takers, std::size_t noise) {
+    std::vector<std::unique_ptr<SimulatedAgent>> agents;
+    for (std::size_t i = 0; i < makers; ++i) {
+        agents.push_back(std::make_unique<MarketMakerAgent>(10, 2 + static_cast<Price>(i % 3), 500us));
+    }
+    for (std::size_t i = 0; i < takers; ++i) {
+        agents.push_back(std::make_unique<TakerAgent>(5, 200us));
+    }
+    for (std::size_t i = 0; i < noise; ++i) {
+        agents.push_back(std::make_unique<NoiseTraderAgent>(20, 10, 100us));
+    }
+    return agents;
+}
+
+struct Run {
+    std::uint64_t state_hash;
+    std::uint64_t events;
+    std::uint64_t commands;
+    std::uint64_t trades;
+    std::vector<JournalRecord> journal;
+};
+
+Run simulate(std::uint64_t seed) {
+    MatchingEngine engine;
+    auto simulator = ExchangeSimulator::create(engine, population(10, 20, 70), {.seed = seed});
+    Run run{};
+    simulator->sessions().set_command_callback(
+        [&](std::uint64_t sequence, ParticipantId participant, const OrderCommand& command) {
+            run.journal.push_back({.sequence = sequence, .timestamp = simulator->now().count(),
+                                   .participant = participant, .command = command});
+        });
+    simulator->run_until(20ms);
+    run.state_hash = engine.get_order_book().state_hash();
+    run.events = simulator->events();
+    run.commands = simulator->commands();
+    run.trades = simulator->trades();
+    return run;
+}
+
+} // namespace
+
+TEST_CASE("ExchangeSimulator - Runs are reproducible and replay from their command stream", "[exchange_simulator]") {
+    const Run first = simulate(7);
+    const Run second = simulate(7);
+    REQUIRE(first.commands > 10'000);
+    REQUIRE(first.trades > 100);
+    REQUIRE(first.commands == first.journal.size());
+    REQUIRE(second.state_hash == first.state_hash);
+    REQUIRE(second.events == first.events);
+    REQUIRE(second.trades == first.trades);
+    REQUIRE(second.journal.size() == first.journal.size());
+    REQUIRE(std::memcmp(second.journal.data(), first.journal.data(), first.journal.size() * sizeof(JournalRecord)) == 0);
+    REQUIRE(simulate(8).state_hash != first.state_hash);
+
+    // Every agent got commands through its own session
+    std::set<ParticipantId> participants;
+    for (const JournalRecord& record : first.journal) {
+        participants.insert(record.participant);
+    }
+    REQUIRE(participants.size() == 100);
+
+    // The journal rebuilds the book without the simulator
+    MatchingEngine replay;
+    for (const JournalRecord& record : first.journal) {
+        (void)execute_command(replay, record.command, record.participant);
+    }
+    REQUIRE(replay.get_order_book().state_hash() == first.state_hash);
+}
+
+TEST_CASE("ExchangeSimulator - Queueing latency emerges when the exchange saturates", "[exchange_simulator]") {
+    REQUIRE_FALSE(ExchangeSimulator::create(*std::make_unique<MatchingEngine>(), {}));
+
+    auto latency = [](Timestamp service_time, std::size_t& depth) {
+        MatchingEngine engine;
+        auto simulator = ExchangeSimulator::create(engine, population(5, 10, 35), {.service_time = service_time});
+        simulator->run_until(10ms);
+        REQUIRE(simulator->exchange_latency().count() == simulator->commands());
+        REQUIRE(simulator->processing().count() == simulator->commands());
+        depth = simulator->max_queue_depth();
+        return simulator->exchange_latency().percentile(0.5);
+    };
+    std::size_t idle_depth = 0;
+    std::size_t busy_depth = 0;
+    // About one command per microsecond offered: light load at 100ns, overload at 5us
+    REQUIRE(latency(100ns, idle_depth) <= 500ns);
+    REQUIRE(latency(5us, busy_depth) > 1ms);
+    REQUIRE(busy_depth > 10 * idle_depth);
+
+    LatencyHistogram histogram;
+    for (int ns = 1; ns <= 1000; ++ns) {
+        histogram.record(Timestamp{ns});
+    }
+    REQUIRE(histogram.percentile(0.5) >= 500ns);
+    REQUIRE(histogram.percentile(0.5) <= 625ns);
+    REQUIRE(histogram.percentile(1.0) == 1000ns);
+}
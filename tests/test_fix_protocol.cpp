@@ -0,0 +1,273 @@
+#include <catch2/catch_test_macros.hpp>
+#include "fix_protocol.hpp"
+#include "fix_session.hpp"
+#include "matching_engine.hpp"
+#include "order_entry.hpp"
+#include "wire_protocol.hpp"
+#include <algorithm>
+#include <array>
+#include <string>
+#include <vector>
+
+using namespace lob;
+using fix::Tag;
+
+namespace {
+
+constexpr std::string_view SENDING_TIME = "20240102-09:30:00.000";
+
+// Client side of a FIX session: composes messages with increasing MsgSeqNum
+struct FixClient {
+    explicit FixClient(std::string id) : comp_id(std::move(id)) {}
+
+    std::string comp_id;
+    std::uint64_t seq{0};
+    fix::MessageBuilder builder;
+
+    fix::MessageBuilder& start(std::string_view msg_type) {
+        builder.begin(msg_type, comp_id, "LOB", ++seq, SENDING_TIME);
+        return builder;
+    }
+    std::string finish() const {
+        std::string out(builder.size(), '\0');
+        out.resize(builder.finish(out.data()));
+        return out;
+    }
+    std::string new_order(OrderId id, char side, std::string_view price, std::uint64_t quantity) {
+        start("D").add(Tag::ClOrdID, id).add(Tag::Symbol, "XYZ").add(Tag::Side, side)
+            .add(Tag::OrderQty, quantity).add(Tag::OrdType, '2').add(Tag::Price, price)
+            .add(Tag::TimeInForce, '1');
+        return finish();
+    }
+};
+
+// body (fields joined by '|') framed with a correct BodyLength and CheckSum
+std::string frame(std::string body) {
+    std::ranges::replace(body, '|', fix::SOH);
+    std::string out = std::string(fix::BEGIN_STRING) + std::to_string(body.size()) + fix::SOH + body;
+    const unsigned sum = fix::checksum(out);
+    out += "10=";
+    out += static_cast<char>('0' + sum / 100);
+    out += static_cast<char>('0' + sum / 10 % 10);
+    out += static_cast<char>('0' + sum % 10);
+    out += fix::SOH;
+    return out;
+}
+
+FixSessions::ProcessResult feed(FixSessions& sessions, std::size_t slot, const std::string& bytes) {
+    return sessions.process(slot, std::as_bytes(std::span(bytes.data(), bytes.size())));
+}
+
+// Every message the session has queued, decoded; the views point into out
+std::vector<fix::Message> drain(FixSessions& sessions, std::size_t slot, std::string& out) {
+    const auto pending = sessions.pending_output(slot);
+    out.assign(reinterpret_cast<const char*>(pending.data()), pending.size());
+    sessions.consume_output(slot, pending.size());
+    std::vector<fix::Message> messages;
+    std::size_t offset = 0;
+    fix::Message message;
+    while (offset < out.size()) {
+        const auto decoded = fix::decode_message(std::span(out.data() + offset, out.size() - offset), message);
+        REQUIRE(decoded.status == fix::DecodeStatus::Ok);
+        messages.push_back(message);
+        offset += decoded.consumed;
+    }
+    return messages;
+}
+
+} // namespace
+
+TEST_CASE("FIX codec - NewOrderSingle round trip and framing errors", "[fix]") {
+    FixClient client("CLIENT");
+    const std::string order = client.new_order(42, '2', "101.25", 300);
+    REQUIRE(order.starts_with("8=FIX.4.4\x01" "9="));
+    REQUIRE(order.ends_with("\x01"));
+
+    fix::Message message;
+    const auto result = fix::decode_message(order, message);
+    REQUIRE(result.status == fix::DecodeStatus::Ok);
+    REQUIRE(result.consumed == order.size());
+    REQUIRE(message.msg_type == "D");
+    REQUIRE(message.seq == 1);
+    REQUIRE(message.sender_comp_id == "CLIENT");
+    REQUIRE(message.target_comp_id == "LOB");
+    REQUIRE(message.cl_ord_id == "42");
+    REQUIRE(message.symbol == "XYZ");
+    REQUIRE(message.side == '2');
+    REQUIRE(message.order_qty == "300");
+    REQUIRE(message.price == "101.25");
+    REQUIRE(message.time_in_force == '1');
+
+    // Every strict prefix needs more bytes
+    for (std::size_t length = 1; length < order.size(); ++length) {
+        REQUIRE(fix::decode_message(std::span(order.data(), length), message).status ==
+                fix::DecodeStatus::NeedMore);
+    }
+
+    std::string corrupted = order;
+    corrupted[corrupted.size() - 2] = corrupted[corrupted.size() - 2] == '0' ? '1' : '0';
+    REQUIRE(fix::decode_message(corrupted, message).status == fix::DecodeStatus::Invalid);
+    REQUIRE(fix::decode_message(std::string_view("8=FIX.4.2\x01"), message).status == fix::DecodeStatus::Invalid);
+}
+
+TEST_CASE("FIX codec - Field syntax", "[fix]") {
+    fix::Message message;
+    std::string framed;  // Outlives the views in message
+    const auto status = [&](const std::string& body) {
+        framed = frame(body);
+        return fix::decode_message(framed, message).status;
+    };
+    // '=' inside a value is data, and unknown tags of up to five digits are skipped
+    REQUIRE(status("35=D|34=3|49=A=B|56=LOB|99999=x|11=7|") == fix::DecodeStatus::Ok);
+    REQUIRE(message.sender_comp_id == "A=B");
+    REQUIRE(message.cl_ord_id == "7");
+    REQUIRE(message.seq == 3);
+
+    REQUIRE(status("35=D|100000=x|") == fix::DecodeStatus::Invalid);  // Six-digit tag
+    REQUIRE(status("35=D|11=|") == fix::DecodeStatus::Invalid);       // Empty value
+    REQUIRE(status("35=D|=7|") == fix::DecodeStatus::Invalid);        // No tag
+    REQUIRE(status("35=D|11|") == fix::DecodeStatus::Invalid);        // No '='
+    REQUIRE(status("35=D|1|1=7|") == fix::DecodeStatus::Invalid);     // SOH inside a tag
+    REQUIRE(status("3a=D|") == fix::DecodeStatus::Invalid);           // Non-digit tag
+    REQUIRE(status("34=1|35=D|") == fix::DecodeStatus::Invalid);      // MsgType not first
+    REQUIRE(status("35=D|35=D|") == fix::DecodeStatus::Invalid);      // MsgType again
+    REQUIRE(status("35=D|54=12|") == fix::DecodeStatus::Invalid);     // Side is one character
+}
+
+TEST_CASE("FIX codec - Prices in ticks", "[fix]") {
+    Price price = 0;
+    REQUIRE(fix::parse_price("101.25", 2, price));
+    REQUIRE(price == 10125);
+    REQUIRE(fix::parse_price("101.5", 2, price));
+    REQUIRE(price == 10150);
+    REQUIRE(fix::parse_price("-3", 2, price));
+    REQUIRE(price == -300);
+    REQUIRE(fix::parse_price("7.000", 0, price));
+    REQUIRE(price == 7);
+    REQUIRE_FALSE(fix::parse_price("101.255", 2, price));  // Off tick
+    REQUIRE_FALSE(fix::parse_price("1a", 2, price));
+
+    fix::MessageBuilder builder;
+    builder.begin("8", "A", "B", 1, SENDING_TIME);
+    builder.add_price(Tag::Price, -10125, 2);
+    std::string out(builder.size(), '\0');
+    builder.finish(out.data());
+    REQUIRE(out.find("\x01" "44=-101.25\x01") != std::string::npos);
+}
+
+TEST_CASE("FixSessions - Logon, orders, fills and cancel reject", "[fix]") {
+    MatchingEngine engine;
+    FixSessions sessions(engine, 4, FixSessionConfig{.comp_id = "LOB", .symbol = "XYZ", .price_decimals = 2});
+    FixClient maker("MAKER");
+    FixClient taker("TAKER");
+    const std::size_t maker_slot = *sessions.open();
+    const std::size_t taker_slot = *sessions.open();
+    std::string out;
+
+    // Orders before a logon end the session
+    FixClient early("EARLY");
+    const std::size_t early_slot = *sessions.open();
+    REQUIRE(feed(sessions, early_slot, early.new_order(1, '1', "1", 1)).error);
+    sessions.close(early_slot);
+
+    for (auto [client, slot] : {std::pair{&maker, maker_slot}, std::pair{&taker, taker_slot}}) {
+        client->start("A").add(Tag::EncryptMethod, '0').add(Tag::HeartBtInt, std::uint64_t{30});
+        REQUIRE_FALSE(feed(sessions, slot, client->finish()).error);
+        const auto logon = drain(sessions, slot, out);
+        REQUIRE(logon.size() == 1);
+        REQUIRE(logon[0].msg_type == "A");
+        REQUIRE(logon[0].target_comp_id == client->comp_id);
+    }
+
+    // Two messages in one read, the second split off
+    std::string both = maker.new_order(1, '2', "101.25", 10);
+    both += maker.new_order(2, '2', "101.50", 10);
+    auto result = feed(sessions, maker_slot, both.substr(0, both.size() - 5));
+    REQUIRE(result.commands == 1);
+    result = feed(sessions, maker_slot, both.substr(result.consumed));
+    REQUIRE(result.commands == 1);
+    auto acks = drain(sessions, maker_slot, out);
+    REQUIRE(acks.size() == 2);
+    REQUIRE(acks[1].msg_type == "8");
+    REQUIRE(acks[1].cl_ord_id == "2");
+    REQUIRE(engine.get_order_book().best_ask() == 10125);
+
+    REQUIRE(feed(sessions, taker_slot, taker.new_order(3, '1', "101.50", 15)).commands == 1);
+    const auto taker_reports = drain(sessions, taker_slot, out);
+    REQUIRE(taker_reports.size() == 3);  // Two fills, then the acknowledgement
+    REQUIRE(out.find("\x01" "150=F\x01") != std::string::npos);
+    REQUIRE(out.find("\x01" "31=101.25\x01") != std::string::npos);
+    REQUIRE(out.rfind("\x01" "39=2\x01") > out.rfind("\x01" "150=F\x01"));
+    REQUIRE(out.rfind("\x01" "14=15\x01") != std::string::npos);
+    REQUIRE(drain(sessions, maker_slot, out).size() == 2);
+
+    // Order 2 has 5 left; replace it, then cancel someone else's order
+    maker.start("G").add(Tag::ClOrdID, std::uint64_t{4}).add(Tag::OrigClOrdID, std::uint64_t{2})
+        .add(Tag::Symbol, "XYZ").add(Tag::Side, '2').add(Tag::OrderQty, std::uint64_t{20})
+        .add(Tag::OrdType, '2').add(Tag::Price, "102");
+    REQUIRE(feed(sessions, maker_slot, maker.finish()).commands == 1);
+    REQUIRE(engine.get_order_book().best_ask() == 10200);
+    REQUIRE(drain(sessions, maker_slot, out).size() == 1);
+    REQUIRE(out.find("\x01" "150=5\x01") != std::string::npos);
+
+    taker.start("F").add(Tag::ClOrdID, std::uint64_t{5}).add(Tag::OrigClOrdID, std::uint64_t{2})
+        .add(Tag::Symbol, "XYZ").add(Tag::Side, '2');
+    REQUIRE(feed(sessions, taker_slot, taker.finish()).commands == 1);
+    const auto reject = drain(sessions, taker_slot, out);
+    REQUIRE(reject.size() == 1);
+    REQUIRE(reject[0].msg_type == "9");
+    REQUIRE(engine.get_order_book().get_order(2) != nullptr);
+
+    // TestRequest is answered; a sequence gap ends the session
+    taker.start("1").add(Tag::TestReqID, "ping");
+    REQUIRE_FALSE(feed(sessions, taker_slot, taker.finish()).error);
+    const auto heartbeat = drain(sessions, taker_slot, out);
+    REQUIRE(heartbeat.size() == 1);
+    REQUIRE(heartbeat[0].test_req_id == "ping");
+    ++taker.seq;
+    taker.start("0");
+    REQUIRE(feed(sessions, taker_slot, taker.finish()).error);
+
+    maker.start("5");
+    REQUIRE(feed(sessions, maker_slot, maker.finish()).logout);
+    sessions.close(maker_slot);
+    REQUIRE(engine.get_order_book().order_count() == 0);
+}
+
+TEST_CASE("FixSessions - Sharing an engine with binary sessions", "[fix]") {
+    MatchingEngine engine;
+    OrderEntrySessions binary(engine, 2);
+    FixSessions sessions(engine, 2, FixSessionConfig{.comp_id = "LOB", .symbol = "XYZ", .price_decimals = 2});
+    REQUIRE(binary.participant(1) == 2);
+    REQUIRE(sessions.participant(0) == 3);
+    const std::size_t binary_slot = *binary.open();
+    const std::size_t fix_slot = *sessions.open();
+    FixClient taker("TAKER");
+    taker.start("A").add(Tag::EncryptMethod, '0').add(Tag::HeartBtInt, std::uint64_t{30});
+    REQUIRE_FALSE(feed(sessions, fix_slot, taker.finish()).error);
+    std::string out;
+    REQUIRE(drain(sessions, fix_slot, out).size() == 1);
+
+    std::array<std::byte, wire::MAX_FRAME> frame{};
+    const std::size_t length = wire::encode_command(
+        frame.data(), OrderCommand{.id = 1, .price = 10100, .quantity = 10, .side = Side::Sell}, 1);
+    REQUIRE(binary.process(binary_slot, std::span(frame.data(), length)).commands == 1);
+
+    // Each side hears of the fill once, on its own session
+    REQUIRE(feed(sessions, fix_slot, taker.new_order(2, '1', "101", 4)).commands == 1);
+    REQUIRE(drain(sessions, fix_slot, out).size() == 2);
+    std::size_t reports = 0;
+    for (auto pending = binary.pending_output(binary_slot); !pending.empty(); ++reports) {
+        ExecutionReport report;
+        const wire::DecodeResult decoded = wire::decode_report(pending, report);
+        REQUIRE(decoded.status == wire::DecodeStatus::Ok);
+        pending = pending.subspan(decoded.consumed);
+    }
+    REQUIRE(reports == 2);  // Ack, then the fill
+
+    // Closing the FIX session cancels only its own orders
+    REQUIRE(feed(sessions, fix_slot, taker.new_order(3, '1', "100", 5)).commands == 1);
+    sessions.close(fix_slot);
+    REQUIRE(engine.get_order_book().get_order(1) != nullptr);
+    REQUIRE(engine.get_order_book().get_order(3) == nullptr);
+}
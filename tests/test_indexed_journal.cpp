@@ -0,0 +1,308 @@
+#include <catch2/catch_test_macros.hpp>
+#include "indexed_journal.hpp"
+#include "matching_engine.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace lob;
+
+namespace {
+
+std::string journal_directory() {
+    return "/tmp/lob_indexed_journal_test_" + std::to_string(::getpid());
+}
+
+// Book state after every record, to compare seeks against
+struct History {
+    std::vector<JournalRecord> records;
+    std::vector<std::uint64_t> hashes;  // hashes[i]: after records[i]
+    std::vector<std::size_t> orders;
+};
+
+// Random flow through engine and writer, as a gateway would journal it
+History run_session(MatchingEngine& engine, IndexedJournalWriter& writer, std::size_t count) {
+    std::mt19937_64 rng(3);
+    History history;
+    std::int64_t time = 1'700'000'000'000'000'000;
+    for (std::uint64_t sequence = 1; sequence <= count; ++sequence) {
+        time += static_cast<std::int64_t>(rng() % 1'000'000);
+        const auto participant = static_cast<ParticipantId>(1 + rng() % 4);
+        OrderCommand command{.client_seq = sequence, .id = 1 + rng() % (sequence + 1)};
+        switch (rng() % 10) {
+            case 0: case 1:
+                command.type = CommandType::Cancel;
+                break;
+            case 2:
+                command.type = CommandType::Modify;
+                command.price = 95 + static_cast<Price>(rng() % 10);
+                command.quantity = 1 + rng() % 40;
+                break;
+            case 3:
+                command.type = rng() % 8 ? CommandType::Cancel : CommandType::MassCancel;
+                break;
+            default:
+                command.id = sequence;
+                command.side = rng() % 2 ? Side::Buy : Side::Sell;
+                command.price = 95 + static_cast<Price>(rng() % 10);
+                command.quantity = 1 + rng() % 30;
+                command.order_type = rng() % 6 ? OrderType::Limit : OrderType::IOC;
+                break;
+        }
+        const JournalRecord record{.sequence = sequence, .timestamp = time, .participant = participant,
+                                   .command = command};
+        writer.append(record);
+        (void)execute_command(engine, command, participant);
+        history.records.push_back(record);
+        history.hashes.push_back(engine.get_order_book().state_hash());
+        history.orders.push_back(engine.get_order_book().order_count());
+    }
+    return history;
+}
+
+} // namespace
+
+TEST_CASE("IndexedJournal - Seeking rebuilds the book at any time or sequence", "[indexed_journal]") {
+    const std::string directory = journal_directory();
+    for (const JournalFormat format : {JournalFormat::Raw, JournalFormat::Compressed}) {
+        constexpr std::size_t count = 3000;
+        History history;
+        {
+            MatchingEngine engine;
+            engine.set_self_trade_prevention(SelfTradePrevention::CancelNewest);
+            auto writer = IndexedJournalWriter::create(engine, directory, {
+                .format = format, .index_interval = 16, .snapshot_interval = 256, .write_bytes = 4096});
+            REQUIRE(writer);
+            history = run_session(engine, *writer, count);
+            REQUIRE(writer->snapshots() == (count + 255) / 256);
+            REQUIRE(writer->write_errors() == 0);
+        }
+
+        auto reader = IndexedJournalReader::open(directory);
+        REQUIRE(reader);
+        REQUIRE(reader->format() == format);
+        REQUIRE(reader->index().size() == (count + 15) / 16);
+
+        for (std::size_t target : {0, 1, 15, 16, 255, 256, 257, 1000, 2047, 2048, 2999}) {
+            // Between this record and the next one
+            const Timestamp time{history.records[target].timestamp + 1};
+            MatchingEngine engine;
+            const auto position = reader->seek(time, engine);
+            REQUIRE(position);
+            REQUIRE(position->sequence == target + 1);
+            REQUIRE(position->replayed <= 256);  // One segment at most
+            REQUIRE(engine.get_order_book().order_count() == history.orders[target]);
+            REQUIRE(engine.get_order_book().state_hash() == history.hashes[target]);
+            REQUIRE(engine.self_trade_prevention() == SelfTradePrevention::CancelNewest);
+
+            MatchingEngine by_sequence;
+            const auto same = reader->seek_sequence(target + 1, by_sequence);
+            REQUIRE(same);
+            REQUIRE(same->sequence == target + 1);
+            REQUIRE(by_sequence.get_order_book().state_hash() == history.hashes[target]);
+        }
+
+        // Before the first record: the empty book of the first snapshot
+        MatchingEngine early;
+        const auto position = reader->seek(Timestamp{history.records[0].timestamp - 1}, early);
+        REQUIRE(position);
+        REQUIRE(position->sequence == 0);
+        REQUIRE(early.get_order_book().order_count() == 0);
+
+        // Only into an empty engine
+        MatchingEngine busy;
+        REQUIRE(busy.submit_order(1, Side::Buy, OrderType::Limit, 90, 1) == OrderStatus::New);
+        REQUIRE_FALSE(reader->seek(Timestamp{history.records[100].timestamp}, busy));
+    }
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("IndexedJournal - A torn journal tail is not replayed", "[indexed_journal]") {
+    const std::string directory = journal_directory();
+    History history;
+    {
+        MatchingEngine engine;
+        auto writer = IndexedJournalWriter::create(engine, directory, {.index_interval = 8, .snapshot_interval = 64});
+        REQUIRE(writer);
+        history = run_session(engine, *writer, 200);
+        REQUIRE_FALSE(IndexedJournalWriter::create(engine, directory, {.index_interval = 8, .snapshot_interval = 60}));
+    }
+
+    // The last record only half made it to disk
+    const auto size = std::filesystem::file_size(directory + "/journal");
+    std::filesystem::resize_file(directory + "/journal", size - sizeof(JournalRecord) / 2);
+    auto reader = IndexedJournalReader::open(directory);
+    REQUIRE(reader);
+    MatchingEngine engine;
+    const auto position = reader->seek(Timestamp{history.records.back().timestamp}, engine);
+    REQUIRE(position);
+    REQUIRE(position->sequence == 199);
+    REQUIRE(engine.get_order_book().state_hash() == history.hashes[198]);
+
+    std::filesystem::remove_all(directory);
+    REQUIRE_FALSE(IndexedJournalReader::open(directory));
+}
+
+TEST_CASE("IndexedJournal - A corrupt snapshot leaves the engine empty", "[indexed_journal]") {
+    const std::string directory = journal_directory();
+    History history;
+    {
+        MatchingEngine engine;
+        engine.set_self_trade_prevention(SelfTradePrevention::CancelOldest);
+        auto writer = IndexedJournalWriter::create(engine, directory, {.index_interval = 8, .snapshot_interval = 64});
+        REQUIRE(writer);
+        history = run_session(engine, *writer, 200);
+    }
+    const std::uint64_t snapshot = [&] {
+        auto reader = IndexedJournalReader::open(directory);
+        REQUIRE(reader);
+        return reader->index()[16].snapshot;  // Records 129 on, with orders resting
+    }();
+    REQUIRE(snapshot != journal::NO_SNAPSHOT);
+
+    // Overwrite one field of the last order in the snapshot, so earlier orders restore first
+    const auto corrupt = [&](std::size_t field, auto value) {
+        std::FILE* file = std::fopen((directory + "/snapshots").c_str(), "r+b");
+        REQUIRE(file);
+        journal::SnapshotHeader header;
+        REQUIRE(std::fseek(file, static_cast<long>(snapshot), SEEK_SET) == 0);
+        REQUIRE(std::fread(&header, sizeof(header), 1, file) == 1);
+        REQUIRE(header.orders > 1);
+        const auto at = snapshot + sizeof(header) + (header.orders - 1) * sizeof(journal::SnapshotOrder) + field;
+        REQUIRE(std::fseek(file, static_cast<long>(at), SEEK_SET) == 0);
+        REQUIRE(std::fwrite(&value, sizeof(value), 1, file) == 1);
+        std::fclose(file);
+    };
+    const auto seek_fails = [&] {
+        auto reader = IndexedJournalReader::open(directory);
+        REQUIRE(reader);
+        MatchingEngine engine;
+        REQUIRE_FALSE(reader->seek_sequence(150, engine));
+        REQUIRE(engine.get_order_book().order_count() == 0);
+        REQUIRE(engine.get_order_book().state_hash() == 0);
+        REQUIRE(engine.self_trade_prevention() == SelfTradePrevention::None);
+        // Still usable for an earlier segment
+        REQUIRE(reader->seek_sequence(100, engine));
+        REQUIRE(engine.get_order_book().state_hash() == history.hashes[99]);
+    };
+
+    SECTION("Out-of-range side") {
+        corrupt(offsetof(journal::SnapshotOrder, side), std::uint8_t{7});
+        seek_fails();
+    }
+    SECTION("Out-of-range time in force") {
+        corrupt(offsetof(journal::SnapshotOrder, time_in_force), std::uint8_t{9});
+        seek_fails();
+    }
+    SECTION("Quantity that does not hash as recorded") {
+        corrupt(offsetof(journal::SnapshotOrder, quantity), Quantity{1'000'000});
+        seek_fails();
+    }
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("IndexedJournal - Restored orders keep the time they had left", "[indexed_journal]") {
+    using namespace std::chrono_literals;
+    const std::string directory = journal_directory();
+    const auto engine_time = [] {
+        return std::chrono::duration_cast<Timestamp>(std::chrono::steady_clock::now().time_since_epoch());
+    };
+    {
+        MatchingEngine engine;
+        engine.set_session_close(engine_time() + 2h);
+        REQUIRE(engine.submit_order(1, Side::Buy, OrderType::Limit, 100, 5, TimeInForce::GTT,
+                                    engine_time() + 1h) == OrderStatus::New);
+        REQUIRE(engine.submit_order(2, Side::Sell, OrderType::Limit, 101, 5, TimeInForce::Day) == OrderStatus::New);
+        REQUIRE(engine.submit_order(3, Side::Sell, OrderType::Limit, 102, 5) == OrderStatus::New);
+        auto writer = IndexedJournalWriter::create(engine, directory, {.index_interval = 1, .snapshot_interval = 1});
+        REQUIRE(writer);
+        writer->append(1, 1, OrderCommand{.id = 9, .type = CommandType::Cancel});
+    }
+
+    // On disk, relative to when the snapshot was taken
+    std::FILE* file = std::fopen((directory + "/snapshots").c_str(), "rb");
+    REQUIRE(file);
+    journal::SnapshotHeader header;
+    REQUIRE(std::fread(&header, sizeof(header), 1, file) == 1);
+    REQUIRE(header.orders == 3);
+    journal::SnapshotOrder orders[3];
+    REQUIRE(std::fread(orders, sizeof(orders), 1, file) == 1);
+    std::fclose(file);
+    REQUIRE(header.has_session_close);
+    REQUIRE(header.session_close > 0);
+    REQUIRE(header.session_close <= std::chrono::nanoseconds(2h).count());
+    for (const journal::SnapshotOrder& order : orders) {
+        if (order.time_in_force == TimeInForce::GTC) {
+            REQUIRE(order.expire_time == 0);
+        } else {
+            REQUIRE(order.expire_time > 0);
+            REQUIRE(order.expire_time <= std::chrono::nanoseconds(2h).count());
+        }
+    }
+
+    auto reader = IndexedJournalReader::open(directory);
+    REQUIRE(reader);
+    MatchingEngine engine;
+    const Timestamp before = engine_time();
+    REQUIRE(reader->seek_sequence(0, engine));
+    const Timestamp after = engine_time();
+    const Order* gtt = engine.get_order_book().get_order(1);
+    REQUIRE(gtt);
+    REQUIRE(gtt->expire_time > before);
+    REQUIRE(gtt->expire_time <= after + 1h);
+    REQUIRE(engine.get_order_book().get_order(3)->expire_time == Timestamp{0});
+    const Timestamp close = engine.engine_state().session_close;
+    REQUIRE(close > before + 1h);
+    REQUIRE(close <= after + 2h);
+    REQUIRE(engine.get_order_book().get_order(2)->expire_time == close);
+    REQUIRE(engine.expire_orders(after) == 0);
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("IndexedJournal - Replay expires orders on the journal's clock", "[indexed_journal]") {
+    using namespace std::chrono_literals;
+    const std::string directory = journal_directory();
+    std::uint64_t hashes[3];
+    {
+        MatchingEngine engine;
+        auto writer = IndexedJournalWriter::create(engine, directory, {.index_interval = 1, .snapshot_interval = 4});
+        REQUIRE(writer);
+        const auto journal = [&](std::uint64_t sequence, const OrderCommand& command) {
+            writer->append(sequence, 1, command);
+            (void)execute_command(engine, command, 1);
+            hashes[sequence - 1] = engine.get_order_book().state_hash();
+        };
+        journal(1, OrderCommand{.id = 1, .price = 100, .quantity = 5,
+                                .expire_time = (steady_time() + 20ms).count(),
+                                .time_in_force = TimeInForce::GTT});
+        journal(2, OrderCommand{.id = 2, .price = 105, .quantity = 5, .side = Side::Sell});
+        std::this_thread::sleep_for(40ms);
+        // Would trade with order 1 had it not expired
+        journal(3, OrderCommand{.id = 3, .price = 100, .quantity = 5, .side = Side::Sell});
+        REQUIRE(engine.get_order_book().order_count() == 2);
+    }
+
+    // Past order 1's expiry on the steady clock, but not at sequence 2 on the journal's
+    auto reader = IndexedJournalReader::open(directory);
+    REQUIRE(reader);
+    MatchingEngine at_two;
+    const Timestamp before = steady_time();
+    REQUIRE(reader->seek_sequence(2, at_two)->replayed == 2);
+    REQUIRE(at_two.get_order_book().state_hash() == hashes[1]);
+    const Order* gtt = at_two.get_order_book().get_order(1);
+    REQUIRE(gtt);
+    REQUIRE(gtt->expire_time > before);
+    REQUIRE(gtt->expire_time <= steady_time() + 20ms);
+
+    MatchingEngine at_three;
+    REQUIRE(reader->seek_sequence(3, at_three)->replayed == 3);
+    REQUIRE(at_three.get_order_book().state_hash() == hashes[2]);
+    REQUIRE_FALSE(at_three.get_order_book().get_order(1));
+    REQUIRE(at_three.get_order_book().get_order(3));
+    std::filesystem::remove_all(directory);
+}
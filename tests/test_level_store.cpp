@@ -0,0 +1,93 @@
+#include <catch2/catch_test_macros.hpp>
+#include "level_store.hpp"
+#include <map>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct TestLevel {
+    lob::Price price{0};
+    int value{0};
+
+    void reset(lob::Price level_price) {
+        price = level_price;
+        value = 0;
+    }
+};
+
+// Drives a 64-slot store and a std::map through the same adds and erases: a drifting
+// touch, with now and then an outlier far behind it or a jump well past it
+template<bool Descending>
+void check_against_map(std::uint64_t seed) {
+    using Compare = std::conditional_t<Descending, std::greater<lob::Price>, std::less<lob::Price>>;
+    lob::LevelStore<TestLevel, Descending, 64> store;
+    std::map<lob::Price, TestLevel*, Compare> expected;
+    std::mt19937_64 rng(seed);
+    lob::Price touch = 10'000;
+    const lob::Price behind = Descending ? -1 : 1;
+    std::size_t max_cold = 0;
+
+    for (int step = 0; step < 20'000; ++step) {
+        const std::uint64_t pick = rng() % 100;
+        if (pick < 3) {
+            touch -= behind * static_cast<lob::Price>(rng() % 200);  // Jump to better prices
+        } else if (pick < 10) {
+            touch += behind * static_cast<lob::Price>(rng() % 5);
+        }
+        if (pick < 55 || expected.empty()) {
+            const lob::Price price = pick % 7 == 0 ? touch + behind * static_cast<lob::Price>(100 + rng() % 1000)
+                                                   : touch + behind * static_cast<lob::Price>(rng() % 40);
+            if (!expected.contains(price)) {
+                TestLevel& level = store.emplace(price);
+                REQUIRE(level.price == price);
+                level.value = step;
+                expected[price] = &level;
+            }
+        } else {
+            // Mostly at the touch, so the window has to follow the best behind it
+            auto it = rng() % 2 ? expected.begin() : std::next(expected.begin(), static_cast<std::ptrdiff_t>(
+                                                         rng() % expected.size()));
+            store.erase(it->first);
+            expected.erase(it);
+        }
+        max_cold = std::max(max_cold, store.cold_size());
+
+        REQUIRE(store.size() == expected.size());
+        REQUIRE((store.best() == nullptr) == expected.empty());
+        if (!expected.empty()) {
+            REQUIRE(store.best() == expected.begin()->second);
+        }
+        if (step % 97 == 0) {
+            // Same order, and the same level objects wherever they migrated
+            auto want = expected.begin();
+            for (const TestLevel& level : store) {
+                REQUIRE(want != expected.end());
+                REQUIRE(&level == want->second);
+                ++want;
+            }
+            REQUIRE(want == expected.end());
+            for (const auto& [price, level] : expected) {
+                REQUIRE(store.find(price) == level);
+            }
+            REQUIRE(store.find(touch - behind * 1'000'000) == nullptr);
+            REQUIRE(store.find(touch + behind * 1'000'000) == nullptr);
+        }
+    }
+    REQUIRE(max_cold > 0);
+
+    store.clear();
+    REQUIRE(store.empty());
+    REQUIRE(store.begin() == store.end());
+    REQUIRE(store.emplace(5).value == 0);
+    REQUIRE(store.best()->price == 5);
+}
+
+} // namespace
+
+TEST_CASE("LevelStore - Matches an ordered map across tier migrations", "[level_store]") {
+    check_against_map<false>(1);
+    check_against_map<false>(2);
+    check_against_map<true>(3);
+    check_against_map<true>(4);
+}
@@ -0,0 +1,149 @@
+#include <catch2/catch_test_macros.hpp>
+#include "market_data.hpp"
+#include "matching_engine.hpp"
+#include <cstring>
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+constexpr std::size_t ALL_LEVELS = 1'000'000;
+
+// Overlapping price bands per side, so some orders cross, with cancels of earlier ones
+void trade_randomly(MatchingEngine& engine, OrderId& next_id, std::uint64_t& state, int orders) {
+    for (int i = 0; i < orders; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        const auto draw = static_cast<std::uint32_t>(state >> 33);
+        if (draw % 5 == 0 && next_id > 1) {
+            (void)engine.cancel_order(1 + draw % (next_id - 1));
+            continue;
+        }
+        const Side side = draw & 1 ? Side::Buy : Side::Sell;
+        const Price price = (side == Side::Buy ? 80 : 90) + static_cast<Price>(draw / 2 % 31);
+        (void)engine.submit_order(next_id++, side, OrderType::Limit, price, 1 + draw / 32 % 50);
+    }
+}
+
+std::vector<std::byte> make_packet(mdp::Channel channel, std::uint64_t sequence, std::uint64_t incremental_seq,
+                                   std::uint8_t flags, const std::vector<mdp::Entry>& entries) {
+    const mdp::PacketHeader header{
+        .sequence = sequence,
+        .incremental_seq = incremental_seq,
+        .length = static_cast<std::uint16_t>(sizeof(header) + entries.size() * sizeof(mdp::Entry)),
+        .count = static_cast<std::uint16_t>(entries.size()),
+        .channel = channel,
+        .flags = flags,
+        .reserved = {}
+    };
+    std::vector<std::byte> packet(header.length);
+    std::memcpy(packet.data(), &header, sizeof(header));
+    std::memcpy(packet.data() + sizeof(header), entries.data(), entries.size() * sizeof(mdp::Entry));
+    return packet;
+}
+
+mdp::Entry level(Side side, Price price, Quantity quantity) {
+    return {.price = price, .quantity = quantity, .type = mdp::EntryType::Level, .side = side,
+            .flags = 0, .reserved = {}};
+}
+
+} // namespace
+
+TEST_CASE("MarketDataReceiver - Snapshot sync, replay and gap recovery", "[market_data]") {
+    MarketDataReceiver receiver;
+    using mdp::Channel;
+
+    // Incrementals before any snapshot are only buffered
+    REQUIRE(receiver.handle_packet(make_packet(Channel::Incremental, 3, 0, 0, {level(Side::Buy, 100, 5)})));
+    REQUIRE(receiver.handle_packet(make_packet(Channel::Incremental, 4, 0, 0, {level(Side::Sell, 102, 7)})));
+    REQUIRE_FALSE(receiver.synced());
+
+    // A two-packet snapshot as of incremental 3: packet 3 is skipped, packet 4 replayed
+    REQUIRE(receiver.handle_packet(make_packet(Channel::Snapshot, 10, 3, mdp::SnapshotBegin,
+                                               {level(Side::Buy, 100, 5), level(Side::Buy, 99, 2)})));
+    REQUIRE_FALSE(receiver.synced());
+    REQUIRE(receiver.handle_packet(make_packet(Channel::Snapshot, 11, 3, mdp::SnapshotEnd,
+                                               {level(Side::Sell, 101, 4)})));
+    REQUIRE(receiver.synced());
+    REQUIRE(receiver.incremental_seq() == 4);
+    REQUIRE(receiver.get_levels(Side::Buy) == std::vector<std::pair<Price, Quantity>>{{100, 5}, {99, 2}});
+    REQUIRE(receiver.get_levels(Side::Sell) == std::vector<std::pair<Price, Quantity>>{{101, 4}, {102, 7}});
+
+    mdp::Entry trade = level(Side::Buy, 101, 4);
+    trade.type = mdp::EntryType::Trade;
+    REQUIRE(receiver.handle_packet(make_packet(Channel::Incremental, 5, 0, 0, {trade, level(Side::Sell, 101, 0)})));
+    REQUIRE(receiver.trades() == 1);
+    REQUIRE(receiver.get_levels(Side::Sell, 1).front().first == 102);
+
+    // Packet 6 lost: the book is held at 5 until it is retransmitted
+    REQUIRE(receiver.handle_packet(make_packet(Channel::Incremental, 7, 0, 0, {level(Side::Buy, 98, 1)})));
+    REQUIRE_FALSE(receiver.synced());
+    REQUIRE(receiver.gaps() == 1);
+    REQUIRE(receiver.missing() == std::pair<std::uint64_t, std::uint64_t>{6, 6});
+    REQUIRE(receiver.get_levels(Side::Buy).size() == 2);
+    REQUIRE(receiver.handle_packet(make_packet(Channel::Incremental, 6, 0, 0, {level(Side::Buy, 99, 0)})));
+    REQUIRE(receiver.synced());
+    REQUIRE(receiver.incremental_seq() == 7);
+    REQUIRE(receiver.get_levels(Side::Buy) == std::vector<std::pair<Price, Quantity>>{{100, 5}, {98, 1}});
+
+    // Packet 8 lost for good: the next complete snapshot resyncs
+    REQUIRE(receiver.handle_packet(make_packet(Channel::Incremental, 9, 0, 0, {level(Side::Sell, 103, 1)})));
+    REQUIRE_FALSE(receiver.synced());
+    // A snapshot whose first fragment was lost is ignored
+    REQUIRE(receiver.handle_packet(make_packet(Channel::Snapshot, 13, 8, mdp::SnapshotEnd, {})));
+    REQUIRE_FALSE(receiver.synced());
+    REQUIRE(receiver.handle_packet(make_packet(Channel::Snapshot, 14, 8, mdp::SnapshotBegin | mdp::SnapshotEnd,
+                                               {level(Side::Buy, 100, 6)})));
+    REQUIRE(receiver.synced());
+    REQUIRE(receiver.incremental_seq() == 9);
+    REQUIRE(receiver.missing() == std::nullopt);
+    REQUIRE(receiver.get_levels(Side::Buy) == std::vector<std::pair<Price, Quantity>>{{100, 6}});
+    REQUIRE(receiver.get_levels(Side::Sell) == std::vector<std::pair<Price, Quantity>>{{103, 1}});
+
+    REQUIRE_FALSE(receiver.handle_packet(std::vector<std::byte>(10)));
+}
+
+TEST_CASE("MarketDataPublisher - Late joiner rebuilds the book over loopback multicast", "[market_data]") {
+    const MarketDataOptions options{
+        .incremental_group = "239.255.77.1",
+        .incremental_port = 39101,
+        .snapshot_group = "239.255.77.2",
+        .snapshot_port = 39102,
+        .packet_size = 256  // Small packets so batches and snapshots span several
+    };
+    MatchingEngine engine;
+    auto publisher = MarketDataPublisher::create(engine, options);
+    REQUIRE(publisher != nullptr);
+
+    OrderId next_id = 1;
+    std::uint64_t state = 7;
+    trade_randomly(engine, next_id, state, 300);
+    publisher->flush();
+    REQUIRE(publisher->incremental_seq() > 10);
+
+    // Joins after the first packets went out
+    auto receiver = MarketDataReceiver::create(options);
+    if (!receiver || publisher->send_errors() != 0) {
+        SKIP("loopback multicast is unavailable here");
+    }
+    trade_randomly(engine, next_id, state, 100);
+    publisher->flush();
+    receiver->poll(std::chrono::milliseconds(100));
+    REQUIRE_FALSE(receiver->synced());
+
+    publisher->publish_snapshot();
+    REQUIRE(publisher->snapshot_seq() > 1);
+    trade_randomly(engine, next_id, state, 300);
+    publisher->flush();
+
+    for (int turn = 0; turn < 100 && receiver->incremental_seq() < publisher->incremental_seq(); ++turn) {
+        receiver->poll(std::chrono::milliseconds(10));
+    }
+    REQUIRE(receiver->synced());
+    REQUIRE(receiver->gaps() == 0);
+    REQUIRE(receiver->incremental_seq() == publisher->incremental_seq());
+    REQUIRE(receiver->trades() > 0);
+    for (Side side : {Side::Buy, Side::Sell}) {
+        REQUIRE(receiver->get_levels(side, ALL_LEVELS) == engine.get_order_book().get_levels(side, ALL_LEVELS));
+    }
+}
@@ -0,0 +1,135 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include "market_signals.hpp"
+#include "matching_engine.hpp"
+#include "seqlock.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace lob;
+using namespace std::chrono_literals;
+
+namespace {
+
+Trade make_trade(Timestamp ts, Price price, Quantity quantity, std::optional<Side> aggressor) {
+    return Trade{.buy_order_id = 1, .sell_order_id = 2, .price = price, .quantity = quantity,
+                 .timestamp = ts, .aggressor = aggressor};
+}
+
+} // namespace
+
+TEST_CASE("MarketSignals - Touch imbalance and microprice", "[market_signals]") {
+    MatchingEngine engine;
+    MarketSignals signals(1s);
+    engine.add_observer(&signals);
+
+    engine.submit_order(1, Side::Buy, OrderType::Limit, 99, 30);
+    engine.submit_order(2, Side::Sell, OrderType::Limit, 101, 10);
+    engine.submit_order(3, Side::Buy, OrderType::Limit, 98, 50);
+
+    auto snap = signals.snapshot();
+    REQUIRE(snap.sequence == 3);
+    REQUIRE(snap.best_bid == 99);
+    REQUIRE(snap.bid_quantity == 30);
+    REQUIRE(snap.best_ask == 101);
+    REQUIRE(snap.imbalance == Catch::Approx(0.5));
+    // (99 * 10 + 101 * 30) / 40
+    REQUIRE(snap.microprice == Catch::Approx(100.5));
+
+    // Emptying the touch falls back to the next level
+    REQUIRE(engine.cancel_order(1));
+    snap = signals.snapshot();
+    REQUIRE(snap.best_bid == 98);
+    REQUIRE(snap.bid_quantity == 50);
+
+    REQUIRE(engine.cancel_order(2));
+    snap = signals.snapshot();
+    REQUIRE(snap.ask_quantity == 0);
+    REQUIRE(snap.imbalance == Catch::Approx(1.0));
+    REQUIRE(snap.microprice == 0.0);
+
+    engine.remove_observer(&signals);
+    engine.submit_order(4, Side::Sell, OrderType::Limit, 105, 10);
+    REQUIRE(signals.snapshot().sequence == 5);  // Detached: the last cancel was the last message seen
+}
+
+TEST_CASE("MarketSignals - Trades feed VWAP and flow from the engine", "[market_signals]") {
+    MatchingEngine engine;
+    MarketSignals signals(1h);
+    engine.add_observer(&signals);
+
+    engine.submit_order(1, Side::Sell, OrderType::Limit, 100, 10);
+    engine.submit_order(2, Side::Sell, OrderType::Limit, 102, 10);
+    engine.submit_order(3, Side::Buy, OrderType::Limit, 102, 15);
+    engine.submit_order(4, Side::Buy, OrderType::Limit, 95, 5);
+    engine.submit_order(5, Side::Sell, OrderType::Market, 0, 5);
+
+    // Buys 10 @ 100 + 5 @ 102, then sells 5 @ 95
+    const auto snap = signals.snapshot();
+    REQUIRE(snap.window_volume == 20);
+    REQUIRE(snap.vwap == Catch::Approx((1000.0 + 510.0 + 475.0) / 20));
+    REQUIRE(snap.trade_flow_imbalance == Catch::Approx(10.0 / 20));
+    REQUIRE(snap.best_ask == 102);
+    REQUIRE(snap.ask_quantity == 5);
+    REQUIRE(snap.bid_quantity == 0);
+}
+
+TEST_CASE("MarketSignals - Rolling window eviction", "[market_signals]") {
+    MarketSignals signals(10ms, 3);
+    OrderBook book;
+
+    signals.on_trade(make_trade(Timestamp{0ms}, 100, 10, Side::Buy));
+    signals.on_trade(make_trade(Timestamp{5ms}, 110, 10, Side::Sell));
+    signals.on_message_processed(book);
+    REQUIRE(signals.snapshot().vwap == Catch::Approx(105.0));
+    REQUIRE(signals.snapshot().trade_flow_imbalance == Catch::Approx(0.0));
+
+    // The first trade falls out of the 10ms window
+    signals.on_trade(make_trade(Timestamp{12ms}, 120, 10, std::nullopt));
+    signals.on_message_processed(book);
+    REQUIRE(signals.snapshot().window_volume == 20);
+    REQUIRE(signals.snapshot().vwap == Catch::Approx(115.0));
+    REQUIRE(signals.snapshot().trade_flow_imbalance == Catch::Approx(-0.5));
+
+    // Ring capacity of 3 drops the oldest even inside the window
+    signals.on_trade(make_trade(Timestamp{13ms}, 130, 10, Side::Buy));
+    signals.on_trade(make_trade(Timestamp{14ms}, 140, 10, Side::Buy));
+    signals.on_message_processed(book);
+    REQUIRE(signals.snapshot().window_volume == 30);
+    REQUIRE(signals.snapshot().vwap == Catch::Approx(130.0));
+}
+
+TEST_CASE("SeqLock - Readers never observe a torn value", "[market_signals]") {
+    struct Pair {
+        std::uint64_t a;
+        std::uint64_t b;
+        std::uint64_t c;
+    };
+    SeqLock<Pair> lock;
+    REQUIRE(lock.sequence() == 0);
+
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (std::uint64_t i = 1; i <= 200000; ++i) {
+            lock.store(Pair{i, i * 2, i * 3});
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    std::uint64_t last = 0;
+    bool consistent = true;
+    bool monotonic = true;
+    while (!done.load(std::memory_order_acquire)) {
+        const Pair p = lock.load();
+        consistent &= p.b == p.a * 2 && p.c == p.a * 3;
+        monotonic &= p.a >= last;
+        last = p.a;
+    }
+    writer.join();
+
+    REQUIRE(consistent);
+    REQUIRE(monotonic);
+    REQUIRE(lock.load().a == 200000);
+    REQUIRE(lock.sequence() == 400000);
+}
@@ -1,5 +1,8 @@
 #include <catch2/catch_test_macros.hpp>
 #include "matching_engine.hpp"
+#include <chrono>
+#include <map>
+#include <random>
 #include <vector>
 
 TEST_CASE("MatchingEngine - Limit order matching", "[matching_engine]") {
@@ -43,7 +46,7 @@ TEST_CASE("MatchingEngine - Price-time priority", "[matching_engine]") {
     // Add multiple sell orders at same price
     engine.submit_order(1, lob::Side::Sell, lob::OrderType::Limit, 100, 5);
     engine.submit_order(2, lob::Side::Sell, lob::OrderType::Limit, 100, 3);
-    engine.submit_order(3, lob::Side::Sell, lob::OrderType::Limit, 100, 2);
+    engine.submit_order(3, lob::Side::Sell, lob::OrderType::Limit, 100, 4);
     
     // Buy order that matches all
     engine.submit_order(4, lob::Side::Buy, lob::OrderType::Limit, 100, 10);
@@ -103,6 +106,7 @@ TEST_CASE("MatchingEngine - IOC order", "[matching_engine]") {
 
 TEST_CASE("MatchingEngine - Trade generation", "[matching_engine]") {
     lob::MatchingEngine engine;
+    engine.set_keep_trades(true);
     
     engine.submit_order(1, lob::Side::Sell, lob::OrderType::Limit, 100, 10);
     engine.submit_order(2, lob::Side::Buy, lob::OrderType::Limit, 100, 5);
@@ -115,6 +119,18 @@ TEST_CASE("MatchingEngine - Trade generation", "[matching_engine]") {
     REQUIRE(trades[0].sell_order_id == 1);
 }
 
+TEST_CASE("MatchingEngine - Trades are kept only on request", "[matching_engine]") {
+    lob::MatchingEngine engine;
+    engine.submit_order(1, lob::Side::Sell, lob::OrderType::Limit, 100, 10);
+    engine.submit_order(2, lob::Side::Buy, lob::OrderType::Limit, 100, 5);
+    REQUIRE(engine.trades().empty());
+    
+    engine.set_keep_trades(true);
+    engine.submit_order(3, lob::Side::Buy, lob::OrderType::Limit, 100, 5);
+    REQUIRE(engine.trades().size() == 1);
+    REQUIRE(engine.trades()[0].buy_order_id == 3);
+}
+
 TEST_CASE("MatchingEngine - Memory management for filled orders", "[matching_engine]") {
     lob::MatchingEngine engine;
     
@@ -160,3 +176,583 @@ TEST_CASE("MatchingEngine - Partially filled orders remain in book", "[matching_
     REQUIRE(engine.get_order_book().order_count() == 1);
 }
 
+
+TEST_CASE("MatchingEngine - GTT order expires", "[matching_engine]") {
+    lob::MatchingEngine engine;
+    const lob::Timestamp start = std::chrono::duration_cast<lob::Timestamp>(
+        std::chrono::steady_clock::now().time_since_epoch());
+    const lob::Timestamp expiry = start + std::chrono::hours(1);
+    
+    auto status = engine.submit_order(1, lob::Side::Buy, lob::OrderType::Limit, 100, 10,
+                                      lob::TimeInForce::GTT, expiry);
+    REQUIRE(status == lob::OrderStatus::New);
+    REQUIRE(engine.get_order_book().pending_expiries() == 1);
+    
+    REQUIRE(engine.expire_orders(expiry - std::chrono::milliseconds(5)) == 0);
+    REQUIRE(engine.get_order_book().get_order(1) != nullptr);
+    
+    REQUIRE(engine.expire_orders(expiry) == 1);
+    REQUIRE(engine.get_order_book().get_order(1) == nullptr);
+    REQUIRE(!engine.get_order_book().best_bid().has_value());
+    
+    // Expiry in the past is rejected up front
+    status = engine.submit_order(2, lob::Side::Buy, lob::OrderType::Limit, 100, 10,
+                                 lob::TimeInForce::GTT, start);
+    REQUIRE(status == lob::OrderStatus::Rejected);
+}
+
+TEST_CASE("MatchingEngine - Cancelled or filled GTT order leaves the wheel", "[matching_engine]") {
+    lob::MatchingEngine engine;
+    const lob::Timestamp expiry = std::chrono::duration_cast<lob::Timestamp>(
+        std::chrono::steady_clock::now().time_since_epoch()) + std::chrono::hours(1);
+    
+    engine.submit_order(1, lob::Side::Sell, lob::OrderType::Limit, 100, 10,
+                        lob::TimeInForce::GTT, expiry);
+    engine.submit_order(2, lob::Side::Sell, lob::OrderType::Limit, 101, 10,
+                        lob::TimeInForce::GTT, expiry);
+    REQUIRE(engine.get_order_book().pending_expiries() == 2);
+    
+    REQUIRE(engine.cancel_order(1));
+    engine.submit_order(3, lob::Side::Buy, lob::OrderType::Limit, 101, 10);
+    REQUIRE(engine.get_order_book().pending_expiries() == 0);
+    REQUIRE(engine.expire_orders(expiry) == 0);
+}
+
+TEST_CASE("MatchingEngine - Day orders expire at session close in batches", "[matching_engine]") {
+    lob::MatchingEngine engine;
+    
+    // Day orders are rejected until a session close is configured
+    REQUIRE(engine.submit_order(1, lob::Side::Buy, lob::OrderType::Limit, 100, 10,
+                                lob::TimeInForce::Day) == lob::OrderStatus::Rejected);
+    
+    const lob::Timestamp close = std::chrono::duration_cast<lob::Timestamp>(
+        std::chrono::steady_clock::now().time_since_epoch()) + std::chrono::hours(8);
+    engine.set_session_close(close);
+    for (lob::OrderId id = 1; id <= 100; ++id) {
+        engine.submit_order(id, lob::Side::Buy, lob::OrderType::Limit, 90 + (id % 5), 10,
+                            lob::TimeInForce::Day);
+    }
+    engine.submit_order(1000, lob::Side::Buy, lob::OrderType::Limit, 90, 10);  // GTC survives
+    
+    std::size_t expired = 0;
+    while (std::size_t batch = engine.expire_orders(close, 32)) {
+        REQUIRE(batch <= 32);
+        expired += batch;
+    }
+    REQUIRE(expired == 100);
+    REQUIRE(engine.get_order_book().order_count() == 1);
+    REQUIRE(engine.get_order_book().depth_at_price(lob::Side::Buy, 90) == 10);
+}
+
+TEST_CASE("MatchingEngine - Self-trade prevention cancel newest", "[matching_engine]") {
+    lob::MatchingEngine engine;
+    engine.set_keep_trades(true);
+    engine.set_self_trade_prevention(lob::SelfTradePrevention::CancelNewest);
+    
+    engine.submit_order(1, lob::Side::Sell, lob::OrderType::Limit, 100, 5,
+                        lob::TimeInForce::GTC, {}, 7);
+    engine.submit_order(2, lob::Side::Sell, lob::OrderType::Limit, 100, 5,
+                        lob::TimeInForce::GTC, {}, 9);
+    
+    auto status = engine.submit_order(3, lob::Side::Buy, lob::OrderType::Limit, 100, 10,
+                                      lob::TimeInForce::GTC, {}, 7);
+    REQUIRE(status == lob::OrderStatus::Cancelled);
+    REQUIRE(engine.get_trades().empty());
+    REQUIRE(engine.get_order_book().get_order(1) != nullptr);
+    REQUIRE(engine.get_order_book().get_order(3) == nullptr);
+    REQUIRE(!engine.get_order_book().best_bid().has_value());
+}
+
+TEST_CASE("MatchingEngine - Self-trade prevention cancel oldest", "[matching_engine]") {
+    lob::MatchingEngine engine;
+    engine.set_keep_trades(true);
+    engine.set_self_trade_prevention(lob::SelfTradePrevention::CancelOldest);
+    
+    engine.submit_order(1, lob::Side::Sell, lob::OrderType::Limit, 100, 5,
+                        lob::TimeInForce::GTC, {}, 7);
+    engine.submit_order(2, lob::Side::Sell, lob::OrderType::Limit, 100, 5,
+                        lob::TimeInForce::GTC, {}, 9);
+    
+    auto status = engine.submit_order(3, lob::Side::Buy, lob::OrderType::Limit, 100, 10,
+                                      lob::TimeInForce::GTC, {}, 7);
+    REQUIRE(status == lob::OrderStatus::PartiallyFilled);
+    REQUIRE(engine.get_order_book().get_order(1) == nullptr);
+    
+    auto trades = engine.get_trades();
+    REQUIRE(trades.size() == 1);
+    REQUIRE(trades[0].sell_order_id == 2);
+    REQUIRE(engine.get_order_book().depth_at_price(lob::Side::Buy, 100) == 5);
+}
+
+TEST_CASE("MatchingEngine - Self-trade prevention cancel both", "[matching_engine]") {
+    lob::MatchingEngine engine;
+    engine.set_self_trade_prevention(lob::SelfTradePrevention::CancelBoth);
+    
+    engine.submit_order(1, lob::Side::Buy, lob::OrderType::Limit, 100, 5,
+                        lob::TimeInForce::GTC, {}, 7);
+    auto status = engine.submit_order(2, lob::Side::Sell, lob::OrderType::Limit, 100, 5,
+                                      lob::TimeInForce::GTC, {}, 7);
+    REQUIRE(status == lob::OrderStatus::Cancelled);
+    REQUIRE(engine.get_order_book().order_count() == 0);
+}
+
+TEST_CASE("MatchingEngine - Self-trade prevention decrement", "[matching_engine]") {
+    lob::MatchingEngine engine;
+    engine.set_keep_trades(true);
+    engine.set_self_trade_prevention(lob::SelfTradePrevention::Decrement);
+    
+    engine.submit_order(1, lob::Side::Sell, lob::OrderType::Limit, 100, 4,
+                        lob::TimeInForce::GTC, {}, 7);
+    engine.submit_order(2, lob::Side::Sell, lob::OrderType::Limit, 100, 5,
+                        lob::TimeInForce::GTC, {}, 9);
+    
+    // Decrement by 4 against order 1 (removed), then trade 5 against order 2
+    auto status = engine.submit_order(3, lob::Side::Buy, lob::OrderType::Limit, 100, 12,
+                                      lob::TimeInForce::GTC, {}, 7);
+    REQUIRE(status == lob::OrderStatus::PartiallyFilled);
+    REQUIRE(engine.get_order_book().get_order(1) == nullptr);
+    
+    const auto* buy_order = engine.get_order_book().get_order(3);
+    REQUIRE(buy_order != nullptr);
+    REQUIRE(buy_order->quantity == 8);
+    REQUIRE(buy_order->remaining() == 3);
+    REQUIRE(engine.get_order_book().depth_at_price(lob::Side::Buy, 100) == 3);
+    REQUIRE(engine.get_trades().size() == 1);
+}
+
+TEST_CASE("MatchingEngine - Untagged orders bypass self-trade prevention", "[matching_engine]") {
+    lob::MatchingEngine engine;
+    engine.set_self_trade_prevention(lob::SelfTradePrevention::CancelNewest);
+    
+    engine.submit_order(1, lob::Side::Sell, lob::OrderType::Limit, 100, 5);
+    auto status = engine.submit_order(2, lob::Side::Buy, lob::OrderType::Limit, 100, 5);
+    REQUIRE(status == lob::OrderStatus::Filled);
+}
+
+TEST_CASE("MatchingEngine - Sweep publishes one level batch", "[matching_engine]") {
+    lob::MatchingEngine engine;
+    engine.submit_order(1, lob::Side::Sell, lob::OrderType::Limit, 100, 5);
+    engine.submit_order(2, lob::Side::Sell, lob::OrderType::Limit, 100, 5);
+    engine.submit_order(3, lob::Side::Sell, lob::OrderType::Limit, 101, 5);
+    
+    std::vector<std::vector<lob::LevelUpdate>> batches;
+    engine.get_order_book().set_level_update_callback([&](std::span<const lob::LevelUpdate> updates) {
+        batches.emplace_back(updates.begin(), updates.end());
+    });
+    
+    REQUIRE(engine.submit_order(4, lob::Side::Buy, lob::OrderType::Limit, 101, 17) ==
+            lob::OrderStatus::PartiallyFilled);
+    REQUIRE(batches.size() == 1);
+    REQUIRE(batches[0].size() == 3);  // Bid 101 remainder, asks 100 and 101 removed
+    REQUIRE(batches[0][0].side == lob::Side::Buy);
+    REQUIRE(batches[0][0].quantity == 2);
+    
+    REQUIRE(engine.mass_cancel(99) == 0);
+}
+
+TEST_CASE("MatchingEngine - Auction orders rest without matching", "[matching_engine]") {
+    lob::MatchingEngine engine;
+    engine.set_keep_trades(true);
+    engine.start_auction();
+    
+    REQUIRE(engine.submit_order(1, lob::Side::Buy, lob::OrderType::Limit, 102, 10) == lob::OrderStatus::New);
+    REQUIRE(engine.submit_order(2, lob::Side::Sell, lob::OrderType::Limit, 99, 10) == lob::OrderStatus::New);
+    REQUIRE(engine.submit_order(3, lob::Side::Buy, lob::OrderType::Market, 0, 5) == lob::OrderStatus::Rejected);
+    REQUIRE(engine.get_trades().empty());
+    REQUIRE(*engine.get_order_book().best_bid() > *engine.get_order_book().best_ask());
+}
+
+TEST_CASE("MatchingEngine - Auction uncross maximizes volume", "[matching_engine]") {
+    lob::MatchingEngine engine;
+    engine.set_keep_trades(true);
+    engine.start_auction();
+    
+    // Demand: 103x5, 102x10, 100x10    Supply: 99x5, 101x10, 102x10
+    engine.submit_order(1, lob::Side::Buy, lob::OrderType::Limit, 103, 5);
+    engine.submit_order(2, lob::Side::Buy, lob::OrderType::Limit, 102, 10);
+    engine.submit_order(3, lob::Side::Buy, lob::OrderType::Limit, 100, 10);
+    engine.submit_order(4, lob::Side::Sell, lob::OrderType::Limit, 99, 5);
+    engine.submit_order(5, lob::Side::Sell, lob::OrderType::Limit, 101, 10);
+    engine.submit_order(6, lob::Side::Sell, lob::OrderType::Limit, 102, 10);
+    
+    // At 101: demand 15, supply 15 -> volume 15 (102: demand 15, supply 25)
+    auto indicative = engine.indicative_uncross();
+    REQUIRE(indicative.has_value());
+    REQUIRE(indicative->price == 101);
+    REQUIRE(indicative->volume == 15);
+    REQUIRE(indicative->imbalance == 0);
+    
+    // Indicative tracks book changes during the call period
+    engine.submit_order(7, lob::Side::Buy, lob::OrderType::Limit, 104, 10);
+    indicative = engine.indicative_uncross();
+    REQUIRE(indicative->price == 102);
+    REQUIRE(indicative->volume == 25);
+    REQUIRE(engine.cancel_order(7));
+    REQUIRE(engine.indicative_uncross()->price == 101);
+    
+    auto result = engine.uncross();
+    REQUIRE(result.has_value());
+    REQUIRE(engine.session_state() == lob::SessionState::Continuous);
+    
+    auto trades = engine.get_trades();
+    lob::Quantity volume = 0;
+    for (const auto& trade : trades) {
+        REQUIRE(trade.price == 101);
+        volume += trade.quantity;
+    }
+    REQUIRE(volume == 15);
+    REQUIRE(*engine.get_order_book().best_bid() == 100);
+    REQUIRE(*engine.get_order_book().best_ask() == 102);
+    REQUIRE(*engine.last_trade_price() == 101);
+}
+
+TEST_CASE("MatchingEngine - Auction tie broken by reference price", "[matching_engine]") {
+    lob::MatchingEngine engine;
+    engine.start_auction();
+    
+    // Volume 10 with zero surplus anywhere in [100, 104]
+    engine.submit_order(1, lob::Side::Buy, lob::OrderType::Limit, 104, 10);
+    engine.submit_order(2, lob::Side::Sell, lob::OrderType::Limit, 100, 10);
+    REQUIRE(engine.indicative_uncross()->price == 100);
+    
+    engine.set_reference_price(103);
+    REQUIRE(engine.indicative_uncross()->price == 104);
+    
+    REQUIRE(engine.uncross()->volume == 10);
+    REQUIRE(engine.get_order_book().order_count() == 0);
+}
+
+TEST_CASE("MatchingEngine - Auction follows a new reference price", "[matching_engine]") {
+    lob::MatchingEngine engine;
+    engine.start_auction();
+    engine.submit_order(1, lob::Side::Buy, lob::OrderType::Limit, 102, 10);
+    engine.submit_order(2, lob::Side::Sell, lob::OrderType::Limit, 100, 10);
+    engine.set_reference_price(100);
+    REQUIRE(engine.indicative_uncross()->price == 100);
+    
+    engine.set_reference_price(102);
+    REQUIRE(engine.indicative_uncross()->price == 102);
+    auto uncross = engine.uncross();
+    REQUIRE(uncross->price == 102);
+    REQUIRE(*engine.last_trade_price() == 102);
+}
+
+TEST_CASE("MatchingEngine - Auction ties at equal distance take the lower price", "[matching_engine]") {
+    lob::MatchingEngine engine;
+    engine.start_auction();
+    
+    // Volume 5 with surplus 3 at every level: buy surplus at 98 and 100, sell surplus at 102 and 104
+    engine.submit_order(1, lob::Side::Sell, lob::OrderType::Limit, 98, 5);
+    engine.submit_order(2, lob::Side::Buy, lob::OrderType::Limit, 100, 3);
+    engine.submit_order(3, lob::Side::Sell, lob::OrderType::Limit, 102, 3);
+    engine.submit_order(4, lob::Side::Buy, lob::OrderType::Limit, 104, 5);
+    REQUIRE(engine.indicative_uncross()->price == 98);
+    
+    engine.set_reference_price(101);
+    auto indicative = engine.indicative_uncross();
+    REQUIRE(indicative->price == 100);
+    REQUIRE(indicative->volume == 5);
+    REQUIRE(indicative->imbalance == 3);
+    
+    engine.set_reference_price(103);
+    indicative = engine.indicative_uncross();
+    REQUIRE(indicative->price == 102);
+    REQUIRE(indicative->imbalance == -3);
+}
+
+TEST_CASE("MatchingEngine - Auction equilibrium at either end of the crossing range", "[matching_engine]") {
+    lob::MatchingEngine at_ask;
+    at_ask.start_auction();
+    // At 100: demand 4, supply 3; at 101: demand 2, supply 3
+    at_ask.submit_order(1, lob::Side::Sell, lob::OrderType::Limit, 100, 3);
+    at_ask.submit_order(2, lob::Side::Buy, lob::OrderType::Limit, 100, 2);
+    at_ask.submit_order(3, lob::Side::Buy, lob::OrderType::Limit, 101, 2);
+    REQUIRE(at_ask.indicative_uncross()->price == 100);
+    REQUIRE(at_ask.indicative_uncross()->volume == 3);
+    
+    lob::MatchingEngine at_bid;
+    at_bid.start_auction();
+    // At 100: demand 3, supply 2; at 101: demand 3, supply 4
+    at_bid.submit_order(1, lob::Side::Buy, lob::OrderType::Limit, 101, 3);
+    at_bid.submit_order(2, lob::Side::Sell, lob::OrderType::Limit, 101, 2);
+    at_bid.submit_order(3, lob::Side::Sell, lob::OrderType::Limit, 100, 2);
+    REQUIRE(at_bid.indicative_uncross()->price == 101);
+    REQUIRE(at_bid.indicative_uncross()->volume == 3);
+    REQUIRE(at_bid.indicative_uncross()->imbalance == -1);
+}
+
+TEST_CASE("MatchingEngine - Auction without cross", "[matching_engine]") {
+    lob::MatchingEngine engine;
+    engine.start_auction();
+    engine.submit_order(1, lob::Side::Buy, lob::OrderType::Limit, 99, 10);
+    engine.submit_order(2, lob::Side::Sell, lob::OrderType::Limit, 100, 10);
+    
+    REQUIRE(!engine.indicative_uncross().has_value());
+    REQUIRE(!engine.uncross().has_value());
+    REQUIRE(engine.session_state() == lob::SessionState::Continuous);
+    REQUIRE(engine.get_order_book().order_count() == 2);
+}
+
+namespace {
+
+// The uncross by definition: every level price in the crossing range, best by volume,
+// then surplus, then distance to reference, then lower price
+std::optional<lob::AuctionUncross> uncross_by_definition(const lob::OrderBook& book,
+                                                        std::optional<lob::Price> reference) {
+    const auto best_bid = book.best_bid();
+    const auto best_ask = book.best_ask();
+    if (!best_bid || !best_ask || *best_bid < *best_ask) {
+        return std::nullopt;
+    }
+    std::map<lob::Price, std::pair<lob::Quantity, lob::Quantity>> levels;  // Bid, ask
+    book.for_each_level(lob::Side::Buy, SIZE_MAX, [&](lob::Price price, lob::Quantity quantity) {
+        levels[price].first = quantity;
+    });
+    book.for_each_level(lob::Side::Sell, SIZE_MAX, [&](lob::Price price, lob::Quantity quantity) {
+        levels[price].second = quantity;
+    });
+    std::optional<lob::AuctionUncross> best;
+    lob::Quantity best_surplus = 0;
+    for (auto it = levels.lower_bound(*best_ask); it != levels.end() && it->first <= *best_bid; ++it) {
+        lob::Quantity demand = 0;
+        lob::Quantity supply = 0;
+        for (const auto& [price, quantities] : levels) {
+            demand += price >= it->first ? quantities.first : 0;
+            supply += price <= it->first ? quantities.second : 0;
+        }
+        const lob::Quantity volume = std::min(demand, supply);
+        const lob::Quantity surplus = demand > supply ? demand - supply : supply - demand;
+        auto distance = [&](lob::Price price) { return reference ? std::abs(price - *reference) : 0; };
+        if (!best || volume > best->volume ||
+            (volume == best->volume && (surplus < best_surplus ||
+                                        (surplus == best_surplus && distance(it->first) < distance(best->price))))) {
+            best = lob::AuctionUncross{it->first, volume,
+                                       static_cast<std::int64_t>(demand) - static_cast<std::int64_t>(supply)};
+            best_surplus = surplus;
+        }
+    }
+    return best && best->volume > 0 ? best : std::nullopt;
+}
+
+} // namespace
+
+TEST_CASE("MatchingEngine - Indicative uncross follows the book through the call period", "[matching_engine]") {
+    std::mt19937_64 rng(7);
+    for (int round = 0; round < 4; ++round) {
+        lob::MatchingEngine engine;
+        engine.start_auction();
+        std::optional<lob::Price> reference;
+        if (round % 2 == 1) {
+            reference = 1'000;
+            engine.set_reference_price(*reference);
+        }
+        std::vector<lob::OrderId> live;
+        lob::OrderId next_id = 1;
+        lob::OrderId outlier = 0;
+        lob::Price centre = 1'000;
+        for (int step = 0; step < 3'000; ++step) {
+            const std::uint64_t pick = rng() % 100;
+            if (outlier != 0 && pick < 50) {
+                REQUIRE(engine.cancel_order(outlier));
+                outlier = 0;
+            }
+            if (pick < 2) {
+                centre += static_cast<lob::Price>(rng() % 6'001) - 3'000;  // Leaves the curves' window
+            }
+            if (reference && step % 20 == 0) {
+                reference = centre + static_cast<lob::Price>(rng() % 21) - 10;
+                engine.set_reference_price(*reference);
+            }
+            if (pick < 60 || live.empty()) {
+                const bool buy = rng() % 2 == 0;
+                const lob::Price width = round < 2 ? 20 : 3;  // Later rounds pile orders onto few levels
+                lob::Price price = centre + static_cast<lob::Price>(rng() % (2 * width + 1)) - width;
+                const bool wide = pick == 2 && outlier == 0;
+                if (wide) {
+                    price += buy ? 200'000 : -200'000;  // Crossing range wider than the window
+                }
+                const lob::Quantity quantity = 1 + rng() % (pick < 30 ? 3 : 20);
+                REQUIRE(engine.submit_order(next_id, buy ? lob::Side::Buy : lob::Side::Sell,
+                                            lob::OrderType::Limit, price, quantity) == lob::OrderStatus::New);
+                (wide ? outlier : live.emplace_back()) = next_id++;
+            } else {
+                const std::size_t index = rng() % live.size();
+                const lob::OrderId id = live[index];
+                if (pick < 85) {
+                    REQUIRE(engine.cancel_order(id));
+                    live[index] = live.back();
+                    live.pop_back();
+                } else {
+                    const lob::Order* order = engine.get_order_book().get_order(id);
+                    REQUIRE(engine.modify_order(id, order->price + static_cast<lob::Price>(rng() % 5) - 2,
+                                                1 + rng() % 20));
+                }
+            }
+            if (step % 3 == 0) {
+                const auto expected = uncross_by_definition(engine.get_order_book(), reference);
+                const auto actual = engine.indicative_uncross();
+                REQUIRE(actual.has_value() == expected.has_value());
+                if (expected) {
+                    REQUIRE(actual->price == expected->price);
+                    REQUIRE(actual->volume == expected->volume);
+                    REQUIRE(actual->imbalance == expected->imbalance);
+                }
+            }
+        }
+        const auto expected = uncross_by_definition(engine.get_order_book(), reference);
+        const auto result = engine.uncross();
+        REQUIRE(result.has_value() == expected.has_value());
+        if (expected) {
+            REQUIRE(result->price == expected->price);
+        }
+    }
+}
+
+TEST_CASE("MatchingEngine - Pro-rata allocation with minimum lot", "[matching_engine]") {
+    lob::ProRataMatchingEngine engine(nullptr, lob::ProRataAllocation{.min_lot = 6});
+    engine.set_keep_trades(true);
+    
+    engine.submit_order(1, lob::Side::Sell, lob::OrderType::Limit, 100, 60);
+    engine.submit_order(2, lob::Side::Sell, lob::OrderType::Limit, 100, 30);
+    engine.submit_order(3, lob::Side::Sell, lob::OrderType::Limit, 100, 10);
+    
+    // Shares 30/15/5; the 5 is below the minimum lot and goes to the oldest order
+    REQUIRE(engine.submit_order(4, lob::Side::Buy, lob::OrderType::Limit, 100, 50) ==
+            lob::OrderStatus::Filled);
+    REQUIRE(engine.get_order_book().get_order(1)->filled_quantity == 35);
+    REQUIRE(engine.get_order_book().get_order(2)->filled_quantity == 15);
+    REQUIRE(engine.get_order_book().get_order(3)->filled_quantity == 0);
+    REQUIRE(engine.get_order_book().depth_at_price(lob::Side::Sell, 100) == 50);
+    REQUIRE(engine.get_trades().size() == 2);
+}
+
+TEST_CASE("MatchingEngine - Pro-rata sweeps full levels", "[matching_engine]") {
+    lob::ProRataMatchingEngine engine;
+    
+    engine.submit_order(1, lob::Side::Buy, lob::OrderType::Limit, 101, 10);
+    engine.submit_order(2, lob::Side::Buy, lob::OrderType::Limit, 101, 30);
+    engine.submit_order(3, lob::Side::Buy, lob::OrderType::Limit, 100, 30);
+    engine.submit_order(4, lob::Side::Buy, lob::OrderType::Limit, 100, 10);
+    
+    // Clears 101, then 20 of 40 at 100 split 15/5
+    REQUIRE(engine.submit_order(5, lob::Side::Sell, lob::OrderType::Limit, 100, 60) ==
+            lob::OrderStatus::Filled);
+    REQUIRE(engine.get_order_book().get_order(1) == nullptr);
+    REQUIRE(engine.get_order_book().get_order(2) == nullptr);
+    REQUIRE(engine.get_order_book().get_order(3)->filled_quantity == 15);
+    REQUIRE(engine.get_order_book().get_order(4)->filled_quantity == 5);
+}
+
+TEST_CASE("MatchingEngine - Top order then pro-rata allocation", "[matching_engine]") {
+    lob::TopOrderProRataMatchingEngine engine;
+    
+    engine.submit_order(1, lob::Side::Sell, lob::OrderType::Limit, 100, 20);
+    engine.submit_order(2, lob::Side::Sell, lob::OrderType::Limit, 100, 60);
+    engine.submit_order(3, lob::Side::Sell, lob::OrderType::Limit, 100, 20);
+    
+    // Top order takes 20, remaining 40 is split 30/10
+    REQUIRE(engine.submit_order(4, lob::Side::Buy, lob::OrderType::Limit, 100, 60) ==
+            lob::OrderStatus::Filled);
+    REQUIRE(engine.get_order_book().get_order(1) == nullptr);
+    REQUIRE(engine.get_order_book().get_order(2)->filled_quantity == 30);
+    REQUIRE(engine.get_order_book().get_order(3)->filled_quantity == 10);
+}
+
+TEST_CASE("MatchingEngine - Queue position tracks fills", "[matching_engine]") {
+    lob::MatchingEngine engine;
+    
+    engine.submit_order(1, lob::Side::Buy, lob::OrderType::Limit, 100, 30);
+    engine.submit_order(2, lob::Side::Buy, lob::OrderType::Limit, 100, 20);
+    engine.submit_order(3, lob::Side::Buy, lob::OrderType::Limit, 100, 10);
+    REQUIRE(engine.get_order_book().queue_position(3)->quantity_ahead == 50);
+    
+    // Fills at the head of the queue move everyone up
+    engine.submit_order(4, lob::Side::Sell, lob::OrderType::Limit, 100, 35);
+    REQUIRE(engine.get_order_book().queue_position(2)->quantity_ahead == 0);
+    REQUIRE(engine.get_order_book().queue_position(3)->quantity_ahead == 15);
+    REQUIRE(engine.get_order_book().queue_position(3)->level_quantity == 25);
+}
+
+TEST_CASE("MatchingEngine - Queue position under pro-rata fills", "[matching_engine]") {
+    lob::ProRataMatchingEngine engine;
+    
+    engine.submit_order(1, lob::Side::Sell, lob::OrderType::Limit, 100, 60);
+    engine.submit_order(2, lob::Side::Sell, lob::OrderType::Limit, 100, 30);
+    engine.submit_order(3, lob::Side::Sell, lob::OrderType::Limit, 100, 10);
+    
+    // 50 split 30/15/5 fills behind the head as well
+    engine.submit_order(4, lob::Side::Buy, lob::OrderType::Limit, 100, 50);
+    REQUIRE(engine.get_order_book().queue_position(2)->quantity_ahead == 30);
+    REQUIRE(engine.get_order_book().queue_position(3)->quantity_ahead == 45);
+}
+
+TEST_CASE("MatchingEngine - Replayed commands give the same state hash", "[matching_engine]") {
+    lob::MatchingEngine primary;
+    lob::MatchingEngine replica;
+    
+    // Crossing bands, modifies and cancels, applied to both engines
+    std::uint64_t state = 7;
+    for (lob::OrderId id = 1; id <= 2000; ++id) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        const auto draw = static_cast<std::uint32_t>(state >> 33);
+        const lob::Side side = draw & 1 ? lob::Side::Buy : lob::Side::Sell;
+        const lob::Price price = (side == lob::Side::Buy ? 80 : 90) + static_cast<lob::Price>(draw / 2 % 31);
+        for (lob::MatchingEngine* engine : {&primary, &replica}) {
+            if (draw % 7 == 0) {
+                (void)engine->cancel_order(1 + draw % id);
+            } else if (draw % 7 == 1) {
+                (void)engine->modify_order(1 + draw % id, price, 1 + draw / 64 % 40);
+            }
+            (void)engine->submit_order(id, side, lob::OrderType::Limit, price, 1 + draw / 32 % 50);
+        }
+        REQUIRE(primary.get_order_book().state_hash() == replica.get_order_book().state_hash());
+    }
+    REQUIRE(primary.get_order_book().state_hash() != 0);
+    
+    // A single fill on one side only is caught, and localized to its level
+    const lob::Price best = replica.get_order_book().top_level(lob::Side::Sell)->first;
+    (void)replica.submit_order(9999, lob::Side::Buy, lob::OrderType::IOC, best, 1);
+    REQUIRE(primary.get_order_book().state_hash() != replica.get_order_book().state_hash());
+    REQUIRE(primary.get_order_book().level_hash(lob::Side::Sell, best) !=
+            replica.get_order_book().level_hash(lob::Side::Sell, best));
+    REQUIRE(primary.get_order_book().level_hash(lob::Side::Sell, best + 1) ==
+            replica.get_order_book().level_hash(lob::Side::Sell, best + 1));
+    
+    // Incremental updates never drift: an emptied book hashes to zero
+    for (lob::OrderId id = 1; id <= 2000; ++id) {
+        (void)replica.cancel_order(id);
+    }
+    REQUIRE(replica.get_order_book().order_count() == 0);
+    REQUIRE(replica.get_order_book().state_hash() == 0);
+}
+
+TEST_CASE("MatchingEngine - Restoring a for_each_order walk rebuilds the book", "[matching_engine]") {
+    lob::MatchingEngine engine;
+    REQUIRE(engine.submit_order(1, lob::Side::Sell, lob::OrderType::Limit, 101, 10) == lob::OrderStatus::New);
+    REQUIRE(engine.submit_order(2, lob::Side::Sell, lob::OrderType::Limit, 101, 5) == lob::OrderStatus::New);
+    REQUIRE(engine.submit_order(3, lob::Side::Buy, lob::OrderType::Limit, 99, 8) == lob::OrderStatus::New);
+    REQUIRE(engine.submit_order(4, lob::Side::Buy, lob::OrderType::Limit, 101, 4) == lob::OrderStatus::Filled);
+    REQUIRE(engine.cancel_order(3));
+    REQUIRE(engine.submit_order(5, lob::Side::Buy, lob::OrderType::Limit, 98, 8) == lob::OrderStatus::New);
+    const lob::OrderBook& source = engine.get_order_book();
+    
+    lob::OrderBook copy;
+    std::vector<lob::OrderId> walk;
+    source.for_each_order([&copy, &walk](const lob::Order& order) {
+        walk.push_back(order.id);
+        REQUIRE(copy.restore_order(order));
+    });
+    copy.set_next_arrival(source.next_arrival());
+    REQUIRE(walk == std::vector<lob::OrderId>{5, 1, 2});  // Bids, then asks in queue order
+    REQUIRE(copy.state_hash() == source.state_hash());
+    REQUIRE(copy.get_order(1)->quantity == 10);
+    REQUIRE(copy.get_order(1)->filled_quantity == 4);
+    REQUIRE(copy.depth_at_price(lob::Side::Sell, 101) == 11);
+    REQUIRE(copy.queue_position(2)->quantity_ahead == 6);
+    
+    // Both books go on the same way
+    REQUIRE(copy.add_order(6, lob::Side::Sell, lob::OrderType::Limit, 101, 1));
+    REQUIRE(engine.submit_order(6, lob::Side::Sell, lob::OrderType::Limit, 101, 1) == lob::OrderStatus::New);
+    REQUIRE(copy.state_hash() == source.state_hash());
+    REQUIRE_FALSE(copy.restore_order(*source.get_order(6)));  // Already there
+}
@@ -1,4 +1,5 @@
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
 #include "order_book.hpp"
 #include <vector>
 
@@ -99,3 +100,245 @@ TEST_CASE("OrderBook - Market depth", "[order_book]") {
     REQUIRE(book.depth_at_price(lob::Side::Buy, 98) == 0);
 }
 
+
+TEST_CASE("OrderBook - Mass cancel by participant", "[order_book]") {
+    lob::OrderBook book;
+    
+    REQUIRE(book.add_order(1, lob::Side::Buy, lob::OrderType::Limit, 100, 10, lob::TimeInForce::GTC, {}, 7));
+    REQUIRE(book.add_order(2, lob::Side::Buy, lob::OrderType::Limit, 99, 10, lob::TimeInForce::GTC, {}, 7));
+    REQUIRE(book.add_order(3, lob::Side::Sell, lob::OrderType::Limit, 105, 10, lob::TimeInForce::GTC, {}, 7));
+    REQUIRE(book.add_order(4, lob::Side::Buy, lob::OrderType::Limit, 100, 5, lob::TimeInForce::GTC, {}, 9));
+    
+    REQUIRE(book.cancel_all(7) == 3);
+    REQUIRE(book.order_count() == 1);
+    REQUIRE(book.get_order(4) != nullptr);
+    REQUIRE(book.depth_at_price(lob::Side::Buy, 100) == 5);
+    REQUIRE(!book.best_ask().has_value());
+    
+    REQUIRE(book.cancel_all(7) == 0);
+    REQUIRE(book.cancel_all(42) == 0);
+}
+
+TEST_CASE("OrderBook - Mass cancel by side and price range", "[order_book]") {
+    lob::OrderBook book;
+    
+    for (lob::OrderId id = 1; id <= 10; ++id) {
+        REQUIRE(book.add_order(id, lob::Side::Buy, lob::OrderType::Limit, 90 + static_cast<lob::Price>(id), 1,
+                               lob::TimeInForce::GTC, {}, 7));
+        REQUIRE(book.add_order(100 + id, lob::Side::Sell, lob::OrderType::Limit, 110 + static_cast<lob::Price>(id), 1,
+                               lob::TimeInForce::GTC, {}, 7));
+    }
+    
+    REQUIRE(book.cancel_price_range(7, lob::Side::Buy, 95, 97) == 3);
+    REQUIRE(book.depth_at_price(lob::Side::Buy, 96) == 0);
+    REQUIRE(book.depth_at_price(lob::Side::Buy, 94) == 1);
+    
+    REQUIRE(book.cancel_side(7, lob::Side::Sell) == 10);
+    REQUIRE(!book.best_ask().has_value());
+    REQUIRE(book.order_count() == 7);
+    
+    // A cancelled order no longer shows up in its participant's list
+    REQUIRE(book.cancel_order(1));
+    REQUIRE(book.cancel_all(7) == 6);
+    REQUIRE(book.order_count() == 0);
+}
+
+TEST_CASE("OrderBook - Mass cancel emits one coalesced level batch", "[order_book]") {
+    lob::OrderBook book;
+    
+    for (lob::OrderId id = 1; id <= 6; ++id) {
+        REQUIRE(book.add_order(id, lob::Side::Buy, lob::OrderType::Limit, 100 + static_cast<lob::Price>(id % 2), 10,
+                               lob::TimeInForce::GTC, {}, 7));
+    }
+    REQUIRE(book.add_order(7, lob::Side::Buy, lob::OrderType::Limit, 100, 10, lob::TimeInForce::GTC, {}, 9));
+    
+    std::vector<std::vector<lob::LevelUpdate>> batches;
+    book.set_level_update_callback([&](std::span<const lob::LevelUpdate> updates) {
+        batches.emplace_back(updates.begin(), updates.end());
+    });
+    
+    REQUIRE(book.cancel_all(7) == 6);
+    REQUIRE(batches.size() == 1);
+    REQUIRE(batches[0].size() == 2);  // One entry per touched level
+    for (const auto& update : batches[0]) {
+        REQUIRE(update.side == lob::Side::Buy);
+        REQUIRE(update.quantity == (update.price == 100 ? 10u : 0u));
+    }
+}
+
+TEST_CASE("OrderBook - Queue position", "[order_book]") {
+    lob::OrderBook book;
+    
+    REQUIRE_FALSE(book.queue_position(1).has_value());
+    for (lob::OrderId id = 1; id <= 4; ++id) {
+        REQUIRE(book.add_order(id, lob::Side::Sell, lob::OrderType::Limit, 100, id * 10));
+    }
+    
+    REQUIRE(book.queue_position(1)->quantity_ahead == 0);
+    REQUIRE(book.queue_position(4)->quantity_ahead == 60);
+    REQUIRE(book.queue_position(4)->level_quantity == 100);
+    
+    // Cancels ahead move the order up; a quantity increase keeps priority
+    REQUIRE(book.cancel_order(2));
+    REQUIRE(book.queue_position(4)->quantity_ahead == 40);
+    REQUIRE(book.modify_order(1, 100, 15));
+    REQUIRE(book.queue_position(4)->quantity_ahead == 45);
+    
+    // A price change loses priority
+    REQUIRE(book.modify_order(3, 101, 30));
+    REQUIRE(book.modify_order(3, 100, 30));
+    REQUIRE(book.queue_position(3)->quantity_ahead == 55);
+    REQUIRE(book.queue_position(4)->quantity_ahead == 15);
+}
+
+TEST_CASE("OrderBook - Queue position survives slot compaction", "[order_book]") {
+    lob::OrderBook book;
+    
+    // Churn far past the initial slot capacity while one order keeps its place
+    REQUIRE(book.add_order(1, lob::Side::Buy, lob::OrderType::Limit, 100, 7));
+    lob::OrderId id = 2;
+    for (int round = 0; round < 200; ++round) {
+        REQUIRE(book.add_order(id, lob::Side::Buy, lob::OrderType::Limit, 100, 5));
+        REQUIRE(book.add_order(id + 1, lob::Side::Buy, lob::OrderType::Limit, 100, 3));
+        REQUIRE(book.cancel_order(id));
+        id += 2;
+    }
+    
+    // 200 survivors of quantity 3 behind order 1
+    REQUIRE(book.queue_position(1)->quantity_ahead == 0);
+    REQUIRE(book.queue_position(id - 1)->quantity_ahead == 7 + 199 * 3);
+    REQUIRE(book.queue_position(id - 1)->level_quantity == 7 + 200 * 3);
+}
+
+TEST_CASE("OrderBook - Sweep cost by quantity", "[order_book]") {
+    lob::OrderBook book;
+    
+    REQUIRE(book.add_order(1, lob::Side::Sell, lob::OrderType::Limit, 100, 10));
+    REQUIRE(book.add_order(2, lob::Side::Sell, lob::OrderType::Limit, 101, 20));
+    REQUIRE(book.add_order(3, lob::Side::Sell, lob::OrderType::Limit, 103, 30));
+    REQUIRE(book.add_order(4, lob::Side::Buy, lob::OrderType::Limit, 99, 5));
+    
+    // 10 @ 100 + 20 @ 101 + 5 @ 103
+    auto cost = book.sweep_cost(lob::Side::Buy, 35);
+    REQUIRE(cost.complete);
+    REQUIRE(cost.quantity == 35);
+    REQUIRE(cost.notional == 1000 + 2020 + 515);
+    REQUIRE(cost.last_price == 103);
+    REQUIRE(cost.levels == 3);
+    REQUIRE(cost.average_price() == Catch::Approx(3535.0 / 35));
+    
+    // Exactly one full level
+    cost = book.sweep_cost(lob::Side::Buy, 10);
+    REQUIRE(cost.complete);
+    REQUIRE(cost.levels == 1);
+    REQUIRE(cost.last_price == 100);
+    
+    // More than the book holds
+    cost = book.sweep_cost(lob::Side::Sell, 8);
+    REQUIRE_FALSE(cost.complete);
+    REQUIRE(cost.quantity == 5);
+    REQUIRE(cost.last_price == 99);
+    
+    REQUIRE(book.sweep_cost(lob::Side::Sell, 0).quantity == 0);
+}
+
+TEST_CASE("OrderBook - Sweep cost by notional", "[order_book]") {
+    lob::OrderBook book;
+    
+    REQUIRE(book.add_order(1, lob::Side::Sell, lob::OrderType::Limit, 100, 10));
+    REQUIRE(book.add_order(2, lob::Side::Sell, lob::OrderType::Limit, 101, 20));
+    
+    // 1000 buys the first level, the remaining 550 buys 5 @ 101
+    auto cost = book.sweep_cost_notional(lob::Side::Buy, 1550);
+    REQUIRE(cost.quantity == 15);
+    REQUIRE(cost.notional == 1505);
+    REQUIRE(cost.last_price == 101);
+    REQUIRE(cost.levels == 2);
+    REQUIRE(cost.complete);
+    
+    cost = book.sweep_cost_notional(lob::Side::Buy, 1000000);
+    REQUIRE(cost.quantity == 30);
+    REQUIRE_FALSE(cost.complete);
+}
+
+TEST_CASE("OrderBook - State hash tracks resting orders and priority", "[order_book]") {
+    lob::OrderBook a;
+    lob::OrderBook b;
+    REQUIRE(a.state_hash() == 0);
+    
+    for (lob::OrderBook* book : {&a, &b}) {
+        REQUIRE(book->add_order(1, lob::Side::Buy, lob::OrderType::Limit, 100, 10));
+        REQUIRE(book->add_order(2, lob::Side::Buy, lob::OrderType::Limit, 100, 10));
+        REQUIRE(book->add_order(3, lob::Side::Sell, lob::OrderType::Limit, 105, 7));
+    }
+    REQUIRE(a.state_hash() != 0);
+    REQUIRE(a.state_hash() == b.state_hash());
+    REQUIRE(a.level_hash(lob::Side::Buy, 100) != 0);
+    REQUIRE(a.level_hash(lob::Side::Buy, 99) == 0);
+    
+    // A cancelled order leaves no trace
+    const std::uint64_t before = b.state_hash();
+    REQUIRE(b.add_order(4, lob::Side::Sell, lob::OrderType::Limit, 106, 1));
+    REQUIRE(b.state_hash() != before);
+    REQUIRE(b.cancel_order(4));
+    REQUIRE(b.state_hash() == before);
+    
+    // Same levels, but order 1 lost its place in the queue
+    REQUIRE(b.modify_order(1, 101, 10));
+    REQUIRE(b.modify_order(1, 100, 10));
+    REQUIRE(b.get_levels(lob::Side::Buy) == a.get_levels(lob::Side::Buy));
+    REQUIRE(b.state_hash() != a.state_hash());
+    REQUIRE(b.level_hash(lob::Side::Buy, 100) != a.level_hash(lob::Side::Buy, 100));
+    REQUIRE(b.level_hash(lob::Side::Sell, 105) == a.level_hash(lob::Side::Sell, 105));
+    
+    // Growing in place keeps priority
+    lob::OrderBook c;
+    REQUIRE(c.add_order(1, lob::Side::Buy, lob::OrderType::Limit, 100, 10));
+    REQUIRE(c.add_order(2, lob::Side::Buy, lob::OrderType::Limit, 100, 12));
+    REQUIRE(c.add_order(3, lob::Side::Sell, lob::OrderType::Limit, 105, 7));
+    REQUIRE(a.modify_order(2, 100, 12));
+    REQUIRE(a.state_hash() == c.state_hash());
+    
+    a.clear();
+    REQUIRE(a.state_hash() == 0);
+}
+
+TEST_CASE("OrderBook - Levels far from the touch behave like near ones", "[order_book]") {
+    // Prices tens of thousands of ticks apart, beyond any window around the touch
+    lob::OrderBook book;
+    REQUIRE(book.add_order(1, lob::Side::Buy, lob::OrderType::Limit, 100'000, 10));
+    REQUIRE(book.add_order(2, lob::Side::Buy, lob::OrderType::Limit, 60'000, 20));
+    REQUIRE(book.add_order(3, lob::Side::Buy, lob::OrderType::Limit, 60'000, 5));
+    REQUIRE(book.add_order(4, lob::Side::Sell, lob::OrderType::Limit, 100'010, 7));
+    REQUIRE(book.add_order(5, lob::Side::Sell, lob::OrderType::Limit, 190'000, 9));
+    REQUIRE(book.depth_at_price(lob::Side::Buy, 60'000) == 25);
+    REQUIRE(book.queue_position(3)->quantity_ahead == 20);
+    REQUIRE(book.get_levels(lob::Side::Buy) ==
+            std::vector<std::pair<lob::Price, lob::Quantity>>{{100'000, 10}, {60'000, 25}});
+    
+    // The touch leaves and the far level becomes the best
+    REQUIRE(book.cancel_order(1));
+    REQUIRE(book.best_bid() == 60'000);
+    REQUIRE(book.add_order(6, lob::Side::Buy, lob::OrderType::Limit, 60'000, 1));
+    REQUIRE(book.queue_position(6)->quantity_ahead == 25);
+    
+    // A much better price arrives and the old best falls far behind it
+    REQUIRE(book.add_order(7, lob::Side::Buy, lob::OrderType::Limit, 140'000, 4));
+    REQUIRE(book.cancel_order(4));
+    REQUIRE(book.add_order(8, lob::Side::Sell, lob::OrderType::Limit, 140'001, 2));
+    REQUIRE(book.top_level(lob::Side::Buy) == std::pair<lob::Price, lob::Quantity>{140'000, 4});
+    REQUIRE(book.get_levels(lob::Side::Sell) ==
+            std::vector<std::pair<lob::Price, lob::Quantity>>{{140'001, 2}, {190'000, 9}});
+    REQUIRE(book.queue_position(3)->quantity_ahead == 20);
+    
+    std::vector<lob::OrderId> walk;
+    book.for_each_order([&](const lob::Order& order) { walk.push_back(order.id); });
+    REQUIRE(walk == std::vector<lob::OrderId>{7, 2, 3, 6, 8, 5});
+    
+    // Same resting orders added straight into a fresh book hash the same
+    lob::OrderBook fresh;
+    book.for_each_order([&](const lob::Order& order) { REQUIRE(fresh.restore_order(order)); });
+    fresh.set_next_arrival(book.next_arrival());
+    REQUIRE(fresh.state_hash() == book.state_hash());
+    REQUIRE(fresh.sweep_cost(lob::Side::Buy, 11).notional == book.sweep_cost(lob::Side::Buy, 11).notional);
+}
@@ -0,0 +1,226 @@
+#include <catch2/catch_test_macros.hpp>
+#include "gateway_test_helpers.hpp"
+#include "matching_engine.hpp"
+#include "replication.hpp"
+#include "tcp_gateway.hpp"
+#include <chrono>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace lob;
+using namespace lob::test;
+using namespace std::chrono_literals;
+
+namespace {
+
+std::string socket_path() {
+    return "/tmp/lob_replication_test_" + std::to_string(::getpid()) + ".sock";
+}
+
+} // namespace
+
+TEST_CASE("Replication - Reports are held until the backup acks", "[replication]") {
+    MatchingEngine engine;
+    MatchingEngine backup_engine;
+    auto gateway = TcpGateway::create(engine, 0, 4);
+    auto primary = ReplicationPrimary::create(socket_path());
+    REQUIRE(gateway);
+    REQUIRE(primary);
+    REQUIRE_FALSE(gateway->set_replication(primary.get()));  // No backup yet
+    auto backup = ReplicationBackup::connect(backup_engine, socket_path());
+    REQUIRE(backup);
+    REQUIRE(primary->accept_backup(1s));
+    REQUIRE(gateway->set_replication(primary.get()));
+
+    auto client = TcpOrderClient::connect("127.0.0.1", gateway->port());
+    REQUIRE(client);
+    client->send(new_order(1, Side::Sell, 101, 10));
+    client->send(new_order(2, Side::Buy, 99, 10));
+    REQUIRE(client->flush());
+    for (int i = 0; i < 200 && primary->replicated() < 2; ++i) {
+        gateway->poll(5ms);
+    }
+    REQUIRE(engine.get_order_book().order_count() == 2);
+
+    // Executed on the primary, but the backup has not applied them yet
+    ExecutionReport report;
+    gateway->poll(5ms);
+    REQUIRE_FALSE(client->receive(report, 20ms));
+    REQUIRE(primary->acked() == 0);
+
+    REQUIRE(backup->poll(1s) == 2);
+    REQUIRE(backup->applied() == 2);
+    REQUIRE(receive(*gateway, *client, report));
+    REQUIRE(report.client_seq == 1);
+    REQUIRE(receive(*gateway, *client, report));
+    REQUIRE(report.client_seq == 2);
+    REQUIRE(primary->acked() == 2);
+    REQUIRE(backup_engine.get_order_book().order_count() == 2);
+
+    gateway->set_replication(nullptr);
+}
+
+TEST_CASE("Replication - Backup takes over after the primary fails", "[replication]") {
+    MatchingEngine engine;
+    MatchingEngine backup_engine;
+    auto gateway = TcpGateway::create(engine, 0, 4);
+    auto primary = ReplicationPrimary::create(socket_path());
+    REQUIRE(gateway);
+    REQUIRE(primary);
+    auto backup = ReplicationBackup::connect(backup_engine, socket_path());
+    REQUIRE(backup);
+    REQUIRE(primary->accept_backup(1s));
+    REQUIRE(gateway->set_replication(primary.get()));
+
+    std::thread replica([&backup] {
+        while (!backup->primary_lost()) {
+            backup->poll(10ms);
+        }
+    });
+
+    auto maker = TcpOrderClient::connect("127.0.0.1", gateway->port());  // Participant 1
+    auto taker = TcpOrderClient::connect("127.0.0.1", gateway->port());
+    auto leaver = TcpOrderClient::connect("127.0.0.1", gateway->port());
+    REQUIRE(maker);
+    REQUIRE(taker);
+    REQUIRE(leaver);
+    for (int i = 0; i < 200 && gateway->open_sessions() < 3; ++i) {
+        gateway->poll(5ms);
+    }
+    REQUIRE(gateway->open_sessions() == 3);
+
+    // Pipelined: every command is in flight before any ack comes back
+    constexpr OrderId count = 200;
+    for (OrderId id = 1; id <= count; ++id) {
+        maker->send(new_order(id, Side::Sell, 100 + static_cast<Price>(id % 20), 10));
+    }
+    REQUIRE(maker->flush());
+    ExecutionReport report;
+    for (OrderId id = 1; id <= count; ++id) {
+        REQUIRE(receive(*gateway, *maker, report));
+        REQUIRE(report.client_seq == id);
+    }
+    for (OrderId id = 1; id <= 20; ++id) {
+        taker->send(new_order(1000 + id, Side::Buy, 105, 7));
+        leaver->send(new_order(2000 + id, Side::Buy, 90 + static_cast<Price>(id % 5), 3));
+    }
+    REQUIRE(taker->flush());
+    REQUIRE(leaver->flush());
+    for (int acks = 0; acks < 20;) {
+        REQUIRE(receive(*gateway, *taker, report));
+        acks += report.type == ReportType::Ack;
+    }
+    for (int acks = 0; acks < 20; ++acks) {
+        REQUIRE(receive(*gateway, *leaver, report));
+    }
+    leaver.reset();  // Its disconnect cancel is replicated too
+    for (int i = 0; i < 200 && gateway->open_sessions() > 2; ++i) {
+        gateway->poll(5ms);
+    }
+    for (int i = 0; i < 200 && primary->acked() < primary->replicated(); ++i) {
+        gateway->poll(5ms);
+    }
+    REQUIRE(primary->acked() == primary->replicated());
+
+    // The primary dies: everything it acknowledged to a client is in the backup
+    const auto bids = engine.get_order_book().get_levels(Side::Buy, 1000);
+    const auto asks = engine.get_order_book().get_levels(Side::Sell, 1000);
+    const std::size_t orders = engine.get_order_book().order_count();
+    const std::uint64_t hash = engine.get_order_book().state_hash();
+    gateway->set_replication(nullptr);
+    primary.reset();
+    replica.join();
+    REQUIRE(backup->primary_lost());
+    REQUIRE(backup_engine.get_order_book().get_levels(Side::Buy, 1000) == bids);
+    REQUIRE(backup_engine.get_order_book().get_levels(Side::Sell, 1000) == asks);
+    REQUIRE(backup_engine.get_order_book().order_count() == orders);
+    REQUIRE(backup_engine.get_order_book().state_hash() == hash);  // Same orders, same priority
+    REQUIRE(backup_engine.get_order_book().get_order(2001) == nullptr);
+    gateway.reset();
+
+    // Promoted: the maker reconnects as participant 1 and still owns its orders
+    auto promoted = TcpGateway::create(backup_engine, 0, 4);
+    REQUIRE(promoted);
+    auto reconnected = TcpOrderClient::connect("127.0.0.1", promoted->port());
+    REQUIRE(reconnected);
+    reconnected->send(OrderCommand{.id = 119, .type = CommandType::Cancel});  // Rests at 119
+    REQUIRE(reconnected->flush());
+    REQUIRE(receive(*promoted, *reconnected, report));
+    REQUIRE(report.status == OrderStatus::Cancelled);
+    REQUIRE(backup_engine.get_order_book().order_count() == orders - 1);
+}
+
+TEST_CASE("Replication - The backup expires orders on the primary's clock", "[replication]") {
+    MatchingEngine engine;
+    MatchingEngine backup_engine;
+    auto gateway = TcpGateway::create(engine, 0, 4);
+    auto primary = ReplicationPrimary::create(socket_path());
+    REQUIRE(gateway);
+    REQUIRE(primary);
+    auto backup = ReplicationBackup::connect(backup_engine, socket_path());
+    REQUIRE(backup);
+    REQUIRE(primary->accept_backup(1s));
+    REQUIRE(gateway->set_replication(primary.get()));
+
+    // The buy trades with the GTT sell on the primary, in time
+    auto client = TcpOrderClient::connect("127.0.0.1", gateway->port());
+    REQUIRE(client);
+    const auto expiry = std::chrono::system_clock::now() + 200ms;
+    client->send(OrderCommand{.id = 1, .price = 100, .quantity = 10,
+                              .expire_time = std::chrono::duration_cast<Timestamp>(expiry.time_since_epoch()).count(),
+                              .type = CommandType::New, .side = Side::Sell, .time_in_force = TimeInForce::GTT});
+    client->send(new_order(2, Side::Buy, 100, 4));
+    REQUIRE(client->flush());
+    for (int i = 0; i < 200 && primary->replicated() < 2; ++i) {
+        gateway->poll(5ms);
+    }
+    REQUIRE(primary->replicated() == 2);
+    REQUIRE(engine.get_order_book().get_order(1)->remaining() == 6);
+
+    // The backup only gets to it after the sell would have expired on its own clock
+    std::this_thread::sleep_for(250ms);
+    REQUIRE(backup->poll(1s) == 2);
+    REQUIRE(backup_engine.get_order_book().state_hash() == engine.get_order_book().state_hash());
+    REQUIRE(backup_engine.get_order_book().get_order(1) != nullptr);
+    REQUIRE(backup_engine.get_order_book().get_order(2) == nullptr);
+
+    // A later command expires it on both
+    client->send(new_order(3, Side::Buy, 90, 1));
+    REQUIRE(client->flush());
+    for (int i = 0; i < 200 && primary->replicated() < 3; ++i) {
+        gateway->poll(5ms);
+    }
+    REQUIRE(backup->poll(1s) == 1);
+    REQUIRE(engine.get_order_book().get_order(1) == nullptr);
+    REQUIRE(backup_engine.get_order_book().state_hash() == engine.get_order_book().state_hash());
+    gateway->set_replication(nullptr);
+}
+
+TEST_CASE("Replication - Only a gateway that has not executed anything replicates", "[replication]") {
+    MatchingEngine engine;
+    MatchingEngine backup_engine;
+    auto gateway = TcpGateway::create(engine, 0, 4);
+    REQUIRE(gateway);
+    auto client = TcpOrderClient::connect("127.0.0.1", gateway->port());
+    REQUIRE(client);
+    client->send(new_order(1, Side::Sell, 101, 10));
+    REQUIRE(client->flush());
+    ExecutionReport report;
+    REQUIRE(receive(*gateway, *client, report));
+
+    // The backup would start from an empty book at sequence 1
+    auto primary = ReplicationPrimary::create(socket_path());
+    REQUIRE(primary);
+    auto backup = ReplicationBackup::connect(backup_engine, socket_path());
+    REQUIRE(backup);
+    REQUIRE(primary->accept_backup(1s));
+    REQUIRE_FALSE(gateway->set_replication(primary.get()));
+
+    // Still serving, unreplicated and unheld
+    client->send(new_order(2, Side::Buy, 99, 10));
+    REQUIRE(client->flush());
+    REQUIRE(receive(*gateway, *client, report));
+    REQUIRE(report.client_seq == 2);
+    REQUIRE(primary->replicated() == 0);
+}
@@ -0,0 +1,121 @@
+#include <catch2/catch_test_macros.hpp>
+#include "market_data.hpp"
+#include "matching_engine.hpp"
+#include "retransmission.hpp"
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+using namespace lob;
+
+namespace {
+
+// Packet n is n bytes of the value n
+std::vector<std::byte> numbered(std::uint64_t n) {
+    return std::vector<std::byte>(n, static_cast<std::byte>(n));
+}
+
+} // namespace
+
+TEST_CASE("PacketHistory - Memory ring spills to the mapped file", "[retransmission]") {
+    const auto path = (std::filesystem::temp_directory_path() / "lob_packet_history_test.bin").string();
+    auto history = PacketHistory::create({.memory_packets = 4, .spill_path = path, .spill_packets = 8, .max_packet = 64});
+    REQUIRE(history != nullptr);
+    REQUIRE(history->oldest() == 0);
+
+    for (std::uint64_t n = 1; n <= 20; ++n) {
+        REQUIRE(history->append(n, numbered(n)));
+    }
+    REQUIRE_FALSE(history->append(22, numbered(22)));              // Out of order
+    REQUIRE_FALSE(history->append(21, std::vector<std::byte>(65)));  // Too large
+    REQUIRE(history->newest() == 20);
+    REQUIRE(history->oldest() == 9);
+
+    std::vector<std::byte> out(64);
+    for (std::uint64_t n = 9; n <= 20; ++n) {  // 17-20 from memory, 9-16 from the file
+        REQUIRE(history->read(n, out) == n);
+        REQUIRE(std::memcmp(out.data(), numbered(n).data(), n) == 0);
+    }
+    REQUIRE(history->read(8, out) == 0);
+    REQUIRE(history->read(21, out) == 0);
+
+    history.reset();
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("RetransmissionServer - Lossy receiver recovers while publishing continues", "[retransmission]") {
+    MatchingEngine engine;
+    auto publisher = MarketDataPublisher::create(engine, {
+        .incremental_group = "239.255.77.3",
+        .incremental_port = 39103,
+        .snapshot_group = "239.255.77.4",
+        .snapshot_port = 39104,
+        .packet_size = 256
+    });
+    auto history = PacketHistory::create({.memory_packets = 64, .spill_path = {}, .spill_packets = 0, .max_packet = 256});
+    REQUIRE(publisher != nullptr);
+    REQUIRE(history != nullptr);
+    publisher->set_history(history.get());
+
+    auto server = RetransmissionServer::create(*history, 0);
+    REQUIRE(server != nullptr);
+    std::atomic<bool> stop{false};
+    std::thread serving([&] {
+        while (!stop.load(std::memory_order_relaxed)) {
+            server->poll(std::chrono::milliseconds(10));
+        }
+    });
+    auto client = RetransmissionClient::connect("127.0.0.1", server->port());
+    REQUIRE(client.has_value());
+
+    // Seeded with the empty book, then fed from the history with every fifth packet lost
+    MarketDataReceiver receiver;
+    const mdp::PacketHeader empty{.sequence = 1, .incremental_seq = 0, .length = sizeof(mdp::PacketHeader),
+                                  .count = 0, .channel = mdp::Channel::Snapshot,
+                                  .flags = mdp::SnapshotBegin | mdp::SnapshotEnd, .reserved = {}};
+    REQUIRE(receiver.handle_packet(std::as_bytes(std::span(&empty, 1))));
+    REQUIRE(receiver.synced());
+
+    std::vector<std::byte> packet(history->max_packet());
+    std::uint64_t delivered = 0;
+    std::size_t recovered = 0;
+    OrderId id = 1;
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 40; ++i, ++id) {
+            const Side side = id % 2 ? Side::Buy : Side::Sell;
+            const Price price = side == Side::Buy ? 90 + static_cast<Price>(id % 13) : 98 + static_cast<Price>(id % 11);
+            (void)engine.submit_order(id, side, OrderType::Limit, price, 1 + id % 7);
+            if (id % 4 == 0) {
+                (void)engine.cancel_order(id - 3);
+            }
+        }
+        publisher->flush();
+        for (; delivered < history->newest(); ++delivered) {
+            const std::size_t length = history->read(delivered + 1, packet);
+            REQUIRE(length != 0);
+            if ((delivered + 1) % 5 != 0) {
+                REQUIRE(receiver.handle_packet(std::span(packet.data(), length)));
+            }
+        }
+        for (int attempt = 0; attempt < 10 && receiver.missing(); ++attempt) {
+            const auto gap = receiver.missing();
+            recovered += client->fetch(gap->first, static_cast<std::uint32_t>(gap->second - gap->first + 1),
+                                       [&receiver](std::span<const std::byte> bytes) { receiver.handle_packet(bytes); });
+        }
+        REQUIRE(receiver.synced());
+    }
+
+    // Packets that were never published end the answer at once
+    REQUIRE(client->fetch(history->newest() + 1, 10, [](std::span<const std::byte>) {}) == 0);
+    stop.store(true, std::memory_order_relaxed);
+    serving.join();
+
+    REQUIRE(receiver.gaps() > 0);
+    REQUIRE(recovered >= receiver.gaps());
+    REQUIRE(receiver.incremental_seq() == publisher->incremental_seq());
+    for (Side side : {Side::Buy, Side::Sell}) {
+        REQUIRE(receiver.get_levels(side, 1000) == engine.get_order_book().get_levels(side, 1000));
+    }
+}
@@ -0,0 +1,174 @@
+#include <catch2/catch_test_macros.hpp>
+#include "risk_gate.hpp"
+#include "matching_engine.hpp"
+
+using namespace lob;
+
+namespace {
+
+constexpr SymbolId SYM = 0;
+constexpr ParticipantId ACCT = 1;
+
+RiskGate make_gate() {
+    RiskGate gate(4, 8);
+    gate.set_symbol_limits(SYM, SymbolRiskLimits{
+        .max_order_quantity = 1000,
+        .max_order_notional = 50000,
+        .collar_ticks = 10});
+    gate.set_credit_limit(ACCT, 100000);
+    return gate;
+}
+
+} // namespace
+
+TEST_CASE("RiskGate - Accepts orders within limits", "[risk_gate]") {
+    RiskGate gate = make_gate();
+
+    REQUIRE(gate.check(SYM, ACCT, Side::Buy, OrderType::Limit, 100, 10) == RiskResult::Accepted);
+    REQUIRE_FALSE(gate.collar(SYM).has_value());
+}
+
+TEST_CASE("RiskGate - Rejects unknown symbols and accounts", "[risk_gate]") {
+    RiskGate gate = make_gate();
+
+    REQUIRE(gate.check(4, ACCT, Side::Buy, OrderType::Limit, 100, 10) == RiskResult::UnknownSymbol);
+    REQUIRE(gate.check(SYM, 2, Side::Buy, OrderType::Limit, 100, 10) == RiskResult::UnknownAccount);
+    REQUIRE(gate.check(SYM, 99, Side::Buy, OrderType::Limit, 100, 10) == RiskResult::UnknownAccount);
+}
+
+TEST_CASE("RiskGate - Quantity and notional limits", "[risk_gate]") {
+    RiskGate gate = make_gate();
+
+    REQUIRE(gate.check(SYM, ACCT, Side::Sell, OrderType::Limit, 10, 1001) == RiskResult::MaxQuantityExceeded);
+    REQUIRE(gate.check(SYM, ACCT, Side::Sell, OrderType::Limit, 100, 500) == RiskResult::Accepted);
+    REQUIRE(gate.check(SYM, ACCT, Side::Sell, OrderType::Limit, 101, 500) == RiskResult::MaxNotionalExceeded);
+}
+
+TEST_CASE("RiskGate - Price collar around reference", "[risk_gate]") {
+    RiskGate gate = make_gate();
+    gate.set_reference_price(SYM, 100);
+
+    auto band = gate.collar(SYM);
+    REQUIRE(band.has_value());
+    REQUIRE(band->first == 90);
+    REQUIRE(band->second == 110);
+
+    REQUIRE(gate.check(SYM, ACCT, Side::Buy, OrderType::Limit, 110, 1) == RiskResult::Accepted);
+    REQUIRE(gate.check(SYM, ACCT, Side::Buy, OrderType::Limit, 111, 1) == RiskResult::PriceOutsideCollar);
+    REQUIRE(gate.check(SYM, ACCT, Side::Sell, OrderType::Limit, 89, 1) == RiskResult::PriceOutsideCollar);
+
+    // Tightening the collar re-derives the band around the same reference
+    gate.set_symbol_limits(SYM, SymbolRiskLimits{.collar_ticks = 2});
+    REQUIRE(gate.collar(SYM)->first == 98);
+    REQUIRE(gate.collar(SYM)->second == 102);
+}
+
+TEST_CASE("RiskGate - Market orders need a reference price", "[risk_gate]") {
+    RiskGate gate = make_gate();
+
+    REQUIRE(gate.check(SYM, ACCT, Side::Buy, OrderType::Market, 0, 10) == RiskResult::NoReferencePrice);
+
+    // Valued at the far edge of the band: 110 * 400 = 44000, 110 * 500 > 50000
+    gate.set_reference_price(SYM, 100);
+    REQUIRE(gate.check(SYM, ACCT, Side::Buy, OrderType::Market, 0, 400) == RiskResult::Accepted);
+    REQUIRE(gate.check(SYM, ACCT, Side::Buy, OrderType::Market, 0, 500) == RiskResult::MaxNotionalExceeded);
+    // Sells too: the top of the band is the largest short they can open
+    REQUIRE(gate.check(SYM, ACCT, Side::Sell, OrderType::Market, 0, 500) == RiskResult::MaxNotionalExceeded);
+}
+
+TEST_CASE("RiskGate - Default limits do not overflow", "[risk_gate]") {
+    RiskGate gate(1, 2);
+    gate.set_credit_limit(ACCT, 1'000'000);
+    gate.set_reference_price(SYM, 100);
+
+    REQUIRE(gate.check(SYM, ACCT, Side::Buy, OrderType::Limit, 100, 10) == RiskResult::Accepted);
+    // Market orders are valued at the top of the default band, 10100 a lot, on both sides
+    REQUIRE(gate.check(SYM, ACCT, Side::Buy, OrderType::Market, 0, 99) == RiskResult::Accepted);
+    REQUIRE(gate.check(SYM, ACCT, Side::Sell, OrderType::Market, 0, 99) == RiskResult::Accepted);
+    REQUIRE(gate.check(SYM, ACCT, Side::Buy, OrderType::Market, 0, 100) == RiskResult::CreditLimitExceeded);
+    REQUIRE(gate.check(SYM, ACCT, Side::Sell, OrderType::Market, 0, 100) == RiskResult::CreditLimitExceeded);
+
+    // Fills too large to value pin the exposure rather than wrap it
+    gate.on_trade(Trade{.buy_order_id = 1, .sell_order_id = 2, .price = 1LL << 40, .quantity = 1ULL << 40,
+                        .timestamp = {}, .buy_participant = ACCT, .aggressor = Side::Buy});
+    gate.on_trade(Trade{.buy_order_id = 3, .sell_order_id = 4, .price = 1LL << 40, .quantity = 1ULL << 40,
+                        .timestamp = {}, .buy_participant = ACCT, .aggressor = Side::Buy});
+    REQUIRE(gate.exposure(ACCT) == std::numeric_limits<Notional>::max());
+    REQUIRE(gate.check(SYM, ACCT, Side::Buy, OrderType::Limit, 100, 1) == RiskResult::CreditLimitExceeded);
+}
+
+TEST_CASE("RiskGate - Credit limit tracks executed exposure", "[risk_gate]") {
+    RiskGate gate = make_gate();
+    gate.set_credit_limit(2, 100000);
+    MatchingEngine engine([&gate](const Trade& trade) { gate.on_trade(trade); });
+
+    engine.submit_order(1, Side::Sell, OrderType::Limit, 100, 400, TimeInForce::GTC, {}, 2);
+    REQUIRE(gate.check(SYM, ACCT, Side::Buy, OrderType::Limit, 100, 400) == RiskResult::Accepted);
+    engine.submit_order(2, Side::Buy, OrderType::Limit, 100, 400, TimeInForce::GTC, {}, ACCT);
+
+    REQUIRE(gate.exposure(ACCT) == 40000);
+    REQUIRE(gate.exposure(2) == -40000);
+
+    // 40000 + 30000 fits, 40000 + 70000 would breach the 100000 limit
+    REQUIRE(gate.check(SYM, ACCT, Side::Buy, OrderType::Limit, 100, 300) == RiskResult::Accepted);
+    gate.set_symbol_limits(SYM, SymbolRiskLimits{.max_order_quantity = 1000, .collar_ticks = 10});
+    REQUIRE(gate.check(SYM, ACCT, Side::Buy, OrderType::Limit, 100, 700) == RiskResult::CreditLimitExceeded);
+    // Selling reduces exposure
+    REQUIRE(gate.check(SYM, ACCT, Side::Sell, OrderType::Limit, 100, 700) == RiskResult::Accepted);
+
+    gate.refresh_reference(SYM, engine);
+    REQUIRE(gate.collar(SYM)->first == 90);
+}
+
+TEST_CASE("RiskGate - Reference from BBO midpoint", "[risk_gate]") {
+    RiskGate gate = make_gate();
+    MatchingEngine engine;
+
+    gate.refresh_reference(SYM, engine);
+    REQUIRE_FALSE(gate.collar(SYM).has_value());
+
+    engine.submit_order(1, Side::Buy, OrderType::Limit, 98, 10);
+    engine.submit_order(2, Side::Sell, OrderType::Limit, 104, 10);
+    gate.refresh_reference(SYM, engine);
+    REQUIRE(gate.collar(SYM)->first == 91);
+    REQUIRE(gate.collar(SYM)->second == 111);
+}
+
+TEST_CASE("RiskGate - Resting orders count toward credit", "[risk_gate]") {
+    RiskGate gate = make_gate();
+    gate.set_credit_limit(2, 100000);
+    MatchingEngine engine([&gate](const Trade& trade) { gate.on_trade(trade); });
+    const auto submit = [&](OrderId id, Side side, Price price, Quantity quantity, ParticipantId account) {
+        REQUIRE(gate.check(SYM, account, side, OrderType::Limit, price, quantity) == RiskResult::Accepted);
+        engine.submit_order(id, side, OrderType::Limit, price, quantity, TimeInForce::GTC, {}, account);
+        if (const Order* order = engine.get_order_book().get_order(id)) {
+            gate.on_order_resting(id, account, side, order->price, order->remaining());
+        }
+    };
+
+    // Two resting buys of 40000 leave room for 20000 more, whatever has executed
+    submit(1, Side::Buy, 100, 400, ACCT);
+    submit(2, Side::Buy, 100, 400, ACCT);
+    REQUIRE(gate.open_notional(ACCT, Side::Buy) == 80000);
+    REQUIRE(gate.check(SYM, ACCT, Side::Buy, OrderType::Limit, 100, 201) == RiskResult::CreditLimitExceeded);
+    REQUIRE(gate.check(SYM, ACCT, Side::Buy, OrderType::Limit, 100, 200) == RiskResult::Accepted);
+    // Open buys do not offset a short
+    REQUIRE(gate.check(SYM, ACCT, Side::Sell, OrderType::Limit, 100, 500) == RiskResult::Accepted);
+
+    // A fill moves its part from open to executed
+    submit(3, Side::Sell, 100, 300, 2);
+    REQUIRE(gate.exposure(ACCT) == 30000);
+    REQUIRE(gate.open_notional(ACCT, Side::Buy) == 50000);
+    REQUIRE(gate.open_notional(2, Side::Sell) == 0);
+    REQUIRE(gate.check(SYM, ACCT, Side::Buy, OrderType::Limit, 100, 201) == RiskResult::CreditLimitExceeded);
+
+    // A cancel releases the rest; a modify reserves at the new price and quantity
+    REQUIRE(engine.cancel_order(2));
+    gate.on_order_closed(2);
+    REQUIRE(gate.open_notional(ACCT, Side::Buy) == 10000);
+    gate.on_order_resting(1, ACCT, Side::Buy, 99, 500);
+    REQUIRE(gate.open_notional(ACCT, Side::Buy) == 49500);
+    gate.on_order_closed(1);
+    REQUIRE(gate.open_notional(ACCT, Side::Buy) == 0);
+    REQUIRE(gate.check(SYM, ACCT, Side::Buy, OrderType::Limit, 100, 500) == RiskResult::Accepted);
+}
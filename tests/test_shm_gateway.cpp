@@ -0,0 +1,127 @@
+#include <catch2/catch_test_macros.hpp>
+#include "matching_engine.hpp"
+#include "shm_gateway.hpp"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace lob;
+using namespace std::chrono_literals;
+
+namespace {
+
+std::string gateway_name(const char* suffix) {
+    return std::string("lob_cpp_test_gw_") + suffix + "_" + std::to_string(::getpid());
+}
+
+OrderCommand new_order(std::uint64_t seq, OrderId id, Side side, Price price, Quantity quantity) {
+    return OrderCommand{.client_seq = seq, .id = id, .price = price, .quantity = quantity,
+                        .type = CommandType::New, .side = side};
+}
+
+} // namespace
+
+TEST_CASE("ShmGateway - Commands, acks and routed fills", "[shm_gateway]") {
+    MatchingEngine engine;
+    auto server = ShmGatewayServer::create(gateway_name("basic"), engine, 2);
+    REQUIRE(server);
+
+    auto maker = ShmGatewayClient::connect(gateway_name("basic"));
+    auto taker = ShmGatewayClient::connect(gateway_name("basic"));
+    REQUIRE(maker);
+    REQUIRE(taker);
+    REQUIRE_FALSE(ShmGatewayClient::connect(gateway_name("basic")));  // Both channels taken
+    REQUIRE(maker->participant() != taker->participant());
+    REQUIRE(server->connected_clients() == 2);
+
+    REQUIRE(maker->send(new_order(1, 100, Side::Sell, 101, 10)));
+    REQUIRE(server->poll() == 1);
+    ExecutionReport report;
+    REQUIRE(maker->try_receive(report));
+    REQUIRE(report.type == ReportType::Ack);
+    REQUIRE(report.client_seq == 1);
+    REQUIRE(report.status == OrderStatus::New);
+    REQUIRE(report.leaves == 10);
+    REQUIRE(engine.get_order_book().get_order(100)->participant == maker->participant());
+
+    // The taker may not cancel someone else's order
+    REQUIRE(taker->send(OrderCommand{.client_seq = 1, .id = 100, .type = CommandType::Cancel}));
+    REQUIRE(taker->send(new_order(2, 200, Side::Buy, 101, 4)));
+    REQUIRE(server->poll() == 2);
+    REQUIRE(taker->try_receive(report));
+    REQUIRE(report.status == OrderStatus::Rejected);
+
+    // Aggressor sees its fill before the ack; the maker gets the passive fill
+    REQUIRE(taker->try_receive(report));
+    REQUIRE(report.type == ReportType::Fill);
+    REQUIRE(report.id == 200);
+    REQUIRE(report.quantity == 4);
+    REQUIRE(report.status == OrderStatus::Filled);
+    REQUIRE(taker->try_receive(report));
+    REQUIRE(report.type == ReportType::Ack);
+    REQUIRE(report.client_seq == 2);
+    REQUIRE(report.status == OrderStatus::Filled);
+
+    REQUIRE(maker->try_receive(report));
+    REQUIRE(report.type == ReportType::Fill);
+    REQUIRE(report.id == 100);
+    REQUIRE(report.price == 101);
+    REQUIRE(report.leaves == 6);
+    REQUIRE(report.status == OrderStatus::PartiallyFilled);
+    REQUIRE_FALSE(maker->try_receive(report));
+
+    // Out-of-range enum bytes from the shared ring are rejected before they reach the book
+    OrderCommand bad_side = new_order(3, 300, Side::Buy, 99, 1);
+    OrderCommand bad_type = new_order(4, 301, Side::Buy, 99, 1);
+    OrderCommand bad_tif = new_order(5, 302, Side::Buy, 99, 1);
+    bad_side.side = static_cast<Side>(7);
+    bad_type.order_type = static_cast<OrderType>(4);
+    bad_tif.time_in_force = static_cast<TimeInForce>(3);
+    REQUIRE(taker->send(bad_side));
+    REQUIRE(taker->send(bad_type));
+    REQUIRE(taker->send(bad_tif));
+    REQUIRE(server->poll() == 3);
+    for (std::uint64_t seq = 3; seq <= 5; ++seq) {
+        REQUIRE(taker->try_receive(report));
+        REQUIRE(report.client_seq == seq);
+        REQUIRE(report.status == OrderStatus::Rejected);
+    }
+    REQUIRE(engine.get_order_book().order_count() == 1);
+
+    // Disconnecting cancels the client's resting orders and frees the channel
+    maker.reset();
+    server->poll();
+    REQUIRE(engine.get_order_book().get_order(100) == nullptr);
+    REQUIRE(server->connected_clients() == 1);
+    REQUIRE(ShmGatewayClient::connect(gateway_name("basic")));
+}
+
+TEST_CASE("ShmGateway - Futex wait on both sides", "[shm_gateway]") {
+    MatchingEngine engine;
+    auto server = ShmGatewayServer::create(gateway_name("futex"), engine, 1);
+    REQUIRE(server);
+    REQUIRE_FALSE(ShmGatewayServer::create(gateway_name("futex"), engine, 1));
+
+    std::atomic<bool> stop{false};
+    std::thread matcher([&] {
+        while (!stop.load(std::memory_order_acquire)) {
+            server->wait_and_poll(WaitMode::Futex, 10ms);
+        }
+    });
+
+    auto client = ShmGatewayClient::connect(gateway_name("futex"));
+    REQUIRE(client);
+    bool acked = true;
+    for (std::uint64_t seq = 1; seq <= 1000; ++seq) {
+        REQUIRE(client->send(new_order(seq, seq, Side::Buy, 100, 1)));
+        ExecutionReport report;
+        acked &= client->receive(report, WaitMode::Futex, 1s) && report.client_seq == seq;
+    }
+    REQUIRE(acked);
+    REQUIRE(engine.get_order_book().order_count() == 1000);
+
+    stop.store(true, std::memory_order_release);
+    matcher.join();
+    REQUIRE_FALSE(client->overflowed());
+}
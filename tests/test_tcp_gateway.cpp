@@ -0,0 +1,202 @@
+#include <catch2/catch_test_macros.hpp>
+#include "gateway_test_helpers.hpp"
+#include "matching_engine.hpp"
+#include "tcp_gateway.hpp"
+#include "wire_protocol.hpp"
+#include <array>
+#include <chrono>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace lob;
+using namespace lob::test;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Commands with each enum byte out of range in turn
+std::array<OrderCommand, 3> malformed_orders() {
+    std::array<OrderCommand, 3> orders{new_order(1, Side::Buy, 99, 10), new_order(1, Side::Buy, 99, 10),
+                                       new_order(1, Side::Buy, 99, 10)};
+    orders[0].side = static_cast<Side>(7);
+    orders[1].order_type = static_cast<OrderType>(4);
+    orders[2].time_in_force = static_cast<TimeInForce>(3);
+    return orders;
+}
+
+} // namespace
+
+TEST_CASE("Wire protocol - Round trip and partial frames", "[tcp_gateway]") {
+    std::array<std::byte, wire::MAX_FRAME> buffer{};
+    const OrderCommand sent{.id = 7, .price = 101, .quantity = 5, .expire_time = 42,
+                            .type = CommandType::New, .side = Side::Sell,
+                            .order_type = OrderType::Limit, .time_in_force = TimeInForce::GTT};
+    const std::size_t length = wire::encode_command(buffer.data(), sent, 3);
+    REQUIRE(length == wire::NEW_ORDER_FRAME);
+
+    OrderCommand decoded;
+    REQUIRE(wire::decode_command(std::span(buffer.data(), length - 1), decoded).status ==
+            wire::DecodeStatus::NeedMore);
+    const auto result = wire::decode_command(std::span(buffer.data(), length), decoded);
+    REQUIRE(result.status == wire::DecodeStatus::Ok);
+    REQUIRE(result.consumed == length);
+    REQUIRE(decoded.client_seq == 3);
+    REQUIRE(decoded.id == 7);
+    REQUIRE(decoded.side == Side::Sell);
+    REQUIRE(decoded.time_in_force == TimeInForce::GTT);
+    REQUIRE(decoded.expire_time == 42);
+
+    // A cancel header claiming a new-order length is rejected
+    wire::encode_command(buffer.data(), OrderCommand{.id = 7, .type = CommandType::Cancel}, 4);
+    buffer[0] = std::byte{wire::NEW_ORDER_FRAME};
+    REQUIRE(wire::decode_command(std::span(buffer.data(), buffer.size()), decoded).status ==
+            wire::DecodeStatus::Invalid);
+
+    // So are enum bytes out of range
+    for (const OrderCommand& order : malformed_orders()) {
+        const std::size_t bad = wire::encode_command(buffer.data(), order, 5);
+        REQUIRE(wire::decode_command(std::span(buffer.data(), bad), decoded).status ==
+                wire::DecodeStatus::Invalid);
+    }
+}
+
+TEST_CASE("Wire protocol - GTT expiries move from the wall clock to the engine's", "[tcp_gateway]") {
+    MatchingEngine engine;
+    OrderEntrySessions sessions(engine, 1);
+    const std::size_t slot = *sessions.open();
+    const auto wall = [](std::chrono::nanoseconds from_now) {
+        return std::chrono::duration_cast<Timestamp>(
+            (std::chrono::system_clock::now() + from_now).time_since_epoch()).count();
+    };
+    std::array<std::byte, wire::MAX_FRAME> buffer{};
+    const auto send = [&](OrderId id, std::int64_t expire_time, std::uint32_t seq) {
+        const std::size_t length = wire::encode_command(
+            buffer.data(), OrderCommand{.id = id, .price = 100, .quantity = 5, .expire_time = expire_time,
+                                        .time_in_force = TimeInForce::GTT}, seq);
+        REQUIRE(sessions.process(slot, std::span(buffer.data(), length)).commands == 1);
+    };
+
+    const Timestamp before = steady_time();
+    send(1, wall(1h), 1);
+    const Timestamp after = steady_time();
+    const Order* order = engine.get_order_book().get_order(1);
+    REQUIRE(order);
+    REQUIRE(order->expire_time > before + 1h - 10ms);
+    REQUIRE(order->expire_time < after + 1h + 10ms);
+
+    send(2, wall(-1s), 2);
+    REQUIRE(engine.get_order_book().get_order(2) == nullptr);
+}
+
+TEST_CASE("TcpGateway - Orders, fills and cancel on disconnect over loopback", "[tcp_gateway]") {
+    MatchingEngine engine;
+    auto gateway = TcpGateway::create(engine, 0, 4);
+    REQUIRE(gateway);
+    REQUIRE(gateway->port() != 0);
+
+    auto maker = TcpOrderClient::connect("127.0.0.1", gateway->port());
+    auto taker = TcpOrderClient::connect("127.0.0.1", gateway->port());
+    REQUIRE(maker);
+    REQUIRE(taker);
+    REQUIRE(pump(*gateway, [&] { return gateway->open_sessions() == 2; }));
+
+    // A batch of resting orders in one flush
+    for (OrderId id = 1; id <= 100; ++id) {
+        maker->send(new_order(id, Side::Sell, 100 + static_cast<Price>(id), 10));
+    }
+    REQUIRE(maker->flush());
+    REQUIRE(pump(*gateway, [&] { return engine.get_order_book().order_count() == 100; }));
+    ExecutionReport report;
+    for (std::uint64_t seq = 1; seq <= 100; ++seq) {
+        REQUIRE(maker->receive(report));
+        REQUIRE(report.type == ReportType::Ack);
+        REQUIRE(report.client_seq == seq);
+        REQUIRE(report.status == OrderStatus::New);
+    }
+
+    taker->send(OrderCommand{.id = 1, .type = CommandType::Cancel});  // Not the taker's order
+    taker->send(new_order(500, Side::Buy, 101, 15));
+    REQUIRE(taker->flush());
+    REQUIRE(pump(*gateway, [&] { return engine.get_order_book().get_order(500) != nullptr; }));
+    REQUIRE(taker->receive(report));
+    REQUIRE(report.status == OrderStatus::Rejected);
+    REQUIRE(taker->receive(report));
+    REQUIRE(report.type == ReportType::Fill);
+    REQUIRE(report.quantity == 10);
+    REQUIRE(taker->receive(report));
+    REQUIRE(report.type == ReportType::Ack);
+    REQUIRE(report.status == OrderStatus::PartiallyFilled);
+    REQUIRE(report.leaves == 5);
+
+    REQUIRE(maker->receive(report));
+    REQUIRE(report.type == ReportType::Fill);
+    REQUIRE(report.id == 1);
+    REQUIRE(report.status == OrderStatus::Filled);
+
+    maker.reset();
+    REQUIRE(pump(*gateway, [&] { return gateway->open_sessions() == 1; }));
+    REQUIRE(engine.get_order_book().order_count() == 1);  // Only the taker's remainder
+}
+
+TEST_CASE("TcpGateway - Capacity limit and sequence gaps close sessions", "[tcp_gateway]") {
+    MatchingEngine engine;
+    auto gateway = TcpGateway::create(engine, 0, 1);
+    REQUIRE(gateway);
+
+    // Raw socket so the frames can carry a sequence gap
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(gateway->port());
+    ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    REQUIRE(::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0);
+    REQUIRE(pump(*gateway, [&] { return gateway->open_sessions() == 1; }));
+
+    // A second connection is dropped while the only session is taken
+    auto extra = TcpOrderClient::connect("127.0.0.1", gateway->port());
+    REQUIRE(extra);
+    gateway->poll(5ms);
+    ExecutionReport report;
+    REQUIRE_FALSE(extra->receive(report, 100ms));
+    REQUIRE_FALSE(extra->connected());
+
+    // Sequence 1 rests; skipping 2 ends the session and cancels its orders
+    std::array<std::byte, 2 * wire::MAX_FRAME> frames{};
+    std::size_t length = wire::encode_command(frames.data(), new_order(1, Side::Buy, 99, 10), 1);
+    length += wire::encode_command(frames.data() + length, new_order(2, Side::Buy, 98, 10), 3);
+    REQUIRE(::send(fd, frames.data(), length, MSG_NOSIGNAL) == static_cast<ssize_t>(length));
+    REQUIRE(pump(*gateway, [&] { return gateway->open_sessions() == 0; }));
+    REQUIRE(engine.get_order_book().order_count() == 0);
+
+    std::array<std::byte, wire::EXEC_REPORT_FRAME> reply{};
+    REQUIRE(::recv(fd, reply.data(), reply.size(), MSG_WAITALL) == static_cast<ssize_t>(reply.size()));
+    REQUIRE(wire::decode_report(reply, report).status == wire::DecodeStatus::Ok);
+    REQUIRE(report.status == OrderStatus::New);
+    REQUIRE(::recv(fd, reply.data(), reply.size(), 0) == 0);  // Then closed
+    ::close(fd);
+}
+
+TEST_CASE("TcpGateway - Out-of-range enum bytes close the session", "[tcp_gateway]") {
+    MatchingEngine engine;
+    auto gateway = TcpGateway::create(engine, 0, 1);
+    REQUIRE(gateway);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(gateway->port());
+    ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+    for (const OrderCommand& order : malformed_orders()) {
+        const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        REQUIRE(::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0);
+        REQUIRE(pump(*gateway, [&] { return gateway->open_sessions() == 1; }));
+
+        std::array<std::byte, wire::MAX_FRAME> frame{};
+        const std::size_t length = wire::encode_command(frame.data(), order, 1);
+        REQUIRE(::send(fd, frame.data(), length, MSG_NOSIGNAL) == static_cast<ssize_t>(length));
+        REQUIRE(pump(*gateway, [&] { return gateway->open_sessions() == 0; }));
+        REQUIRE(engine.get_order_book().order_count() == 0);
+        ::close(fd);
+    }
+}
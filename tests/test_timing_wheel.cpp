@@ -0,0 +1,89 @@
+#include <catch2/catch_test_macros.hpp>
+#include "timing_wheel.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+struct TimerNode {
+    int id{0};
+    TimerNode* timer_next{nullptr};
+    TimerNode* timer_prev{nullptr};
+    std::uint64_t timer_deadline{0};
+    std::uint32_t timer_slot{lob::TimingWheel<TimerNode>::NO_SLOT};
+};
+
+} // namespace
+
+TEST_CASE("TimingWheel - Fires at deadline", "[timing_wheel]") {
+    lob::TimingWheel<TimerNode> wheel;
+    TimerNode a{.id = 1}, b{.id = 2};
+    wheel.schedule(&a, 10);
+    wheel.schedule(&b, 300);  // Level 1
+    REQUIRE(wheel.size() == 2);
+    
+    std::vector<int> fired;
+    auto record = [&](TimerNode* node) { fired.push_back(node->id); };
+    
+    REQUIRE(wheel.advance(9, 100, record) == 0);
+    REQUIRE(wheel.advance(10, 100, record) == 1);
+    REQUIRE(wheel.advance(299, 100, record) == 0);
+    REQUIRE(wheel.advance(300, 100, record) == 1);
+    REQUIRE(fired == std::vector<int>{1, 2});
+    REQUIRE(wheel.empty());
+}
+
+TEST_CASE("TimingWheel - Cascades across all levels", "[timing_wheel]") {
+    lob::TimingWheel<TimerNode> wheel(5);
+    std::vector<TimerNode> nodes(6);
+    const std::uint64_t deadlines[] = {7, 1000, 70000, 20000000, 5000000000ull, 6};
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        nodes[i].id = static_cast<int>(i);
+        wheel.schedule(&nodes[i], deadlines[i]);
+    }
+    
+    std::vector<std::uint64_t> fired_at;
+    std::uint64_t now = 0;
+    auto record = [&](TimerNode* node) {
+        REQUIRE(node->timer_deadline <= now);
+        fired_at.push_back(node->timer_deadline);
+    };
+    for (std::uint64_t deadline : {6ull, 7ull, 1000ull, 70000ull, 20000000ull, 5000000000ull}) {
+        now = deadline - 1;
+        REQUIRE(wheel.advance(now, 100, record) == 0);
+        now = deadline;
+        REQUIRE(wheel.advance(now, 100, record) == 1);
+    }
+    REQUIRE(fired_at.size() == 6);
+    REQUIRE(wheel.empty());
+}
+
+TEST_CASE("TimingWheel - Cancel unlinks node", "[timing_wheel]") {
+    lob::TimingWheel<TimerNode> wheel;
+    TimerNode a{.id = 1}, b{.id = 2};
+    wheel.schedule(&a, 50);
+    wheel.schedule(&b, 50);
+    wheel.cancel(&a);
+    wheel.cancel(&a);  // Second cancel is a no-op
+    REQUIRE(wheel.size() == 1);
+    REQUIRE(a.timer_slot == lob::TimingWheel<TimerNode>::NO_SLOT);
+    
+    std::vector<int> fired;
+    wheel.advance(100, 100, [&](TimerNode* node) { fired.push_back(node->id); });
+    REQUIRE(fired == std::vector<int>{2});
+}
+
+TEST_CASE("TimingWheel - Bounded batches resume", "[timing_wheel]") {
+    lob::TimingWheel<TimerNode> wheel;
+    std::vector<TimerNode> nodes(10);
+    for (auto& node : nodes) {
+        wheel.schedule(&node, 20);
+    }
+    
+    auto ignore = [](TimerNode*) {};
+    REQUIRE(wheel.advance(1000, 4, ignore) == 4);
+    REQUIRE(wheel.advance(1000, 4, ignore) == 4);
+    REQUIRE(wheel.advance(1000, 4, ignore) == 2);
+    REQUIRE(wheel.advance(1000, 4, ignore) == 0);
+    REQUIRE(wheel.current_tick() == 1000);
+}
@@ -0,0 +1,110 @@
+#include <catch2/catch_test_macros.hpp>
+#include "matching_engine.hpp"
+#include "top_of_book.hpp"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace lob;
+
+TEST_CASE("TopOfBookPublisher - Publishes top levels per message", "[top_of_book]") {
+    MatchingEngine engine;
+    TopOfBookPublisher publisher;
+    engine.add_observer(&publisher);
+
+    REQUIRE(publisher.snapshot().sequence == 0);
+    REQUIRE_FALSE(publisher.snapshot().best_bid());
+
+    for (Price p = 0; p < 7; ++p) {
+        engine.submit_order(1 + p, Side::Buy, OrderType::Limit, 99 - p, 10 + p);
+    }
+    engine.submit_order(20, Side::Sell, OrderType::Limit, 101, 5);
+    engine.submit_order(21, Side::Sell, OrderType::Limit, 101, 5);
+
+    auto snap = publisher.snapshot();
+    REQUIRE(snap.sequence == 9);
+    REQUIRE(snap.book_version == engine.get_order_book().version());
+    REQUIRE(snap.bid_depth == TopOfBookSnapshot::DEPTH);
+    REQUIRE(snap.bids[0].price == 99);
+    REQUIRE(snap.bids[4].price == 95);
+    REQUIRE(snap.bids[4].quantity == 14);
+    REQUIRE(snap.ask_depth == 1);
+    REQUIRE(snap.best_ask()->quantity == 10);
+
+    // A rejected cancel leaves the book alone, so nothing is republished
+    REQUIRE_FALSE(engine.cancel_order(999));
+    REQUIRE(publisher.snapshot().sequence == 9);
+
+    // Sweeping the asks clears the side, including stale entries
+    engine.submit_order(30, Side::Buy, OrderType::Market, 0, 10);
+    snap = publisher.snapshot();
+    REQUIRE(snap.sequence == 11);
+    REQUIRE(snap.ask_depth == 0);
+    REQUIRE_FALSE(snap.best_ask());
+    REQUIRE(snap.asks[0].quantity == 0);
+}
+
+TEST_CASE("TopOfBookPublisher - Shared memory slot is readable by name", "[top_of_book]") {
+    const std::string name = "lob_cpp_test_tob_" + std::to_string(::getpid());
+    REQUIRE_FALSE(TopOfBookReader::open(name));
+
+    MatchingEngine engine;
+    auto publisher = TopOfBookPublisher::create_shared(name);
+    REQUIRE(publisher);
+    REQUIRE_FALSE(TopOfBookPublisher::create_shared(name));  // Name already taken
+    engine.add_observer(publisher.get());
+
+    auto reader = TopOfBookReader::open(name);
+    REQUIRE(reader);
+    engine.submit_order(1, Side::Buy, OrderType::Limit, 100, 25);
+    engine.submit_order(2, Side::Sell, OrderType::Limit, 102, 40);
+
+    const auto snap = reader->snapshot();
+    REQUIRE(snap.sequence == 2);
+    REQUIRE(snap.best_bid()->price == 100);
+    REQUIRE(snap.best_bid()->quantity == 25);
+    REQUIRE(snap.best_ask()->price == 102);
+
+    engine.remove_observer(publisher.get());
+    publisher.reset();
+    REQUIRE_FALSE(TopOfBookReader::open(name));  // Unlinked by the publisher
+    REQUIRE(reader->snapshot().sequence == 2);   // Existing mappings stay valid
+}
+
+TEST_CASE("TopOfBookPublisher - Cross-thread readers see consistent books", "[top_of_book]") {
+    MatchingEngine engine;
+    TopOfBookPublisher publisher;
+    engine.add_observer(&publisher);
+
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        // Bid and ask always rest at the same quantity; each round replaces both
+        for (OrderId id = 1; id <= 20000; ++id) {
+            engine.submit_order(id * 2, Side::Buy, OrderType::Limit, 100, id);
+            engine.submit_order(id * 2 + 1, Side::Sell, OrderType::Limit, 101, id);
+            if (id > 1) {
+                (void)engine.cancel_order((id - 1) * 2);
+                (void)engine.cancel_order((id - 1) * 2 + 1);
+            }
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    bool ordered = true;
+    std::uint64_t last = 0;
+    while (!done.load(std::memory_order_acquire)) {
+        const auto snap = publisher.snapshot();
+        ordered &= snap.sequence >= last;
+        last = snap.sequence;
+        if (snap.bid_depth && snap.ask_depth) {
+            ordered &= snap.bids[0].price < snap.asks[0].price;
+        }
+    }
+    writer.join();
+
+    REQUIRE(ordered);
+    const auto snap = publisher.snapshot();
+    REQUIRE(snap.best_bid()->quantity == 20000);
+    REQUIRE(snap.best_ask()->quantity == 20000);
+}
@@ -0,0 +1,201 @@
+#include <catch2/catch_test_macros.hpp>
+#include "matching_engine.hpp"
+#include "trade_tape.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+
+using namespace lob;
+
+namespace {
+
+std::string tape_path() {
+    return "/tmp/lob_trade_tape_test_" + std::to_string(::getpid()) + ".tape";
+}
+
+// b as read back from a block with clock_offset
+bool same_trade(const Trade& a, const Trade& b, std::int64_t clock_offset) {
+    return a.buy_order_id == b.buy_order_id && a.sell_order_id == b.sell_order_id &&
+           a.price == b.price && a.quantity == b.quantity &&
+           a.timestamp + Timestamp{clock_offset} == b.timestamp &&
+           a.buy_participant == b.buy_participant && a.sell_participant == b.sell_participant &&
+           a.aggressor == b.aggressor;
+}
+
+std::vector<Trade> read_all(const TradeTapeReader& reader) {
+    std::vector<Trade> trades;
+    for (std::size_t block = 0; block < reader.blocks(); ++block) {
+        reader.read_block(block, trades);
+    }
+    return trades;
+}
+
+} // namespace
+
+TEST_CASE("Trade tape - Engine fills round-trip through the tape", "[trade_tape]") {
+    const std::string path = tape_path();
+    std::remove(path.c_str());
+    std::vector<Trade> expected;
+    MatchingEngine engine([&expected](const Trade& trade) { expected.push_back(trade); });
+    auto writer = TradeTapeWriter::create(engine, path, {.block_trades = 64});
+    REQUIRE(writer);
+
+    OrderId id = 1;
+    for (int round = 0; round < 50; ++round) {
+        for (Price price = 100; price < 105; ++price) {
+            REQUIRE(engine.submit_order(id++, Side::Sell, OrderType::Limit, price, 10, TimeInForce::GTC,
+                                        Timestamp{0}, 1 + static_cast<ParticipantId>(round % 3)) !=
+                    OrderStatus::Rejected);
+        }
+        (void)engine.submit_order(id++, Side::Buy, OrderType::Limit, 104, 17 + round, TimeInForce::GTC,
+                                  Timestamp{0}, 7);
+        (void)engine.submit_order(id++, Side::Buy, OrderType::IOC, 110, 50 - round / 2);
+    }
+    engine.start_auction();
+    REQUIRE(engine.submit_order(id++, Side::Sell, OrderType::Limit, 115, 20) == OrderStatus::New);
+    REQUIRE(engine.submit_order(id++, Side::Buy, OrderType::Limit, 120, 30) == OrderStatus::New);
+    REQUIRE(engine.uncross());
+
+    writer->flush();
+    REQUIRE(expected.size() > 3 * 64);
+    REQUIRE(writer->trades_written() == expected.size());
+    REQUIRE(writer->write_errors() == 0);
+
+    auto reader = TradeTapeReader::open(path);
+    REQUIRE(reader);
+    REQUIRE(reader->trades() == expected.size());
+    REQUIRE(reader->file_bytes() == writer->bytes_written());
+    REQUIRE(reader->file_bytes() < expected.size() * sizeof(Trade) / 4);  // Columns compress
+    const auto trades = read_all(*reader);
+    REQUIRE(trades.size() == expected.size());
+    for (std::size_t i = 0; i < trades.size(); ++i) {
+        REQUIRE(same_trade(expected[i], trades[i], reader->block_header(i / 64).clock_offset));
+    }
+    REQUIRE_FALSE(trades.back().aggressor);  // Auction fill
+
+    // On the wall clock, so a time of day can be asked for
+    const auto wall = std::chrono::duration_cast<Timestamp>(std::chrono::system_clock::now().time_since_epoch());
+    REQUIRE(trades.front().timestamp <= wall);
+    REQUIRE(trades.back().timestamp > wall - std::chrono::minutes(1));
+
+    writer.reset();
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Trade tape - Bars match a scan of every trade", "[trade_tape]") {
+    const std::string path = tape_path();
+    std::remove(path.c_str());
+    MatchingEngine engine;
+    std::vector<Trade> trades;
+    {
+        auto writer = TradeTapeWriter::create(engine, path, {.block_trades = 100});
+        REQUIRE(writer);
+        std::int64_t time = 1'000'000;
+        for (std::uint64_t i = 0; i < 1000; ++i) {
+            time += static_cast<std::int64_t>((i * 7919) % 50'000);
+            const Trade trade{
+                .buy_order_id = 10 * i + 1,
+                .sell_order_id = 1'000'000 - i,
+                .price = 10'000 + static_cast<Price>((i * 37) % 200) - 100,
+                .quantity = 1 + (i * 13) % 500,
+                .timestamp = Timestamp{time},
+                .aggressor = i % 2 ? Side::Sell : Side::Buy
+            };
+            trades.push_back(trade);
+            writer->on_trade(trade);
+        }
+        writer->flush();
+    }
+
+    auto reader = TradeTapeReader::open(path);
+    REQUIRE(reader);
+    REQUIRE(reader->blocks() == 10);
+    for (std::size_t i = 0; i < trades.size(); ++i) {
+        trades[i].timestamp += Timestamp{reader->block_header(i / 100).clock_offset};  // As taped
+    }
+    REQUIRE(reader->block_header(3).first_timestamp == trades[300].timestamp.count());
+    REQUIRE(reader->block_header(3).last_timestamp == trades[399].timestamp.count());
+
+    // A range inside the tape, so whole blocks are skipped at both ends
+    const Timestamp begin = trades[250].timestamp + Timestamp{123};
+    const Timestamp end = trades[720].timestamp;
+    const Timestamp interval{1'000'000};
+    const auto bars = reader->bars(begin, end, interval);
+    REQUIRE(bars.size() == static_cast<std::size_t>((end - begin + interval - Timestamp{1}) / interval));
+
+    std::vector<TradeBar> expected(bars.size());
+    for (const Trade& trade : trades) {
+        if (trade.timestamp < begin || trade.timestamp >= end) {
+            continue;
+        }
+        TradeBar& bar = expected[static_cast<std::size_t>((trade.timestamp - begin) / interval)];
+        bar.high = bar.trades ? std::max(bar.high, trade.price) : trade.price;
+        bar.low = bar.trades ? std::min(bar.low, trade.price) : trade.price;
+        ++bar.trades;
+        bar.volume += trade.quantity;
+        bar.notional += trade.price * static_cast<Notional>(trade.quantity);
+    }
+    std::uint64_t covered = 0;
+    for (std::size_t i = 0; i < bars.size(); ++i) {
+        REQUIRE(bars[i].start == begin + interval * static_cast<std::int64_t>(i));
+        REQUIRE(bars[i].trades == expected[i].trades);
+        REQUIRE(bars[i].volume == expected[i].volume);
+        REQUIRE(bars[i].notional == expected[i].notional);
+        REQUIRE(bars[i].high == expected[i].high);
+        REQUIRE(bars[i].low == expected[i].low);
+        covered += bars[i].trades;
+    }
+    REQUIRE(covered == 720 - 251);
+    REQUIRE(reader->bars(end, begin, interval).empty());
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Trade tape - Reopening appends and a torn block is ignored", "[trade_tape]") {
+    const std::string path = tape_path();
+    std::remove(path.c_str());
+    MatchingEngine engine;
+    const auto write_trades = [&engine, &path](std::uint64_t first, std::uint64_t count) {
+        auto writer = TradeTapeWriter::create(engine, path, {.block_trades = 16});
+        REQUIRE(writer);
+        for (std::uint64_t i = first; i < first + count; ++i) {
+            writer->on_trade(Trade{.buy_order_id = i, .sell_order_id = i + 1, .price = 100,
+                                   .quantity = i, .timestamp = Timestamp{static_cast<std::int64_t>(i)},
+                                   .aggressor = Side::Buy});
+        }
+    };
+    write_trades(0, 40);   // Blocks of 16, 16 and 8
+    write_trades(40, 20);  // 16 and 4
+
+    auto reader = TradeTapeReader::open(path);
+    REQUIRE(reader);
+    REQUIRE(reader->blocks() == 5);
+    auto trades = read_all(*reader);
+    REQUIRE(trades.size() == 60);
+    for (std::uint64_t i = 0; i < trades.size(); ++i) {
+        REQUIRE(trades[i].quantity == i);
+    }
+
+    // A crash mid-write leaves part of a block behind
+    const std::size_t whole = reader->file_bytes();
+    write_trades(60, 16);
+    reader.reset();
+    REQUIRE(::truncate(path.c_str(), static_cast<off_t>(whole + sizeof(tape::BlockHeader) + 8)) == 0);
+    reader = TradeTapeReader::open(path);
+    REQUIRE(reader);
+    REQUIRE(reader->blocks() == 5);
+    REQUIRE(reader->trades() == 60);
+
+    // Not a tape at all
+    REQUIRE(::truncate(path.c_str(), 0) == 0);
+    reader = TradeTapeReader::open(path);
+    REQUIRE(reader);
+    REQUIRE(reader->blocks() == 0);
+    const std::string text(2 * sizeof(tape::BlockHeader), 'x');
+    const int fd = ::open(path.c_str(), O_WRONLY);
+    REQUIRE(::write(fd, text.data(), text.size()) == static_cast<ssize_t>(text.size()));
+    ::close(fd);
+    REQUIRE_FALSE(TradeTapeReader::open(path));
+    std::remove(path.c_str());
+}
@@ -0,0 +1,174 @@
+#include <catch2/catch_test_macros.hpp>
+#include "gateway_test_helpers.hpp"
+#include "matching_engine.hpp"
+#include "tcp_gateway.hpp"
+#include "uring_gateway.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace lob;
+using namespace lob::test;
+using namespace std::chrono_literals;
+
+TEST_CASE("UringGateway - Orders, fills and cancel on disconnect over loopback", "[uring_gateway]") {
+    MatchingEngine engine;
+    auto gateway = UringGateway::create(engine, 0, 4);
+    if (!gateway) {
+        SKIP("io_uring is unavailable here");
+    }
+    REQUIRE(gateway->port() != 0);
+
+    auto maker = TcpOrderClient::connect("127.0.0.1", gateway->port());
+    auto taker = TcpOrderClient::connect("127.0.0.1", gateway->port());
+    REQUIRE(maker);
+    REQUIRE(taker);
+    REQUIRE(pump(*gateway, [&] { return gateway->open_sessions() == 2; }));
+
+    // Enough frames to span several receive buffers, so some frames arrive split
+    constexpr OrderId resting = 2000;
+    for (OrderId id = 1; id <= resting; ++id) {
+        maker->send(new_order(id, Side::Sell, 100 + static_cast<Price>(id), 10));
+    }
+    REQUIRE(maker->flush());
+    REQUIRE(pump(*gateway, [&] { return engine.get_order_book().order_count() == resting; }));
+    ExecutionReport report;
+    for (std::uint64_t seq = 1; seq <= resting; ++seq) {
+        REQUIRE(receive(*gateway, *maker, report));
+        REQUIRE(report.client_seq == seq);
+        REQUIRE(report.status == OrderStatus::New);
+    }
+
+    taker->send(new_order(5000, Side::Buy, 101, 15));
+    REQUIRE(taker->flush());
+    REQUIRE(pump(*gateway, [&] { return engine.get_order_book().get_order(5000) != nullptr; }));
+    REQUIRE(receive(*gateway, *taker, report));
+    REQUIRE(report.type == ReportType::Fill);
+    REQUIRE(receive(*gateway, *taker, report));
+    REQUIRE(report.type == ReportType::Ack);
+    REQUIRE(report.leaves == 5);
+    REQUIRE(receive(*gateway, *maker, report));
+    REQUIRE(report.type == ReportType::Fill);
+    REQUIRE(report.id == 1);
+
+    maker.reset();
+    REQUIRE(pump(*gateway, [&] { return gateway->open_sessions() == 1; }));
+    REQUIRE(engine.get_order_book().order_count() == 1);  // Only the taker's remainder
+
+    // The slot is reused by a new connection
+    auto next = TcpOrderClient::connect("127.0.0.1", gateway->port());
+    REQUIRE(next);
+    REQUIRE(pump(*gateway, [&] { return gateway->open_sessions() == 2; }));
+    next->send(OrderCommand{.id = 5000, .type = CommandType::Cancel});  // Not its order
+    REQUIRE(next->flush());
+    REQUIRE(receive(*gateway, *next, report));
+    REQUIRE(report.status == OrderStatus::Rejected);
+}
+
+TEST_CASE("UringGateway - A zero timeout does not wait", "[uring_gateway]") {
+    MatchingEngine engine;
+    auto gateway = UringGateway::create(engine, 0, 4);
+    if (!gateway) {
+        SKIP("io_uring is unavailable here");
+    }
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(gateway->poll(0ms) == 0);
+    }
+    REQUIRE(std::chrono::steady_clock::now() - start < 1s);
+
+    // Still picks up work that is already there
+    auto client = TcpOrderClient::connect("127.0.0.1", gateway->port());
+    REQUIRE(client);
+    for (int i = 0; i < 1000 && gateway->open_sessions() == 0; ++i) {
+        gateway->poll(0ms);
+        std::this_thread::sleep_for(1ms);
+    }
+    REQUIRE(gateway->open_sessions() == 1);
+}
+
+TEST_CASE("UringGateway - Journal records every executed command in order", "[uring_gateway]") {
+    const std::string path = "/tmp/lob_uring_journal_" + std::to_string(::getpid());
+    MatchingEngine engine;
+    auto gateway = UringGateway::create(engine, 0, 2, UringGateway::Options{.sqpoll = false, .journal_path = path});
+    if (!gateway) {
+        SKIP("io_uring is unavailable here");
+    }
+
+    auto client = TcpOrderClient::connect("127.0.0.1", gateway->port());
+    REQUIRE(client);
+    constexpr std::size_t count = 500;
+    for (OrderId id = 1; id <= count; ++id) {
+        client->send(new_order(id, Side::Buy, 100 - static_cast<Price>(id % 10), 1));
+    }
+    REQUIRE(client->flush());
+    REQUIRE(pump(*gateway, [&] { return engine.get_order_book().order_count() == count; }));
+    gateway.reset();  // Lands the journal writes still in flight
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    REQUIRE(fd >= 0);
+    JournalRecord record;
+    std::size_t read_count = 0;
+    while (::read(fd, &record, sizeof(record)) == static_cast<ssize_t>(sizeof(record))) {
+        ++read_count;
+        REQUIRE(record.sequence == read_count);
+        REQUIRE(record.participant == 1);
+        if (read_count > count) {
+            break;
+        }
+        REQUIRE(record.command.id == read_count);
+        REQUIRE(record.command.client_seq == read_count);
+    }
+    ::close(fd);
+    std::remove(path.c_str());
+    REQUIRE(read_count == count + 1);  // The session's disconnect cancel comes last
+    REQUIRE(record.command.type == CommandType::MassCancel);
+}
+
+TEST_CASE("UringGateway - Compressed journal decodes to the raw records", "[uring_gateway]") {
+    const std::string path = "/tmp/lob_uring_journal_compressed_" + std::to_string(::getpid());
+    MatchingEngine engine;
+    auto gateway = UringGateway::create(engine, 0, 2, UringGateway::Options{
+        .sqpoll = false, .journal_path = path, .journal_format = JournalFormat::Compressed});
+    if (!gateway) {
+        SKIP("io_uring is unavailable here");
+    }
+
+    auto client = TcpOrderClient::connect("127.0.0.1", gateway->port());
+    REQUIRE(client);
+    constexpr std::size_t count = 500;
+    for (OrderId id = 1; id <= count; ++id) {
+        client->send(new_order(id, Side::Buy, 100 - static_cast<Price>(id % 10), 1));
+    }
+    REQUIRE(client->flush());
+    REQUIRE(pump(*gateway, [&] { return engine.get_order_book().order_count() == count; }));
+    const std::uint64_t written = gateway->journal_bytes();
+    gateway.reset();
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    REQUIRE(fd >= 0);
+    std::vector<std::byte> stream(written + 4096);
+    const ssize_t length = ::read(fd, stream.data(), stream.size());
+    ::close(fd);
+    std::remove(path.c_str());
+    REQUIRE(length > 0);
+    stream.resize(static_cast<std::size_t>(length));
+    REQUIRE(stream.size() < count * sizeof(JournalRecord) / 4);
+
+    JournalDecoder decoder;
+    std::vector<JournalRecord> records;
+    REQUIRE(decoder.decode_all(stream, records) == stream.size());
+    REQUIRE(records.size() == count + 1);
+    for (std::size_t i = 0; i < count; ++i) {
+        REQUIRE(records[i].sequence == i + 1);
+        REQUIRE(records[i].participant == 1);
+        REQUIRE(records[i].command.id == i + 1);
+        REQUIRE(records[i].command.client_seq == i + 1);
+        REQUIRE(records[i].command.price == 100 - static_cast<Price>((i + 1) % 10));
+    }
+    REQUIRE(records.back().command.type == CommandType::MassCancel);
+}